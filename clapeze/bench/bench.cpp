@@ -0,0 +1,535 @@
+#include <clap/clap.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+#include "benchHost.h"
+
+/**
+ * clapeze_bench: runs every plugin from the linked clap_entry through a set of scenarios, and reports how long each
+ * process() call took. Any heap allocation made during process() is counted and flagged, and makes the bench exit with
+ * an error, so it can double as a real-time safety check.
+ *
+ * Link it against a library that defines clap_entry (see CMakeLists.txt). See --help for options.
+ */
+
+// allocation tracking. every global new/delete goes through here, but only calls made while a plugin is processing
+// are counted. memory allocated with malloc() directly isn't caught.
+namespace {
+std::atomic<bool> sTrackAllocations{false};
+std::atomic<size_t> sNumAllocations{0};
+std::atomic<size_t> sNumFrees{0};
+
+void* Allocate(size_t size, size_t alignment) {
+    if (sTrackAllocations.load(std::memory_order_relaxed)) {
+        sNumAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    size = std::max<size_t>(size, 1);
+    void* ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        ptr = std::malloc(size);
+    } else {
+#ifdef _WIN32
+        ptr = _aligned_malloc(size, alignment);
+#else
+        // aligned_alloc() wants a multiple of the alignment
+        ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    }
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void Free(void* ptr, size_t alignment) {
+    if (!ptr) {
+        return;
+    }
+    if (sTrackAllocations.load(std::memory_order_relaxed)) {
+        sNumFrees.fetch_add(1, std::memory_order_relaxed);
+    }
+#ifdef _WIN32
+    if (alignment > alignof(std::max_align_t)) {
+        _aligned_free(ptr);
+        return;
+    }
+#else
+    (void)alignment;
+#endif
+    std::free(ptr);
+}
+}  // namespace
+
+void* operator new(size_t size) {
+    return Allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size) {
+    return Allocate(size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+    return Allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return Allocate(size, static_cast<size_t>(alignment));
+}
+void operator delete(void* ptr) noexcept {
+    Free(ptr, alignof(std::max_align_t));
+}
+void operator delete[](void* ptr) noexcept {
+    Free(ptr, alignof(std::max_align_t));
+}
+void operator delete(void* ptr, size_t) noexcept {
+    Free(ptr, alignof(std::max_align_t));
+}
+void operator delete[](void* ptr, size_t) noexcept {
+    Free(ptr, alignof(std::max_align_t));
+}
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+    Free(ptr, static_cast<size_t>(alignment));
+}
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept {
+    Free(ptr, static_cast<size_t>(alignment));
+}
+void operator delete(void* ptr, size_t, std::align_val_t alignment) noexcept {
+    Free(ptr, static_cast<size_t>(alignment));
+}
+void operator delete[](void* ptr, size_t, std::align_val_t alignment) noexcept {
+    Free(ptr, static_cast<size_t>(alignment));
+}
+
+namespace {
+using namespace clapeze::bench;
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* kUsage = R"(usage: clapeze_bench [options]
+
+Runs each plugin through a set of scenarios, and reports per-block process() latency and realtime factor. Heap
+allocations made inside process() are flagged, and make the bench exit with an error.
+
+options:
+  -p, --plugin <id>         only bench this plugin. can be repeated
+  -s, --scenario <name>     only run this scenario. can be repeated
+  -t, --seconds <seconds>   how much audio each scenario renders (default: 10)
+  -r, --sample-rate <hz>    (default: 48000)
+  -l, --list                lists plugins and scenarios
+  -h, --help                shows this message
+)";
+
+struct Scenario {
+    const char* name;
+    const char* description;
+    // notes held at once. they're released and replayed every second
+    uint32_t numVoices;
+    // samples between changes to every automatable param, or 0 for none
+    uint32_t automationInterval;
+    // samples between note expressions and per-note param mods for every voice, or 0 for none
+    uint32_t modulationInterval;
+    // process() is called with each block size in turn
+    std::vector<uint32_t> blockSizes;
+};
+
+const std::vector<Scenario>& GetScenarios() {
+    static const std::vector<Scenario> sScenarios{
+        {"idle", "no events, for a baseline", 0, 0, 0, {256}},
+        {"chord4", "4 voice chords", 4, 0, 0, {256}},
+        {"chord16", "16 voice chords", 16, 0, 0, {256}},
+        {"automation", "4 voice chords, every param automated every 32 samples", 4, 32, 0, {256}},
+        {"perNoteMod", "8 voice chords, with note expressions and param mods every 64 samples", 8, 0, 64, {256}},
+        {"blockSizes", "8 voice chords, with irregular block sizes", 8, 0, 0, {1, 16, 33, 64, 100, 256, 441, 1024}},
+    };
+    return sScenarios;
+}
+
+struct Options {
+    std::vector<std::string> plugins;
+    std::vector<std::string> scenarios;
+    double seconds = 10.0;
+    double sampleRate = 48000.0;
+};
+
+struct PluginInfo {
+    std::vector<clap_param_info_t> params;
+    uint32_t numInputs = 0;
+    uint32_t numOutputs = 0;
+    bool hasNotes = false;
+};
+
+struct Result {
+    bool ok = false;
+    std::vector<double> blockSeconds;
+    double audioSeconds = 0.0;
+    double processSeconds = 0.0;
+    size_t numAllocations = 0;
+    size_t numFrees = 0;
+};
+
+PluginInfo GetPluginInfo(const clap_plugin_t* plugin) {
+    PluginInfo info;
+    if (auto* params = BenchHost::GetExtension<clap_plugin_params_t>(plugin, CLAP_EXT_PARAMS)) {
+        uint32_t count = params->count(plugin);
+        for (uint32_t idx = 0; idx < count; ++idx) {
+            clap_param_info_t param{};
+            if (params->get_info(plugin, idx, &param)) {
+                info.params.push_back(param);
+            }
+        }
+    }
+    if (auto* ports = BenchHost::GetExtension<clap_plugin_audio_ports_t>(plugin, CLAP_EXT_AUDIO_PORTS)) {
+        info.numInputs = ports->count(plugin, true);
+        info.numOutputs = ports->count(plugin, false);
+    }
+    if (auto* notes = BenchHost::GetExtension<clap_plugin_note_ports_t>(plugin, CLAP_EXT_NOTE_PORTS)) {
+        info.hasNotes = notes->count(plugin, true) > 0;
+    }
+    return info;
+}
+
+clap_event_header_t MakeHeader(uint32_t time, uint16_t type, uint32_t size) {
+    return {.size = size, .time = time, .space_id = CLAP_CORE_EVENT_SPACE_ID, .type = type, .flags = 0};
+}
+
+int16_t GetVoiceKey(uint32_t voice) {
+    // stacked maj7 chords, starting at C2
+    static constexpr int16_t kChord[] = {0, 4, 7, 11};
+    return static_cast<int16_t>(36 + (voice / 4) * 12 + kChord[voice % 4]);
+}
+
+/** adds every event for the block starting at blockStart to events */
+void AddEvents(const Scenario& scenario,
+               const PluginInfo& info,
+               double sampleRate,
+               uint64_t blockStart,
+               uint32_t blockSize,
+               EventList& events) {
+    uint64_t blockEnd = blockStart + blockSize;
+    auto firstTick = [blockStart](uint64_t interval) { return (blockStart + interval - 1) / interval * interval; };
+
+    if (info.hasNotes && scenario.numVoices > 0) {
+        uint64_t retrigger = static_cast<uint64_t>(sampleRate);
+        for (uint64_t time = firstTick(retrigger); time < blockEnd; time += retrigger) {
+            int32_t generation = static_cast<int32_t>(time / retrigger);
+            for (uint32_t voice = 0; voice < scenario.numVoices; ++voice) {
+                int32_t noteId = generation * static_cast<int32_t>(scenario.numVoices) + static_cast<int32_t>(voice);
+                auto offset = static_cast<uint32_t>(time - blockStart);
+                if (generation > 0) {
+                    events.Push(clap_event_note_t{
+                        .header = MakeHeader(offset, CLAP_EVENT_NOTE_OFF, sizeof(clap_event_note_t)),
+                        .note_id = noteId - static_cast<int32_t>(scenario.numVoices),
+                        .port_index = 0,
+                        .channel = 0,
+                        .key = GetVoiceKey(voice),
+                        .velocity = 0.0,
+                    });
+                }
+                events.Push(clap_event_note_t{
+                    .header = MakeHeader(offset, CLAP_EVENT_NOTE_ON, sizeof(clap_event_note_t)),
+                    .note_id = noteId,
+                    .port_index = 0,
+                    .channel = 0,
+                    .key = GetVoiceKey(voice),
+                    .velocity = 0.8,
+                });
+            }
+        }
+    }
+
+    if (scenario.automationInterval > 0) {
+        for (uint64_t time = firstTick(scenario.automationInterval); time < blockEnd;
+             time += scenario.automationInterval) {
+            double seconds = static_cast<double>(time) / sampleRate;
+            for (size_t idx = 0; idx < info.params.size(); ++idx) {
+                const clap_param_info_t& param = info.params[idx];
+                if (!(param.flags & CLAP_PARAM_IS_AUTOMATABLE) || (param.flags & CLAP_PARAM_IS_READONLY)) {
+                    continue;
+                }
+                // a slow sweep, offset per param so they don't all move together
+                double t = 0.5 + 0.5 * std::sin(2.0 * std::numbers::pi * 0.5 * seconds + static_cast<double>(idx));
+                double value = param.min_value + (param.max_value - param.min_value) * t;
+                if (param.flags & CLAP_PARAM_IS_STEPPED) {
+                    value = std::round(value);
+                }
+                events.Push(clap_event_param_value_t{
+                    .header = MakeHeader(static_cast<uint32_t>(time - blockStart), CLAP_EVENT_PARAM_VALUE,
+                                         sizeof(clap_event_param_value_t)),
+                    .param_id = param.id,
+                    .cookie = param.cookie,
+                    .note_id = -1,
+                    .port_index = -1,
+                    .channel = -1,
+                    .key = -1,
+                    .value = value,
+                });
+            }
+        }
+    }
+
+    if (info.hasNotes && scenario.modulationInterval > 0) {
+        static constexpr clap_param_info_flags kPerNote = CLAP_PARAM_IS_MODULATABLE_PER_NOTE_ID |
+                                                          CLAP_PARAM_IS_MODULATABLE_PER_KEY |
+                                                          CLAP_PARAM_IS_MODULATABLE_PER_CHANNEL;
+        uint64_t retrigger = static_cast<uint64_t>(sampleRate);
+        for (uint64_t time = firstTick(scenario.modulationInterval); time < blockEnd;
+             time += scenario.modulationInterval) {
+            auto offset = static_cast<uint32_t>(time - blockStart);
+            double seconds = static_cast<double>(time) / sampleRate;
+            int32_t generation = static_cast<int32_t>(time / retrigger);
+            for (uint32_t voice = 0; voice < scenario.numVoices; ++voice) {
+                int32_t noteId = generation * static_cast<int32_t>(scenario.numVoices) + static_cast<int32_t>(voice);
+                double lfo = std::sin(2.0 * std::numbers::pi * (5.0 * seconds + 0.1 * voice));
+                // vibrato, in semitones
+                events.Push(clap_event_note_expression_t{
+                    .header = MakeHeader(offset, CLAP_EVENT_NOTE_EXPRESSION, sizeof(clap_event_note_expression_t)),
+                    .expression_id = CLAP_NOTE_EXPRESSION_TUNING,
+                    .note_id = noteId,
+                    .port_index = 0,
+                    .channel = 0,
+                    .key = GetVoiceKey(voice),
+                    .value = 0.3 * lfo,
+                });
+                events.Push(clap_event_note_expression_t{
+                    .header = MakeHeader(offset, CLAP_EVENT_NOTE_EXPRESSION, sizeof(clap_event_note_expression_t)),
+                    .expression_id = CLAP_NOTE_EXPRESSION_PRESSURE,
+                    .note_id = noteId,
+                    .port_index = 0,
+                    .channel = 0,
+                    .key = GetVoiceKey(voice),
+                    .value = 0.5 + 0.5 * lfo,
+                });
+                for (const clap_param_info_t& param : info.params) {
+                    if (!(param.flags & kPerNote)) {
+                        continue;
+                    }
+                    events.Push(clap_event_param_mod_t{
+                        .header = MakeHeader(offset, CLAP_EVENT_PARAM_MOD, sizeof(clap_event_param_mod_t)),
+                        .param_id = param.id,
+                        .cookie = param.cookie,
+                        .note_id = noteId,
+                        .port_index = 0,
+                        .channel = 0,
+                        .key = GetVoiceKey(voice),
+                        .amount = 0.1 * (param.max_value - param.min_value) * lfo,
+                    });
+                }
+            }
+        }
+    }
+
+    events.Sort();
+}
+
+/** a playing transport at 120bpm, 4/4 */
+clap_event_transport_t MakeTransport(uint64_t time, double sampleRate) {
+    constexpr double kTempo = 120.0;
+    double seconds = static_cast<double>(time) / sampleRate;
+    double beats = seconds * kTempo / 60.0;
+    double bars = std::floor(beats / 4.0);
+    clap_event_transport_t transport{};
+    transport.header = MakeHeader(0, CLAP_EVENT_TRANSPORT, sizeof(clap_event_transport_t));
+    transport.flags = CLAP_TRANSPORT_HAS_TEMPO | CLAP_TRANSPORT_HAS_BEATS_TIMELINE |
+                      CLAP_TRANSPORT_HAS_SECONDS_TIMELINE | CLAP_TRANSPORT_HAS_TIME_SIGNATURE |
+                      CLAP_TRANSPORT_IS_PLAYING;
+    transport.song_pos_beats = static_cast<clap_beattime>(std::round(beats * CLAP_BEATTIME_FACTOR));
+    transport.song_pos_seconds = static_cast<clap_sectime>(std::round(seconds * CLAP_SECTIME_FACTOR));
+    transport.tempo = kTempo;
+    transport.bar_start = static_cast<clap_beattime>(std::round(bars * 4.0 * CLAP_BEATTIME_FACTOR));
+    transport.bar_number = static_cast<int32_t>(bars);
+    transport.tsig_num = 4;
+    transport.tsig_denom = 4;
+    return transport;
+}
+
+Result RunScenario(const clap_plugin_t* plugin, const PluginInfo& info, const Scenario& scenario, const Options& options) {
+    Result result;
+    uint32_t maxBlockSize = *std::max_element(scenario.blockSizes.begin(), scenario.blockSizes.end());
+    uint32_t minBlockSize = *std::min_element(scenario.blockSizes.begin(), scenario.blockSizes.end());
+
+    // stereo buffers for every port. inputs get noise, like a real signal would
+    auto makeBuffers = [maxBlockSize](uint32_t numPorts, std::vector<float>& samples,
+                                      std::vector<float*>& channels, std::vector<clap_audio_buffer_t>& buffers) {
+        samples.resize(static_cast<size_t>(numPorts) * 2 * maxBlockSize);
+        for (size_t idx = 0; idx < static_cast<size_t>(numPorts) * 2; ++idx) {
+            channels.push_back(samples.data() + idx * maxBlockSize);
+        }
+        for (uint32_t port = 0; port < numPorts; ++port) {
+            clap_audio_buffer_t buffer{};
+            buffer.data32 = channels.data() + static_cast<size_t>(port) * 2;
+            buffer.channel_count = 2;
+            buffers.push_back(buffer);
+        }
+    };
+    std::vector<float> inSamples, outSamples;
+    std::vector<float*> inChannels, outChannels;
+    std::vector<clap_audio_buffer_t> inBuffers, outBuffers;
+    makeBuffers(info.numInputs, inSamples, inChannels, inBuffers);
+    makeBuffers(info.numOutputs, outSamples, outChannels, outBuffers);
+    std::minstd_rand rng(1234);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    for (float& sample : inSamples) {
+        sample = noise(rng);
+    }
+
+    EventList events;
+    clap_event_transport_t transport{};
+    clap_process_t process{};
+    process.transport = &transport;
+    process.audio_inputs = inBuffers.data();
+    process.audio_outputs = outBuffers.data();
+    process.audio_inputs_count = info.numInputs;
+    process.audio_outputs_count = info.numOutputs;
+    process.in_events = events.GetInput();
+    process.out_events = events.GetOutput();
+
+    if (!plugin->activate(plugin, options.sampleRate, minBlockSize, maxBlockSize)) {
+        return result;
+    }
+    if (!plugin->start_processing(plugin)) {
+        plugin->deactivate(plugin);
+        return result;
+    }
+
+    auto totalSamples = static_cast<uint64_t>(options.seconds * options.sampleRate);
+    uint64_t time = 0;
+    size_t blockIndex = 0;
+    sNumAllocations = 0;
+    sNumFrees = 0;
+    while (time < totalSamples) {
+        uint32_t blockSize = scenario.blockSizes[blockIndex++ % scenario.blockSizes.size()];
+        blockSize = static_cast<uint32_t>(std::min<uint64_t>(blockSize, totalSamples - time));
+
+        // everything the host does happens outside of the measured (and allocation tracked) section
+        events.Clear();
+        AddEvents(scenario, info, options.sampleRate, time, blockSize, events);
+        transport = MakeTransport(time, options.sampleRate);
+        process.steady_time = static_cast<int64_t>(time);
+        process.frames_count = blockSize;
+
+        sTrackAllocations = true;
+        Clock::time_point start = Clock::now();
+        plugin->process(plugin, &process);
+        Clock::time_point end = Clock::now();
+        sTrackAllocations = false;
+
+        result.blockSeconds.push_back(std::chrono::duration<double>(end - start).count());
+        time += blockSize;
+    }
+    result.numAllocations = sNumAllocations;
+    result.numFrees = sNumFrees;
+
+    plugin->stop_processing(plugin);
+    plugin->deactivate(plugin);
+
+    result.ok = true;
+    result.audioSeconds = static_cast<double>(time) / options.sampleRate;
+    for (double seconds : result.blockSeconds) {
+        result.processSeconds += seconds;
+    }
+    return result;
+}
+
+double Percentile(std::vector<double> values, double percentile) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    auto idx = static_cast<size_t>(std::round(percentile * static_cast<double>(values.size() - 1)));
+    return values[idx];
+}
+
+bool Contains(const std::vector<std::string>& filter, const std::string& value) {
+    return filter.empty() || std::find(filter.begin(), filter.end(), value) != filter.end();
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    bool list = false;
+    std::vector<std::string> args(argv + 1, argv + argc);
+    for (size_t idx = 0; idx < args.size(); ++idx) {
+        const std::string& arg = args[idx];
+        bool hasValue = idx + 1 < args.size();
+        if (arg == "-h" || arg == "--help") {
+            fmt::print("{}", kUsage);
+            return 0;
+        } else if (arg == "-l" || arg == "--list") {
+            list = true;
+        } else if ((arg == "-p" || arg == "--plugin") && hasValue) {
+            options.plugins.push_back(args[++idx]);
+        } else if ((arg == "-s" || arg == "--scenario") && hasValue) {
+            options.scenarios.push_back(args[++idx]);
+        } else if ((arg == "-t" || arg == "--seconds") && hasValue) {
+            options.seconds = std::max(std::strtod(args[++idx].c_str(), nullptr), 0.01);
+        } else if ((arg == "-r" || arg == "--sample-rate") && hasValue) {
+            options.sampleRate = std::max(std::strtod(args[++idx].c_str(), nullptr), 1000.0);
+        } else {
+            fmt::print(stderr, "unknown option '{}'\n\n{}", arg, kUsage);
+            return 1;
+        }
+    }
+
+    if (!BenchHost::Init()) {
+        fmt::print(stderr, "clap_entry.init() failed\n");
+        return 1;
+    }
+
+    if (list) {
+        fmt::print("plugins:\n");
+        for (const clap_plugin_descriptor_t* descriptor : BenchHost::GetPlugins()) {
+            fmt::print("    {}: {}\n", descriptor->id, descriptor->name);
+        }
+        fmt::print("scenarios:\n");
+        for (const Scenario& scenario : GetScenarios()) {
+            fmt::print("    {}: {}\n", scenario.name, scenario.description);
+        }
+        BenchHost::Deinit();
+        return 0;
+    }
+
+    size_t numFailures = 0;
+    for (const clap_plugin_descriptor_t* descriptor : BenchHost::GetPlugins()) {
+        if (!Contains(options.plugins, descriptor->id)) {
+            continue;
+        }
+        const clap_plugin_t* plugin = BenchHost::CreatePlugin(descriptor->id);
+        if (!plugin) {
+            fmt::print(stderr, "{}: could not create plugin\n", descriptor->id);
+            ++numFailures;
+            continue;
+        }
+        PluginInfo info = GetPluginInfo(plugin);
+
+        fmt::print("{}\n", descriptor->id);
+        fmt::print("    {:<12} {:>8} {:>10} {:>10} {:>10} {:>10} {:>8} {:>8}\n", "scenario", "blocks", "p50 (us)",
+                   "p99 (us)", "max (us)", "realtime", "allocs", "frees");
+        for (const Scenario& scenario : GetScenarios()) {
+            if (!Contains(options.scenarios, scenario.name)) {
+                continue;
+            }
+            Result result = RunScenario(plugin, info, scenario, options);
+            if (!result.ok) {
+                fmt::print(stderr, "    {:<12} could not activate plugin\n", scenario.name);
+                ++numFailures;
+                continue;
+            }
+            bool allocates = result.numAllocations > 0 || result.numFrees > 0;
+            fmt::print("    {:<12} {:>8} {:>10.1f} {:>10.1f} {:>10.1f} {:>9.1f}x {:>8} {:>8}{}\n", scenario.name,
+                       result.blockSeconds.size(), Percentile(result.blockSeconds, 0.5) * 1e6,
+                       Percentile(result.blockSeconds, 0.99) * 1e6, Percentile(result.blockSeconds, 1.0) * 1e6,
+                       result.audioSeconds / std::max(result.processSeconds, 1e-9), result.numAllocations,
+                       result.numFrees, allocates ? "  <- heap used in process()" : "");
+            numFailures += allocates ? 1 : 0;
+        }
+        BenchHost::DestroyPlugin(plugin);
+    }
+
+    BenchHost::Deinit();
+    return numFailures == 0 ? 0 : 1;
+}
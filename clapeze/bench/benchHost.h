@@ -0,0 +1,141 @@
+#pragma once
+
+#include <clap/clap.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+extern "C" const clap_plugin_entry_t clap_entry;
+
+namespace clapeze::bench {
+
+/**
+ * A minimal headless host, like the MockHost used by the tests, but without any gtest dependencies. It creates plugins
+ * through the statically linked clap_entry, and offers no host extensions, so plugins get the same treatment they'd get
+ * from the most bare-bones host out there.
+ */
+class BenchHost {
+   public:
+    static bool Init() { return clap_entry.init(""); }
+    static void Deinit() { clap_entry.deinit(); }
+
+    static std::vector<const clap_plugin_descriptor_t*> GetPlugins() {
+        std::vector<const clap_plugin_descriptor_t*> out;
+        const clap_plugin_factory_t* factory = GetFactory();
+        uint32_t count = factory->get_plugin_count(factory);
+        for (uint32_t idx = 0; idx < count; ++idx) {
+            out.push_back(factory->get_plugin_descriptor(factory, idx));
+        }
+        return out;
+    }
+
+    static const clap_plugin_t* CreatePlugin(const std::string& pluginId) {
+        const clap_plugin_factory_t* factory = GetFactory();
+        const clap_plugin_t* plugin = factory->create_plugin(factory, Host(), pluginId.c_str());
+        if (plugin && !plugin->init(plugin)) {
+            plugin->destroy(plugin);
+            return nullptr;
+        }
+        return plugin;
+    }
+
+    static void DestroyPlugin(const clap_plugin_t* plugin) { plugin->destroy(plugin); }
+
+    template <typename TExtension>
+    static const TExtension* GetExtension(const clap_plugin_t* plugin, const char* name) {
+        return static_cast<const TExtension*>(plugin->get_extension(plugin, name));
+    }
+
+   private:
+    static const clap_plugin_factory_t* GetFactory() {
+        return static_cast<const clap_plugin_factory_t*>(clap_entry.get_factory(CLAP_PLUGIN_FACTORY_ID));
+    }
+
+    static clap_host_t* Host() {
+        static clap_host_t sHost{
+            .clap_version = CLAP_VERSION_INIT,
+            .host_data = nullptr,
+            .name = "clapeze bench",
+            .vendor = "clapeze",
+            .url = "https://crouton.net",
+            .version = "0.0.0",
+            .get_extension = _get_extension,
+            .request_restart = _request_restart,
+            .request_process = _request_process,
+            .request_callback = _request_callback,
+        };
+        return &sHost;
+    }
+
+    static const void* _get_extension([[maybe_unused]] const clap_host_t* host,
+                                      [[maybe_unused]] const char* extension_id) {
+        return nullptr;
+    }
+    static void _request_restart([[maybe_unused]] const clap_host_t* host) {}
+    static void _request_process([[maybe_unused]] const clap_host_t* host) {}
+    static void _request_callback([[maybe_unused]] const clap_host_t* host) {}
+};
+
+/**
+ * Holds the events for a single process() call. Events are copied into fixed size slots, so once the list has grown to
+ * fit the biggest block, Clear() and Push() don't allocate. Call Sort() once everything's been pushed.
+ */
+class EventList {
+   public:
+    union Event {
+        clap_event_header_t header;
+        clap_event_note_t note;
+        clap_event_note_expression_t expression;
+        clap_event_param_value_t value;
+        clap_event_param_mod_t mod;
+    };
+
+    EventList() {
+        mIn.ctx = this;
+        mIn.size = _size;
+        mIn.get = _get;
+        mOut.ctx = this;
+        mOut.try_push = _try_push;
+    }
+    EventList(const EventList&) = delete;
+    EventList& operator=(const EventList&) = delete;
+
+    void Clear() { mEvents.clear(); }
+
+    template <typename TEvent>
+    void Push(const TEvent& event) {
+        Event& slot = mEvents.emplace_back();
+        reinterpret_cast<TEvent&>(slot) = event;
+    }
+
+    /** sorts events by time. events pushed at the same time keep their order, so a note off can go before a note on */
+    void Sort() {
+        std::stable_sort(mEvents.begin(), mEvents.end(),
+                         [](const Event& lhs, const Event& rhs) { return lhs.header.time < rhs.header.time; });
+    }
+
+    size_t Size() const { return mEvents.size(); }
+
+    const clap_input_events_t* GetInput() const { return &mIn; }
+    /** output events are dropped, the bench doesn't look at them */
+    const clap_output_events_t* GetOutput() const { return &mOut; }
+
+   private:
+    static uint32_t _size(const clap_input_events_t* list) {
+        return static_cast<uint32_t>(static_cast<const EventList*>(list->ctx)->mEvents.size());
+    }
+    static const clap_event_header_t* _get(const clap_input_events_t* list, uint32_t index) {
+        return &static_cast<const EventList*>(list->ctx)->mEvents[index].header;
+    }
+    static bool _try_push([[maybe_unused]] const clap_output_events_t* list,
+                          [[maybe_unused]] const clap_event_header_t* event) {
+        return true;
+    }
+
+    std::vector<Event> mEvents;
+    clap_input_events_t mIn{};
+    clap_output_events_t mOut{};
+};
+
+}  // namespace clapeze::bench
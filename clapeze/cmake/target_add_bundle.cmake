@@ -3,11 +3,19 @@ add_executable(create-zip EXCLUDE_FROM_ALL "${CMAKE_CURRENT_LIST_DIR}/../tools/c
 target_link_libraries(create-zip PRIVATE miniz)
 
 # Use to add a bundled output to your library/executable target
+# target_add_bundle(<target> <out file> [COMPRESS] <sources...>)
+# COMPRESS deflates assets that aren't already compressed. by default everything is stored, which is bigger on disk,
+# but can be read straight from the mapped file (see clapeze::AssetArchive)
 function(target_add_bundle TARGET_NAME OUT_FILE)
     if (NOT TARGET ${TARGET_NAME})
         message(FATAL_ERROR "Target '${TARGET_NAME}' does not exist")
     endif()
-    set(SOURCES ${ARGN})
+    cmake_parse_arguments(PARSE_ARGV 2 BUNDLE "COMPRESS" "" "")
+    set(SOURCES ${BUNDLE_UNPARSED_ARGUMENTS})
+    set(ZIP_FLAGS)
+    if (BUNDLE_COMPRESS)
+        set(ZIP_FLAGS --compress)
+    endif()
 
     # make zip
     set(ZIP_DIR "${CMAKE_CURRENT_BINARY_DIR}/tmp")
@@ -22,7 +30,7 @@ function(target_add_bundle TARGET_NAME OUT_FILE)
         WORKING_DIRECTORY "${PROJECT_SOURCE_DIR}" # use so final zip looks like project dir
         COMMAND ${CMAKE_COMMAND} -E make_directory "${ZIP_DIR}"
         COMMAND ${CMAKE_COMMAND} -E rm -f "${ZIP_FILE}"
-        COMMAND create-zip "${ZIP_FILE}" ${SOURCES}
+        COMMAND create-zip ${ZIP_FLAGS} "${ZIP_FILE}" ${SOURCES}
         COMMENT "creating zip file: ${ZIP_FILE}"
         VERBATIM
     )
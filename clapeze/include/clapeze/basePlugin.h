@@ -3,7 +3,10 @@
 #include <clap/clap.h>
 #include <clap/events.h>
 #include <cassert>
+#include <functional>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include "clapeze/features/baseFeature.h"
@@ -14,6 +17,7 @@
 namespace clapeze {
 
 class BasePlugin;
+class ProfilingFeature;
 
 struct PluginEntry {
     clap_plugin_descriptor_t meta;
@@ -94,12 +98,21 @@ class BasePlugin {
 
     /* internal implementation*/
    private:
+    // lets us look up by const char* without building a std::string, since some lookups happen on the audio thread
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+    template <typename TValue>
+    using NameMap = std::unordered_map<std::string, TValue, NameHash, std::equal_to<>>;
+
     clap_plugin_t mPlugin;
     const clap_plugin_descriptor_t& mDescriptor;
-    std::unordered_map<std::string, std::unique_ptr<BaseFeature>> mFeatures{};
-    std::unordered_map<std::string, const void*> mExtensions{};
+    NameMap<std::unique_ptr<BaseFeature>> mFeatures{};
+    NameMap<const void*> mExtensions{};
     std::unique_ptr<PluginHost> mHost{};
     std::unique_ptr<BaseProcessor> mProcessor{};
+    ProfilingFeature* mProfiling{};
 
     static bool _init(const clap_plugin* plugin);
     static void _destroy(const clap_plugin* plugin);
@@ -0,0 +1,115 @@
+// Reads assets out of a zip archive that's been memory mapped, indexed once, and cached.
+
+#pragma once
+
+#include <miniz.h>
+#include <miniz_zip.h>
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace clapeze {
+
+/**
+ * The contents of a single asset. Stored (uncompressed) entries point straight into the mapped archive, and
+ * compressed entries hold on to their decompressed copy, so the data stays valid even if it's evicted from the cache
+ * in the meantime. Either way, don't keep it around after the archive is closed.
+ */
+struct AssetData {
+    std::span<const char> bytes{};
+    std::shared_ptr<const std::vector<char>> owner{};
+
+    std::string_view view() const { return {bytes.data(), bytes.size()}; }
+};
+
+/**
+ * A read-only zip archive, usually the one appended to the end of the plugin binary (see target_add_bundle()).
+ *
+ * The file is memory mapped, and its central directory is read once into a hash map, so looking up an asset is a
+ * single hash instead of a scan. Entries stored without compression are returned as spans of the mapped file, with no
+ * copying or decompressing at all. Compressed entries are decompressed in one go, and kept in an LRU cache, up to
+ * cacheLimitBytes, so reopening the editor doesn't decompress everything again.
+ *
+ * Read() is [thread-safe]. Open() and Close() aren't.
+ */
+class AssetArchive {
+   public:
+    static constexpr size_t kDefaultCacheLimitBytes = 32 * 1024 * 1024;
+
+    explicit AssetArchive(size_t cacheLimitBytes = kDefaultCacheLimitBytes);
+    ~AssetArchive();
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive(AssetArchive&&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+    AssetArchive& operator=(AssetArchive&&) = delete;
+
+    /** Maps the file at path, and indexes the zip archive at the end of it. */
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return mMappedData != nullptr; }
+
+    /** Every file path in the archive that starts with prefix, in archive order. */
+    std::vector<std::string> GetAllPaths(std::string_view prefix = "") const;
+    bool Contains(std::string_view path) const;
+
+    /** Returns the contents of the file at path, or nullopt if there isn't one (see GetLastError()). */
+    std::optional<AssetData> Read(std::string_view path);
+    /** the error from the last failed Open() or Read() */
+    const char* GetLastError() const { return mLastError; }
+
+    size_t GetCacheSize() const {
+        std::lock_guard lock(mCacheMutex);
+        return mCacheBytes;
+    }
+
+   private:
+    struct Entry {
+        mz_uint fileIndex{};
+        size_t size{};
+        // only for stored entries, otherwise nullptr
+        const char* storedData{};
+    };
+    struct CachedEntry {
+        std::string path;
+        std::shared_ptr<const std::vector<char>> data;
+    };
+    struct PathHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    bool Map(const char* path);
+    void Unmap();
+    const char* FindStoredData(const mz_zip_archive_file_stat& stat) const;
+
+    size_t mCacheLimitBytes;
+
+    // mapped file
+    const char* mMappedData{};
+    size_t mMappedSize{};
+    void* mFileHandle{};
+    void* mMappingHandle{};
+    // the part of the mapped file the zip archive is in
+    const char* mArchiveData{};
+    size_t mArchiveSize{};
+
+    mz_zip_archive mZip{};
+    std::vector<std::string> mPaths;
+    std::unordered_map<std::string, Entry, PathHash, std::equal_to<>> mEntries;
+
+    mutable std::mutex mCacheMutex;
+    // most recently used first
+    std::list<CachedEntry> mCache;
+    std::unordered_map<std::string_view, std::list<CachedEntry>::iterator> mCacheLookup;
+    size_t mCacheBytes{};
+    std::atomic<const char*> mLastError{""};
+};
+}  // namespace clapeze
@@ -1,74 +1,42 @@
 // Loads files from either from disk directly, or from a virtual filesystem embedded within the plugin.
 #pragma once
 
-#include <miniz.h>
-#include <miniz_zip.h>
+#include <filesystem>
 #include <ios>
 #include <istream>
+#include <optional>
+#include <string_view>
 #include <vector>
+#include "clapeze/features/assetArchive.h"
 #include "clapeze/features/baseFeature.h"
+#include "clapeze/impl/streamUtils.h"
 
 namespace clapeze {
 class PluginHost;
 
-class miniz_istreambuf : public std::streambuf {
-    // TODO: seek support. full example at https://stackoverflow.com/a/79746417
-   public:
-    explicit miniz_istreambuf(mz_zip_archive* pZip, const char* path)
-        : mState(mz_zip_reader_extract_file_iter_new(pZip, path, kLoadFlags)) {}
-    ~miniz_istreambuf() { mz_zip_reader_extract_iter_free(mState); }
-    miniz_istreambuf(const miniz_istreambuf&) = delete;
-    miniz_istreambuf(miniz_istreambuf&&) = delete;
-    miniz_istreambuf& operator=(const miniz_istreambuf&) = delete;
-    miniz_istreambuf& operator=(miniz_istreambuf&&) = delete;
-
-   protected:
-    static constexpr mz_uint kLoadFlags = 0;
-    std::streamsize xsgetn(char* s, std::streamsize n) override {
-        // read up to n chars from s
-        size_t bytesRead = mz_zip_reader_extract_iter_read(mState, s, n);
-        return static_cast<std::streamsize>((bytesRead <= 0) ? 0 : bytesRead);
-    }
-
-    int_type underflow() override {
-        // fill internal buffer with more bytes
-        size_t bytesRead = mz_zip_reader_extract_iter_read(mState, mBuffer, kBufferSize);
-        if (bytesRead <= 0) {
-            return traits_type::eof();
-        }
-
-        // expose buffer + first char in buffer to stream
-        setg(mBuffer, mBuffer, mBuffer + bytesRead);
-        return traits_type::to_int_type(mBuffer[0]);
-    }
-
-   private:
-    mz_zip_reader_extract_iter_state* mState;
-    static constexpr std::size_t kBufferSize = 256;  // TODO: configurable?
-    char mBuffer[kBufferSize];
-};
-
 /**
- * Wraps a miniz file into a std::streambuf for use with iostream-based APIs.
- *
- * if your api expects seeking, this won't work! instead use istream_tostring.
+ * Reads an asset from the plugin as a std::istream. Seeking works, too.
  */
-class miniz_istream : public std::basic_istream<char> {
+class asset_istream : public std::basic_istream<char> {
    public:
-    explicit miniz_istream(mz_zip_archive* pZip, const char* path)
-        : basic_istream(nullptr), mBuf(pZip, path), mZip(pZip) {
+    explicit asset_istream(std::optional<AssetData> data, const char* error)
+        : basic_istream(nullptr),
+          mData(std::move(data)),
+          mBuf(mData ? mData->bytes : std::span<const char>()),
+          mError(error) {
         this->init(&mBuf);
+        if (!mData) {
+            this->setstate(std::ios_base::badbit);
+        }
     }
 
-    void getZipError(int32_t& errorcode, const char*& msg) {
-        mz_zip_error err = mz_zip_get_last_error(mZip);
-        errorcode = static_cast<int32_t>(err);
-        msg = mz_zip_get_error_string(err);
-    }
+    /** if the stream is bad(), this is why */
+    const char* getError() const { return mError; }
 
    private:
-    miniz_istreambuf mBuf;
-    mz_zip_archive* mZip;
+    std::optional<AssetData> mData;
+    impl::memory_istreambuf mBuf;
+    const char* mError;
 };
 
 class AssetsFeature : public BaseFeature {
@@ -87,8 +55,24 @@ class AssetsFeature : public BaseFeature {
 
     std::vector<std::string> GetAllPathsFromPlugin(std::string_view prefix = "") const;
 
-    miniz_istream OpenFromPlugin(const char* path);
+    /**
+     * Returns the contents of a file embedded in the plugin, without copying it if it was stored uncompressed. See
+     * AssetArchive.
+     *
+     * Stored files point straight into the mapped plugin binary, which is unmapped when the last AssetsFeature is
+     * destroyed. So don't keep the data (or a stream from OpenFromPlugin()) past the plugin instance that read it; copy
+     * it out if it needs to live longer.
+     */
+    std::optional<AssetData> ReadFromPlugin(std::string_view path);
+    /** Same lifetime as ReadFromPlugin(). */
+    asset_istream OpenFromPlugin(const char* path);
     std::ifstream OpenFromFilesystem(const char* path);
     std::ofstream OpenFromFilesystemOut(const char* path);
+
+    /**
+     * Where user presets are saved, named after the plugin library. For example `~/.local/share/kitsblips/presets` on
+     * linux. Empty if there's no home directory to put it in.
+     */
+    std::filesystem::path GetUserPresetDirectory() const;
 };
 }  // namespace clapeze
\ No newline at end of file
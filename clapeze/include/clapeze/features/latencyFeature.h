@@ -6,6 +6,7 @@
 
 #include <clap/ext/preset-load.h>
 #include <clap/factory/preset-discovery.h>
+#include <atomic>
 #include "clap/ext/latency.h"
 #include "clapeze/basePlugin.h"
 #include "clapeze/features/baseFeature.h"
@@ -19,7 +20,8 @@ class LatencyFeature : public BaseFeature {
     const char* Name() const override { return NAME; }
 
     void Configure(BasePlugin& self) override {
-        self.GetHost().TryGetExtension(NAME, mRawHost, mRawHostLatency);
+        mHost = &self.GetHost();
+        mHost->TryGetExtension(NAME, mRawHost, mRawHostLatency);
         static const clap_plugin_latency_t value = {
             &_get,
         };
@@ -27,25 +29,42 @@ class LatencyFeature : public BaseFeature {
     }
 
     void OnActivated() {
-        if (mNextLatencySamples != mLatencySamples) {
-            mLatencySamples = mNextLatencySamples;
-            mRawHostLatency->changed(mRawHost);
+        uint32_t nextLatencySamples = mNextLatencySamples.load(std::memory_order_relaxed);
+        if (nextLatencySamples != mLatencySamples) {
+            mLatencySamples = nextLatencySamples;
+            if (mRawHostLatency) {
+                mRawHostLatency->changed(mRawHost);
+            }
         }
+        mActive.store(true, std::memory_order_relaxed);
     }
+    void OnDeactivated() { mActive.store(false, std::memory_order_relaxed); }
 
     /*
-     * NOTE: if you are changing latency outside of the Activate() method, call host.RequestRestart() so it can be
-     * applied on next activation.
+     * Latency can only change while the plugin is being activated. Changes from inside Activate() are applied right
+     * away, and changes made while the plugin is already active ask the host to restart it, so they're applied on the
+     * next activation.
+     *
+     * [thread-safe]
      */
-    void ChangeLatency(uint32_t newLatencySamples) { mNextLatencySamples = newLatencySamples; }
+    void ChangeLatency(uint32_t newLatencySamples) {
+        mNextLatencySamples.store(newLatencySamples, std::memory_order_relaxed);
+        if (mActive.load(std::memory_order_relaxed) && newLatencySamples != mLatencySamples && mHost) {
+            mHost->RequestRestart();
+        }
+    }
+    /** the latency the host currently knows about */
+    uint32_t GetLatency() const { return mLatencySamples; }
 
    private:
     static uint32_t _get(const clap_plugin_t* plugin) {
         LatencyFeature& self = LatencyFeature::GetFromPluginObject<LatencyFeature>(plugin);
         return self.mLatencySamples;
     }
-    uint32_t mLatencySamples;
-    uint32_t mNextLatencySamples;
+    uint32_t mLatencySamples = 0;
+    std::atomic<uint32_t> mNextLatencySamples{0};
+    std::atomic<bool> mActive{};
+    PluginHost* mHost = nullptr;
     const clap_host_t* mRawHost = nullptr;
     const clap_host_latency_t* mRawHostLatency = nullptr;
 };
@@ -3,7 +3,6 @@
 #include <clap/events.h>
 #include <clap/ext/params.h>
 #include <clap/id.h>
-#include <etl/queue_spsc_atomic.h>
 #include <concepts>
 #include <cstdint>
 #include <optional>
@@ -11,19 +10,12 @@
 #include "clapeze/basePlugin.h"
 #include "clapeze/common.h"
 #include "clapeze/features/params/baseParameter.h"
+#include "clapeze/features/params/changeQueue.h"
 #include "clapeze/impl/stringUtils.h"
 
 namespace clapeze::params {
-enum class ChangeType : uint8_t { SetValue, SetModulation, StartGesture, StopGesture };
-struct Change {
-    ChangeType type;
-    clap_id id;
-    NoteTuple note;
-    double value;
-};
-// likely worst case is something like 2x the number of parameters in the feature (queue up everything to change on
-// activate, then queue up everything to change on patch load)
-using Queue = etl::queue_spsc_atomic<Change, 1000, etl::memory_model::MEMORY_MODEL_MEDIUM>;
+// automation is coalesced per parameter, so this can't overflow no matter how dense it gets. see ChangeQueue
+using Queue = ChangeQueue;
 
 class BaseMainHandle {
    public:
@@ -80,6 +72,11 @@ class BaseParametersFeature : public BaseFeature {
     std::optional<clap_id> GetIdFromKey(std::string_view) const;
     void ResetAllParamsToDefault();
 
+    /** changes that were merged into a newer change before being flushed, in both directions. [thread-safe] */
+    uint64_t GetNumCoalescedChanges() const;
+    /** changes that were lost, in both directions. [thread-safe] */
+    uint64_t GetNumDroppedChanges() const;
+
    protected:
     PluginHost& mHost;
     const size_t mNumParams;
@@ -135,7 +132,11 @@ inline bool BaseParametersFeature::Validate(const BasePlugin& self) const {
 }
 
 inline BaseParametersFeature::BaseParametersFeature(PluginHost& host, clap_id numParams)
-    : mHost(host), mNumParams(static_cast<size_t>(numParams)), mParams(mNumParams), mAudioToMain(), mMainToAudio() {}
+    : mHost(host),
+      mNumParams(static_cast<size_t>(numParams)),
+      mParams(mNumParams),
+      mAudioToMain(mNumParams, false),
+      mMainToAudio(mNumParams, true) {}
 
 inline const BaseParam* BaseParametersFeature::GetBaseParam(clap_id id) const {
     if (id >= mNumParams) {
@@ -196,6 +197,12 @@ inline void BaseParametersFeature::ResetAllParamsToDefault() {
     }
     RequestRescan(CLAP_PARAM_RESCAN_VALUES);
 }
+inline uint64_t BaseParametersFeature::GetNumCoalescedChanges() const {
+    return mAudioToMain.GetNumCoalesced() + mMainToAudio.GetNumCoalesced();
+}
+inline uint64_t BaseParametersFeature::GetNumDroppedChanges() const {
+    return mAudioToMain.GetNumDropped() + mMainToAudio.GetNumDropped();
+}
 
 /*static*/ inline uint32_t BaseParametersFeature::_count(const clap_plugin_t* plugin) {
     BaseParametersFeature& self = BaseParametersFeature::GetFromPluginObject<BaseParametersFeature>(plugin);
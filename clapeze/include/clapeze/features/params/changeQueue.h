@@ -0,0 +1,144 @@
+#pragma once
+
+#include <clap/id.h>
+#include <etl/queue_spsc_atomic.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "clapeze/common.h"
+#include "clapeze/impl/dirtySet.h"
+
+namespace clapeze::params {
+enum class ChangeType : uint8_t { SetValue, SetModulation, StartGesture, StopGesture };
+struct Change {
+    ChangeType type;
+    clap_id id;
+    NoteTuple note;
+    double value;
+};
+
+/**
+ * Sends parameter changes from one thread to another, keeping only the latest value of each parameter.
+ *
+ * Every parameter has a slot for its latest value and modulation, plus a dirty bit. Pushing a change overwrites the
+ * slot and sets the bit, so dense automation can't fill anything up: the consumer sees each changed parameter once per
+ * Drain(), with its final value, no matter how many changes were pushed in between. Values and modulation can be
+ * pushed from any thread.
+ *
+ * Gestures can't be merged like that, so when enabled they go through a small ordered queue instead, and a parameter's
+ * latest value is always delivered before the gesture that ends it. That queue only supports a single producer.
+ *
+ * Modulation is merged per parameter too, so the consumer only gets the latest amount, without the note it was for.
+ */
+class ChangeQueue {
+   public:
+    static constexpr size_t kMaxParams = 1024;
+    static constexpr size_t kMaxGestures = 128;
+
+    /**
+     * Only the first kMaxParams parameters fit in the dirty sets. Past that, changes to the rest are dropped (and
+     * counted in GetNumDropped()) instead of overflowing them.
+     */
+    ChangeQueue(size_t numParams, bool passGestures)
+        : mNumParams(std::min(numParams, kMaxParams)),
+          mPassGestures(passGestures),
+          mSlots(std::make_unique<Slot[]>(mNumParams)) {
+        assert(numParams <= kMaxParams);
+    }
+
+    /**
+     * Returns false if the change was dropped, which only happens to gestures, when their queue is full (or disabled).
+     *
+     * [thread-safe & realtime-safe]
+     */
+    bool Push(const Change& change) {
+        if (change.id >= mNumParams) {
+            mNumDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        switch (change.type) {
+            case ChangeType::SetValue: {
+                mSlots[change.id].value.store(change.value, std::memory_order_relaxed);
+                if (mDirtyValues.TestAndSetAtomic(change.id)) {
+                    mNumCoalesced.fetch_add(1, std::memory_order_relaxed);
+                }
+                return true;
+            }
+            case ChangeType::SetModulation: {
+                mSlots[change.id].modulation.store(change.value, std::memory_order_relaxed);
+                if (mDirtyModulations.TestAndSetAtomic(change.id)) {
+                    mNumCoalesced.fetch_add(1, std::memory_order_relaxed);
+                }
+                return true;
+            }
+            case ChangeType::StartGesture:
+            case ChangeType::StopGesture: {
+                if (mPassGestures && mGestures.push(change)) {
+                    return true;
+                }
+                mNumDropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Calls fn(const Change&) for every pending change: gestures first, in order, then every changed value and
+     * modulation. Returns the number of changes delivered.
+     *
+     * [single consumer & realtime-safe]
+     */
+    template <typename TFn>
+    size_t Drain(TFn&& fn) {
+        size_t count = 0;
+        Change change;
+        while (mGestures.pop(change)) {
+            if (change.type == ChangeType::StopGesture && mDirtyValues.TestAndClearAtomic(change.id)) {
+                // the gesture's final value has to arrive before the gesture ends
+                fn(Change{ChangeType::SetValue, change.id, {}, LoadValue(change.id)});
+                ++count;
+            }
+            fn(change);
+            ++count;
+        }
+        mDirtyValues.ForEachSetAtomic([&](size_t idx) {
+            auto id = static_cast<clap_id>(idx);
+            fn(Change{ChangeType::SetValue, id, {}, LoadValue(id)});
+            ++count;
+        });
+        mDirtyModulations.ForEachSetAtomic([&](size_t idx) {
+            auto id = static_cast<clap_id>(idx);
+            fn(Change{ChangeType::SetModulation, id, {}, mSlots[id].modulation.load(std::memory_order_relaxed)});
+            ++count;
+        });
+        return count;
+    }
+
+    /** changes that were overwritten by a newer one before they were drained. [thread-safe] */
+    uint64_t GetNumCoalesced() const { return mNumCoalesced.load(std::memory_order_relaxed); }
+    /** changes that were lost. [thread-safe] */
+    uint64_t GetNumDropped() const { return mNumDropped.load(std::memory_order_relaxed); }
+
+   private:
+    struct Slot {
+        std::atomic<double> value{};
+        std::atomic<double> modulation{};
+    };
+    static_assert(std::atomic<double>::is_always_lock_free);
+
+    double LoadValue(clap_id id) const { return mSlots[id].value.load(std::memory_order_relaxed); }
+
+    size_t mNumParams;
+    bool mPassGestures;
+    std::unique_ptr<Slot[]> mSlots;
+    DirtySet<kMaxParams> mDirtyValues;
+    DirtySet<kMaxParams> mDirtyModulations;
+    etl::queue_spsc_atomic<Change, kMaxGestures, etl::memory_model::MEMORY_MODEL_SMALL> mGestures;
+    std::atomic<uint64_t> mNumCoalesced{};
+    std::atomic<uint64_t> mNumDropped{};
+};
+}  // namespace clapeze::params
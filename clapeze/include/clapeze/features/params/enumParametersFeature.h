@@ -8,6 +8,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <type_traits>
 
 #include "clap/events.h"
 #include "clapeze/common.h"
@@ -32,6 +33,10 @@ class EnumAudioHandle : public BaseAudioHandle {
                     Queue& mainToAudio,
                     Queue& audioToMain);
 
+    /**
+     * Returns the current value of the param, with modulation and its curve applied. This is cached whenever the
+     * value or modulation changes, so it's just a load, and cheap enough to call per voice.
+     */
     template <class TParam>
     typename TParam::_valuetype Get(clap_id id) const;
 
@@ -53,7 +58,7 @@ class EnumAudioHandle : public BaseAudioHandle {
                 // tricksy: we're sending our own update from the audio thread to be processed in
                 // FlushEventsFromMain. probably smarter to ask for the event queue and push ourselves in there
                 // instead.
-                mMainToAudio.push({ChangeType::SetValue, index, {}, raw});
+                mMainToAudio.Push({ChangeType::SetValue, index, {}, raw});
             }
         }
     }
@@ -63,7 +68,20 @@ class EnumAudioHandle : public BaseAudioHandle {
     void OnNoteStart(const NoteTuple& note) override { /* TODO */ }
     void OnNoteEnd(const NoteTuple& note) override { /* TODO */ }
 
+    /**
+     * Caches the param's value through TParam::ToValue() from now on. That's resolved here, rather than through
+     * BaseParam, so params that shadow ToValue() with their own conversion get the same value from Get() that
+     * they'd get from calling it directly. [main-thread & !active]
+     */
+    template <class TParam>
+    void AddParam(clap_id id);
+
    private:
+    using PlainFn = double (*)(const BaseParam& param, double rawValue);
+    template <class TParam>
+    static double ToPlain(const BaseParam& param, double rawValue);
+    void RefreshPlainValue(clap_id id);
+
     double GetRawValue(clap_id id) const;
     void SetRawValue(clap_id id, double newValue);
 
@@ -73,6 +91,9 @@ class EnumAudioHandle : public BaseAudioHandle {
     std::vector<std::unique_ptr<BaseParam>>& mParamsRef;
     std::vector<double> mValues;
     std::vector<double> mModulations;
+    // mValues + mModulations, through each param's ToValue()
+    std::vector<double> mPlainValues;
+    std::vector<PlainFn> mToPlain;
     Queue& mMainToAudio;
     Queue& mAudioToMain;
 };
@@ -118,6 +139,7 @@ class EnumParametersFeature : public BaseParametersFeature {
         ParamType* param = new ParamType();
         BaseType::mParams[index].reset(param);
         BaseType::mParamKeyToId.insert_or_assign(param->GetKey(), index);
+        impl::down_cast<AudioHandle&>(*BaseType::mAudio).template AddParam<ParamType>(index);
         BaseType::mMain->SetRawValue(index, param->GetRawDefault());
         return *this;
     }
@@ -141,14 +163,15 @@ class EnumParametersFeature : public BaseParametersFeature {
 template <ParamEnum TParamId>
 template <class TParam>
 typename TParam::_valuetype EnumAudioHandle<TParamId>::Get(clap_id id) const {
-    typename TParam::_valuetype out{};
-    clap_id index = id;
-    if (index < mValues.size()) {
-        double raw = GetRawValue(id);
-        double mod = GetRawModulation(id);
-        impl::down_cast<const TParam*>(mParamsRef[index].get())->ToValue(raw + mod, out);
+    using TValue = typename TParam::_valuetype;
+    if (id >= mPlainValues.size()) {
+        return TValue{};
+    }
+    if constexpr (std::is_enum_v<TValue>) {
+        return static_cast<TValue>(static_cast<std::underlying_type_t<TValue>>(mPlainValues[id]));
+    } else {
+        return static_cast<TValue>(mPlainValues[id]);
     }
-    return out;
 }
 
 template <ParamEnum TParamId>
@@ -159,6 +182,8 @@ EnumAudioHandle<TParamId>::EnumAudioHandle(std::vector<std::unique_ptr<BaseParam
     : mParamsRef(ref),
       mValues(numParams, 0.0f),
       mModulations(numParams, 0.0f),
+      mPlainValues(numParams, 0.0),
+      mToPlain(numParams, nullptr),
       mMainToAudio(mainToAudio),
       mAudioToMain(audioToMain) {}
 
@@ -190,8 +215,7 @@ void EnumAudioHandle<TParamId>::FlushEventsFromMain(BaseProcessor& processor, co
     // Send events queued from us to the host
     // Since these all happened on an independent thread, they do not have sample-accurate timing; we'll just
     // send them at the front of the queue.
-    Change change;
-    while (mMainToAudio.pop(change)) {
+    mMainToAudio.Drain([&](const Change& change) {
         switch (change.type) {
             case ChangeType::StartGesture:
             case ChangeType::StopGesture: {
@@ -210,6 +234,7 @@ void EnumAudioHandle<TParamId>::FlushEventsFromMain(BaseProcessor& processor, co
             case ChangeType::SetValue: {
                 clap_id index = change.id;
                 mValues[index] = change.value;
+                RefreshPlainValue(index);
 
                 clap_event_param_value_t event = {};
                 event.header.size = sizeof(event);
@@ -234,7 +259,7 @@ void EnumAudioHandle<TParamId>::FlushEventsFromMain(BaseProcessor& processor, co
                 break;
             }
         }
-    }
+    });
 }
 template <ParamEnum TParamId>
 double EnumAudioHandle<TParamId>::GetRawValue(clap_id id) const {
@@ -249,11 +274,41 @@ void EnumAudioHandle<TParamId>::SetRawValue(clap_id id, double newValue) {
     clap_id index = id;
     if (index < mValues.size()) {
         mValues[index] = newValue;
-        mAudioToMain.push({ChangeType::SetValue, id, {}, newValue});
+        RefreshPlainValue(index);
+        mAudioToMain.Push({ChangeType::SetValue, id, {}, newValue});
         // onAudioChanged
     }
 }
 
+template <ParamEnum TParamId>
+template <class TParam>
+void EnumAudioHandle<TParamId>::AddParam(clap_id id) {
+    if (id < mToPlain.size()) {
+        mToPlain[id] = &ToPlain<TParam>;
+        RefreshPlainValue(id);
+    }
+}
+
+template <ParamEnum TParamId>
+template <class TParam>
+double EnumAudioHandle<TParamId>::ToPlain(const BaseParam& param, double rawValue) {
+    using TValue = typename TParam::_valuetype;
+    TValue out{};
+    impl::down_cast<const TParam&>(param).ToValue(rawValue, out);
+    if constexpr (std::is_enum_v<TValue>) {
+        return static_cast<double>(static_cast<std::underlying_type_t<TValue>>(out));
+    } else {
+        return static_cast<double>(out);
+    }
+}
+
+template <ParamEnum TParamId>
+void EnumAudioHandle<TParamId>::RefreshPlainValue(clap_id id) {
+    if (id < mPlainValues.size() && mToPlain[id] && mParamsRef[id]) {
+        mPlainValues[id] = mToPlain[id](*mParamsRef[id], mValues[id] + mModulations[id]);
+    }
+}
+
 template <ParamEnum TParamId>
 double EnumAudioHandle<TParamId>::GetRawModulation(clap_id id) const {
     clap_id index = id;
@@ -267,7 +322,8 @@ void EnumAudioHandle<TParamId>::SetRawModulation(clap_id id, double newModulatio
     clap_id index = id;
     if (index < mModulations.size()) {
         mModulations[index] = newModulation;
-        mAudioToMain.push({ChangeType::SetModulation, id, {}, newModulation});
+        RefreshPlainValue(index);
+        mAudioToMain.Push({ChangeType::SetModulation, id, {}, newModulation});
         // onAudioChanged
     }
 }
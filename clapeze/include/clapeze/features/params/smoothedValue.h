@@ -0,0 +1,90 @@
+#pragma once
+
+#include <etl/span.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace clapeze::params {
+/**
+ * Optional: turns a param value into a per-sample buffer that ramps linearly towards it, for params that would zipper
+ * if they jumped once per block (gains, cutoffs...). Keep one per param in your processor, and feed it the value from
+ * Get() in ProcessAudio():
+ *
+ *     etl::span<const float> gain = mGainSmoother.Process(params.Get<Params::Gain>(), blockStop - blockStart);
+ *
+ * Once the ramp reaches its target the buffer stays constant, and isn't written to again until the target changes, so
+ * a param that isn't moving costs a compare per block.
+ */
+class SmoothedValue {
+   public:
+    /**
+     * Allocates the buffer, and jumps straight to value.
+     *
+     * [main-thread & !active]
+     */
+    void Reset(double sampleRate, size_t maxBlockSize, float rampMs, float value) {
+        mBuffer.assign(maxBlockSize, value);
+        mRampSamples = std::max<size_t>(1, static_cast<size_t>(sampleRate * static_cast<double>(rampMs) / 1000.0));
+        mCurrent = value;
+        mTarget = value;
+        mStep = 0.0f;
+        mRemaining = 0;
+        mConstantSamples = maxBlockSize;
+    }
+
+    /**
+     * Fills the next numSamples of the ramp towards target. The returned span is only valid until the next call.
+     *
+     * [audio-thread & active & processing]
+     */
+    etl::span<const float> Process(float target, size_t numSamples) {
+        numSamples = std::min(numSamples, mBuffer.size());
+        if (target != mTarget) {
+            mTarget = target;
+            mRemaining = mRampSamples;
+            mStep = (mTarget - mCurrent) / static_cast<float>(mRampSamples);
+        }
+
+        if (mRemaining == 0) {
+            // the buffer is already full of mCurrent from last time, unless the ramp ended partway through it
+            if (mConstantSamples < numSamples) {
+                std::fill(mBuffer.begin(), mBuffer.begin() + static_cast<std::ptrdiff_t>(numSamples), mCurrent);
+                mConstantSamples = numSamples;
+            }
+            return {mBuffer.data(), numSamples};
+        }
+
+        size_t rampSamples = std::min(numSamples, mRemaining);
+        for (size_t idx = 0; idx < rampSamples; ++idx) {
+            mCurrent += mStep;
+            mBuffer[idx] = mCurrent;
+        }
+        mRemaining -= rampSamples;
+        if (mRemaining == 0) {
+            // land exactly on the target, instead of wherever the rounding errors got us
+            mCurrent = mTarget;
+            mBuffer[rampSamples - 1] = mCurrent;
+        }
+        std::fill(mBuffer.begin() + static_cast<std::ptrdiff_t>(rampSamples),
+                  mBuffer.begin() + static_cast<std::ptrdiff_t>(numSamples), mCurrent);
+        mConstantSamples = 0;
+        return {mBuffer.data(), numSamples};
+    }
+
+    /** the value at the end of the last processed block */
+    float GetValue() const { return mCurrent; }
+    /** if false, every sample of the last processed block was the same */
+    bool IsSmoothing() const { return mRemaining > 0 || mConstantSamples == 0; }
+
+   private:
+    std::vector<float> mBuffer;
+    size_t mRampSamples = 1;
+    float mCurrent = 0.0f;
+    float mTarget = 0.0f;
+    float mStep = 0.0f;
+    size_t mRemaining = 0;
+    // how many samples at the start of mBuffer are known to equal mCurrent
+    size_t mConstantSamples = 0;
+};
+}  // namespace clapeze::params
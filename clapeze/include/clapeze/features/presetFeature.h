@@ -5,12 +5,14 @@
 
 #include <clap/ext/preset-load.h>
 #include <clap/factory/preset-discovery.h>
+#include <memory>
 #include <optional>
 #include "clapeze/basePlugin.h"
 #include "clapeze/features/assetsFeature.h"
 #include "clapeze/features/baseFeature.h"
 
 namespace clapeze {
+class PresetIndex;
 
 struct PresetInfo {
     std::string name{};
@@ -61,8 +63,12 @@ class PresetProvider {
 
    private:
     explicit PresetProvider(const clap_preset_discovery_indexer_t* indexer);
+    ~PresetProvider();
     const clap_preset_discovery_indexer_t* mIndexer;
     AssetsFeature mAssets{};
+    // cached metadata for user presets, so hosts rescanning on startup don't need to parse every file again
+    std::unique_ptr<PresetIndex> mUserPresets;
+    std::string mUserPresetDirectory;
 
     bool Init();
     bool GetMetadata(uint32_t location_kind,
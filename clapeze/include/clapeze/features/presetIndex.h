@@ -0,0 +1,76 @@
+// a persistent cache of preset metadata, so preset files don't need to be parsed every time they're listed.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include "clapeze/features/presetFeature.h"
+
+namespace clapeze {
+/**
+ * Indexes every preset file in a directory (and its subdirectories), and caches the metadata found in each one to an
+ * index file in the same directory. Files are identified by their modified time and size, so rescanning only parses
+ * files that were added or changed since the index was last saved.
+ *
+ * Usage:
+ *   PresetIndex index(directory);
+ *   index.Load();
+ *   index.Scan();
+ *   index.Save();
+ *   for (const auto& [path, entry] : index.GetEntries()) { ... }
+ */
+class PresetIndex {
+   public:
+    static constexpr auto kIndexFilename = ".presetindex.toml";
+    static constexpr int64_t kFormatVersion = 1;
+
+    struct Entry {
+        int64_t modifiedTime{};
+        int64_t size{};
+        // false if the file couldn't be read as a preset. it's still cached, so it isn't parsed again until it changes
+        bool isPreset{};
+        std::string pluginId{};
+        PresetInfo info{};
+    };
+    // keyed by path, relative to the index directory
+    using Entries = std::map<std::string, Entry, std::less<>>;
+
+    explicit PresetIndex(std::filesystem::path directory, std::string extension = ".preset");
+
+    /**
+     * Loads the index file, if there is one. Returns false if it's missing or unreadable, in which case the next Scan()
+     * parses everything.
+     */
+    bool Load();
+    /** Writes the index file, if anything changed since it was loaded. */
+    bool Save();
+
+    /**
+     * Walks the directory, parsing files that are new or have changed, and dropping files that no longer exist. Returns
+     * the number of files parsed. If the walk fails partway through, nothing is dropped.
+     */
+    size_t Scan();
+
+    /**
+     * Looks up a single file, parsing it if it's new or has changed. Returns nullptr if it can't be read, or isn't in
+     * this directory. Check isPreset before using the metadata.
+     */
+    const Entry* Get(const std::filesystem::path& file);
+
+    const Entries& GetEntries() const { return mEntries; }
+    const std::filesystem::path& GetDirectory() const { return mDirectory; }
+    std::filesystem::path GetFullPath(std::string_view relativePath) const { return mDirectory / relativePath; }
+
+   private:
+    // returns true if the file was parsed
+    bool Refresh(const std::filesystem::path& file, std::string_view relativePath);
+
+    std::filesystem::path mDirectory;
+    std::string mExtension;
+    Entries mEntries{};
+    bool mDirty{};
+};
+}  // namespace clapeze
@@ -0,0 +1,159 @@
+/*
+ * Measures how much CPU time a plugin spends processing, for finding out which plugin (and which part of it) is
+ * blowing the budget in a heavy session.
+ */
+
+#pragma once
+
+#include <etl/queue_spsc_atomic.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "clapeze/features/baseFeature.h"
+
+namespace clapeze {
+/**
+ * Times every process() call, and summarizes the timings into a histogram over a rolling window (half a second, by
+ * default). Processors can also time their own stages (voices, effects, etc.) with Scope.
+ *
+ * All timings are a load: the fraction of the block's duration spent processing it. At 1.0, processing took exactly as
+ * long as the audio lasts, and the plugin is about to drop out; anything over the budget passed to the constructor is
+ * counted as an xrun risk. Hosts run plenty of other plugins in the same time, so the default budget is well below 1.0.
+ *
+ * Summaries are sent to the main thread over a lock-free queue. Call Poll() there (from a GUI update, for example) to
+ * receive them, then read GetStats() for the latest window, or WriteCsv() for everything so far.
+ */
+class ProfilingFeature : public BaseFeature {
+   public:
+    static constexpr auto NAME = "clapeze.profiling";
+    static constexpr size_t kMaxStages = 8;
+    static constexpr size_t kMaxHistory = 1200;
+    using StageId = uint8_t;
+    using Clock = std::chrono::steady_clock;
+
+    struct Timing {
+        float min{};
+        float avg{};
+        float p99{};
+        float max{};
+    };
+
+    struct Stats {
+        // seconds of audio processed since activation, as of the end of this window
+        double time{};
+        uint32_t numBlocks{};
+        // blocks whose total load was over the budget
+        uint32_t numOverBudget{};
+        Timing total{};
+        std::array<Timing, kMaxStages> stages{};
+    };
+
+    /**
+     * Times everything until it goes out of scope, and adds it to a stage. Pass nullptr as the feature to disable.
+     *
+     * [audio-thread]
+     */
+    class Scope {
+       public:
+        Scope(ProfilingFeature* feature, StageId stage)
+            : mFeature(feature), mStage(stage), mStart(feature ? Clock::now() : Clock::time_point{}) {}
+        ~Scope() {
+            if (mFeature) {
+                mFeature->mStageSeconds[mStage] += std::chrono::duration<double>(Clock::now() - mStart).count();
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+       private:
+        ProfilingFeature* mFeature;
+        StageId mStage;
+        Clock::time_point mStart;
+    };
+
+    explicit ProfilingFeature(float budget = 0.7f, double windowSeconds = 0.5);
+    const char* Name() const override { return NAME; }
+    void Configure(BasePlugin& self) override;
+
+    /**
+     * Adds a stage to time with Scope. Returns its id.
+     *
+     * [main-thread & !active]
+     */
+    StageId AddStage(std::string_view name);
+    const std::vector<std::string>& GetStageNames() const { return mStageNames; }
+
+    float GetBudget() const { return mBudget; }
+
+    /**
+     * Receives new stats from the audio thread. returns true if there were any.
+     *
+     * [main-thread]
+     */
+    bool Poll();
+    /** the most recent window. [main-thread] */
+    const Stats& GetStats() const { return mLatest; }
+    /** every window received so far, oldest first, up to kMaxHistory. [main-thread] */
+    const std::deque<Stats>& GetHistory() const { return mHistory; }
+    /** blocks over the budget since activation. [thread-safe] */
+    uint64_t GetTotalOverBudget() const { return mTotalOverBudget.load(std::memory_order_relaxed); }
+
+    /**
+     * Writes the history as CSV, one row per window per stage (including the total).
+     *
+     * [main-thread]
+     */
+    void WriteCsv(std::ostream& out) const;
+
+    /** [main-thread & !active] */
+    void OnActivated();
+    /** called by the plugin after every process() call. [audio-thread] */
+    void OnProcessed(double secondsSpent, double blockSeconds);
+
+   private:
+    /** log-scaled, so there's the same relative precision at 1% load as at 100% */
+    class Histogram {
+       public:
+        void Reset();
+        void Add(float load);
+        Timing Summarize() const;
+        uint32_t GetCount() const { return mCount; }
+
+       private:
+        static constexpr size_t kBinsPerOctave = 8;
+        static constexpr int32_t kMinOctave = -12;
+        static constexpr size_t kNumBins = kBinsPerOctave * 14;
+
+        std::array<uint32_t, kNumBins> mBins{};
+        uint32_t mCount{};
+        double mSum{};
+        float mMin{};
+        float mMax{};
+    };
+
+    float mBudget;
+    double mWindowSeconds;
+    std::string mPluginId;
+    std::vector<std::string> mStageNames;
+
+    // audio thread
+    Histogram mTotal{};
+    std::array<Histogram, kMaxStages> mStages{};
+    std::array<double, kMaxStages> mStageSeconds{};
+    double mTime{};
+    double mWindowElapsed{};
+    uint32_t mNumOverBudget{};
+    std::atomic<uint64_t> mTotalOverBudget{};
+    etl::queue_spsc_atomic<Stats, 8, etl::memory_model::MEMORY_MODEL_SMALL> mQueue;
+
+    // main thread
+    Stats mLatest{};
+    std::deque<Stats> mHistory;
+};
+}  // namespace clapeze
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <clap/clap.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace clapeze {
+
+/**
+ * A compact binary encoding for plugin state, for when the host saves and loads sessions. Loading TOML means buffering
+ * the whole stream into a string, parsing it, and then looking up every parameter by key; with hundreds of plugin
+ * instances in a project, that adds up. This reads straight from the stream instead, and when the parameter layout
+ * hasn't changed since it was saved, assigns values by id without any key lookups at all.
+ *
+ * Layout (all numbers little-endian):
+ *   char[4]  magic, "CLZB"
+ *   u32      format version
+ *   u64      hash of the plugin id
+ *   u32      save version (see TomlStateFeature)
+ *   u64      schema hash (every parameter key, in id order)
+ *   u32      number of parameters
+ *   f64[]    raw parameter values, in id order
+ *   u32      size of the key table in bytes, followed by a u16 length + bytes for every key, in id order
+ *   u32      size of the extra data in bytes, followed by the extra data
+ *
+ * The key table is only read if the schema hash doesn't match, so parameters can still be matched up by key after
+ * they've been added, removed, or reordered.
+ */
+class BinaryStateCodec {
+   public:
+    static constexpr std::array<char, 4> kMagic = {'C', 'L', 'Z', 'B'};
+    static constexpr uint32_t kFormatVersion = 1;
+
+    struct Header {
+        uint32_t formatVersion = kFormatVersion;
+        uint64_t pluginIdHash{};
+        uint32_t saveVersion{};
+        uint64_t schemaHash{};
+        uint32_t numParams{};
+    };
+
+    /** FNV-1a. stable across platforms and runs, unlike std::hash */
+    static uint64_t Hash(std::string_view text, uint64_t hash = 0xcbf29ce484222325ull) {
+        for (char c : text) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    template <class TParamsFeature>
+    static uint64_t SchemaHash(const TParamsFeature& params) {
+        uint64_t numParams = params.GetNumParams();
+        uint64_t hash = Hash(std::string_view(reinterpret_cast<const char*>(&numParams), sizeof(numParams)));
+        for (clap_id id = 0; id < numParams; ++id) {
+            hash = Hash(params.GetBaseParam(id)->GetKey(), hash);
+            // separator, so {"ab", "c"} and {"a", "bc"} hash differently
+            hash = Hash(std::string_view("\0", 1), hash);
+        }
+        return hash;
+    }
+
+    /**
+     * Reads the magic number, and returns true if this is binary state. If it isn't, whatever was read is left in
+     * prefixOut, so the rest can be parsed as something else (the stream can't be rewound).
+     */
+    static bool ReadMagic(std::istream& in, std::string& prefixOut) {
+        std::array<char, kMagic.size()> magic{};
+        in.read(magic.data(), magic.size());
+        if (in && magic == kMagic) {
+            return true;
+        }
+        prefixOut.assign(magic.data(), static_cast<size_t>(in.gcount()));
+        return false;
+    }
+
+    static bool WriteHeader(std::ostream& out, const Header& header) {
+        out.write(kMagic.data(), kMagic.size());
+        Write(out, header.formatVersion);
+        Write(out, header.pluginIdHash);
+        Write(out, header.saveVersion);
+        Write(out, header.schemaHash);
+        Write(out, header.numParams);
+        return out.good();
+    }
+
+    /** reads everything after the magic number, so call ReadMagic() first */
+    static bool ReadHeader(std::istream& in, Header& header) {
+        return Read(in, header.formatVersion) && header.formatVersion == kFormatVersion &&
+               Read(in, header.pluginIdHash) && Read(in, header.saveVersion) && Read(in, header.schemaHash) &&
+               Read(in, header.numParams);
+    }
+
+    /** writes every raw parameter value, then the key table */
+    template <class TParamsFeature>
+    static bool WriteParams(std::ostream& out, TParamsFeature& params) {
+        auto& handle = params.GetMainHandle();
+        size_t numParams = params.GetNumParams();
+        for (clap_id id = 0; id < numParams; ++id) {
+            Write(out, handle.GetRawValue(id));
+        }
+
+        uint32_t keyTableSize = 0;
+        for (clap_id id = 0; id < numParams; ++id) {
+            keyTableSize += sizeof(uint16_t) + static_cast<uint32_t>(params.GetBaseParam(id)->GetKey().size());
+        }
+        Write(out, keyTableSize);
+        for (clap_id id = 0; id < numParams; ++id) {
+            const std::string& key = params.GetBaseParam(id)->GetKey();
+            Write(out, static_cast<uint16_t>(key.size()));
+            out.write(key.data(), static_cast<std::streamsize>(key.size()));
+        }
+        return out.good();
+    }
+
+    /**
+     * Reads numParams raw values, and calls fn(id, value) for each of them. Values are read in small batches, so
+     * there's no buffer the size of the whole state.
+     */
+    template <typename TFn>
+    static bool ReadValues(std::istream& in, uint32_t numParams, TFn&& fn) {
+        static constexpr uint32_t kBatchSize = 64;
+        std::array<double, kBatchSize> batch{};
+        for (uint32_t start = 0; start < numParams; start += kBatchSize) {
+            uint32_t count = std::min(kBatchSize, numParams - start);
+            in.read(reinterpret_cast<char*>(batch.data()), static_cast<std::streamsize>(count * sizeof(double)));
+            if (!in) {
+                return false;
+            }
+            for (uint32_t idx = 0; idx < count; ++idx) {
+                fn(static_cast<clap_id>(start + idx), batch[idx]);
+            }
+        }
+        return true;
+    }
+
+    static bool SkipKeys(std::istream& in) {
+        uint32_t keyTableSize{};
+        if (!Read(in, keyTableSize)) {
+            return false;
+        }
+        in.ignore(keyTableSize);
+        return in.good();
+    }
+
+    static bool ReadKeys(std::istream& in, uint32_t numParams, std::vector<std::string>& keysOut) {
+        uint32_t keyTableSize{};
+        if (!Read(in, keyTableSize)) {
+            return false;
+        }
+        keysOut.resize(numParams);
+        for (auto& key : keysOut) {
+            uint16_t size{};
+            if (!Read(in, size)) {
+                return false;
+            }
+            key.resize(size);
+            in.read(key.data(), size);
+        }
+        return in.good();
+    }
+
+    static bool WriteExtra(std::ostream& out, std::string_view extra) {
+        Write(out, static_cast<uint32_t>(extra.size()));
+        out.write(extra.data(), static_cast<std::streamsize>(extra.size()));
+        return out.good();
+    }
+
+    static bool ReadExtra(std::istream& in, std::string& extraOut) {
+        uint32_t size{};
+        if (!Read(in, size)) {
+            return false;
+        }
+        extraOut.resize(size);
+        in.read(extraOut.data(), size);
+        return static_cast<bool>(in);
+    }
+
+   private:
+    static_assert(std::endian::native == std::endian::little, "BinaryStateCodec assumes a little-endian platform");
+
+    template <typename T>
+    static void Write(std::ostream& out, T value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static bool Read(std::istream& in, T& value) {
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return static_cast<bool>(in);
+    }
+};
+}  // namespace clapeze
@@ -2,16 +2,25 @@
 
 #include <clap/clap.h>
 #include <clap/ext/params.h>
+#include <algorithm>
 #include <cstdio>
+#include <string>
+#include <vector>
 
 #include "clapeze/basePlugin.h"
 #include "clapeze/features/state/baseStateFeature.h"
+#include "clapeze/features/state/binaryStateCodec.h"
 #include "clapeze/impl/streamUtils.h"
 
 namespace clapeze {
 
 /*
- * Saves and loads parameter state. This works(tm), but you should probably prefer TomlStateFeature.
+ * Saves and loads parameter state, using BinaryStateCodec. There's no way to save anything besides parameters, and
+ * nothing human-readable for presets, so you should probably prefer TomlStateFeature (which can use the same format for
+ * host sessions).
+ *
+ * This still loads state from before BinaryStateCodec, but it always saves the new format, so sessions saved with it
+ * won't open in older builds of the plugin.
  */
 template <class TParamsFeature>
 class BinaryStateFeature : public BaseStateFeature {
@@ -40,29 +49,65 @@ class BinaryStateFeature : public BaseStateFeature {
         TParamsFeature& params = BaseFeature::GetFromPlugin<TParamsFeature>(mPlugin);
 
         params.FlushFromAudio();  // empty queue to ensure newest changes
-        auto& handle = params.GetMainHandle();
+        BinaryStateCodec::Header header{};
+        header.pluginIdHash = BinaryStateCodec::Hash(mPlugin.GetDescriptor().id);
+        header.schemaHash = BinaryStateCodec::SchemaHash(params);
+        header.numParams = static_cast<uint32_t>(params.GetNumParams());
+        return BinaryStateCodec::WriteHeader(out, header) && BinaryStateCodec::WriteParams(out, params) &&
+               BinaryStateCodec::WriteExtra(out, {});
+    }
+    bool Load(std::istream& in) override {
+        TParamsFeature& params = BaseFeature::GetFromPlugin<TParamsFeature>(mPlugin);
 
+        params.FlushFromAudio();  // empty queue so changes apply on top
+        auto& handle = params.GetMainHandle();
         size_t numParams = params.GetNumParams();
-        for (clap_id id = 0; id < numParams; ++id) {
-            double value = handle.GetRawValue(id);
-            out.write(reinterpret_cast<char*>(&value), sizeof(double));
-            if (out.fail()) {
-                return false;
+        std::string prefix;
+        if (!BinaryStateCodec::ReadMagic(in, prefix)) {
+            return LoadLegacy(prefix, in);
+        }
+
+        BinaryStateCodec::Header header{};
+        if (!BinaryStateCodec::ReadHeader(in, header) ||
+            header.pluginIdHash != BinaryStateCodec::Hash(mPlugin.GetDescriptor().id)) {
+            return false;
+        }
+        if (header.schemaHash == BinaryStateCodec::SchemaHash(params)) {
+            return BinaryStateCodec::ReadValues(in, header.numParams,
+                                                [&](clap_id id, double value) { handle.SetRawValue(id, value); });
+        }
+
+        // parameters have changed since this was saved, match them up by key instead
+        std::vector<double> values;
+        std::vector<std::string> keys;
+        values.reserve(header.numParams);
+        if (!BinaryStateCodec::ReadValues(in, header.numParams,
+                                          [&](clap_id, double value) { values.push_back(value); }) ||
+            !BinaryStateCodec::ReadKeys(in, header.numParams, keys)) {
+            return false;
+        }
+        for (size_t idx = 0; idx < keys.size(); ++idx) {
+            if (auto id = params.GetIdFromKey(keys[idx]); id && *id < numParams) {
+                handle.SetRawValue(*id, values[idx]);
             }
         }
         return true;
-        return true;
     }
-    bool Load(std::istream& in) override {
-        TParamsFeature& params = BaseFeature::GetFromPlugin<TParamsFeature>(mPlugin);
 
-        params.FlushFromAudio();  // empty queue so changes apply on top
+   private:
+    // before BinaryStateCodec, state was every raw value in id order, and nothing else
+    bool LoadLegacy(const std::string& prefix, std::istream& in) {
+        TParamsFeature& params = BaseFeature::GetFromPlugin<TParamsFeature>(mPlugin);
         auto& handle = params.GetMainHandle();
         size_t numParams = params.GetNumParams();
         clap_id id = 0;
         while (id < numParams) {
             double value = 0.0f;
-            in.read(reinterpret_cast<char*>(&value), sizeof(double));
+            char* bytes = reinterpret_cast<char*>(&value);
+            // the first value starts with the bytes ReadMagic() already took
+            size_t fromPrefix = id == 0 ? prefix.size() : 0;
+            std::copy(prefix.begin(), prefix.begin() + static_cast<std::ptrdiff_t>(fromPrefix), bytes);
+            in.read(bytes + fromPrefix, static_cast<std::streamsize>(sizeof(double) - fromPrefix));
             if (in.bad()) {
                 // error
                 return false;
@@ -74,10 +119,8 @@ class BinaryStateFeature : public BaseStateFeature {
             id++;
         }
         return id == numParams;
-        return true;
     }
 
-   private:
     BasePlugin& mPlugin;
     static bool _save(const clap_plugin_t* plugin, const clap_ostream_t* out) {
         BinaryStateFeature<TParamsFeature>& self =
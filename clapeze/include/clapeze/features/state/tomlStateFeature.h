@@ -4,7 +4,11 @@
 #include <clap/ext/params.h>
 #include <cstdio>
 #include <cwchar>
+#include <optional>
+#include <sstream>
+#include <string>
 #include <toml++/toml.hpp>
+#include <vector>
 
 #include "clap/plugin.h"
 #include "clap/stream.h"
@@ -13,6 +17,7 @@
 #include "clapeze/features/params/baseParameter.h"
 #include "clapeze/features/presetFeature.h"
 #include "clapeze/features/state/baseStateFeature.h"
+#include "clapeze/features/state/binaryStateCodec.h"
 #include "clapeze/impl/streamUtils.h"
 #include "clapeze/pluginHost.h"
 
@@ -22,14 +27,33 @@ struct Metadata {
     PresetInfo preset;
 
     static void LoadPresetInfo(toml::table* presetkv, PresetInfo& preset);
+    static toml::table SavePresetInfo(const PresetInfo& preset);
     /* Used for filesystem scanning */
     static std::optional<Metadata> loadMetadata(std::istream& in);
 };
 
+enum class StateFormat {
+    // human-readable, see TomlStateFeature
+    Toml,
+    // compact and quick to load, see BinaryStateCodec
+    Binary,
+};
+
+/**
+ * Saves and loads parameter state (plus whatever OnSave()/OnLoad() add) as TOML.
+ *
+ * Presets and Save()/Load() always use TOML, so they stay readable and diffable. Host sessions are saved in
+ * `sessionFormat`. Projects with lots of plugins load a lot faster with StateFormat::Binary, but builds from before
+ * BinaryStateCodec existed can't read it, so it's opt-in: sessions saved that way won't open in an older version of
+ * the plugin. Load() accepts either.
+ */
 template <class TParamsFeature>
 class TomlStateFeature : public BaseStateFeature {
    public:
-    explicit TomlStateFeature(BasePlugin& self, uint32_t saveVersion = 0) : mPlugin(self), mSaveVersion(saveVersion) {}
+    explicit TomlStateFeature(BasePlugin& self,
+                              uint32_t saveVersion = 0,
+                              StateFormat sessionFormat = StateFormat::Toml)
+        : mPlugin(self), mSaveVersion(saveVersion), mSessionFormat(sessionFormat) {}
     static constexpr auto NAME = CLAP_EXT_STATE;
     const char* Name() const override { return NAME; }
     void Configure(BasePlugin& self) override {
@@ -42,30 +66,19 @@ class TomlStateFeature : public BaseStateFeature {
 
     bool Validate(const BasePlugin& plugin) const override { (void)plugin; return true; }
 
-    // customization points
+    // customization points. note that when binary state takes the fast path, the table OnLoad() gets has no _meta or
+    // params in it, only what OnSave() added
     virtual bool OnMigrate(toml::table& t, uint32_t currentVersion, uint32_t targetVersion) const { (void)t; (void)currentVersion; (void)targetVersion; return true; }
     virtual bool OnSave(toml::table& t) const { (void)t; return true; }
     virtual bool OnLoad(const toml::table& t) { (void)t; return true; }
 
     bool Save(std::ostream& out) override {
         TParamsFeature& params = BaseFeature::GetFromPlugin<TParamsFeature>(mPlugin);
-        PresetFeature* presets = static_cast<PresetFeature*>(mPlugin.TryGetFeature(PresetFeature::NAME));
         const clap_plugin_descriptor_t& desc = mPlugin.GetDescriptor();
 
         toml::table file{};
         file.insert("_meta", toml::table{{"version", mSaveVersion}, {"plugin", desc.id}});
 
-        if (presets) {
-            const PresetInfo& info = presets->GetPresetInfo();
-            toml::table presetkv{
-                {"name", info.name},
-                {"creator", info.creator},
-                {"description", info.description},
-                //{"features", info.features}
-            };
-            file.insert("preset", presetkv);
-        }
-
         toml::table paramkv{};
         params.FlushFromAudio();  // empty queue to ensure newest changes
         auto& handle = params.GetMainHandle();
@@ -76,7 +89,7 @@ class TomlStateFeature : public BaseStateFeature {
         }
         file.insert("params", paramkv);
 
-        if (!OnSave(file)) {
+        if (!SaveExtra(file)) {
             return false;
         }
 
@@ -84,14 +97,41 @@ class TomlStateFeature : public BaseStateFeature {
         return out.good();
     }
 
-    bool Load(std::istream& in) override {
+    /** Saves in the binary format. Anything besides parameters (preset info, OnSave()) is still stored as TOML. */
+    bool SaveBinary(std::ostream& out) {
         TParamsFeature& params = BaseFeature::GetFromPlugin<TParamsFeature>(mPlugin);
-        PresetFeature* presets = static_cast<PresetFeature*>(mPlugin.TryGetFeature(PresetFeature::NAME));
-        PluginHost& host = mPlugin.GetHost();
         const clap_plugin_descriptor_t& desc = mPlugin.GetDescriptor();
 
+        toml::table extra{};
+        if (!SaveExtra(extra)) {
+            return false;
+        }
+        std::string extraText;
+        if (!extra.empty()) {
+            std::stringstream ss;
+            ss << extra;
+            extraText = ss.str();
+        }
+
+        params.FlushFromAudio();  // empty queue to ensure newest changes
+        BinaryStateCodec::Header header{};
+        header.pluginIdHash = BinaryStateCodec::Hash(desc.id);
+        header.saveVersion = mSaveVersion;
+        header.schemaHash = GetSchemaHash(params);
+        header.numParams = static_cast<uint32_t>(params.GetNumParams());
+        return BinaryStateCodec::WriteHeader(out, header) && BinaryStateCodec::WriteParams(out, params) &&
+               BinaryStateCodec::WriteExtra(out, extraText);
+    }
+
+    bool Load(std::istream& in) override {
+        std::string fileText;
+        if (BinaryStateCodec::ReadMagic(in, fileText)) {
+            return LoadBinary(in);
+        }
+
+        PluginHost& host = mPlugin.GetHost();
         host.Log(clapeze::LogSeverity::Debug, "loading file");
-        std::string fileText = impl::istream_tostring(in);
+        fileText += impl::istream_tostring(in);
         auto result = toml::parse(fileText);
         if (!result) {
             // parse error
@@ -100,7 +140,92 @@ class TomlStateFeature : public BaseStateFeature {
             return true;
         }
 
-        auto& file = result.table();
+        return LoadTable(result.table());
+    }
+
+   private:
+    // everything but _meta and params
+    bool SaveExtra(toml::table& file) const {
+        PresetFeature* presets = static_cast<PresetFeature*>(mPlugin.TryGetFeature(PresetFeature::NAME));
+        if (presets) {
+            file.insert("preset", Metadata::SavePresetInfo(presets->GetPresetInfo()));
+        }
+        return OnSave(file);
+    }
+
+    bool LoadBinary(std::istream& in) {
+        TParamsFeature& params = BaseFeature::GetFromPlugin<TParamsFeature>(mPlugin);
+        PluginHost& host = mPlugin.GetHost();
+        const clap_plugin_descriptor_t& desc = mPlugin.GetDescriptor();
+
+        BinaryStateCodec::Header header{};
+        if (!BinaryStateCodec::ReadHeader(in, header)) {
+            host.Log(clapeze::LogSeverity::Warning, "loading, could not read binary header");
+            return true;
+        }
+        if (header.pluginIdHash != BinaryStateCodec::Hash(desc.id)) {
+            host.LogFmt(clapeze::LogSeverity::Warning, "loading, wrong plugin id (expected '{}')", desc.id);
+            return true;
+        }
+
+        if (header.schemaHash == GetSchemaHash(params) && header.saveVersion == mSaveVersion) {
+            // fast path: same parameters in the same order as when it was saved, so no keys to look up
+            params.FlushFromAudio();  // empty queue so changes apply on top
+            auto& handle = params.GetMainHandle();
+            std::string extraText;
+            if (!BinaryStateCodec::ReadValues(in, header.numParams,
+                                              [&](clap_id id, double value) { handle.SetRawValue(id, value); }) ||
+                !BinaryStateCodec::SkipKeys(in) || !BinaryStateCodec::ReadExtra(in, extraText)) {
+                host.Log(clapeze::LogSeverity::Warning, "loading, binary state is truncated");
+                return true;
+            }
+            toml::table extra{};
+            if (!extraText.empty()) {
+                auto result = toml::parse(extraText);
+                if (!result) {
+                    host.LogFmt(clapeze::LogSeverity::Warning, "loading, could not parse toml: {}",
+                                result.error().description());
+                    return true;
+                }
+                extra = std::move(result.table());
+            }
+            LoadExtra(extra);
+            return OnLoad(extra);
+        }
+
+        // slow path: rebuild the equivalent TOML, so parameters are matched up by key and OnMigrate() gets a say
+        std::vector<double> values;
+        values.reserve(header.numParams);
+        std::vector<std::string> keys;
+        std::string extraText;
+        if (!BinaryStateCodec::ReadValues(in, header.numParams, [&](clap_id, double value) { values.push_back(value); }) ||
+            !BinaryStateCodec::ReadKeys(in, header.numParams, keys) || !BinaryStateCodec::ReadExtra(in, extraText)) {
+            host.Log(clapeze::LogSeverity::Warning, "loading, binary state is truncated");
+            return true;
+        }
+        toml::table file{};
+        if (!extraText.empty()) {
+            auto result = toml::parse(extraText);
+            if (!result) {
+                host.LogFmt(clapeze::LogSeverity::Warning, "loading, could not parse toml: {}",
+                            result.error().description());
+                return true;
+            }
+            file = std::move(result.table());
+        }
+        file.insert_or_assign("_meta", toml::table{{"version", header.saveVersion}, {"plugin", desc.id}});
+        toml::table paramkv{};
+        for (size_t idx = 0; idx < keys.size(); ++idx) {
+            paramkv.insert(keys[idx], values[idx]);
+        }
+        file.insert_or_assign("params", paramkv);
+        return LoadTable(file);
+    }
+
+    bool LoadTable(toml::table& file) {
+        TParamsFeature& params = BaseFeature::GetFromPlugin<TParamsFeature>(mPlugin);
+        PluginHost& host = mPlugin.GetHost();
+        const clap_plugin_descriptor_t& desc = mPlugin.GetDescriptor();
 
         // Meta
         {
@@ -124,14 +249,7 @@ class TomlStateFeature : public BaseStateFeature {
             }
         }
 
-        // Preset Info (optional)
-        {
-            auto presetkv = file["preset"].as_table();
-            if (presetkv && presets) {
-                PresetInfo& preset = presets->GetPresetInfo();
-                Metadata::LoadPresetInfo(presetkv, preset);
-            }
-        }
+        LoadExtra(file);
 
         // Params
         {
@@ -159,13 +277,35 @@ class TomlStateFeature : public BaseStateFeature {
         return true;
     }
 
-   private:
+    void LoadExtra(toml::table& file) {
+        // Preset Info (optional)
+        PresetFeature* presets = static_cast<PresetFeature*>(mPlugin.TryGetFeature(PresetFeature::NAME));
+        auto presetkv = file["preset"].as_table();
+        if (presetkv && presets) {
+            PresetInfo& preset = presets->GetPresetInfo();
+            Metadata::LoadPresetInfo(presetkv, preset);
+        }
+    }
+
+    // parameters can't change after Config(), so this only needs working out once
+    uint64_t GetSchemaHash(const TParamsFeature& params) {
+        if (!mSchemaHash) {
+            mSchemaHash = BinaryStateCodec::SchemaHash(params);
+        }
+        return *mSchemaHash;
+    }
+
     BasePlugin& mPlugin;
     uint32_t mSaveVersion;
+    StateFormat mSessionFormat;
+    std::optional<uint64_t> mSchemaHash{};
     static bool _save(const clap_plugin_t* plugin, const clap_ostream_t* out) {
         TomlStateFeature<TParamsFeature>& self =
             BaseFeature::GetFromPluginObject<TomlStateFeature<TParamsFeature>>(plugin);
         impl::clap_ostream stream(out);
+        if (self.mSessionFormat == StateFormat::Binary) {
+            return self.SaveBinary(stream);
+        }
         return self.Save(stream);
     }
 
@@ -190,6 +330,18 @@ inline void Metadata::LoadPresetInfo(toml::table* presetkv, PresetInfo& preset)
         featuresNode->visit([&preset](toml::value<std::string>& s) { preset.features.push_back(*s); });
     }
 }
+inline toml::table Metadata::SavePresetInfo(const PresetInfo& preset) {
+    toml::array features;
+    for (const auto& feature : preset.features) {
+        features.push_back(feature);
+    }
+    return toml::table{
+        {"name", preset.name},
+        {"creator", preset.creator},
+        {"description", preset.description},
+        {"features", std::move(features)},
+    };
+}
 /* Used for filesystem scanning */
 inline std::optional<Metadata> Metadata::loadMetadata(std::istream& in) {
     Metadata data;
@@ -211,7 +363,7 @@ inline std::optional<Metadata> Metadata::loadMetadata(std::istream& in) {
     }
     data.pluginId = **pluginId;
 
-    auto presetkv = file["presetInfo"].as_table();
+    auto presetkv = file["preset"].as_table();
     if (presetkv) {
         LoadPresetInfo(presetkv, data.preset);
     }
@@ -0,0 +1,80 @@
+/*
+ * Lets the plugin borrow the host's worker threads while processing.
+ */
+
+#pragma once
+
+#include <clap/ext/thread-pool.h>
+#include <cstdint>
+#include <type_traits>
+#include "clapeze/basePlugin.h"
+#include "clapeze/features/baseFeature.h"
+
+namespace clapeze {
+/**
+ * Runs a batch of independent tasks on the host's thread pool, and waits for all of them to finish. If the host doesn't
+ * support thread pools (or is busy), the tasks are run one after another on the audio thread instead, so processors
+ * don't need a separate serial path.
+ *
+ * Tasks can run in any order, on any thread, so each one should only write to state nobody else touches: render into a
+ * scratch buffer per task, then mix those down in task order once Run() returns. That way the output doesn't depend on
+ * which thread finished first.
+ *
+ * Usage:
+ *   mThreads.Run(cNumLayers, [&](uint32_t idx) { mLayers[idx].Render(numSamples); });
+ *   for (auto& layer : mLayers) { layer.MixInto(out); }
+ */
+class ThreadPoolFeature : public BaseFeature {
+   public:
+    static constexpr auto NAME = CLAP_EXT_THREAD_POOL;
+    const char* Name() const override { return NAME; }
+
+    void Configure(BasePlugin& self) override {
+        self.GetHost().TryGetExtension(NAME, mRawHost, mRawHostThreadPool);
+        static const clap_plugin_thread_pool_t value = {
+            &_exec,
+        };
+        self.RegisterExtension(NAME, static_cast<const void*>(&value));
+    }
+
+    /** true if tasks can actually run in parallel */
+    bool IsHostSupported() const { return mRawHostThreadPool != nullptr; }
+
+    /**
+     * Calls fn(taskIndex) for every index in [0, numTasks), and returns once they're all done. fn is called from
+     * multiple threads at once!
+     *
+     * [audio-thread & process]
+     */
+    template <typename TFn>
+    void Run(uint32_t numTasks, TFn&& fn) {
+        using FnType = std::remove_reference_t<TFn>;
+        mTaskContext = const_cast<void*>(static_cast<const void*>(&fn));
+        mTaskFn = [](void* context, uint32_t taskIndex) { (*static_cast<FnType*>(context))(taskIndex); };
+
+        // a single task isn't worth waking up another thread for
+        bool ranOnHost = numTasks > 1 && mRawHostThreadPool && mRawHostThreadPool->request_exec(mRawHost, numTasks);
+        if (!ranOnHost) {
+            for (uint32_t taskIndex = 0; taskIndex < numTasks; ++taskIndex) {
+                fn(taskIndex);
+            }
+        }
+
+        mTaskFn = nullptr;
+        mTaskContext = nullptr;
+    }
+
+   private:
+    static void _exec(const clap_plugin_t* plugin, uint32_t taskIndex) {
+        ThreadPoolFeature& self = ThreadPoolFeature::GetFromPluginObject<ThreadPoolFeature>(plugin);
+        if (self.mTaskFn) {
+            self.mTaskFn(self.mTaskContext, taskIndex);
+        }
+    }
+
+    void (*mTaskFn)(void* context, uint32_t taskIndex) = nullptr;
+    void* mTaskContext = nullptr;
+    const clap_host_t* mRawHost = nullptr;
+    const clap_host_thread_pool_t* mRawHostThreadPool = nullptr;
+};
+}  // namespace clapeze
@@ -1,24 +1,35 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <bit>
-#include <cmath>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
-#include <vector>
 
 namespace clapeze {
 /**
- * dynamically sized bitset, optimized for holding lots of dirty flags.
+ * fixed size bitset, optimized for holding lots of dirty flags. nothing allocates, so it's fine to use on the audio
+ * thread.
+ *
+ * ForEachSet() visits set bits a word at a time, skipping over empty words, so flushing changes costs O(dirty + N/64)
+ * rather than O(N).
+ *
+ * The *Atomic() variants can be called from any thread at the same time, for flagging changes on one thread and
+ * collecting them on another. Don't mix them with the plain variants while another thread might be touching the same
+ * set.
  */
+template <size_t N>
 class DirtySet {
    public:
-    explicit DirtySet(size_t numBits) : mNumBits(numBits), mWords(GetNumWords(), 0) {}
+    static constexpr size_t kCapacity = N;
+    static constexpr size_t kNumWords = (N + 63) / 64;
 
-    void Reset() { std::fill(mWords.begin(), mWords.end(), 0); }
+    static constexpr size_t Capacity() { return kCapacity; }
+
+    void Reset() { mWords.fill(0); }
     void Set(size_t idx, bool value = true) {
-        size_t wordIdx{};
-        uint64_t mask{};
-        Split(idx, wordIdx, mask);
+        auto [wordIdx, mask] = Split(idx);
         if (value) {
             mWords[wordIdx] |= mask;
         } else {
@@ -26,23 +37,28 @@ class DirtySet {
         }
     }
     void Unset(size_t idx) { Set(idx, false); }
-    bool Test(size_t idx) {
-        size_t wordIdx{};
-        uint64_t mask{};
-        Split(idx, wordIdx, mask);
+    bool Test(size_t idx) const {
+        auto [wordIdx, mask] = Split(idx);
         return (mWords[wordIdx] & mask) != 0;
     }
+    /** returns whether idx was set, and clears it */
+    bool TestAndClear(size_t idx) {
+        auto [wordIdx, mask] = Split(idx);
+        bool wasSet = (mWords[wordIdx] & mask) != 0;
+        mWords[wordIdx] &= ~mask;
+        return wasSet;
+    }
 
-    size_t Count() {
+    size_t Count() const {
         size_t sum = 0;
-        for (const auto& word : mWords) {
-            sum += std::popcount(word);
+        for (uint64_t word : mWords) {
+            sum += static_cast<size_t>(std::popcount(word));
         }
         return sum;
     }
-    bool Any() {
-        for (const auto& word : mWords) {
-            if (word > 0) {
+    bool Any() const {
+        for (uint64_t word : mWords) {
+            if (word != 0) {
                 return true;
             }
         }
@@ -50,25 +66,96 @@ class DirtySet {
     }
     template <size_t... Idxs>
     bool AnyOf() const {
-        std::vector<uint64_t> masks(GetNumWords(), 0);
-        ((masks[Idxs / 64] |= (1 << (Idxs % 64))), ...);
-
-        for (size_t i = 0; i < masks.size(); ++i) {
-            if ((mWords[i] & masks[i]) != 0) {
+        static_assert(((Idxs < N) && ...), "index out of range");
+        static constexpr std::array<uint64_t, kNumWords> kMasks = [] {
+            std::array<uint64_t, kNumWords> masks{};
+            ((masks[Idxs / 64] |= uint64_t{1} << (Idxs % 64)), ...);
+            return masks;
+        }();
+        for (size_t wordIdx = 0; wordIdx < kNumWords; ++wordIdx) {
+            if ((mWords[wordIdx] & kMasks[wordIdx]) != 0) {
                 return true;
             }
         }
-
         return false;
     }
 
+    /**
+     * Calls fn(idx) for every set bit, in order, clearing them as it goes. Bits that fn() sets again are kept for the
+     * next time around.
+     */
+    template <typename TFn>
+    void ForEachSet(TFn&& fn) {
+        for (size_t wordIdx = 0; wordIdx < kNumWords; ++wordIdx) {
+            uint64_t word = mWords[wordIdx];
+            if (word == 0) {
+                continue;
+            }
+            mWords[wordIdx] = 0;
+            VisitWord(wordIdx, word, fn);
+        }
+    }
+
+    /** [thread-safe] */
+    void SetAtomic(size_t idx) {
+        auto [wordIdx, mask] = Split(idx);
+        AtomicWord(wordIdx).fetch_or(mask, std::memory_order_release);
+    }
+    /** sets idx, and returns whether it was already set. [thread-safe] */
+    bool TestAndSetAtomic(size_t idx) {
+        auto [wordIdx, mask] = Split(idx);
+        return (AtomicWord(wordIdx).fetch_or(mask, std::memory_order_acq_rel) & mask) != 0;
+    }
+    /** [thread-safe] */
+    bool TestAtomic(size_t idx) const {
+        auto [wordIdx, mask] = Split(idx);
+        return (AtomicWord(wordIdx).load(std::memory_order_acquire) & mask) != 0;
+    }
+    /** returns whether idx was set, and clears it. [thread-safe] */
+    bool TestAndClearAtomic(size_t idx) {
+        auto [wordIdx, mask] = Split(idx);
+        return (AtomicWord(wordIdx).fetch_and(~mask, std::memory_order_acq_rel) & mask) != 0;
+    }
+    /**
+     * Like ForEachSet(), but takes each word atomically, so other threads can keep calling SetAtomic() in the meantime.
+     * Anything set after its word was taken is left for the next call.
+     *
+     * [thread-safe]
+     */
+    template <typename TFn>
+    void ForEachSetAtomic(TFn&& fn) {
+        for (size_t wordIdx = 0; wordIdx < kNumWords; ++wordIdx) {
+            auto atomicWord = AtomicWord(wordIdx);
+            // skip the read-modify-write for empty words, that's most of them
+            if (atomicWord.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            uint64_t word = atomicWord.exchange(0, std::memory_order_acquire);
+            VisitWord(wordIdx, word, fn);
+        }
+    }
+
    private:
-    static void Split(size_t idx, size_t& wordIdx, uint64_t& mask) {
-        wordIdx = idx / 64;
-        mask = 1 << (idx % 64);
+    struct Location {
+        size_t wordIdx;
+        uint64_t mask;
+    };
+    static Location Split(size_t idx) {
+        assert(idx < N);
+        return {idx / 64, uint64_t{1} << (idx % 64)};
+    }
+    template <typename TFn>
+    static void VisitWord(size_t wordIdx, uint64_t word, TFn& fn) {
+        while (word != 0) {
+            size_t bit = static_cast<size_t>(std::countr_zero(word));
+            word &= word - 1;
+            fn(wordIdx * 64 + bit);
+        }
     }
-    size_t GetNumWords() const { return static_cast<size_t>(std::ceil(static_cast<double>(mNumBits) / 64.0)); }
-    size_t mNumBits;
-    std::vector<uint64_t> mWords;
+    std::atomic_ref<uint64_t> AtomicWord(size_t wordIdx) const {
+        return std::atomic_ref<uint64_t>(const_cast<uint64_t&>(mWords[wordIdx]));
+    }
+
+    alignas(std::atomic_ref<uint64_t>::required_alignment) std::array<uint64_t, kNumWords> mWords{};
 };
-}  // namespace clapeze
\ No newline at end of file
+}  // namespace clapeze
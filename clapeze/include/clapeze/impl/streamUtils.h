@@ -1,8 +1,11 @@
 #pragma once
 
 #include <clap/clap.h>
+#include <algorithm>
+#include <cstring>
 #include <istream>
 #include <ostream>
+#include <span>
 #include <streambuf>
 #include "clap/stream.h"
 
@@ -14,9 +17,22 @@ class clap_istream_streambuf : public std::streambuf {
 
    protected:
     std::streamsize xsgetn(char* s, std::streamsize n) override {
-        // read up to n chars from s
-        int64_t bytesRead = mIn->read(mIn, s, static_cast<int64_t>(n));
-        return (bytesRead <= 0) ? 0 : bytesRead;
+        // anything underflow() already buffered (from a peek(), say) comes first
+        std::streamsize buffered = std::min<std::streamsize>(n, egptr() - gptr());
+        if (buffered > 0) {
+            std::memcpy(s, gptr(), static_cast<size_t>(buffered));
+            gbump(static_cast<int>(buffered));
+        }
+        // read up to n chars from s. hosts may hand over less than asked for, so keep going until they run out
+        std::streamsize total = std::max<std::streamsize>(buffered, 0);
+        while (total < n) {
+            int64_t bytesRead = mIn->read(mIn, s + total, static_cast<int64_t>(n - total));
+            if (bytesRead <= 0) {
+                break;
+            }
+            total += bytesRead;
+        }
+        return total;
     }
 
     int_type underflow() override {
@@ -49,6 +65,37 @@ class clap_istream : public std::basic_istream<char> {
     explicit clap_istream(const clap_istream_t* outstream) : basic_istream(nullptr), mBuf(outstream) { this->init(&mBuf); }
 };
 
+/**
+ * wraps a block of memory into a std::streambuf, without copying it. supports seeking.
+ */
+class memory_istreambuf : public std::streambuf {
+   public:
+    memory_istreambuf() = default;
+    explicit memory_istreambuf(std::span<const char> data) {
+        // the get area is never written to, streambuf just doesn't have a const version
+        char* begin = const_cast<char*>(data.data());
+        setg(begin, begin, begin + data.size());
+    }
+
+   protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::in)) {
+            return pos_type(off_type(-1));
+        }
+        off_type base = dir == std::ios_base::beg ? 0 : dir == std::ios_base::cur ? gptr() - eback() : egptr() - eback();
+        off_type target = base + off;
+        if (target < 0 || target > egptr() - eback()) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + target, egptr());
+        return pos_type(target);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
 inline std::string istream_tostring(std::istream& stream) {
     return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
 }
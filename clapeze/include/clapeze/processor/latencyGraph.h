@@ -0,0 +1,158 @@
+#pragma once
+
+#include <etl/span.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "clapeze/common.h"
+#include "clapeze/features/latencyFeature.h"
+
+namespace clapeze {
+
+/**
+ * Keeps track of how much latency each stage of your DSP adds (oversamplers, lookahead, FFTs...), and works out the
+ * plugin's total latency from that, so you don't have to tally it up by hand.
+ *
+ * Stages are connected like your signal flow: each one is fed by the plugin input, or by another stage. The total
+ * latency is the longest path through them, and is reported to the LatencyFeature whenever it changes. Any path that's
+ * shorter than that needs to be delayed to line up with it, eg. the dry signal of a dry/wet mix, and
+ * GetCompensation() says by how much:
+ *
+ *     mDry = mLatency.AddStage(0);
+ *     mOversampler = mLatency.AddStage(mUpsampler.GetLatency());
+ *     mLimiter = mLatency.AddStage(kLookaheadSamples, mOversampler);
+ *     ...
+ *     mDryDelay.Reset(2, mLatency.GetCompensation(mDry));
+ *
+ * Add stages when constructing your processor, and set their latencies in Activate(). If a stage's latency changes
+ * while active, the host is asked to restart the plugin, so keep using the old delays until Activate() is called again.
+ */
+class LatencyGraph {
+   public:
+    using Stage = uint32_t;
+    /** stands in for the plugin's input, which has no latency */
+    static constexpr Stage kInput = UINT32_MAX;
+
+    /** latency is reported to feature if provided, otherwise you're on your own */
+    explicit LatencyGraph(LatencyFeature* feature = nullptr) : mFeature(feature) {}
+
+    /**
+     * Adds a stage fed by the output of from.
+     *
+     * [main-thread & !active]
+     */
+    Stage AddStage(uint32_t latencySamples = 0, Stage from = kInput) {
+        assert(from == kInput || from < mStages.size());
+        auto stage = static_cast<Stage>(mStages.size());
+        mStages.push_back({from, latencySamples, 0});
+        Update();
+        return stage;
+    }
+
+    /**
+     * Changes the latency of a single stage. Doesn't allocate.
+     *
+     * [main-thread | audio-thread]
+     */
+    void SetStageLatency(Stage stage, uint32_t latencySamples) {
+        assert(stage < mStages.size());
+        if (mStages[stage].latency != latencySamples) {
+            mStages[stage].latency = latencySamples;
+            Update();
+        }
+    }
+
+    uint32_t GetStageLatency(Stage stage) const { return stage == kInput ? 0 : mStages[stage].latency; }
+    /** how far behind the input the output of stage is */
+    uint32_t GetPathLatency(Stage stage) const { return stage == kInput ? 0 : mStages[stage].pathLatency; }
+    /** the latency of the longest path, which is what the host compensates for */
+    uint32_t GetTotalLatency() const { return mTotalLatency; }
+    /** how much the output of stage needs to be delayed to line up with the plugin's output */
+    uint32_t GetCompensation(Stage stage) const { return mTotalLatency - GetPathLatency(stage); }
+
+   private:
+    struct StageInfo {
+        Stage from;
+        uint32_t latency;
+        uint32_t pathLatency;
+    };
+
+    void Update() {
+        // stages can only be fed by stages added before them, so one pass in order is enough
+        uint32_t total = 0;
+        for (StageInfo& info : mStages) {
+            info.pathLatency = GetPathLatency(info.from) + info.latency;
+            total = std::max(total, info.pathLatency);
+        }
+        if (total != mTotalLatency) {
+            mTotalLatency = total;
+            if (mFeature) {
+                mFeature->ChangeLatency(total);
+            }
+        }
+    }
+
+    LatencyFeature* mFeature;
+    std::vector<StageInfo> mStages;
+    uint32_t mTotalLatency = 0;
+};
+
+/**
+ * A plain delay line, for lining up a path with the rest of the plugin (see LatencyGraph::GetCompensation()).
+ */
+class CompensationDelay {
+   public:
+    /**
+     * Allocates, and clears the delay.
+     *
+     * [main-thread & !active]
+     */
+    void Reset(size_t numChannels, uint32_t delaySamples) {
+        mDelaySamples = delaySamples;
+        mChannels.assign(numChannels, Channel{std::vector<float>(delaySamples, 0.0f), 0});
+    }
+
+    /**
+     * Delays samples in place.
+     *
+     * [audio-thread & active & processing]
+     */
+    void Process(size_t channel, etl::span<float> samples) {
+        if (mDelaySamples == 0) {
+            return;
+        }
+        assert(channel < mChannels.size());
+        Channel& state = mChannels[channel];
+        for (float& sample : samples) {
+            float delayed = state.buffer[state.pos];
+            state.buffer[state.pos] = sample;
+            sample = delayed;
+            if (++state.pos == mDelaySamples) {
+                state.pos = 0;
+            }
+        }
+    }
+    void Process(MonoAudioBuffer& buffer) {
+        Process(0, buffer.data);
+        buffer.isConstant = buffer.isConstant && mDelaySamples == 0;
+    }
+    void Process(StereoAudioBuffer& buffer) {
+        Process(0, buffer.left);
+        Process(1, buffer.right);
+        buffer.isLeftConstant = buffer.isLeftConstant && mDelaySamples == 0;
+        buffer.isRightConstant = buffer.isRightConstant && mDelaySamples == 0;
+    }
+
+    uint32_t GetDelay() const { return mDelaySamples; }
+
+   private:
+    struct Channel {
+        std::vector<float> buffer;
+        uint32_t pos;
+    };
+    uint32_t mDelaySamples = 0;
+    std::vector<Channel> mChannels;
+};
+}  // namespace clapeze
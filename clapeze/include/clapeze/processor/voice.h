@@ -96,23 +96,45 @@ class VoicePool {
     }
 
     ProcessStatus ProcessAudio(StereoAudioBuffer& out) {
-        //std::fill(out.left.begin(), out.left.end(), 0.0f);
-        //std::fill(out.right.begin(), out.right.end(), 0.0f);
-        for (VoiceIndex idx = 0; idx < mVoices.size(); idx++) {
+        ProcessAudioRange(0, mVoices.size(), out);
+        EndFinishedVoices();
+        return ProcessStatus::Continue;
+    }
+
+    /**
+     * Adds the voices in [begin, end) to out. Voices that stop playing aren't released until EndFinishedVoices() is
+     * called, so this can be called from ThreadPoolFeature tasks, as long as each task gets its own range of voices and
+     * its own buffer.
+     */
+    void ProcessAudioRange(size_t begin, size_t end, StereoAudioBuffer& out) {
+        for (VoiceIndex idx = begin; idx < end && idx < mVoices.size(); idx++) {
             auto& data = mVoices[idx];
-            if (data.activeNote) {
+            if (data.activeNote && !data.isFinished) {
                 // TODO: this api forces voices to _add_ to the buffer, not replace it. this isn't super obvious from
                 // the signature, so maybe we should wrap the StereoAudioBufferType? StereoSummingAudioBuffer or so
-                bool playing = data.voice.ProcessAudio(out);
-                if (!playing) {
+                data.isFinished = !data.voice.ProcessAudio(out);
+            }
+        }
+    }
+
+    /**
+     * Sends note end events for every voice that stopped playing in ProcessAudioRange(). [audio-thread]
+     */
+    void EndFinishedVoices() {
+        for (VoiceIndex idx = 0; idx < mVoices.size(); idx++) {
+            auto& data = mVoices[idx];
+            if (data.isFinished) {
+                if (data.activeNote) {
                     SendNoteEnd(*data.activeNote);
                     data.activeNote = std::nullopt;
                 }
+                data.isFinished = false;
             }
         }
-        return ProcessStatus::Continue;
     }
 
+    size_t GetNumVoices() const { return mVoices.size(); }
+
     void StopAllVoices() {
         for (VoiceIndex idx = 0; idx < mVoices.size(); idx++) {
             StopVoice(idx);
@@ -167,8 +189,9 @@ class VoicePool {
         explicit VoiceData(TProcessor& p, size_t idx) : voice(p, idx) {}
         TVoice voice;
         std::optional<NoteTuple> activeNote{};
-        bool isPressed;
-        int32_t age;
+        bool isFinished{};
+        bool isPressed{};
+        int32_t age{};
     };
 
     TProcessor& mProcessor;
@@ -221,6 +244,7 @@ class VoicePool {
                 pool.SendNoteEnd(*(nextVoiceData.activeNote));
             }
             nextVoiceData.activeNote = note;
+            nextVoiceData.isFinished = false;
             nextVoiceData.voice.ProcessNoteOn(note, velocity);
             nextVoiceData.isPressed = true;
             nextVoiceData.age = mNextAge++;
@@ -256,6 +280,7 @@ class VoicePool {
             }
             mActiveNotes.push_back({note, velocity});
             pool.mVoices[0].activeNote = note;
+            pool.mVoices[0].isFinished = false;
             Voice(pool).ProcessNoteOn(note, velocity);
             pool.SendNoteStart(note);
         }
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "clapeze/pluginHost.h"
+
+#ifndef CLAPEZE_RT_LOG_LEVEL
+// RtLogger messages below this severity are compiled out entirely. see clapeze::LogSeverity for values.
+#define CLAPEZE_RT_LOG_LEVEL 0
+#endif
+
+namespace clapeze {
+/**
+ * A logger that's safe to call from the audio thread. PluginHost::Log() formats strings and calls into the host, either
+ * of which can allocate or lock, so it's for the main thread only.
+ *
+ * Instead, RtLogger captures the format string and its arguments by value into a fixed size lock-free queue, and does
+ * the actual formatting later, on the main thread, when the queue is drained. Draining happens on a host timer (see
+ * Start()), and from Drain() if you call it yourself. Messages go to PluginHost::Log(), so they end up in the host log
+ * and anything hooked up with PluginHost::SetLogFn().
+ *
+ * Any number of threads can log at once. If the queue is full, messages are dropped and counted, and the count is
+ * logged the next time the queue is drained.
+ *
+ * Arguments must be numbers, bools, chars, pointers, or string literals. Strings are captured by pointer, so
+ * they have to outlive the message!
+ *
+ * Usage:
+ *   mLog.Debug("note on {} (id {})", note.key, note.id);
+ */
+class RtLogger {
+   public:
+    static constexpr size_t kCapacity = 256;
+    static constexpr size_t kMaxArgs = 6;
+    static constexpr LogSeverity kMinSeverity = static_cast<LogSeverity>(CLAPEZE_RT_LOG_LEVEL);
+    static_assert((kCapacity & (kCapacity - 1)) == 0, "capacity must be a power of two");
+
+    RtLogger() {
+        for (size_t idx = 0; idx < kCapacity; ++idx) {
+            mSlots[idx].sequence.store(idx, std::memory_order_relaxed);
+        }
+    }
+    ~RtLogger() { Stop(); }
+    RtLogger(const RtLogger&) = delete;
+    RtLogger& operator=(const RtLogger&) = delete;
+
+    /**
+     * Starts draining messages into the host log, every periodMs. Hosts without timer support don't get this, so also
+     * call Drain() from something that runs regularly on the main thread, like your GUI's OnUpdate().
+     *
+     * [main-thread]
+     */
+    void Start(PluginHost& host, uint32_t periodMs = 50) {
+        Stop();
+        mHost = &host;
+        mTimerId = host.AddTimer(periodMs, [this]() { Drain(*mHost); });
+    }
+
+    /**
+     * Stops the timer, and drains whatever is left.
+     *
+     * [main-thread]
+     */
+    void Stop() {
+        if (!mHost) {
+            return;
+        }
+        if (mTimerId) {
+            mHost->CancelTimer(*mTimerId);
+            mTimerId.reset();
+        }
+        Drain(*mHost);
+        mHost = nullptr;
+    }
+
+    /** [thread-safe & realtime-safe] */
+    template <typename... Args>
+    void Debug(fmt::format_string<Args...> format, Args&&... args) {
+        Log<LogSeverity::Debug>(format, std::forward<Args>(args)...);
+    }
+    /** [thread-safe & realtime-safe] */
+    template <typename... Args>
+    void Info(fmt::format_string<Args...> format, Args&&... args) {
+        Log<LogSeverity::Info>(format, std::forward<Args>(args)...);
+    }
+    /** [thread-safe & realtime-safe] */
+    template <typename... Args>
+    void Warning(fmt::format_string<Args...> format, Args&&... args) {
+        Log<LogSeverity::Warning>(format, std::forward<Args>(args)...);
+    }
+    /** [thread-safe & realtime-safe] */
+    template <typename... Args>
+    void Error(fmt::format_string<Args...> format, Args&&... args) {
+        Log<LogSeverity::Error>(format, std::forward<Args>(args)...);
+    }
+
+    /** [thread-safe & realtime-safe] */
+    template <LogSeverity severity, typename... Args>
+    void Log(fmt::format_string<Args...> format, Args&&... args) {
+        static_assert(sizeof...(Args) <= kMaxArgs, "too many arguments, increase kMaxArgs");
+        if constexpr (severity >= kMinSeverity) {
+            fmt::string_view formatView = format;
+            Record record{severity, static_cast<uint8_t>(sizeof...(Args)), formatView.data(), formatView.size(),
+                          {MakeArg(args)...}};
+            if (!TryPush(record)) {
+                mNumDropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Formats every queued message, and hands each of them to fn(LogSeverity, const std::string&). Returns the number
+     * of messages drained.
+     *
+     * [main-thread]
+     */
+    template <typename TFn>
+    size_t Drain(TFn&& fn) {
+        size_t count = 0;
+        Record record;
+        while (TryPop(record)) {
+            fmt::dynamic_format_arg_store<fmt::format_context> store;
+            for (size_t idx = 0; idx < record.numArgs; ++idx) {
+                PushArg(store, record.args[idx]);
+            }
+            fn(record.severity, fmt::vformat(fmt::string_view(record.format, record.formatSize), store));
+            ++count;
+        }
+
+        uint32_t numDropped = mNumDropped.load(std::memory_order_relaxed);
+        if (numDropped != mNumReportedDropped) {
+            fn(LogSeverity::Warning,
+               fmt::format("RtLogger: dropped {} messages, the queue was full", numDropped - mNumReportedDropped));
+            mNumReportedDropped = numDropped;
+        }
+        return count;
+    }
+
+    /** [main-thread] */
+    size_t Drain(PluginHost& host) {
+        return Drain([&host](LogSeverity severity, const std::string& message) { host.Log(severity, message); });
+    }
+
+    /**
+     * Drains into the host passed to Start(). Does nothing if the logger hasn't been started.
+     *
+     * [main-thread]
+     */
+    size_t Drain() { return mHost ? Drain(*mHost) : 0; }
+
+    /** how many messages have been dropped because the queue was full, ever */
+    uint32_t GetNumDropped() const { return mNumDropped.load(std::memory_order_relaxed); }
+
+   private:
+    struct Arg {
+        enum class Type : uint8_t { Int, Uint, Double, Bool, Char, String, Pointer };
+        Type type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            bool b;
+            char c;
+            const char* s;
+            const void* p;
+        };
+    };
+
+    struct Record {
+        LogSeverity severity;
+        uint8_t numArgs;
+        const char* format;
+        size_t formatSize;
+        std::array<Arg, kMaxArgs> args;
+    };
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    template <typename T>
+    static Arg MakeArg(const T& value) {
+        using Type = std::decay_t<T>;
+        Arg arg{};
+        if constexpr (std::is_same_v<Type, bool>) {
+            arg.type = Arg::Type::Bool;
+            arg.b = value;
+        } else if constexpr (std::is_same_v<Type, char>) {
+            arg.type = Arg::Type::Char;
+            arg.c = value;
+        } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+            arg.type = Arg::Type::Int;
+            arg.i = value;
+        } else if constexpr (std::is_integral_v<Type>) {
+            arg.type = Arg::Type::Uint;
+            arg.u = value;
+        } else if constexpr (std::is_floating_point_v<Type>) {
+            arg.type = Arg::Type::Double;
+            arg.d = static_cast<double>(value);
+        } else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) {
+            arg.type = Arg::Type::String;
+            arg.s = value;
+        } else if constexpr (std::is_pointer_v<Type>) {
+            arg.type = Arg::Type::Pointer;
+            arg.p = value;
+        } else {
+            static_assert(!sizeof(T), "RtLogger can only capture numbers, pointers and string literals");
+        }
+        return arg;
+    }
+
+    static void PushArg(fmt::dynamic_format_arg_store<fmt::format_context>& store, const Arg& arg) {
+        switch (arg.type) {
+            case Arg::Type::Int: {
+                store.push_back(arg.i);
+                break;
+            }
+            case Arg::Type::Uint: {
+                store.push_back(arg.u);
+                break;
+            }
+            case Arg::Type::Double: {
+                store.push_back(arg.d);
+                break;
+            }
+            case Arg::Type::Bool: {
+                store.push_back(arg.b);
+                break;
+            }
+            case Arg::Type::Char: {
+                store.push_back(arg.c);
+                break;
+            }
+            case Arg::Type::String: {
+                store.push_back(arg.s ? arg.s : "(null)");
+                break;
+            }
+            case Arg::Type::Pointer: {
+                store.push_back(arg.p);
+                break;
+            }
+        }
+    }
+
+    // a bounded multi-producer queue: each slot's sequence number says whether it's ready to be written (== the
+    // write position) or read (== the read position + 1), so producers only ever contend on mWritePos.
+    bool TryPush(const Record& record) {
+        size_t pos = mWritePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = mSlots[pos & (kCapacity - 1)];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (mWritePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = record;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // full
+                return false;
+            } else {
+                pos = mWritePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // only ever called from the main thread, so there's no contention on this end
+    bool TryPop(Record& out) {
+        Slot& slot = mSlots[mReadPos & (kCapacity - 1)];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != mReadPos + 1) {
+            return false;
+        }
+        out = slot.record;
+        slot.sequence.store(mReadPos + kCapacity, std::memory_order_release);
+        ++mReadPos;
+        return true;
+    }
+
+    std::array<Slot, kCapacity> mSlots;
+    std::atomic<size_t> mWritePos{0};
+    size_t mReadPos{0};
+    std::atomic<uint32_t> mNumDropped{0};
+    uint32_t mNumReportedDropped{0};
+
+    PluginHost* mHost{};
+    std::optional<PluginHost::TimerId> mTimerId;
+};
+}  // namespace clapeze
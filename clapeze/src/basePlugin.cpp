@@ -7,6 +7,7 @@
 #include "clap/process.h"
 #include "clapeze/features/latencyFeature.h"
 #include "clapeze/features/params/baseParametersFeature.h"
+#include "clapeze/features/profilingFeature.h"
 #include "clapeze/pluginHost.h"
 #include "clapeze/processor/baseProcessor.h"
 
@@ -18,21 +19,21 @@ BasePlugin::BasePlugin(const clap_plugin_descriptor_t& descriptor)
       mDescriptor(descriptor) {}
 
 BaseFeature* BasePlugin::TryGetFeature(const char* name) {
-    if (auto search = mFeatures.find(name); search != mFeatures.end()) {
+    if (auto search = mFeatures.find(std::string_view(name)); search != mFeatures.end()) {
         return search->second.get();
     } else {
         return nullptr;
     }
 }
 const BaseFeature* BasePlugin::TryGetFeature(const char* name) const {
-    if (auto search = mFeatures.find(name); search != mFeatures.end()) {
+    if (auto search = mFeatures.find(std::string_view(name)); search != mFeatures.end()) {
         return search->second.get();
     } else {
         return nullptr;
     }
 }
 bool BasePlugin::RegisterExtension(const char* name, const void* ptr) {
-    if (mExtensions.contains(name)) {
+    if (mExtensions.contains(std::string_view(name))) {
         // no system for stacking extensions
         return false;
     }
@@ -40,7 +41,7 @@ bool BasePlugin::RegisterExtension(const char* name, const void* ptr) {
     return true;
 }
 const void* BasePlugin::TryGetExtension(const char* name) {
-    if (auto search = mExtensions.find(name); search != mExtensions.end()) {
+    if (auto search = mExtensions.find(std::string_view(name)); search != mExtensions.end()) {
         return search->second;
     } else {
         return PluginHost::TryGetPluginExtension(name);
@@ -96,10 +97,21 @@ bool BasePlugin::Activate(double sampleRate, uint32_t minBlockSize, uint32_t max
         latency->OnActivated();
     }
 
+    // looked up once here, so process() doesn't have to
+    mProfiling = static_cast<ProfilingFeature*>(TryGetFeature(ProfilingFeature::NAME));
+    if (mProfiling) {
+        mProfiling->OnActivated();
+    }
+
     return true;
 }
 void BasePlugin::Deactivate() {
     mProcessor->Deactivate();
+
+    LatencyFeature* latency = static_cast<LatencyFeature*>(TryGetFeature(CLAP_EXT_LATENCY));
+    if (latency) {
+        latency->OnDeactivated();
+    }
 }
 void BasePlugin::Reset() {
     mProcessor->ProcessReset();
@@ -192,6 +204,9 @@ clap_process_status BasePlugin::_process(const clap_plugin* plugin, const clap_p
     double wallClockTimeSpent = std::chrono::duration<double>(endWallClockTime - startWallClockTime).count();
     double processClockTime = timeCount / p.mSampleRate;
     p.mLastTimeSpentRatio = wallClockTimeSpent / processClockTime;
+    if (self.mProfiling) {
+        self.mProfiling->OnProcessed(wallClockTimeSpent, processClockTime);
+    }
     return static_cast<clap_process_status>(lastStatus);
 }
 
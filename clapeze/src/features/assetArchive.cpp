@@ -0,0 +1,276 @@
+#include "clapeze/features/assetArchive.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace clapeze {
+
+namespace {
+constexpr uint32_t kLocalHeaderSignature = 0x04034b50;
+constexpr size_t kLocalHeaderSize = 30;
+constexpr uint32_t kEndOfCentralDirSignature = 0x06054b50;
+constexpr size_t kEndOfCentralDirSize = 22;
+constexpr size_t kMaxCommentSize = 0xffff;
+
+uint32_t ReadLE32(const char* p) {
+    const auto* b = reinterpret_cast<const uint8_t*>(p);
+    return static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) | (static_cast<uint32_t>(b[2]) << 16) |
+           (static_cast<uint32_t>(b[3]) << 24);
+}
+uint16_t ReadLE16(const char* p) {
+    const auto* b = reinterpret_cast<const uint8_t*>(p);
+    return static_cast<uint16_t>(b[0] | (b[1] << 8));
+}
+}  // namespace
+
+AssetArchive::AssetArchive(size_t cacheLimitBytes) : mCacheLimitBytes(cacheLimitBytes) {
+    mz_zip_zero_struct(&mZip);
+}
+
+AssetArchive::~AssetArchive() {
+    Close();
+}
+
+bool AssetArchive::Open(const char* path) {
+    Close();
+    if (!Map(path)) {
+        mLastError = "could not map file";
+        return false;
+    }
+
+    // the archive is appended to the plugin binary, so the offsets inside it are relative to wherever it starts. find
+    // the end of central directory record, which says how big the archive is. the comment after it can contain the
+    // signature too, so only take one whose comment runs exactly to the end of the file
+    const char* eocd = nullptr;
+    if (mMappedSize >= kEndOfCentralDirSize) {
+        size_t last = mMappedSize - kEndOfCentralDirSize;
+        size_t first = last > kMaxCommentSize ? last - kMaxCommentSize : 0;
+        for (size_t offset = last + 1; offset-- > first;) {
+            if (ReadLE32(mMappedData + offset) == kEndOfCentralDirSignature &&
+                offset + kEndOfCentralDirSize + ReadLE16(mMappedData + offset + 20) == mMappedSize) {
+                eocd = mMappedData + offset;
+                break;
+            }
+        }
+    }
+    if (!eocd) {
+        mLastError = "no zip archive found";
+        Unmap();
+        return false;
+    }
+    uint64_t centralDirSize = ReadLE32(eocd + 12);
+    uint64_t centralDirOffset = ReadLE32(eocd + 16);
+    auto eocdOffset = static_cast<uint64_t>(eocd - mMappedData);
+    if (centralDirOffset + centralDirSize > eocdOffset) {
+        // or zip64, which an asset bundle shouldn't ever need
+        mLastError = "unsupported zip archive";
+        Unmap();
+        return false;
+    }
+    size_t archiveStart = eocdOffset - (centralDirOffset + centralDirSize);
+    mArchiveData = mMappedData + archiveStart;
+    mArchiveSize = mMappedSize - archiveStart;
+
+    if (!mz_zip_reader_init_mem(&mZip, mArchiveData, mArchiveSize, 0)) {
+        mLastError = mz_zip_get_error_string(mz_zip_get_last_error(&mZip));
+        mArchiveData = nullptr;
+        mArchiveSize = 0;
+        Unmap();
+        return false;
+    }
+
+    mz_uint numFiles = mz_zip_reader_get_num_files(&mZip);
+    mPaths.reserve(numFiles);
+    mEntries.reserve(numFiles);
+    for (mz_uint idx = 0; idx < numFiles; ++idx) {
+        mz_zip_archive_file_stat stat;
+        if (!mz_zip_reader_file_stat(&mZip, idx, &stat) || stat.m_is_directory) {
+            continue;
+        }
+        Entry entry{};
+        entry.fileIndex = idx;
+        entry.size = static_cast<size_t>(stat.m_uncomp_size);
+        entry.storedData = FindStoredData(stat);
+        mPaths.emplace_back(stat.m_filename);
+        mEntries.emplace(stat.m_filename, entry);
+    }
+    return true;
+}
+
+void AssetArchive::Close() {
+    {
+        std::lock_guard lock(mCacheMutex);
+        mCacheLookup.clear();
+        mCache.clear();
+        mCacheBytes = 0;
+    }
+    mEntries.clear();
+    mPaths.clear();
+    if (mArchiveData) {
+        mz_zip_reader_end(&mZip);
+        mz_zip_zero_struct(&mZip);
+        mArchiveData = nullptr;
+        mArchiveSize = 0;
+    }
+    Unmap();
+}
+
+std::vector<std::string> AssetArchive::GetAllPaths(std::string_view prefix) const {
+    std::vector<std::string> out;
+    for (const auto& path : mPaths) {
+        if (path.starts_with(prefix)) {
+            out.push_back(path);
+        }
+    }
+    return out;
+}
+
+bool AssetArchive::Contains(std::string_view path) const {
+    return mEntries.find(path) != mEntries.end();
+}
+
+std::optional<AssetData> AssetArchive::Read(std::string_view path) {
+    auto found = mEntries.find(path);
+    if (found == mEntries.end()) {
+        mLastError = "file not found";
+        return std::nullopt;
+    }
+    const Entry& entry = found->second;
+    if (entry.storedData) {
+        // zero copy
+        return AssetData{{entry.storedData, entry.size}, nullptr};
+    }
+
+    std::lock_guard lock(mCacheMutex);
+    if (auto cached = mCacheLookup.find(found->first); cached != mCacheLookup.end()) {
+        mCache.splice(mCache.begin(), mCache, cached->second);
+        const auto& data = cached->second->data;
+        return AssetData{{data->data(), data->size()}, data};
+    }
+
+    auto data = std::make_shared<std::vector<char>>(entry.size);
+    if (!mz_zip_reader_extract_to_mem(&mZip, entry.fileIndex, data->data(), data->size(), 0)) {
+        mLastError = mz_zip_get_error_string(mz_zip_get_last_error(&mZip));
+        return std::nullopt;
+    }
+
+    // anything bigger than the whole cache is handed over without being cached
+    if (entry.size <= mCacheLimitBytes) {
+        while (mCacheBytes + entry.size > mCacheLimitBytes && !mCache.empty()) {
+            mCacheBytes -= mCache.back().data->size();
+            mCacheLookup.erase(mCache.back().path);
+            mCache.pop_back();
+        }
+        mCache.push_front({found->first, data});
+        mCacheLookup.emplace(mCache.front().path, mCache.begin());
+        mCacheBytes += entry.size;
+    }
+    return AssetData{{data->data(), data->size()}, std::move(data)};
+}
+
+const char* AssetArchive::FindStoredData(const mz_zip_archive_file_stat& stat) const {
+    if (stat.m_method != 0 || stat.m_is_encrypted || stat.m_comp_size != stat.m_uncomp_size) {
+        return nullptr;
+    }
+    // the central directory doesn't say where the data starts, the local header in front of it does
+    uint64_t headerOffset = stat.m_local_header_ofs;
+    if (headerOffset + kLocalHeaderSize > mArchiveSize) {
+        return nullptr;
+    }
+    const char* header = mArchiveData + headerOffset;
+    if (ReadLE32(header) != kLocalHeaderSignature) {
+        return nullptr;
+    }
+    uint64_t dataOffset = headerOffset + kLocalHeaderSize + ReadLE16(header + 26) + ReadLE16(header + 28);
+    if (dataOffset + stat.m_uncomp_size > mArchiveSize) {
+        return nullptr;
+    }
+    return mArchiveData + dataOffset;
+}
+
+#ifdef _WIN32
+bool AssetArchive::Map(const char* path) {
+    std::wstring widePath = std::filesystem::path(std::u8string_view(reinterpret_cast<const char8_t*>(path))).wstring();
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    mFileHandle = file;
+    mMappingHandle = mapping;
+    mMappedData = static_cast<const char*>(data);
+    mMappedSize = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void AssetArchive::Unmap() {
+    if (mMappedData) {
+        UnmapViewOfFile(mMappedData);
+        CloseHandle(mMappingHandle);
+        CloseHandle(mFileHandle);
+    }
+    mMappedData = nullptr;
+    mMappedSize = 0;
+    mMappingHandle = nullptr;
+    mFileHandle = nullptr;
+}
+#else
+bool AssetArchive::Map(const char* path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive on its own
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    mMappedData = static_cast<const char*>(data);
+    mMappedSize = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void AssetArchive::Unmap() {
+    if (mMappedData) {
+        munmap(const_cast<char*>(mMappedData), mMappedSize);
+    }
+    mMappedData = nullptr;
+    mMappedSize = 0;
+}
+#endif
+
+}  // namespace clapeze
@@ -1,7 +1,6 @@
 #include "clapeze/features/assetsFeature.h"
 
-#include <miniz.h>
-#include <miniz_zip.h>
+#include <cstdlib>
 #include <fstream>
 #include "clapeze/entryPoint.h"
 
@@ -9,7 +8,8 @@ namespace clapeze {
 
 namespace {
 std::string sArchivePath{};
-mz_zip_archive sZip{};
+// shared by every instance, so assets are only indexed (and cached) once per process
+AssetArchive sArchive{};
 int32_t sInstances{};
 }  // namespace
 
@@ -17,14 +17,13 @@ AssetsFeature::AssetsFeature() {
     sInstances++;
     if (sInstances == 1) {
         sArchivePath = getPluginPath();
-        mz_zip_zero_struct(&sZip);
-        mz_zip_reader_init_file(&sZip, sArchivePath.c_str(), 0);
+        sArchive.Open(sArchivePath.c_str());
     }
 }
 AssetsFeature::~AssetsFeature() {
     sInstances--;
     if (sInstances == 0) {
-        mz_zip_reader_end(&sZip);
+        sArchive.Close();
     }
 }
 
@@ -33,24 +32,17 @@ void AssetsFeature::Configure(BasePlugin& self) {
 }
 
 std::vector<std::string> AssetsFeature::GetAllPathsFromPlugin(std::string_view prefix) const {
-    std::vector<std::string> out;
-    mz_uint numFiles = mz_zip_reader_get_num_files(&sZip);
-    out.reserve(numFiles);
+    return sArchive.GetAllPaths(prefix);
+}
 
-    for (mz_uint idx = 0; idx < numFiles; ++idx) {
-        mz_uint bytesNeeded = mz_zip_reader_get_filename(&sZip, idx, nullptr, 0);
-        std::string buf(bytesNeeded, '\0');
-        [[maybe_unused]] mz_uint bytesWritten = mz_zip_reader_get_filename(&sZip, idx, buf.data(), static_cast<mz_uint>(buf.size()));
-        assert(bytesWritten == bytesNeeded);
-        if(buf.starts_with(prefix)) {
-            out.emplace_back(buf.c_str());
-        }
-    }
-    return out;
+std::optional<AssetData> AssetsFeature::ReadFromPlugin(std::string_view path) {
+    return sArchive.Read(path);
 }
 
-miniz_istream AssetsFeature::OpenFromPlugin(const char* path) {
-    return miniz_istream(&sZip, path);
+asset_istream AssetsFeature::OpenFromPlugin(const char* path) {
+    std::optional<AssetData> data = sArchive.Read(path);
+    const char* error = data ? "" : sArchive.GetLastError();
+    return asset_istream(std::move(data), error);
 }
 
 std::ifstream AssetsFeature::OpenFromFilesystem(const char* path) {
@@ -61,4 +53,35 @@ std::ofstream AssetsFeature::OpenFromFilesystemOut(const char* path) {
     return std::ofstream(std::string(path), std::ios::binary);
 }
 
+std::filesystem::path AssetsFeature::GetUserPresetDirectory() const {
+    auto getEnvPath = [](const char* name) {
+        const char* value = std::getenv(name);
+        return value ? std::filesystem::path(value) : std::filesystem::path();
+    };
+    std::filesystem::path base;
+#ifdef _WIN32
+    base = getEnvPath("APPDATA");
+#endif
+#ifdef __APPLE__
+    base = getEnvPath("HOME");
+    if (!base.empty()) {
+        base /= "Library/Audio/Presets";
+    }
+#endif
+#ifdef __linux__
+    base = getEnvPath("XDG_DATA_HOME");
+    if (base.empty()) {
+        base = getEnvPath("HOME");
+        if (!base.empty()) {
+            base /= ".local/share";
+        }
+    }
+#endif
+    if (base.empty()) {
+        return {};
+    }
+    std::string library = std::filesystem::path(sArchivePath).stem().string();
+    return base / (library.empty() ? "clapeze" : library) / "presets";
+}
+
 }  // namespace clapeze
\ No newline at end of file
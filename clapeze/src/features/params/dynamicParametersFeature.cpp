@@ -37,8 +37,7 @@ void DynamicAudioHandle::FlushEventsFromMain(BaseProcessor& processor, const cla
     // Send events queued from us to the host
     // Since these all happened on an independent thread, they do not have sample-accurate timing; we'll just
     // send them at the front of the queue.
-    Change change;
-    while (mMainToAudio.pop(change)) {
+    mMainToAudio.Drain([&](const Change& change) {
         switch (change.type) {
             case ChangeType::StartGesture:
             case ChangeType::StopGesture: {
@@ -84,7 +83,7 @@ void DynamicAudioHandle::FlushEventsFromMain(BaseProcessor& processor, const cla
                 break;
             }
         }
-    }
+    });
 }
 double DynamicAudioHandle::GetRawValue(clap_id id) const {
     if (id < mValues.size()) {
@@ -95,7 +94,7 @@ double DynamicAudioHandle::GetRawValue(clap_id id) const {
 void DynamicAudioHandle::SetRawValue(clap_id id, double newValue) {
     if (id < mValues.size()) {
         mValues[id] = newValue;
-        mAudioToMain.push({ChangeType::SetValue, id, {}, newValue});
+        mAudioToMain.Push({ChangeType::SetValue, id, {}, newValue});
         if (mHandleChange) {
             mHandleChange(id);
         }
@@ -130,7 +129,7 @@ void DynamicAudioHandle::SetRawModulation(clap_id id, const NoteTuple& note, dou
         } else {
             mModulations.insert({{id, note}, newModulation});
         }
-        mAudioToMain.push({ChangeType::SetModulation, id, note, newModulation});
+        mAudioToMain.Push({ChangeType::SetModulation, id, note, newModulation});
         if (mHandleChange) {
             mHandleChange(id);
         }
@@ -186,7 +185,7 @@ double DynamicMainHandle::GetRawValue(clap_id id) const {
 void DynamicMainHandle::SetRawValue(clap_id id, double newValue) {
     if (id < mValues.size()) {
         mValues[id] = newValue;
-        mMainToAudio.push({ChangeType::SetValue, id, {}, newValue});
+        mMainToAudio.Push({ChangeType::SetValue, id, {}, newValue});
         if (mHandleChange) {
             mHandleChange(id);
         }
@@ -194,16 +193,15 @@ void DynamicMainHandle::SetRawValue(clap_id id, double newValue) {
 }
 
 void DynamicMainHandle::StartGesture(clap_id id) {
-    mMainToAudio.push({ChangeType::StartGesture, id, {}, 0.0});
+    mMainToAudio.Push({ChangeType::StartGesture, id, {}, 0.0});
 }
 
 void DynamicMainHandle::StopGesture(clap_id id) {
-    mMainToAudio.push({ChangeType::StopGesture, id, {}, 0.0});
+    mMainToAudio.Push({ChangeType::StopGesture, id, {}, 0.0});
 }
 
 void DynamicMainHandle::FlushFromAudio() {
-    Change change;
-    while (mAudioToMain.pop(change)) {
+    mAudioToMain.Drain([&](const Change& change) {
         clap_id index = change.id;
         switch (change.type) {
             case ChangeType::SetValue: {
@@ -225,7 +223,7 @@ void DynamicMainHandle::FlushFromAudio() {
                 break;
             }
         }
-    }
+    });
 }
 
 }  // namespace clapeze::params
\ No newline at end of file
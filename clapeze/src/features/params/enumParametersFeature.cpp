@@ -16,13 +16,12 @@ void EnumMainHandle::SetRawValue(clap_id id, double newValue) {
     if (id < mValues.size()) {
         mValues[id] = newValue;
         // OnChangedMain
-        mMainToAudio.push({ChangeType::SetValue, id, {}, newValue});
+        mMainToAudio.Push({ChangeType::SetValue, id, {}, newValue});
     }
 }
 
 void EnumMainHandle::FlushFromAudio() {
-    Change change;
-    while (mAudioToMain.pop(change)) {
+    mAudioToMain.Drain([&](const Change& change) {
         clap_id index = change.id;
         switch (change.type) {
             case ChangeType::SetValue: {
@@ -39,15 +38,15 @@ void EnumMainHandle::FlushFromAudio() {
                 break;
             }
         }
-    }
+    });
 }
 
 void EnumMainHandle::StartGesture(clap_id id) {
-    mMainToAudio.push({ChangeType::StartGesture, id, {}, 0.0});
+    mMainToAudio.Push({ChangeType::StartGesture, id, {}, 0.0});
 }
 
 void EnumMainHandle::StopGesture(clap_id id) {
-    mMainToAudio.push({ChangeType::StopGesture, id, {}, 0.0});
+    mMainToAudio.Push({ChangeType::StopGesture, id, {}, 0.0});
 }
 
 }  // namespace clapeze::params
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <clap/version.h>
 #include <fstream>
 #include "clap/factory/preset-discovery.h"
+#include "clapeze/features/presetIndex.h"
 #include "clapeze/features/state/tomlStateFeature.h"
 
 namespace clapeze {
@@ -44,11 +45,8 @@ bool PresetFeature::LoadPreset(clap_preset_discovery_location_kind location_kind
     if (location_kind == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN) {
         auto loadStream = assets.OpenFromPlugin(load_key);
         if (loadStream.bad()) {
-            int32_t zipError{};
-            const char* msg{};
-            loadStream.getZipError(zipError, msg);
             if(rawPresetLoad) {
-                rawPresetLoad->on_error(rawHost, location_kind, location, load_key, 0, msg);
+                rawPresetLoad->on_error(rawHost, location_kind, location, load_key, 0, loadStream.getError());
             }
             return false;
         }
@@ -134,13 +132,18 @@ const PresetInfo& PresetFeature::GetPresetInfo() const {
     return &desc;
 }
 PresetProvider::PresetProvider(const clap_preset_discovery_indexer_t* indexer) : mIndexer(indexer) {}
+PresetProvider::~PresetProvider() {
+    if (mUserPresets) {
+        mUserPresets->Save();
+    }
+}
 
 bool PresetProvider::Init() {
     // TODO: let each feature type register this themselves
     static clap_preset_discovery_filetype_t filetype{
         .name = "preset",
         .description = "plain text preset",
-        .file_extension = "toml",
+        .file_extension = "preset",
     };
     if (!mIndexer->declare_filetype(mIndexer, &filetype)) {
         return false;
@@ -156,11 +159,20 @@ bool PresetProvider::Init() {
         return false;
     }
 
-    static clap_preset_discovery_location_t savedPresets{
+    std::filesystem::path userDirectory = mAssets.GetUserPresetDirectory();
+    if (userDirectory.empty()) {
+        return true;
+    }
+    mUserPresetDirectory = userDirectory.string();
+    mUserPresets = std::make_unique<PresetIndex>(userDirectory);
+    mUserPresets->Load();
+    mUserPresets->Scan();
+
+    clap_preset_discovery_location_t savedPresets{
         .flags = CLAP_PRESET_DISCOVERY_IS_USER_CONTENT,
         .name = "user",
         .kind = CLAP_PRESET_DISCOVERY_LOCATION_FILE,
-        .location = "",  // directory
+        .location = mUserPresetDirectory.c_str(),
     };
     if (!mIndexer->declare_location(mIndexer, &savedPresets)) {
         return false;
@@ -191,10 +203,19 @@ bool PresetProvider::GetMetadata(uint32_t location_kind,
     };
 
     if (location_kind == CLAP_PRESET_DISCOVERY_LOCATION_FILE) {
-        // read preset from disk, location == path
+        // read preset from disk, location == path. user presets come from the index, and are only parsed if they changed
+        if (mUserPresets) {
+            if (const PresetIndex::Entry* entry = mUserPresets->Get(location)) {
+                return entry->isPreset ? fillPreset(entry->pluginId, entry->info) : true;
+            }
+        }
         std::ifstream stream = mAssets.OpenFromFilesystem(location);
-        Metadata data = *Metadata::loadMetadata(stream);
-        return fillPreset(data.pluginId, data.preset);
+        std::optional<Metadata> data = Metadata::loadMetadata(stream);
+        if (!data) {
+            // not a preset, skip it
+            return true;
+        }
+        return fillPreset(data->pluginId, data->preset);
     } else if (location_kind == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN) {
         // read all presets loaded into plugin at once, no location
     }
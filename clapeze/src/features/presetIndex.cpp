@@ -0,0 +1,206 @@
+#include "clapeze/features/presetIndex.h"
+
+#include <fmt/format.h>
+#include <fstream>
+#include <random>
+#include <set>
+#include <toml++/toml.hpp>
+#include "clapeze/features/state/tomlStateFeature.h"
+#include "clapeze/impl/streamUtils.h"
+
+namespace clapeze {
+
+namespace fs = std::filesystem;
+
+PresetIndex::PresetIndex(fs::path directory, std::string extension)
+    : mDirectory(std::move(directory).lexically_normal()), mExtension(std::move(extension)) {}
+
+bool PresetIndex::Load() {
+    std::ifstream in(mDirectory / kIndexFilename, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::string fileText = impl::istream_tostring(in);
+    auto result = toml::parse(fileText);
+    if (!result) {
+        return false;
+    }
+    auto& file = result.table();
+    if (file["version"].value_or<int64_t>(0) != kFormatVersion) {
+        // written by a different version. start over
+        mDirty = true;
+        return false;
+    }
+
+    auto presetsArr = file["presets"].as_array();
+    if (!presetsArr) {
+        return false;
+    }
+    mEntries.clear();
+    for (auto& node : *presetsArr) {
+        auto presetkv = node.as_table();
+        if (!presetkv) {
+            continue;
+        }
+        auto path = presetkv->get_as<std::string>("file");
+        if (!path) {
+            continue;
+        }
+        Entry entry;
+        entry.modifiedTime = (*presetkv)["mtime"].value_or<int64_t>(0);
+        entry.size = (*presetkv)["size"].value_or<int64_t>(-1);
+        entry.isPreset = (*presetkv)["valid"].value_or(false);
+        entry.pluginId = (*presetkv)["plugin"].value_or("");
+        if (auto infokv = (*presetkv)["preset"].as_table()) {
+            Metadata::LoadPresetInfo(infokv, entry.info);
+        }
+        mEntries.insert_or_assign(**path, std::move(entry));
+    }
+    mDirty = false;
+    return true;
+}
+
+bool PresetIndex::Save() {
+    if (!mDirty) {
+        return true;
+    }
+
+    toml::array presetsArr;
+    for (const auto& [path, entry] : mEntries) {
+        toml::table presetkv{
+            {"file", path},
+            {"mtime", entry.modifiedTime},
+            {"size", entry.size},
+            {"valid", entry.isPreset},
+        };
+        if (entry.isPreset) {
+            presetkv.insert("plugin", entry.pluginId);
+            presetkv.insert("preset", Metadata::SavePresetInfo(entry.info));
+        }
+        presetsArr.push_back(std::move(presetkv));
+    }
+    toml::table file{
+        {"version", kFormatVersion},
+        {"presets", std::move(presetsArr)},
+    };
+
+    // write to the side and swap it in, so a host scanning at the same time never sees half an index. the temp name is
+    // unique, so two plugin instances saving the same directory at once can't write into each other's file
+    std::error_code error;
+    fs::path indexPath = mDirectory / kIndexFilename;
+    fs::path tempPath = indexPath;
+    std::random_device random;
+    uint64_t suffix = (static_cast<uint64_t>(random()) << 32) | random();
+    tempPath += fmt::format(".{:016x}.tmp", suffix);
+    {
+        std::ofstream out(tempPath, std::ios::binary);
+        if (!out) {
+            return false;
+        }
+        out << file;
+        if (!out) {
+            out.close();
+            fs::remove(tempPath, error);
+            return false;
+        }
+    }
+    fs::rename(tempPath, indexPath, error);
+    if (error) {
+        fs::remove(tempPath, error);
+        return false;
+    }
+    mDirty = false;
+    return true;
+}
+
+size_t PresetIndex::Scan() {
+    size_t numParsed = 0;
+    std::set<std::string, std::less<>> seen;
+
+    std::error_code error;
+    auto it = fs::recursive_directory_iterator(mDirectory, fs::directory_options::skip_permission_denied, error);
+    for (; !error && it != fs::recursive_directory_iterator(); it.increment(error)) {
+        const fs::directory_entry& file = *it;
+        if (file.path().extension() != mExtension || file.path().filename() == kIndexFilename) {
+            continue;
+        }
+        std::string relativePath = file.path().lexically_relative(mDirectory).generic_string();
+        std::error_code fileError;
+        bool isFile = file.is_regular_file(fileError);
+        if (fileError) {
+            // couldn't stat it this time around. keep whatever we had, rather than forgetting it
+            seen.insert(std::move(relativePath));
+            continue;
+        }
+        if (!isFile) {
+            continue;
+        }
+        if (Refresh(file.path(), relativePath)) {
+            ++numParsed;
+        }
+        seen.insert(std::move(relativePath));
+    }
+
+    if (error) {
+        // we only saw part of the directory, so we can't tell what was deleted
+        return numParsed;
+    }
+    // anything we didn't see was deleted
+    std::erase_if(mEntries, [&](const auto& item) {
+        if (seen.contains(item.first)) {
+            return false;
+        }
+        mDirty = true;
+        return true;
+    });
+    return numParsed;
+}
+
+const PresetIndex::Entry* PresetIndex::Get(const fs::path& file) {
+    fs::path relative = file.lexically_normal().lexically_relative(mDirectory);
+    if (relative.empty() || *relative.begin() == "..") {
+        return nullptr;
+    }
+    std::string relativePath = relative.generic_string();
+    Refresh(file, relativePath);
+    auto found = mEntries.find(relativePath);
+    if (found == mEntries.end()) {
+        return nullptr;
+    }
+    return &found->second;
+}
+
+bool PresetIndex::Refresh(const fs::path& file, std::string_view relativePath) {
+    auto found = mEntries.find(relativePath);
+    std::error_code error;
+    auto modifiedTime = static_cast<int64_t>(fs::last_write_time(file, error).time_since_epoch().count());
+    auto size = error ? 0 : static_cast<int64_t>(fs::file_size(file, error));
+    if (error) {
+        // gone, or unreadable
+        if (found != mEntries.end()) {
+            mEntries.erase(found);
+            mDirty = true;
+        }
+        return false;
+    }
+
+    if (found != mEntries.end() && found->second.modifiedTime == modifiedTime && found->second.size == size) {
+        // unchanged
+        return false;
+    }
+
+    Entry entry;
+    entry.modifiedTime = modifiedTime;
+    entry.size = size;
+    std::ifstream in(file, std::ios::binary);
+    if (auto metadata = Metadata::loadMetadata(in)) {
+        entry.isPreset = true;
+        entry.pluginId = std::move(metadata->pluginId);
+        entry.info = std::move(metadata->preset);
+    }
+    mEntries.insert_or_assign(std::string(relativePath), std::move(entry));
+    mDirty = true;
+    return true;
+}
+
+}  // namespace clapeze
@@ -0,0 +1,146 @@
+#include "clapeze/features/profilingFeature.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "clapeze/basePlugin.h"
+
+namespace clapeze {
+
+ProfilingFeature::ProfilingFeature(float budget, double windowSeconds)
+    : mBudget(budget), mWindowSeconds(windowSeconds) {}
+
+void ProfilingFeature::Configure(BasePlugin& self) {
+    mPluginId = self.GetDescriptor().id;
+}
+
+ProfilingFeature::StageId ProfilingFeature::AddStage(std::string_view name) {
+    assert(mStageNames.size() < kMaxStages);
+    mStageNames.emplace_back(name);
+    return static_cast<StageId>(mStageNames.size() - 1);
+}
+
+bool ProfilingFeature::Poll() {
+    bool any = false;
+    Stats stats;
+    while (mQueue.pop(stats)) {
+        mLatest = stats;
+        mHistory.push_back(stats);
+        if (mHistory.size() > kMaxHistory) {
+            mHistory.pop_front();
+        }
+        any = true;
+    }
+    return any;
+}
+
+void ProfilingFeature::WriteCsv(std::ostream& out) const {
+    out << "plugin,time,stage,blocks,over_budget,min,avg,p99,max\n";
+    auto writeRow = [&](const Stats& stats, std::string_view stage, const Timing& timing) {
+        out << mPluginId << ',' << stats.time << ',' << stage << ',' << stats.numBlocks << ','
+            << stats.numOverBudget << ',' << timing.min << ',' << timing.avg << ',' << timing.p99 << ','
+            << timing.max << '\n';
+    };
+    for (const Stats& stats : mHistory) {
+        writeRow(stats, "total", stats.total);
+        for (size_t idx = 0; idx < mStageNames.size(); ++idx) {
+            writeRow(stats, mStageNames[idx], stats.stages[idx]);
+        }
+    }
+}
+
+void ProfilingFeature::OnActivated() {
+    mTotal.Reset();
+    for (auto& stage : mStages) {
+        stage.Reset();
+    }
+    mStageSeconds.fill(0.0);
+    mTime = 0.0;
+    mWindowElapsed = 0.0;
+    mNumOverBudget = 0;
+    mTotalOverBudget = 0;
+    // anything left over is from the last activation
+    Poll();
+    mLatest = {};
+    mHistory.clear();
+}
+
+void ProfilingFeature::OnProcessed(double secondsSpent, double blockSeconds) {
+    if (blockSeconds <= 0.0) {
+        return;
+    }
+    float load = static_cast<float>(secondsSpent / blockSeconds);
+    mTotal.Add(load);
+    if (load > mBudget) {
+        ++mNumOverBudget;
+        mTotalOverBudget.fetch_add(1, std::memory_order_relaxed);
+    }
+    for (size_t idx = 0; idx < mStageNames.size(); ++idx) {
+        mStages[idx].Add(static_cast<float>(mStageSeconds[idx] / blockSeconds));
+        mStageSeconds[idx] = 0.0;
+    }
+
+    mTime += blockSeconds;
+    mWindowElapsed += blockSeconds;
+    if (mWindowElapsed >= mWindowSeconds) {
+        Stats stats{};
+        stats.time = mTime;
+        stats.numOverBudget = mNumOverBudget;
+        stats.total = mTotal.Summarize();
+        stats.numBlocks = mTotal.GetCount();
+        for (size_t idx = 0; idx < mStageNames.size(); ++idx) {
+            stats.stages[idx] = mStages[idx].Summarize();
+            mStages[idx].Reset();
+        }
+        // if the main thread isn't keeping up, this window is lost. that's fine, it's only diagnostics
+        mQueue.push(stats);
+
+        mTotal.Reset();
+        mWindowElapsed = 0.0;
+        mNumOverBudget = 0;
+    }
+}
+
+void ProfilingFeature::Histogram::Reset() {
+    mBins.fill(0);
+    mCount = 0;
+    mSum = 0.0;
+    mMin = 0.0f;
+    mMax = 0.0f;
+}
+
+void ProfilingFeature::Histogram::Add(float load) {
+    mMin = mCount == 0 ? load : std::min(mMin, load);
+    mMax = mCount == 0 ? load : std::max(mMax, load);
+    mSum += load;
+    ++mCount;
+
+    float octave = load > 0.0f ? std::log2(load) : static_cast<float>(kMinOctave);
+    auto bin = static_cast<int32_t>(std::floor((octave - static_cast<float>(kMinOctave)) * kBinsPerOctave));
+    mBins[static_cast<size_t>(std::clamp<int32_t>(bin, 0, static_cast<int32_t>(kNumBins) - 1))]++;
+}
+
+ProfilingFeature::Timing ProfilingFeature::Histogram::Summarize() const {
+    Timing out{};
+    if (mCount == 0) {
+        return out;
+    }
+    out.min = mMin;
+    out.max = mMax;
+    out.avg = static_cast<float>(mSum / mCount);
+
+    // the top edge of the bin the 99th percentile falls in, capped to the actual max
+    auto target = static_cast<uint32_t>(std::ceil(0.99 * mCount));
+    uint32_t seen = 0;
+    for (size_t bin = 0; bin < kNumBins; ++bin) {
+        seen += mBins[bin];
+        if (seen >= target) {
+            float octave = static_cast<float>(kMinOctave) + static_cast<float>(bin + 1) / kBinsPerOctave;
+            out.p99 = std::min(std::exp2(octave), mMax);
+            break;
+        }
+    }
+    return out;
+}
+
+}  // namespace clapeze
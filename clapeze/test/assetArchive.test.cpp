@@ -0,0 +1,229 @@
+#include <clapeze/features/assetArchive.h>
+#include <clapeze/features/assetsFeature.h>
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using clapeze::AssetArchive;
+using clapeze::AssetData;
+namespace fs = std::filesystem;
+
+namespace {
+struct ZipFile {
+    const char* path;
+    std::string contents;
+    // MZ_NO_COMPRESSION is stored as-is, anything else is deflated
+    mz_uint level;
+};
+
+std::string MakeZip(const std::vector<ZipFile>& files) {
+    mz_zip_archive zip;
+    mz_zip_zero_struct(&zip);
+    EXPECT_TRUE(mz_zip_writer_init_heap(&zip, 0, 0));
+    for (const ZipFile& file : files) {
+        EXPECT_TRUE(mz_zip_writer_add_mem(&zip, file.path, file.contents.data(), file.contents.size(), file.level));
+    }
+    void* data = nullptr;
+    size_t size = 0;
+    EXPECT_TRUE(mz_zip_writer_finalize_heap_archive(&zip, &data, &size));
+    std::string out(static_cast<const char*>(data), size);
+    mz_free(data);
+    mz_zip_writer_end(&zip);
+    return out;
+}
+
+// compresses well, so it's definitely deflated
+std::string Repeated(std::string_view text, size_t size) {
+    std::string out;
+    while (out.size() < size) {
+        out += text;
+    }
+    out.resize(size);
+    return out;
+}
+
+// an archive on disk, removed afterwards
+struct TempArchive {
+    TempArchive(std::string_view name, std::string_view contents)
+        : path(fs::temp_directory_path() / fmt::format("clapeze-{}.bin", name)) {
+        std::ofstream out(path, std::ios::binary);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+    ~TempArchive() {
+        std::error_code error;
+        fs::remove(path, error);
+    }
+    fs::path path;
+};
+}  // namespace
+
+TEST(AssetArchive, findsArchiveAppendedToBinary) {
+    // like target_add_bundle() does: a plugin binary, followed by a zip whose offsets start from 0, and a comment
+    std::string binary = "\x7f" "ELF";
+    binary += Repeated("not a zip ", 4096);
+    std::string zip = MakeZip({
+        {"assets/a.txt", "hello", MZ_NO_COMPRESSION},
+        {"assets/dir/b.toml", Repeated("b = 1\n", 500), MZ_DEFAULT_LEVEL},
+        {"other.txt", "other", MZ_NO_COMPRESSION},
+    });
+    std::string comment = "a comment, with a fake signature PK\x05\x06 in it";
+    zip[zip.size() - 2] = static_cast<char>(comment.size());
+    TempArchive file("appended", binary + zip + comment);
+
+    AssetArchive archive;
+    ASSERT_TRUE(archive.Open(file.path.string().c_str()));
+    EXPECT_TRUE(archive.IsOpen());
+    EXPECT_EQ(archive.GetAllPaths(), (std::vector<std::string>{"assets/a.txt", "assets/dir/b.toml", "other.txt"}));
+    EXPECT_EQ(archive.GetAllPaths("assets/"), (std::vector<std::string>{"assets/a.txt", "assets/dir/b.toml"}));
+    EXPECT_TRUE(archive.Contains("other.txt"));
+
+    std::optional<AssetData> a = archive.Read("assets/a.txt");
+    ASSERT_TRUE(a);
+    EXPECT_EQ(a->view(), "hello");
+    std::optional<AssetData> b = archive.Read("assets/dir/b.toml");
+    ASSERT_TRUE(b);
+    EXPECT_EQ(b->view(), Repeated("b = 1\n", 500));
+
+    archive.Close();
+    EXPECT_FALSE(archive.IsOpen());
+    EXPECT_TRUE(archive.GetAllPaths().empty());
+}
+
+TEST(AssetArchive, readsStoredEntriesWithoutCopying) {
+    std::string big = Repeated("stored ", 10000);
+    TempArchive file("stored", MakeZip({
+                                   {"stored.bin", big, MZ_NO_COMPRESSION},
+                                   {"deflated.bin", big, MZ_DEFAULT_LEVEL},
+                               }));
+    AssetArchive archive;
+    ASSERT_TRUE(archive.Open(file.path.string().c_str()));
+
+    std::optional<AssetData> stored = archive.Read("stored.bin");
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(stored->view(), big);
+    // points into the mapped file, so there's nothing to own or cache
+    EXPECT_EQ(stored->owner, nullptr);
+    EXPECT_EQ(archive.Read("stored.bin")->bytes.data(), stored->bytes.data());
+    EXPECT_EQ(archive.GetCacheSize(), 0u);
+
+    std::optional<AssetData> deflated = archive.Read("deflated.bin");
+    ASSERT_TRUE(deflated);
+    EXPECT_EQ(deflated->view(), big);
+    ASSERT_NE(deflated->owner, nullptr);
+    EXPECT_EQ(deflated->bytes.data(), deflated->owner->data());
+    EXPECT_EQ(archive.GetCacheSize(), big.size());
+    // decompressed once, then shared
+    EXPECT_EQ(archive.Read("deflated.bin")->owner, deflated->owner);
+}
+
+TEST(AssetArchive, evictsLeastRecentlyUsed) {
+    constexpr size_t kSize = 1000;
+    TempArchive file("lru", MakeZip({
+                                {"a", Repeated("a", kSize), MZ_DEFAULT_LEVEL},
+                                {"b", Repeated("b", kSize), MZ_DEFAULT_LEVEL},
+                                {"c", Repeated("c", kSize), MZ_DEFAULT_LEVEL},
+                                {"d", Repeated("d", kSize), MZ_DEFAULT_LEVEL},
+                                {"huge", Repeated("e", kSize * 4), MZ_DEFAULT_LEVEL},
+                            }));
+    AssetArchive archive(kSize * 3);
+    ASSERT_TRUE(archive.Open(file.path.string().c_str()));
+
+    auto a = archive.Read("a")->owner;
+    auto b = archive.Read("b")->owner;
+    auto c = archive.Read("c")->owner;
+    EXPECT_EQ(archive.GetCacheSize(), kSize * 3);
+
+    // a is now the most recently used, so d pushes out b
+    EXPECT_EQ(archive.Read("a")->owner, a);
+    archive.Read("d");
+    EXPECT_EQ(archive.GetCacheSize(), kSize * 3);
+    EXPECT_EQ(archive.Read("a")->owner, a);
+    EXPECT_EQ(archive.Read("c")->owner, c);
+    std::optional<AssetData> rereadB = archive.Read("b");
+    EXPECT_NE(rereadB->owner, b);
+    // an evicted entry is still good, as long as someone holds on to it
+    EXPECT_EQ(std::string_view(b->data(), b->size()), Repeated("b", kSize));
+
+    // bigger than the whole cache, so it's handed over without evicting anything
+    std::optional<AssetData> huge = archive.Read("huge");
+    ASSERT_TRUE(huge);
+    EXPECT_EQ(huge->bytes.size(), kSize * 4);
+    EXPECT_EQ(archive.GetCacheSize(), kSize * 3);
+    EXPECT_NE(archive.Read("huge")->owner, huge->owner);
+    EXPECT_EQ(archive.Read("b")->owner, rereadB->owner);
+}
+
+TEST(AssetArchive, reportsMissingPaths) {
+    TempArchive file("missing", MakeZip({
+                                    {"dir/", "", MZ_NO_COMPRESSION},
+                                    {"dir/a.txt", "a", MZ_NO_COMPRESSION},
+                                }));
+    AssetArchive archive;
+    EXPECT_FALSE(archive.Read("dir/a.txt"));
+
+    ASSERT_TRUE(archive.Open(file.path.string().c_str()));
+    EXPECT_FALSE(archive.Contains("nope"));
+    EXPECT_FALSE(archive.Read("nope"));
+    EXPECT_STREQ(archive.GetLastError(), "file not found");
+    // directories aren't assets
+    EXPECT_FALSE(archive.Contains("dir/"));
+    EXPECT_FALSE(archive.Read("dir/"));
+    EXPECT_EQ(archive.GetAllPaths(), std::vector<std::string>{"dir/a.txt"});
+
+    archive.Close();
+    EXPECT_FALSE(archive.Read("dir/a.txt"));
+}
+
+TEST(AssetArchive, rejectsFilesWithoutArchives) {
+    TempArchive notZip("notzip", Repeated("just a binary ", 1000));
+    TempArchive empty("empty", "");
+    AssetArchive archive;
+
+    EXPECT_FALSE(archive.Open((fs::temp_directory_path() / "clapeze-does-not-exist.bin").string().c_str()));
+    EXPECT_STREQ(archive.GetLastError(), "could not map file");
+    EXPECT_FALSE(archive.Open(empty.path.string().c_str()));
+    EXPECT_FALSE(archive.Open(notZip.path.string().c_str()));
+    EXPECT_STREQ(archive.GetLastError(), "no zip archive found");
+    EXPECT_FALSE(archive.IsOpen());
+}
+
+TEST(AssetIstream, seeks) {
+    std::string text = "hello world";
+    clapeze::asset_istream in(AssetData{{text.data(), text.size()}, nullptr}, "");
+    std::string word;
+    in >> word;
+    EXPECT_EQ(word, "hello");
+    EXPECT_EQ(in.tellg(), 5);
+
+    in.seekg(-5, std::ios::end);
+    in >> word;
+    EXPECT_EQ(word, "world");
+
+    in.clear();
+    in.seekg(2, std::ios::beg);
+    in.seekg(2, std::ios::cur);
+    EXPECT_EQ(in.tellg(), 4);
+    EXPECT_EQ(in.get(), 'o');
+
+    // out of range
+    in.seekg(100);
+    EXPECT_TRUE(in.fail());
+    in.clear();
+    in.seekg(-1, std::ios::beg);
+    EXPECT_TRUE(in.fail());
+    in.clear();
+    in.seekg(0);
+    EXPECT_EQ(clapeze::impl::istream_tostring(in), text);
+}
+
+TEST(AssetIstream, isBadWithoutData) {
+    clapeze::asset_istream in(std::nullopt, "file not found");
+    EXPECT_TRUE(in.bad());
+    EXPECT_STREQ(in.getError(), "file not found");
+    EXPECT_EQ(in.get(), std::char_traits<char>::eof());
+}
@@ -0,0 +1,99 @@
+#include <clapeze/features/params/changeQueue.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using clapeze::params::Change;
+using clapeze::params::ChangeQueue;
+using clapeze::params::ChangeType;
+
+namespace {
+std::vector<Change> DrainAll(ChangeQueue& queue) {
+    std::vector<Change> out;
+    queue.Drain([&](const Change& change) { out.push_back(change); });
+    return out;
+}
+}  // namespace
+
+TEST(ChangeQueue, keepsLatestValuePerParam) {
+    ChangeQueue queue(300, true);
+    for (int step = 0; step < 10000; ++step) {
+        EXPECT_TRUE(queue.Push({ChangeType::SetValue, 7, {}, static_cast<double>(step)}));
+        EXPECT_TRUE(queue.Push({ChangeType::SetModulation, 7, {}, -static_cast<double>(step)}));
+    }
+    EXPECT_TRUE(queue.Push({ChangeType::SetValue, 299, {}, 0.5}));
+
+    auto changes = DrainAll(queue);
+    ASSERT_EQ(changes.size(), 3u);
+    EXPECT_EQ(changes[0].type, ChangeType::SetValue);
+    EXPECT_EQ(changes[0].id, 7u);
+    EXPECT_EQ(changes[0].value, 9999.0);
+    EXPECT_EQ(changes[1].type, ChangeType::SetValue);
+    EXPECT_EQ(changes[1].id, 299u);
+    EXPECT_EQ(changes[2].type, ChangeType::SetModulation);
+    EXPECT_EQ(changes[2].value, -9999.0);
+    EXPECT_EQ(queue.GetNumCoalesced(), 2u * 9999u);
+    EXPECT_EQ(queue.GetNumDropped(), 0u);
+
+    EXPECT_TRUE(DrainAll(queue).empty());
+    EXPECT_FALSE(queue.Push({ChangeType::SetValue, 300, {}, 0.0}));
+    EXPECT_EQ(queue.GetNumDropped(), 1u);
+}
+
+TEST(ChangeQueue, fillsToCapacity) {
+    ChangeQueue queue(ChangeQueue::kMaxParams, false);
+    for (clap_id id = 0; id < ChangeQueue::kMaxParams; ++id) {
+        EXPECT_TRUE(queue.Push({ChangeType::SetValue, id, {}, static_cast<double>(id)}));
+    }
+    EXPECT_FALSE(queue.Push({ChangeType::SetValue, ChangeQueue::kMaxParams, {}, 0.0}));
+    EXPECT_EQ(queue.GetNumDropped(), 1u);
+
+    auto changes = DrainAll(queue);
+    ASSERT_EQ(changes.size(), ChangeQueue::kMaxParams);
+    EXPECT_EQ(changes.back().id, ChangeQueue::kMaxParams - 1);
+    EXPECT_EQ(changes.back().value, static_cast<double>(ChangeQueue::kMaxParams - 1));
+}
+
+TEST(ChangeQueue, deliversValueBeforeGestureEnds) {
+    ChangeQueue queue(4, true);
+    queue.Push({ChangeType::StartGesture, 2, {}, 0.0});
+    queue.Push({ChangeType::SetValue, 2, {}, 0.25});
+    queue.Push({ChangeType::SetValue, 2, {}, 0.75});
+    queue.Push({ChangeType::StopGesture, 2, {}, 0.0});
+
+    auto changes = DrainAll(queue);
+    ASSERT_EQ(changes.size(), 3u);
+    EXPECT_EQ(changes[0].type, ChangeType::StartGesture);
+    EXPECT_EQ(changes[1].type, ChangeType::SetValue);
+    EXPECT_EQ(changes[1].value, 0.75);
+    EXPECT_EQ(changes[2].type, ChangeType::StopGesture);
+
+    ChangeQueue noGestures(4, false);
+    EXPECT_FALSE(noGestures.Push({ChangeType::StartGesture, 0, {}, 0.0}));
+    EXPECT_EQ(noGestures.GetNumDropped(), 1u);
+    EXPECT_TRUE(DrainAll(noGestures).empty());
+}
+
+TEST(ChangeQueue, neverLosesTheLastValueAcrossThreads) {
+    constexpr size_t kNumParams = 128;
+    constexpr int kSteps = 20000;
+    ChangeQueue queue(kNumParams, false);
+    std::vector<double> received(kNumParams, -1.0);
+
+    std::thread producer([&] {
+        for (int step = 0; step < kSteps; ++step) {
+            for (clap_id id = 0; id < kNumParams; id += 3) {
+                queue.Push({ChangeType::SetValue, id, {}, static_cast<double>(step)});
+            }
+        }
+    });
+    for (int iter = 0; iter < 1000; ++iter) {
+        queue.Drain([&](const Change& change) { received[change.id] = change.value; });
+    }
+    producer.join();
+    queue.Drain([&](const Change& change) { received[change.id] = change.value; });
+
+    for (clap_id id = 0; id < kNumParams; ++id) {
+        EXPECT_EQ(received[id], id % 3 == 0 ? kSteps - 1 : -1.0);
+    }
+}
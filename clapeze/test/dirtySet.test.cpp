@@ -0,0 +1,82 @@
+#include <clapeze/impl/dirtySet.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(DirtySet, setsBitsPastTheFirstWord) {
+    clapeze::DirtySet<200> set;
+    EXPECT_FALSE(set.Any());
+    set.Set(0);
+    set.Set(31);
+    set.Set(32);
+    set.Set(63);
+    set.Set(64);
+    set.Set(199);
+    EXPECT_EQ(set.Count(), 6u);
+    EXPECT_TRUE(set.Test(32));
+    EXPECT_TRUE(set.Test(199));
+    EXPECT_FALSE(set.Test(33));
+    EXPECT_FALSE(set.Test(128));
+
+    EXPECT_TRUE((set.AnyOf<5, 199>()));
+    EXPECT_FALSE((set.AnyOf<1, 100, 198>()));
+
+    EXPECT_TRUE(set.TestAndClear(64));
+    EXPECT_FALSE(set.TestAndClear(64));
+    set.Unset(0);
+    EXPECT_EQ(set.Count(), 4u);
+    set.Reset();
+    EXPECT_FALSE(set.Any());
+}
+
+TEST(DirtySet, forEachSetVisitsInOrderAndClears) {
+    clapeze::DirtySet<300> set;
+    std::vector<size_t> expected{3, 64, 65, 127, 200, 299};
+    for (size_t idx : expected) {
+        set.Set(idx);
+    }
+
+    std::vector<size_t> visited;
+    set.ForEachSet([&](size_t idx) { visited.push_back(idx); });
+    EXPECT_EQ(visited, expected);
+    EXPECT_FALSE(set.Any());
+
+    // setting bits again from inside the callback keeps them for next time
+    set.Set(10);
+    set.ForEachSet([&](size_t idx) { set.Set(idx); });
+    EXPECT_TRUE(set.Test(10));
+}
+
+TEST(DirtySet, atomicSetsFromManyThreadsAreAllCollected) {
+    constexpr size_t kNumThreads = 4;
+    constexpr size_t kPerThread = 256;
+    clapeze::DirtySet<kNumThreads * kPerThread> set;
+
+    std::vector<size_t> hits(set.Capacity(), 0);
+    std::vector<std::thread> threads;
+    std::atomic<size_t> numDone{};
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t idx = 0; idx < kPerThread; ++idx) {
+                set.SetAtomic(idx * kNumThreads + t);
+            }
+            numDone.fetch_add(1);
+        });
+    }
+    // collect while the other threads are still going
+    while (numDone.load() < kNumThreads) {
+        set.ForEachSetAtomic([&](size_t idx) { hits[idx]++; });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    set.ForEachSetAtomic([&](size_t idx) { hits[idx]++; });
+
+    for (size_t idx = 0; idx < hits.size(); ++idx) {
+        EXPECT_EQ(hits[idx], 1u) << idx;
+    }
+    EXPECT_FALSE(set.TestAndClearAtomic(0));
+    set.SetAtomic(0);
+    EXPECT_TRUE(set.TestAtomic(0));
+    EXPECT_TRUE(set.TestAndClearAtomic(0));
+}
@@ -0,0 +1,181 @@
+#include <clapeze/basePlugin.h>
+#include <clapeze/features/latencyFeature.h>
+#include <clapeze/processor/latencyGraph.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+namespace {
+// counts what the plugin asks of the host
+struct HostCalls {
+    int restarts{};
+    int latencyChanges{};
+};
+
+const clap_host_latency_t kHostLatency{
+    .changed = [](const clap_host_t* host) { static_cast<HostCalls*>(host->host_data)->latencyChanges++; }};
+
+const clap_plugin_descriptor_t kDescriptor{.clap_version = CLAP_VERSION_INIT,
+                                           .id = "clapeze.test.latency",
+                                           .name = "Latency",
+                                           .vendor = "clapeze",
+                                           .url = "",
+                                           .manual_url = "",
+                                           .support_url = "",
+                                           .version = "0.0.0",
+                                           .description = "",
+                                           .features = nullptr};
+
+// reports activateLatency from inside Activate(), like a plugin whose latency depends on the sample rate
+class Processor : public clapeze::BaseProcessor {
+   public:
+    Processor(clapeze::PluginHost& host, clapeze::LatencyFeature& latency, const uint32_t& activateLatency)
+        : clapeze::BaseProcessor(host), mLatency(latency), mActivateLatency(activateLatency) {}
+    void Activate(double sampleRate, size_t minBlockSize, size_t maxBlockSize) override {
+        mLatency.ChangeLatency(mActivateLatency);
+    }
+    void ProcessEvent(const clap_event_header_t& event) override {}
+    clapeze::ProcessStatus ProcessAudio(const clap_process_t& process, size_t blockStart, size_t blockStop) override {
+        return clapeze::ProcessStatus::Sleep;
+    }
+    void ProcessFlush(const clap_process_t& process) override {}
+
+   private:
+    clapeze::LatencyFeature& mLatency;
+    const uint32_t& mActivateLatency;
+};
+
+class LatencyPlugin : public clapeze::BasePlugin {
+   public:
+    LatencyPlugin() : clapeze::BasePlugin(kDescriptor) {
+        mHost.host_data = &calls;
+        SetHost(&mHost);
+        EXPECT_TRUE(GetPluginObject()->init(GetPluginObject()));
+    }
+
+    // through the clap plugin, the way a host would
+    bool HostActivate() { return GetPluginObject()->activate(GetPluginObject(), 48000.0, 1, 512); }
+    void HostDeactivate() { GetPluginObject()->deactivate(GetPluginObject()); }
+    clapeze::LatencyFeature& GetLatencyFeature() { return *mLatency; }
+    // through the clap extension, the way a host would
+    uint32_t GetHostLatency() {
+        const clap_plugin_t* plugin = GetPluginObject();
+        auto* ext = static_cast<const clap_plugin_latency_t*>(plugin->get_extension(plugin, CLAP_EXT_LATENCY));
+        return ext->get(plugin);
+    }
+
+    HostCalls calls{};
+    uint32_t activateLatency{};
+
+   protected:
+    void Config() override {
+        mLatency = &ConfigFeature<clapeze::LatencyFeature>(0);
+        ConfigProcessor<Processor>(*mLatency, activateLatency);
+    }
+
+   private:
+    clap_host_t mHost{.clap_version = CLAP_VERSION_INIT,
+                      .host_data = nullptr,
+                      .name = "Latency Host",
+                      .vendor = "clapeze",
+                      .url = "https://crouton.net",
+                      .version = "0.0.0",
+                      .get_extension = [](const clap_host_t*, const char* id) -> const void* {
+                          return std::strcmp(id, CLAP_EXT_LATENCY) == 0 ? &kHostLatency : nullptr;
+                      },
+                      .request_restart =
+                          [](const clap_host_t* host) { static_cast<HostCalls*>(host->host_data)->restarts++; },
+                      .request_process = [](const clap_host_t*) {},
+                      .request_callback = [](const clap_host_t*) {}};
+    clapeze::LatencyFeature* mLatency{};
+};
+}  // namespace
+
+TEST(LatencyGraph, totalIsLongestPath) {
+    clapeze::LatencyGraph graph;
+    auto dry = graph.AddStage();
+    auto oversampler = graph.AddStage(12);
+    auto limiter = graph.AddStage(64, oversampler);
+    auto sidechain = graph.AddStage(100);
+    EXPECT_EQ(graph.GetPathLatency(limiter), 76u);
+    EXPECT_EQ(graph.GetTotalLatency(), 100u);
+    EXPECT_EQ(graph.GetCompensation(dry), 100u);
+    EXPECT_EQ(graph.GetCompensation(limiter), 24u);
+    EXPECT_EQ(graph.GetCompensation(sidechain), 0u);
+
+    graph.SetStageLatency(sidechain, 0);
+    EXPECT_EQ(graph.GetTotalLatency(), 76u);
+    graph.SetStageLatency(oversampler, 0);
+    EXPECT_EQ(graph.GetTotalLatency(), 64u);
+    EXPECT_EQ(graph.GetCompensation(dry), 64u);
+    EXPECT_EQ(graph.GetCompensation(graph.kInput), 64u);
+}
+
+TEST(CompensationDelay, delaysAcrossBlocks) {
+    clapeze::CompensationDelay delay;
+    delay.Reset(2, 3);
+    std::vector<float> left = {1.0f, 2.0f};
+    std::vector<float> right = {-1.0f, -2.0f};
+    delay.Process(0, left);
+    delay.Process(1, right);
+    EXPECT_EQ(left, (std::vector<float>{0.0f, 0.0f}));
+    EXPECT_EQ(right, (std::vector<float>{0.0f, 0.0f}));
+
+    left = {3.0f, 4.0f, 5.0f, 6.0f};
+    delay.Process(0, left);
+    EXPECT_EQ(left, (std::vector<float>{0.0f, 1.0f, 2.0f, 3.0f}));
+
+    delay.Reset(1, 0);
+    left = {7.0f};
+    delay.Process(0, left);
+    EXPECT_EQ(left, (std::vector<float>{7.0f}));
+}
+
+TEST(LatencyFeature, appliesChangesFromActivateWithoutRestarting) {
+    LatencyPlugin plugin;
+    EXPECT_EQ(plugin.GetHostLatency(), 0u);
+
+    plugin.activateLatency = 96;
+    ASSERT_TRUE(plugin.HostActivate());
+    EXPECT_EQ(plugin.GetHostLatency(), 96u);
+    EXPECT_EQ(plugin.calls.latencyChanges, 1);
+    EXPECT_EQ(plugin.calls.restarts, 0);
+    plugin.HostDeactivate();
+
+    // same as last time, so there's nothing to tell the host
+    ASSERT_TRUE(plugin.HostActivate());
+    EXPECT_EQ(plugin.calls.latencyChanges, 1);
+    EXPECT_EQ(plugin.calls.restarts, 0);
+    plugin.HostDeactivate();
+}
+
+TEST(LatencyFeature, restartsOnlyWhileActive) {
+    LatencyPlugin plugin;
+
+    // inactive, so it's just picked up by the next activation
+    plugin.GetLatencyFeature().ChangeLatency(10);
+    EXPECT_EQ(plugin.calls.restarts, 0);
+    EXPECT_EQ(plugin.GetHostLatency(), 0u);
+    plugin.activateLatency = 10;
+    ASSERT_TRUE(plugin.HostActivate());
+    EXPECT_EQ(plugin.GetHostLatency(), 10u);
+    EXPECT_EQ(plugin.calls.restarts, 0);
+
+    // active, so the host keeps the old latency and is asked to restart, but only if it actually changed
+    plugin.GetLatencyFeature().ChangeLatency(10);
+    EXPECT_EQ(plugin.calls.restarts, 0);
+    plugin.GetLatencyFeature().ChangeLatency(20);
+    EXPECT_EQ(plugin.calls.restarts, 1);
+    EXPECT_EQ(plugin.GetHostLatency(), 10u);
+
+    // the restart
+    plugin.HostDeactivate();
+    plugin.GetLatencyFeature().ChangeLatency(20);
+    EXPECT_EQ(plugin.calls.restarts, 1);
+    plugin.activateLatency = 20;
+    ASSERT_TRUE(plugin.HostActivate());
+    EXPECT_EQ(plugin.GetHostLatency(), 20u);
+    EXPECT_EQ(plugin.calls.latencyChanges, 2);
+    EXPECT_EQ(plugin.calls.restarts, 1);
+    plugin.HostDeactivate();
+}
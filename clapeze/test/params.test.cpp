@@ -2,7 +2,9 @@
 #include <gtest/gtest.h>
 #include "clap/events.h"
 #include "clapeze/features/params/dynamicParametersFeature.h"
+#include "clapeze/features/params/enumParametersFeature.h"
 #include "clapeze/features/params/parameterTypes.h"
+#include "clapeze/features/params/smoothedValue.h"
 #include "clapeze/impl/casts.h"
 #include "clapeze/pluginHost.h"
 
@@ -54,3 +56,117 @@ TEST(DynamicParameters, canSortModulation) {
     EXPECT_FLOAT_EQ(audio.Get<clapeze::NumericParam>(0, {13, -1, 3, -1}), 0.5f);
     EXPECT_FLOAT_EQ(audio.Get<clapeze::NumericParam>(0), 0.5f);
 }
+
+namespace {
+enum class CachedParams : clap_id { Cutoff, Steps, Toggle, Fraction, Count };
+}  // namespace
+namespace clapeze::params {
+template <>
+struct ParamTraits<CachedParams, CachedParams::Cutoff> : public clapeze::NumericParam {
+    ParamTraits() : clapeze::NumericParam("cutoff", "Cutoff", 20.0f, 20000.0f, 1000.0f, "hz") {
+        mCurve = clapeze::cPowCurve<2.0f>;
+    }
+};
+template <>
+struct ParamTraits<CachedParams, CachedParams::Steps> : public clapeze::IntegerParam {
+    ParamTraits() : clapeze::IntegerParam("steps", "Steps", 1, 16, 4) {}
+};
+template <>
+struct ParamTraits<CachedParams, CachedParams::Toggle> : public clapeze::OnOffParam {
+    ParamTraits() : clapeze::OnOffParam("toggle", "Toggle", clapeze::OnOff::Off) {}
+};
+// shadows IntegerParam::ToValue() with a different value type, like a tempo-synced rate
+template <>
+struct ParamTraits<CachedParams, CachedParams::Fraction> : public clapeze::IntegerParam {
+    using _valuetype = float;
+    ParamTraits() : clapeze::IntegerParam("fraction", "Fraction", 0, 3, 1) {}
+    bool ToValue(double rawValue, float& out) const {
+        int32_t idx{};
+        if (!clapeze::IntegerParam::ToValue(rawValue, idx)) {
+            return false;
+        }
+        out = 1.0f / static_cast<float>(1 << idx);
+        return true;
+    }
+};
+}  // namespace clapeze::params
+
+TEST(EnumParameters, cachesCurvedValues) {
+    clap_host_t mockHost{
+        .clap_version = CLAP_VERSION_INIT,
+        .get_extension = [](const struct clap_host* host, const char* extension_id) -> const void* { return nullptr; },
+    };
+    clapeze::PluginHost host(&mockHost);
+    clapeze::params::EnumParametersFeature<CachedParams> params(host, CachedParams::Count);
+    params.Parameter<CachedParams::Cutoff>()
+        .Parameter<CachedParams::Steps>()
+        .Parameter<CachedParams::Toggle>()
+        .Parameter<CachedParams::Fraction>();
+    auto& audio = params.GetAudioHandle<clapeze::params::EnumParametersFeature<CachedParams>::AudioHandle>();
+
+    clap_event_param_value_t ev{};
+    ev.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+    ev.header.type = CLAP_EVENT_PARAM_VALUE;
+    ev.param_id = static_cast<clap_id>(CachedParams::Cutoff);
+    ev.value = 0.5;
+    audio.ProcessEvent(ev.header);
+    float expected{};
+    params.GetSpecificParam<CachedParams::Cutoff>()->ToValue(0.5, expected);
+    EXPECT_FLOAT_EQ(audio.Get<CachedParams::Cutoff>(), expected);
+
+    clap_event_param_mod_t mod{};
+    mod.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+    mod.header.type = CLAP_EVENT_PARAM_MOD;
+    mod.param_id = static_cast<clap_id>(CachedParams::Cutoff);
+    mod.amount = 0.25;
+    audio.ProcessEvent(mod.header);
+    params.GetSpecificParam<CachedParams::Cutoff>()->ToValue(0.75, expected);
+    EXPECT_FLOAT_EQ(audio.Get<CachedParams::Cutoff>(), expected);
+
+    ev.param_id = static_cast<clap_id>(CachedParams::Steps);
+    ev.value = 7.0;
+    audio.ProcessEvent(ev.header);
+    EXPECT_EQ(audio.Get<CachedParams::Steps>(), 7);
+
+    ev.param_id = static_cast<clap_id>(CachedParams::Toggle);
+    ev.value = 1.0;
+    audio.ProcessEvent(ev.header);
+    EXPECT_EQ(audio.Get<CachedParams::Toggle>(), clapeze::OnOff::On);
+
+    // goes through the param's own ToValue(), not IntegerParam's
+    EXPECT_FLOAT_EQ(audio.Get<CachedParams::Fraction>(), 1.0f);
+    ev.param_id = static_cast<clap_id>(CachedParams::Fraction);
+    ev.value = 2.0;
+    audio.ProcessEvent(ev.header);
+    EXPECT_FLOAT_EQ(audio.Get<CachedParams::Fraction>(), 0.25f);
+}
+
+TEST(SmoothedValue, rampsToTargetThenHolds) {
+    clapeze::params::SmoothedValue smoother;
+    smoother.Reset(1000.0, 8, 4.0f, 0.0f);
+    auto block = smoother.Process(0.0f, 8);
+    EXPECT_FALSE(smoother.IsSmoothing());
+    EXPECT_FLOAT_EQ(block[7], 0.0f);
+
+    // 4ms at 1khz is 4 samples
+    block = smoother.Process(1.0f, 6);
+    ASSERT_EQ(block.size(), 6u);
+    EXPECT_FLOAT_EQ(block[0], 0.25f);
+    EXPECT_FLOAT_EQ(block[1], 0.5f);
+    EXPECT_FLOAT_EQ(block[3], 1.0f);
+    EXPECT_FLOAT_EQ(block[5], 1.0f);
+    EXPECT_TRUE(smoother.IsSmoothing());
+
+    block = smoother.Process(1.0f, 8);
+    EXPECT_FALSE(smoother.IsSmoothing());
+    for (float sample : block) {
+        EXPECT_FLOAT_EQ(sample, 1.0f);
+    }
+
+    // changing the target mid-ramp starts over from wherever it got to
+    block = smoother.Process(0.0f, 2);
+    EXPECT_FLOAT_EQ(block[1], 0.5f);
+    block = smoother.Process(1.0f, 2);
+    EXPECT_FLOAT_EQ(block[0], 0.625f);
+    EXPECT_FLOAT_EQ(smoother.GetValue(), 0.75f);
+}
@@ -0,0 +1,169 @@
+#include <clapeze/features/presetIndex.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+using clapeze::PresetIndex;
+namespace fs = std::filesystem;
+
+namespace {
+// a scratch directory that cleans up after itself
+struct TempDirectory {
+    explicit TempDirectory(std::string_view name) : path(fs::temp_directory_path() / name) {
+        fs::remove_all(path);
+        fs::create_directories(path);
+    }
+    ~TempDirectory() {
+        std::error_code error;
+        fs::remove_all(path, error);
+    }
+    fs::path path;
+};
+
+void WriteFile(const fs::path& path, std::string_view text) {
+    fs::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+}
+
+void WritePreset(const fs::path& path, std::string_view name) {
+    WriteFile(path, std::string("[_meta]\nplugin = \"clapeze.test.presets\"\n\n[preset]\nname = \"") +
+                        std::string(name) + "\"\n");
+}
+
+size_t CountTempFiles(const fs::path& directory) {
+    size_t count = 0;
+    for (const fs::directory_entry& file : fs::directory_iterator(directory)) {
+        if (file.path().extension() == ".tmp") {
+            ++count;
+        }
+    }
+    return count;
+}
+}  // namespace
+
+TEST(PresetIndex, scansAndCachesPresets) {
+    TempDirectory dir("clapeze-presetindex-scan");
+    WritePreset(dir.path / "a.preset", "A");
+    WritePreset(dir.path / "sub" / "b.preset", "B");
+    WriteFile(dir.path / "broken.preset", "not = [a preset");
+    WriteFile(dir.path / "notes.txt", "ignored");
+
+    PresetIndex index(dir.path);
+    EXPECT_FALSE(index.Load());
+    EXPECT_EQ(index.Scan(), 3u);
+
+    const PresetIndex::Entries& entries = index.GetEntries();
+    ASSERT_EQ(entries.size(), 3u);
+    ASSERT_TRUE(entries.contains("a.preset"));
+    EXPECT_TRUE(entries.at("a.preset").isPreset);
+    EXPECT_EQ(entries.at("a.preset").pluginId, "clapeze.test.presets");
+    EXPECT_EQ(entries.at("a.preset").info.name, "A");
+    ASSERT_TRUE(entries.contains("sub/b.preset"));
+    EXPECT_EQ(entries.at("sub/b.preset").info.name, "B");
+    // cached, so it isn't parsed again
+    ASSERT_TRUE(entries.contains("broken.preset"));
+    EXPECT_FALSE(entries.at("broken.preset").isPreset);
+
+    // nothing changed
+    EXPECT_EQ(index.Scan(), 0u);
+
+    // only the changed file is parsed
+    WritePreset(dir.path / "a.preset", "A, but longer");
+    EXPECT_EQ(index.Scan(), 1u);
+    EXPECT_EQ(entries.at("a.preset").info.name, "A, but longer");
+    fs::last_write_time(dir.path / "sub" / "b.preset",
+                        fs::last_write_time(dir.path / "sub" / "b.preset") + std::chrono::hours(1));
+    EXPECT_EQ(index.Scan(), 1u);
+
+    // deleted files are dropped
+    fs::remove(dir.path / "sub" / "b.preset");
+    EXPECT_EQ(index.Scan(), 0u);
+    EXPECT_EQ(entries.size(), 2u);
+    EXPECT_FALSE(entries.contains("sub/b.preset"));
+}
+
+TEST(PresetIndex, savesAndLoads) {
+    TempDirectory dir("clapeze-presetindex-save");
+    WritePreset(dir.path / "a.preset", "A");
+    WritePreset(dir.path / "sub" / "b.preset", "B");
+    WriteFile(dir.path / "broken.preset", "not = [a preset");
+
+    {
+        PresetIndex index(dir.path);
+        index.Scan();
+        ASSERT_TRUE(index.Save());
+    }
+    EXPECT_TRUE(fs::exists(dir.path / PresetIndex::kIndexFilename));
+    EXPECT_EQ(CountTempFiles(dir.path), 0u);
+
+    PresetIndex index(dir.path);
+    ASSERT_TRUE(index.Load());
+    const PresetIndex::Entries& entries = index.GetEntries();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_TRUE(entries.at("a.preset").isPreset);
+    EXPECT_EQ(entries.at("a.preset").pluginId, "clapeze.test.presets");
+    EXPECT_EQ(entries.at("a.preset").info.name, "A");
+    EXPECT_EQ(entries.at("sub/b.preset").info.name, "B");
+    EXPECT_FALSE(entries.at("broken.preset").isPreset);
+    // everything was up to date, and the index file itself is never indexed
+    EXPECT_EQ(index.Scan(), 0u);
+    EXPECT_EQ(entries.size(), 3u);
+
+    // nothing to write
+    fs::file_time_type savedTime = fs::last_write_time(dir.path / PresetIndex::kIndexFilename);
+    EXPECT_TRUE(index.Save());
+    EXPECT_EQ(fs::last_write_time(dir.path / PresetIndex::kIndexFilename), savedTime);
+}
+
+TEST(PresetIndex, rejectsOtherVersions) {
+    TempDirectory dir("clapeze-presetindex-version");
+    WriteFile(dir.path / PresetIndex::kIndexFilename, "version = 999\npresets = []\n");
+    WritePreset(dir.path / "a.preset", "A");
+
+    PresetIndex index(dir.path);
+    EXPECT_FALSE(index.Load());
+    EXPECT_TRUE(index.GetEntries().empty());
+    EXPECT_EQ(index.Scan(), 1u);
+}
+
+TEST(PresetIndex, getsSingleFiles) {
+    TempDirectory dir("clapeze-presetindex-get");
+    WritePreset(dir.path / "a.preset", "A");
+
+    PresetIndex index(dir.path);
+    const PresetIndex::Entry* entry = index.Get(dir.path / "." / "a.preset");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_TRUE(entry->isPreset);
+    EXPECT_EQ(entry->info.name, "A");
+    EXPECT_TRUE(index.GetEntries().contains("a.preset"));
+
+    // outside the directory
+    EXPECT_EQ(index.Get(dir.path / ".." / "a.preset"), nullptr);
+    EXPECT_EQ(index.Get(dir.path), nullptr);
+
+    // gone
+    fs::remove(dir.path / "a.preset");
+    EXPECT_EQ(index.Get(dir.path / "a.preset"), nullptr);
+    EXPECT_TRUE(index.GetEntries().empty());
+}
+
+TEST(PresetIndex, keepsEntriesWhenScanFails) {
+    TempDirectory dir("clapeze-presetindex-missing");
+    WritePreset(dir.path / "presets" / "a.preset", "A");
+
+    PresetIndex index(dir.path / "presets");
+    EXPECT_EQ(index.Scan(), 1u);
+
+    // e.g. an unmounted drive. that doesn't mean the presets were deleted
+    fs::rename(dir.path / "presets", dir.path / "elsewhere");
+    EXPECT_EQ(index.Scan(), 0u);
+    EXPECT_TRUE(index.GetEntries().contains("a.preset"));
+
+    fs::rename(dir.path / "elsewhere", dir.path / "presets");
+    EXPECT_EQ(index.Scan(), 0u);
+    EXPECT_EQ(index.GetEntries().size(), 1u);
+}
@@ -0,0 +1,118 @@
+#include <clapeze/features/profilingFeature.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using clapeze::ProfilingFeature;
+
+namespace {
+// powers of two, so the window adds up exactly
+constexpr double kBlockSeconds = 0.125;
+}  // namespace
+
+TEST(ProfilingFeature, summarizesEachWindow) {
+    ProfilingFeature profiling(0.5f, 1.0);
+    profiling.OnActivated();
+
+    // loads of 0.125, 0.25, ... 1.0
+    for (int32_t block = 1; block <= 8; ++block) {
+        EXPECT_FALSE(profiling.Poll());
+        profiling.OnProcessed(kBlockSeconds * block * kBlockSeconds, kBlockSeconds);
+    }
+    ASSERT_TRUE(profiling.Poll());
+    EXPECT_FALSE(profiling.Poll());
+
+    const ProfilingFeature::Stats& stats = profiling.GetStats();
+    EXPECT_DOUBLE_EQ(stats.time, 1.0);
+    EXPECT_EQ(stats.numBlocks, 8u);
+    EXPECT_EQ(stats.numOverBudget, 4u);
+    EXPECT_FLOAT_EQ(stats.total.min, 0.125f);
+    EXPECT_FLOAT_EQ(stats.total.avg, 0.5625f);
+    EXPECT_FLOAT_EQ(stats.total.max, 1.0f);
+    // the histogram bin's top edge, capped to the max
+    EXPECT_FLOAT_EQ(stats.total.p99, 1.0f);
+    EXPECT_EQ(profiling.GetTotalOverBudget(), 4u);
+    EXPECT_EQ(profiling.GetHistory().size(), 1u);
+
+    // the next window starts fresh
+    for (int32_t block = 0; block < 8; ++block) {
+        profiling.OnProcessed(0.0, kBlockSeconds);
+    }
+    ASSERT_TRUE(profiling.Poll());
+    EXPECT_DOUBLE_EQ(profiling.GetStats().time, 2.0);
+    EXPECT_EQ(profiling.GetStats().numOverBudget, 0u);
+    EXPECT_EQ(profiling.GetStats().total.max, 0.0f);
+    EXPECT_EQ(profiling.GetTotalOverBudget(), 4u);
+    EXPECT_EQ(profiling.GetHistory().size(), 2u);
+}
+
+TEST(ProfilingFeature, timesStagesWithScope) {
+    ProfilingFeature profiling(0.7f, kBlockSeconds);
+    ProfilingFeature::StageId voices = profiling.AddStage("voices");
+    ProfilingFeature::StageId effects = profiling.AddStage("effects");
+    EXPECT_EQ(profiling.GetStageNames().size(), 2u);
+    profiling.OnActivated();
+
+    {
+        ProfilingFeature::Scope scope(&profiling, voices);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    {
+        // disabled, so this never counts
+        ProfilingFeature::Scope scope(nullptr, effects);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    profiling.OnProcessed(0.0, kBlockSeconds);
+    ASSERT_TRUE(profiling.Poll());
+
+    const ProfilingFeature::Stats& stats = profiling.GetStats();
+    EXPECT_GE(stats.stages[voices].max, 0.002f / kBlockSeconds);
+    EXPECT_EQ(stats.stages[effects].max, 0.0f);
+
+    std::stringstream csv;
+    profiling.WriteCsv(csv);
+    std::string line;
+    ASSERT_TRUE(std::getline(csv, line));
+    EXPECT_EQ(line, "plugin,time,stage,blocks,over_budget,min,avg,p99,max");
+    size_t numRows = 0;
+    while (std::getline(csv, line)) {
+        ++numRows;
+    }
+    // one per stage, plus the total
+    EXPECT_EQ(numRows, 3u);
+}
+
+TEST(ProfilingFeature, keepsBoundedHistory) {
+    ProfilingFeature profiling(0.7f, kBlockSeconds);
+    profiling.OnActivated();
+    for (size_t window = 0; window < ProfilingFeature::kMaxHistory + 10; ++window) {
+        profiling.OnProcessed(0.0, kBlockSeconds);
+        profiling.Poll();
+    }
+    ASSERT_EQ(profiling.GetHistory().size(), ProfilingFeature::kMaxHistory);
+    EXPECT_DOUBLE_EQ(profiling.GetHistory().front().time, 11 * kBlockSeconds);
+    EXPECT_DOUBLE_EQ(profiling.GetHistory().back().time, (ProfilingFeature::kMaxHistory + 10) * kBlockSeconds);
+}
+
+TEST(ProfilingFeature, activatingClearsEverything) {
+    ProfilingFeature profiling(0.5f, kBlockSeconds);
+    profiling.OnActivated();
+    profiling.OnProcessed(kBlockSeconds, kBlockSeconds);
+    ASSERT_TRUE(profiling.Poll());
+    // this window never gets polled before reactivating
+    profiling.OnProcessed(kBlockSeconds, kBlockSeconds);
+    EXPECT_EQ(profiling.GetTotalOverBudget(), 2u);
+
+    profiling.OnActivated();
+    EXPECT_FALSE(profiling.Poll());
+    EXPECT_TRUE(profiling.GetHistory().empty());
+    EXPECT_EQ(profiling.GetStats().numBlocks, 0u);
+    EXPECT_EQ(profiling.GetTotalOverBudget(), 0u);
+
+    // empty blocks are ignored
+    profiling.OnProcessed(1.0, 0.0);
+    EXPECT_FALSE(profiling.Poll());
+    EXPECT_EQ(profiling.GetTotalOverBudget(), 0u);
+}
@@ -0,0 +1,168 @@
+#include <clapeze/rtLogger.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using clapeze::LogSeverity;
+using clapeze::RtLogger;
+
+namespace {
+using Messages = std::vector<std::pair<LogSeverity, std::string>>;
+
+Messages DrainAll(RtLogger& log) {
+    Messages out;
+    log.Drain([&](LogSeverity severity, const std::string& message) { out.emplace_back(severity, message); });
+    return out;
+}
+
+// a host with timer support, that hands out timer ids starting from 0 like some real hosts do
+struct FakeTimerHost {
+    static const void* GetExtension(const clap_host_t* host, const char* id) {
+        static const clap_host_timer_support_t sTimers{_register_timer, _unregister_timer};
+        return std::strcmp(id, CLAP_EXT_TIMER_SUPPORT) == 0 ? &sTimers : nullptr;
+    }
+    static bool _register_timer(const clap_host_t* host, uint32_t periodMs, clap_id* timerId) {
+        auto* self = static_cast<FakeTimerHost*>(host->host_data);
+        *timerId = self->numRegistered++;
+        return true;
+    }
+    static bool _unregister_timer(const clap_host_t* host, clap_id timerId) {
+        static_cast<FakeTimerHost*>(host->host_data)->unregistered.push_back(timerId);
+        return true;
+    }
+
+    clap_id numRegistered = 0;
+    std::vector<clap_id> unregistered;
+    clap_host_t host{.clap_version = CLAP_VERSION_INIT,
+                     .host_data = this,
+                     .name = "Fake Timer Host",
+                     .vendor = "clapeze",
+                     .url = "https://crouton.net",
+                     .version = "0.0.0",
+                     .get_extension = GetExtension,
+                     .request_restart = [](const clap_host_t*) {},
+                     .request_process = [](const clap_host_t*) {},
+                     .request_callback = [](const clap_host_t*) {}};
+};
+}  // namespace
+
+TEST(RtLogger, formatsWhenDrained) {
+    RtLogger log;
+    const char* name = "voice";
+    log.Info("{} {} on key {} at {:.2f} ({}, {})", name, 3, 60u, 0.5, true, 'x');
+    log.Error("no args");
+
+    auto messages = DrainAll(log);
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0].first, LogSeverity::Info);
+    EXPECT_EQ(messages[0].second, "voice 3 on key 60 at 0.50 (true, x)");
+    EXPECT_EQ(messages[1].first, LogSeverity::Error);
+    EXPECT_EQ(messages[1].second, "no args");
+    EXPECT_TRUE(DrainAll(log).empty());
+}
+
+TEST(RtLogger, dropsAndReportsWhenFull) {
+    RtLogger log;
+    // a few laps around the ring, so every slot gets reused
+    for (size_t lap = 0; lap < 3; ++lap) {
+        for (size_t idx = 0; idx < RtLogger::kCapacity + 10; ++idx) {
+            log.Warning("message {}", idx);
+        }
+        auto messages = DrainAll(log);
+        ASSERT_EQ(messages.size(), RtLogger::kCapacity + 1);
+        EXPECT_EQ(messages.front().second, "message 0");
+        EXPECT_EQ(messages[RtLogger::kCapacity - 1].second, fmt::format("message {}", RtLogger::kCapacity - 1));
+        EXPECT_EQ(messages.back().first, LogSeverity::Warning);
+        EXPECT_EQ(messages.back().second, "RtLogger: dropped 10 messages, the queue was full");
+    }
+    EXPECT_EQ(log.GetNumDropped(), 30u);
+}
+
+TEST(RtLogger, keepsEachThreadsMessagesInOrder) {
+    constexpr size_t kNumThreads = 4;
+    constexpr size_t kPerThread = 20000;
+    RtLogger log;
+
+    std::vector<std::thread> producers;
+    for (size_t thread = 0; thread < kNumThreads; ++thread) {
+        producers.emplace_back([&log, thread] {
+            for (size_t idx = 0; idx < kPerThread; ++idx) {
+                log.Debug("{} {}", thread, idx);
+            }
+        });
+    }
+
+    std::vector<std::vector<size_t>> received(kNumThreads);
+    auto consume = [&](LogSeverity severity, const std::string& message) {
+        size_t thread = 0;
+        size_t idx = 0;
+        if (std::sscanf(message.c_str(), "%zu %zu", &thread, &idx) == 2) {
+            received[thread].push_back(idx);
+        }
+    };
+    for (size_t iter = 0; iter < 1000; ++iter) {
+        log.Drain(consume);
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    log.Drain(consume);
+
+    size_t numReceived = 0;
+    for (const std::vector<size_t>& messages : received) {
+        for (size_t idx = 1; idx < messages.size(); ++idx) {
+            ASSERT_LT(messages[idx - 1], messages[idx]);
+        }
+        numReceived += messages.size();
+    }
+    EXPECT_EQ(numReceived + log.GetNumDropped(), kNumThreads * kPerThread);
+}
+
+TEST(RtLogger, cancelsTimerWithIdZero) {
+    FakeTimerHost fake;
+    clapeze::PluginHost host(&fake.host);
+    Messages logged;
+    host.SetLogFn([&](LogSeverity severity, const std::string& message) { logged.emplace_back(severity, message); });
+
+    RtLogger log;
+    log.Start(host);
+    EXPECT_EQ(fake.numRegistered, 1u);
+    log.Info("hello");
+    log.Stop();
+    ASSERT_EQ(fake.unregistered.size(), 1u);
+    EXPECT_EQ(fake.unregistered[0], 0u);
+    ASSERT_EQ(logged.size(), 1u);
+    EXPECT_EQ(logged[0].second, "hello");
+
+    // stopping twice is fine
+    log.Stop();
+    EXPECT_EQ(fake.unregistered.size(), 1u);
+}
+
+TEST(RtLogger, drainsIntoHostWithoutTimers) {
+    clap_host_t rawHost{.clap_version = CLAP_VERSION_INIT,
+                        .host_data = nullptr,
+                        .name = "No Timer Host",
+                        .vendor = "clapeze",
+                        .url = "https://crouton.net",
+                        .version = "0.0.0",
+                        .get_extension = [](const clap_host_t*, const char*) -> const void* { return nullptr; },
+                        .request_restart = [](const clap_host_t*) {},
+                        .request_process = [](const clap_host_t*) {},
+                        .request_callback = [](const clap_host_t*) {}};
+    clapeze::PluginHost host(&rawHost);
+    Messages logged;
+    host.SetLogFn([&](LogSeverity severity, const std::string& message) { logged.emplace_back(severity, message); });
+
+    RtLogger log;
+    EXPECT_EQ(log.Drain(), 0u);
+    log.Start(host);
+    log.Info("first {}", 1);
+    EXPECT_EQ(log.Drain(), 1u);
+    ASSERT_EQ(logged.size(), 1u);
+    EXPECT_EQ(logged[0].second, "first 1");
+}
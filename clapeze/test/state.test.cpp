@@ -0,0 +1,277 @@
+#include <clapeze/basePlugin.h>
+#include <clapeze/features/params/dynamicParametersFeature.h>
+#include <clapeze/features/params/parameterTypes.h>
+#include <clapeze/features/state/binaryStateFeature.h>
+#include <clapeze/features/state/tomlStateFeature.h>
+#include <clapeze/impl/streamUtils.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using clapeze::StateFormat;
+using clapeze::params::DynamicParametersFeature;
+
+namespace {
+clap_host_t sHost{.clap_version = CLAP_VERSION_INIT,
+                  .host_data = nullptr,
+                  .name = "State Host",
+                  .vendor = "clapeze",
+                  .url = "https://crouton.net",
+                  .version = "0.0.0",
+                  .get_extension = [](const clap_host_t*, const char*) -> const void* { return nullptr; },
+                  .request_restart = [](const clap_host_t*) {},
+                  .request_process = [](const clap_host_t*) {},
+                  .request_callback = [](const clap_host_t*) {}};
+
+const clap_plugin_descriptor_t kDescriptor{.clap_version = CLAP_VERSION_INIT,
+                                           .id = "clapeze.test.state",
+                                           .name = "State",
+                                           .vendor = "clapeze",
+                                           .url = "",
+                                           .manual_url = "",
+                                           .support_url = "",
+                                           .version = "0.0.0",
+                                           .description = "",
+                                           .features = nullptr};
+
+int64_t WriteToString(const clap_ostream_t* stream, const void* buffer, uint64_t size) {
+    static_cast<std::string*>(stream->ctx)->append(static_cast<const char*>(buffer), size);
+    return static_cast<int64_t>(size);
+}
+
+// hands over a few bytes at a time from a std::string_view, like some hosts do
+int64_t ReadFewBytes(const clap_istream_t* stream, void* buffer, uint64_t size) {
+    auto& remaining = *static_cast<std::string_view*>(stream->ctx);
+    size_t count = std::min<size_t>({size, remaining.size(), 3});
+    std::memcpy(buffer, remaining.data(), count);
+    remaining.remove_prefix(count);
+    return static_cast<int64_t>(count);
+}
+
+class Processor : public clapeze::BaseProcessor {
+   public:
+    explicit Processor(clapeze::PluginHost& host) : clapeze::BaseProcessor(host) {}
+    void ProcessEvent(const clap_event_header_t& event) override {}
+    clapeze::ProcessStatus ProcessAudio(const clap_process_t& process, size_t blockStart, size_t blockStop) override {
+        return clapeze::ProcessStatus::Sleep;
+    }
+    void ProcessFlush(const clap_process_t& process) override {}
+};
+
+// stores a little extra state, and records migrations
+class StateFeature : public clapeze::TomlStateFeature<DynamicParametersFeature> {
+   public:
+    StateFeature(clapeze::BasePlugin& self, uint32_t saveVersion, StateFormat sessionFormat)
+        : TomlStateFeature(self, saveVersion, sessionFormat) {}
+    bool OnMigrate(toml::table& t, uint32_t currentVersion, uint32_t targetVersion) const override {
+        migratedFrom = currentVersion;
+        return true;
+    }
+    bool OnSave(toml::table& t) const override {
+        t.insert("extra", toml::table{{"answer", answer}});
+        return true;
+    }
+    bool OnLoad(const toml::table& t) override {
+        auto* extra = const_cast<toml::table&>(t)["extra"].as_table();
+        loadedAnswer = extra ? (*extra)["answer"].value_or(int64_t{0}) : 0;
+        return true;
+    }
+
+    int64_t answer{};
+    int64_t loadedAnswer{};
+    mutable std::optional<uint32_t> migratedFrom{};
+};
+
+struct Options {
+    std::vector<std::string> keys = {"a", "b", "c"};
+    uint32_t saveVersion = 0;
+    std::optional<StateFormat> sessionFormat{};
+    // use BinaryStateFeature instead of TomlStateFeature
+    bool binaryFeature = false;
+};
+
+class StatePlugin : public clapeze::BasePlugin {
+   public:
+    explicit StatePlugin(Options options) : clapeze::BasePlugin(kDescriptor), mOptions(std::move(options)) {
+        SetHost(&sHost);
+        EXPECT_TRUE(GetPluginObject()->init(GetPluginObject()));
+    }
+
+    void Set(const std::string& key, double value) {
+        mParams->GetMainHandle().SetRawValue(*mParams->GetIdFromKey(key), value);
+    }
+    double Get(const std::string& key) { return mParams->GetMainHandle().GetRawValue(*mParams->GetIdFromKey(key)); }
+    StateFeature& GetState() { return *mState; }
+
+    // through the clap extension, the way a host would
+    std::string SaveSession() {
+        std::string data;
+        clap_ostream_t stream{.ctx = &data, .write = WriteToString};
+        EXPECT_TRUE(GetStateExtension()->save(GetPluginObject(), &stream));
+        return data;
+    }
+    bool LoadSession(const std::string& data) {
+        std::string_view remaining = data;
+        clap_istream_t stream{.ctx = &remaining, .read = ReadFewBytes};
+        return GetStateExtension()->load(GetPluginObject(), &stream);
+    }
+
+   protected:
+    void Config() override {
+        mParams = &ConfigFeature<DynamicParametersFeature>(GetHost(), static_cast<clap_id>(mOptions.keys.size()));
+        for (clap_id id = 0; id < mOptions.keys.size(); ++id) {
+            const std::string& key = mOptions.keys[id];
+            mParams->Parameter(id, new clapeze::NumericParam(key, key, 0.0f, 1.0f, 0.5f));
+        }
+        if (mOptions.binaryFeature) {
+            ConfigFeature<clapeze::BinaryStateFeature<DynamicParametersFeature>>(*this);
+        } else if (mOptions.sessionFormat) {
+            mState = &ConfigFeature<StateFeature>(*this, mOptions.saveVersion, *mOptions.sessionFormat);
+        } else {
+            // the default
+            ConfigFeature<clapeze::TomlStateFeature<DynamicParametersFeature>>(*this, mOptions.saveVersion);
+        }
+        ConfigProcessor<Processor>();
+    }
+
+   private:
+    const clap_plugin_state_t* GetStateExtension() {
+        const clap_plugin_t* plugin = GetPluginObject();
+        return static_cast<const clap_plugin_state_t*>(plugin->get_extension(plugin, CLAP_EXT_STATE));
+    }
+
+    Options mOptions;
+    DynamicParametersFeature* mParams{};
+    StateFeature* mState{};
+};
+
+bool IsBinary(const std::string& data) {
+    return data.compare(0, clapeze::BinaryStateCodec::kMagic.size(), clapeze::BinaryStateCodec::kMagic.data(),
+                        clapeze::BinaryStateCodec::kMagic.size()) == 0;
+}
+}  // namespace
+
+TEST(TomlStateFeature, savesSessionsAsTomlByDefault) {
+    StatePlugin saved({});
+    saved.Set("b", 0.25);
+    std::string data = saved.SaveSession();
+    EXPECT_FALSE(IsBinary(data));
+    EXPECT_NE(data.find("params"), std::string::npos);
+
+    StatePlugin loaded({});
+    ASSERT_TRUE(loaded.LoadSession(data));
+    EXPECT_DOUBLE_EQ(loaded.Get("b"), 0.25);
+}
+
+TEST(TomlStateFeature, roundTripsBinarySessions) {
+    StatePlugin saved({.sessionFormat = StateFormat::Binary});
+    saved.Set("a", 0.125);
+    saved.Set("c", 1.0);
+    saved.GetState().answer = 42;
+    std::string data = saved.SaveSession();
+    ASSERT_TRUE(IsBinary(data));
+
+    StatePlugin loaded({.sessionFormat = StateFormat::Binary});
+    ASSERT_TRUE(loaded.LoadSession(data));
+    EXPECT_DOUBLE_EQ(loaded.Get("a"), 0.125);
+    EXPECT_DOUBLE_EQ(loaded.Get("b"), 0.5);
+    EXPECT_DOUBLE_EQ(loaded.Get("c"), 1.0);
+    EXPECT_EQ(loaded.GetState().loadedAnswer, 42);
+    EXPECT_FALSE(loaded.GetState().migratedFrom);
+}
+
+TEST(TomlStateFeature, matchesKeysWhenParamsChange) {
+    StatePlugin saved({.sessionFormat = StateFormat::Binary});
+    saved.Set("a", 0.125);
+    saved.Set("b", 0.25);
+    saved.Set("c", 0.75);
+    saved.GetState().answer = 7;
+    std::string data = saved.SaveSession();
+
+    // b was removed, d was added, and everything moved around
+    StatePlugin loaded({.keys = {"d", "c", "a"}, .sessionFormat = StateFormat::Binary});
+    ASSERT_TRUE(loaded.LoadSession(data));
+    EXPECT_DOUBLE_EQ(loaded.Get("a"), 0.125);
+    EXPECT_DOUBLE_EQ(loaded.Get("c"), 0.75);
+    EXPECT_DOUBLE_EQ(loaded.Get("d"), 0.5);
+    EXPECT_EQ(loaded.GetState().loadedAnswer, 7);
+    EXPECT_FALSE(loaded.GetState().migratedFrom);
+
+    // same keys, newer version: still goes through OnMigrate()
+    StatePlugin migrated({.saveVersion = 2, .sessionFormat = StateFormat::Binary});
+    ASSERT_TRUE(migrated.LoadSession(data));
+    EXPECT_EQ(migrated.GetState().migratedFrom, 0u);
+    EXPECT_DOUBLE_EQ(migrated.Get("b"), 0.25);
+}
+
+TEST(TomlStateFeature, fallsBackToToml) {
+    StatePlugin saved({.sessionFormat = StateFormat::Toml});
+    saved.Set("a", 0.875);
+    saved.GetState().answer = 3;
+    std::string data = saved.SaveSession();
+    ASSERT_FALSE(IsBinary(data));
+
+    StatePlugin loaded({.sessionFormat = StateFormat::Binary});
+    ASSERT_TRUE(loaded.LoadSession(data));
+    EXPECT_DOUBLE_EQ(loaded.Get("a"), 0.875);
+    EXPECT_EQ(loaded.GetState().loadedAnswer, 3);
+}
+
+TEST(BinaryStateFeature, roundTripsAndMatchesKeys) {
+    StatePlugin saved({.binaryFeature = true});
+    saved.Set("a", 0.125);
+    saved.Set("b", 0.25);
+    std::string data = saved.SaveSession();
+    ASSERT_TRUE(IsBinary(data));
+
+    StatePlugin same({.binaryFeature = true});
+    ASSERT_TRUE(same.LoadSession(data));
+    EXPECT_DOUBLE_EQ(same.Get("a"), 0.125);
+    EXPECT_DOUBLE_EQ(same.Get("b"), 0.25);
+
+    StatePlugin changed({.keys = {"b", "z"}, .binaryFeature = true});
+    ASSERT_TRUE(changed.LoadSession(data));
+    EXPECT_DOUBLE_EQ(changed.Get("b"), 0.25);
+    EXPECT_DOUBLE_EQ(changed.Get("z"), 0.5);
+}
+
+TEST(BinaryStateFeature, loadsLegacyState) {
+    // before BinaryStateCodec: every raw value in id order, and nothing else
+    std::vector<double> values = {0.125, 0.25, 0.75};
+    std::string data(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+    ASSERT_FALSE(IsBinary(data));
+
+    StatePlugin loaded({.binaryFeature = true});
+    ASSERT_TRUE(loaded.LoadSession(data));
+    EXPECT_DOUBLE_EQ(loaded.Get("a"), 0.125);
+    EXPECT_DOUBLE_EQ(loaded.Get("b"), 0.25);
+    EXPECT_DOUBLE_EQ(loaded.Get("c"), 0.75);
+
+    // too short
+    StatePlugin truncated({.binaryFeature = true});
+    EXPECT_FALSE(truncated.LoadSession(data.substr(0, 2 * sizeof(double))));
+}
+
+TEST(ClapIstream, readsAcrossPeeksAndShortReads) {
+    std::string data = "0123456789abcdefghij";
+    std::string_view remaining = data;
+    clap_istream_t raw{.ctx = &remaining, .read = ReadFewBytes};
+    clapeze::impl::clap_istream in(&raw);
+
+    // peek() makes the streambuf buffer a few bytes, which read() has to hand over before asking for more
+    EXPECT_EQ(in.peek(), '0');
+    std::string first(12, '\0');
+    in.read(first.data(), static_cast<std::streamsize>(first.size()));
+    ASSERT_TRUE(in);
+    EXPECT_EQ(first, "0123456789ab");
+
+    std::string rest(16, '\0');
+    in.read(rest.data(), static_cast<std::streamsize>(rest.size()));
+    EXPECT_EQ(in.gcount(), 8);
+    EXPECT_EQ(rest.substr(0, 8), "cdefghij");
+    EXPECT_TRUE(in.eof());
+}
@@ -0,0 +1,302 @@
+#include <clapeze/basePlugin.h>
+#include <clapeze/features/threadPoolFeature.h>
+#include <clapeze/processor/voice.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr size_t kBlockSize = 16;
+constexpr size_t kMaxVoices = 8;
+
+clap_host_t MakeHost(void* hostData, const void* (*getExtension)(const clap_host_t*, const char*)) {
+    return clap_host_t{.clap_version = CLAP_VERSION_INIT,
+                       .host_data = hostData,
+                       .name = "Voice Pool Host",
+                       .vendor = "clapeze",
+                       .url = "https://crouton.net",
+                       .version = "0.0.0",
+                       .get_extension = getExtension,
+                       .request_restart = [](const clap_host_t*) {},
+                       .request_process = [](const clap_host_t*) {},
+                       .request_callback = [](const clap_host_t*) {}};
+}
+
+const void* NoExtensions(const clap_host_t*, const char*) {
+    return nullptr;
+}
+
+class Processor : public clapeze::BaseProcessor {
+   public:
+    explicit Processor(clapeze::PluginHost& host) : clapeze::BaseProcessor(host) {}
+    void ProcessEvent(const clap_event_header_t& event) override {}
+    clapeze::ProcessStatus ProcessAudio(const clap_process_t& process, size_t blockStart, size_t blockStop) override {
+        return clapeze::ProcessStatus::Sleep;
+    }
+    void ProcessFlush(const clap_process_t& process) override {}
+};
+
+class NoteCounter : public clapeze::params::BaseAudioHandle {
+   public:
+    bool ProcessEvent(const clap_event_header_t& event) override { return false; }
+    void FlushEventsFromMain(clapeze::BaseProcessor& processor, const clap_output_events_t* out) override {}
+    void OnNoteStart(const clapeze::NoteTuple& note) override { ++numStarted; }
+    void OnNoteEnd(const clapeze::NoteTuple& note) override { ++numEnded; }
+
+    size_t numStarted{};
+    size_t numEnded{};
+};
+
+// a ramp that depends on the key, and only lasts as many blocks as the key is above middle C
+class Voice {
+   public:
+    Voice(Processor& processor, size_t idx) {}
+    void ProcessNoteOn(const clapeze::NoteTuple& note, float velocity) {
+        mLevel = velocity * static_cast<float>(note.key) / 127.0f;
+        mBlocksLeft = note.key - 60;
+    }
+    void ProcessNoteOff() {}
+    void ProcessChoke() { mBlocksLeft = 0; }
+    void Reset() { mBlocksLeft = 0; }
+    bool ProcessAudio(clapeze::StereoAudioBuffer& out) {
+        ++numProcessed;
+        for (size_t idx = 0; idx < out.left.size(); ++idx) {
+            mPhase += mLevel * 0.01f;
+            out.left[idx] += mPhase;
+            out.right[idx] -= mPhase;
+        }
+        return --mBlocksLeft > 0;
+    }
+
+    size_t numProcessed{};
+
+   private:
+    float mLevel{};
+    float mPhase{};
+    int32_t mBlocksLeft{};
+};
+
+using Pool = clapeze::VoicePool<Processor, Voice, kMaxVoices>;
+
+struct Buffer {
+    std::array<float, kBlockSize> left{};
+    std::array<float, kBlockSize> right{};
+    clapeze::StereoAudioBuffer Get() { return {left, right, false, false}; }
+};
+
+void PlayChord(Pool& pool) {
+    for (int16_t key = 61; key < 61 + static_cast<int16_t>(kMaxVoices); ++key) {
+        pool.ProcessNoteOn(clapeze::NoteTuple{.key = key}, 0.8f);
+    }
+}
+
+// renders the pool in groups, the same way a processor would from ThreadPoolFeature tasks
+template <typename TRun>
+Buffer ProcessInGroups(Pool& pool, size_t numGroups, TRun&& run) {
+    std::vector<Buffer> groups(numGroups);
+    size_t groupSize = kMaxVoices / numGroups;
+    run(static_cast<uint32_t>(numGroups), [&](uint32_t group) {
+        clapeze::StereoAudioBuffer out = groups[group].Get();
+        pool.ProcessAudioRange(group * groupSize, (group + 1) * groupSize, out);
+    });
+    pool.EndFinishedVoices();
+
+    Buffer mixed;
+    clapeze::StereoAudioBuffer out = mixed.Get();
+    for (Buffer& group : groups) {
+        out.Add(group.Get());
+    }
+    return mixed;
+}
+
+void ExpectNear(const Buffer& expected, const Buffer& actual, size_t block) {
+    // the groups are summed in a different order, so allow for rounding
+    for (size_t idx = 0; idx < kBlockSize; ++idx) {
+        EXPECT_NEAR(expected.left[idx], actual.left[idx], 1e-5f) << "in block " << block << " at sample " << idx;
+        EXPECT_NEAR(expected.right[idx], actual.right[idx], 1e-5f) << "in block " << block << " at sample " << idx;
+    }
+}
+
+void RunSerially(uint32_t numTasks, const std::function<void(uint32_t)>& fn) {
+    for (uint32_t task = 0; task < numTasks; ++task) {
+        fn(task);
+    }
+}
+
+// a host with a thread pool, that runs every task on its own thread
+struct ThreadedHost {
+    static const void* GetExtension(const clap_host_t* host, const char* id) {
+        static const clap_host_thread_pool_t sThreadPool{_request_exec};
+        return std::strcmp(id, CLAP_EXT_THREAD_POOL) == 0 ? &sThreadPool : nullptr;
+    }
+    static bool _request_exec(const clap_host_t* host, uint32_t numTasks) {
+        auto* self = static_cast<ThreadedHost*>(host->host_data);
+        ++self->numRequests;
+        if (self->busy) {
+            return false;
+        }
+        auto* threadPool = static_cast<const clap_plugin_thread_pool_t*>(
+            self->plugin->get_extension(self->plugin, CLAP_EXT_THREAD_POOL));
+        std::vector<std::thread> threads;
+        for (uint32_t task = 0; task < numTasks; ++task) {
+            threads.emplace_back([=] { threadPool->exec(self->plugin, task); });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        return true;
+    }
+
+    const clap_plugin_t* plugin{};
+    size_t numRequests{};
+    bool busy{};
+    clap_host_t host = MakeHost(this, GetExtension);
+};
+
+const clap_plugin_descriptor_t kDescriptor{.clap_version = CLAP_VERSION_INIT,
+                                           .id = "clapeze.test.threads",
+                                           .name = "Threads",
+                                           .vendor = "clapeze",
+                                           .url = "",
+                                           .manual_url = "",
+                                           .support_url = "",
+                                           .version = "0.0.0",
+                                           .description = "",
+                                           .features = nullptr};
+
+class ThreadsPlugin : public clapeze::BasePlugin {
+   public:
+    explicit ThreadsPlugin(const clap_host_t& host) : clapeze::BasePlugin(kDescriptor) {
+        SetHost(&host);
+        EXPECT_TRUE(GetPluginObject()->init(GetPluginObject()));
+    }
+    clapeze::ThreadPoolFeature& GetThreads() {
+        return clapeze::BaseFeature::GetFromPlugin<clapeze::ThreadPoolFeature>(*this);
+    }
+    Processor& GetPoolProcessor() { return static_cast<Processor&>(GetProcessor()); }
+
+   protected:
+    void Config() override {
+        ConfigFeature<clapeze::ThreadPoolFeature>();
+        ConfigProcessor<Processor>();
+    }
+};
+}  // namespace
+
+TEST(VoicePool, rangesMatchProcessAudio) {
+    clap_host_t rawHost = MakeHost(nullptr, NoExtensions);
+    clapeze::PluginHost host(&rawHost);
+    Processor processor(host);
+    NoteCounter serialNotes;
+    NoteCounter groupedNotes;
+    Pool serial(processor, serialNotes);
+    Pool grouped(processor, groupedNotes);
+    PlayChord(serial);
+    PlayChord(grouped);
+
+    for (size_t block = 0; block < kMaxVoices + 1; ++block) {
+        Buffer expected;
+        clapeze::StereoAudioBuffer out = expected.Get();
+        serial.ProcessAudio(out);
+        Buffer actual = ProcessInGroups(grouped, 4, RunSerially);
+        ExpectNear(expected, actual, block);
+        EXPECT_EQ(serial.CountNumActiveVoices(), grouped.CountNumActiveVoices()) << "in block " << block;
+        EXPECT_EQ(serialNotes.numEnded, groupedNotes.numEnded) << "in block " << block;
+    }
+    EXPECT_EQ(grouped.CountNumActiveVoices(), 0u);
+    EXPECT_EQ(groupedNotes.numEnded, kMaxVoices);
+}
+
+TEST(VoicePool, endsVoicesOnlyWhenAsked) {
+    clap_host_t rawHost = MakeHost(nullptr, NoExtensions);
+    clapeze::PluginHost host(&rawHost);
+    Processor processor(host);
+    NoteCounter notes;
+    Pool pool(processor, notes);
+    pool.ProcessNoteOn(clapeze::NoteTuple{.key = 61}, 1.0f);
+
+    Buffer buffer;
+    clapeze::StereoAudioBuffer out = buffer.Get();
+    pool.ProcessAudioRange(0, kMaxVoices, out);
+    // finished, but still holding its note until EndFinishedVoices()
+    EXPECT_EQ(pool.CountNumActiveVoices(), 1u);
+    EXPECT_EQ(notes.numEnded, 0u);
+
+    // and it isn't processed again in the meantime
+    pool.ProcessAudioRange(0, kMaxVoices, out);
+    size_t numProcessed = 0;
+    for (Voice& voice : pool.IterAll()) {
+        numProcessed += voice.numProcessed;
+    }
+    EXPECT_EQ(numProcessed, 1u);
+
+    pool.EndFinishedVoices();
+    EXPECT_EQ(pool.CountNumActiveVoices(), 0u);
+    EXPECT_EQ(notes.numEnded, 1u);
+    pool.EndFinishedVoices();
+    EXPECT_EQ(notes.numEnded, 1u);
+}
+
+TEST(ThreadPoolFeature, threadedMixMatchesSerial) {
+    ThreadedHost threadedHost;
+    ThreadsPlugin plugin(threadedHost.host);
+    threadedHost.plugin = plugin.GetPluginObject();
+    clapeze::ThreadPoolFeature& threads = plugin.GetThreads();
+    ASSERT_TRUE(threads.IsHostSupported());
+
+    NoteCounter serialNotes;
+    NoteCounter threadedNotes;
+    Pool serial(plugin.GetPoolProcessor(), serialNotes);
+    Pool threaded(plugin.GetPoolProcessor(), threadedNotes);
+    PlayChord(serial);
+    PlayChord(threaded);
+
+    auto runThreaded = [&](uint32_t numTasks, const std::function<void(uint32_t)>& fn) { threads.Run(numTasks, fn); };
+    for (size_t block = 0; block < kMaxVoices + 1; ++block) {
+        Buffer expected = ProcessInGroups(serial, 4, RunSerially);
+        Buffer actual = ProcessInGroups(threaded, 4, runThreaded);
+        EXPECT_EQ(expected.left, actual.left) << "in block " << block;
+        EXPECT_EQ(expected.right, actual.right) << "in block " << block;
+        EXPECT_EQ(serialNotes.numEnded, threadedNotes.numEnded) << "in block " << block;
+    }
+    EXPECT_EQ(threadedHost.numRequests, kMaxVoices + 1);
+    EXPECT_EQ(threadedNotes.numEnded, kMaxVoices);
+}
+
+TEST(ThreadPoolFeature, runsSeriallyWithoutHostThreads) {
+    clap_host_t rawHost = MakeHost(nullptr, NoExtensions);
+    ThreadsPlugin plugin(rawHost);
+    clapeze::ThreadPoolFeature& threads = plugin.GetThreads();
+    EXPECT_FALSE(threads.IsHostSupported());
+
+    std::thread::id audioThread = std::this_thread::get_id();
+    std::vector<uint32_t> order;
+    threads.Run(4, [&](uint32_t task) {
+        EXPECT_EQ(std::this_thread::get_id(), audioThread);
+        order.push_back(task);
+    });
+    EXPECT_EQ(order, (std::vector<uint32_t>{0, 1, 2, 3}));
+}
+
+TEST(ThreadPoolFeature, runsSeriallyWhenHostIsBusy) {
+    ThreadedHost threadedHost;
+    threadedHost.busy = true;
+    ThreadsPlugin plugin(threadedHost.host);
+    threadedHost.plugin = plugin.GetPluginObject();
+    clapeze::ThreadPoolFeature& threads = plugin.GetThreads();
+
+    std::thread::id audioThread = std::this_thread::get_id();
+    std::vector<uint32_t> order;
+    threads.Run(3, [&](uint32_t task) {
+        EXPECT_EQ(std::this_thread::get_id(), audioThread);
+        order.push_back(task);
+    });
+    EXPECT_EQ(order, (std::vector<uint32_t>{0, 1, 2}));
+    EXPECT_EQ(threadedHost.numRequests, 1u);
+
+    // a single task never asks the host
+    threads.Run(1, [&](uint32_t task) { order.push_back(task); });
+    EXPECT_EQ(threadedHost.numRequests, 1u);
+}
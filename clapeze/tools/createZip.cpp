@@ -1,12 +1,45 @@
 #include <miniz.h>
 #include <miniz_zip.h>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace {
+// formats that are already compressed. deflating these again barely saves anything, and stored entries can be read
+// straight out of the mapped archive without a copy (see clapeze::AssetArchive)
+constexpr std::array<std::string_view, 12> kStoredExtensions = {
+    ".png", ".jpg", ".jpeg", ".webp", ".ktx2", ".glb", ".ogg", ".opus", ".mp3", ".flac", ".zip", ".gz",
+};
+
+bool IsAlreadyCompressed(std::string_view path) {
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string_view::npos) {
+        return false;
+    }
+    std::string extension(path.substr(dot));
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return std::find(kStoredExtensions.begin(), kStoredExtensions.end(), extension) != kStoredExtensions.end();
+}
+}  // namespace
 
 int main(int argc, const char* argv[]) {
-    if (argc < 3) {
-        printf("usage: %s <archive.zip> [file1, file2...]\n", argv[0]);
+    int firstArg = 1;
+    bool compress = false;
+    if (argc > 1 && std::string_view(argv[1]) == "--compress") {
+        compress = true;
+        firstArg++;
+    }
+    if (argc - firstArg < 2) {
+        printf("usage: %s [--compress] <archive.zip> [file1, file2...]\n", argv[0]);
+        printf("  --compress: deflate files, except for formats that are already compressed (png, glb, ogg...)\n");
+        printf("              by default, every file is stored uncompressed\n");
         return 0;
     }
-    const char* outputFile = argv[1];
+    const char* outputFile = argv[firstArg];
     mz_zip_archive zip;
     mz_zip_archive* pZip = &zip;
     mz_zip_zero_struct(pZip);
@@ -18,11 +51,13 @@ int main(int argc, const char* argv[]) {
         return 1;
     }
 
-    for (uint32_t idx = 2; idx < argc; ++idx) {
+    for (int idx = firstArg + 1; idx < argc; ++idx) {
         const char* targetPath = argv[idx];
         const char* srcPath = argv[idx];
-        printf("Adding %s\n", srcPath);
-        if (!mz_zip_writer_add_file(pZip, targetPath, srcPath, nullptr, 0, MZ_NO_COMPRESSION)) {
+        bool store = !compress || IsAlreadyCompressed(srcPath);
+        printf("Adding %s (%s)\n", srcPath, store ? "stored" : "deflated");
+        mz_uint level = store ? MZ_NO_COMPRESSION : MZ_BEST_COMPRESSION;
+        if (!mz_zip_writer_add_file(pZip, targetPath, srcPath, nullptr, 0, level)) {
             mz_zip_error e = mz_zip_get_last_error(pZip);
             printf("ERROR: %s\n", mz_zip_get_error_string(e));
             return 1;
@@ -38,4 +73,4 @@ int main(int argc, const char* argv[]) {
     mz_zip_writer_end(pZip);
     printf("Archive complete!\n");
     return 0;
-}
\ No newline at end of file
+}
@@ -2,7 +2,7 @@
 #include <clapeze/entryPoint.h>
 #include <clapeze/features/params/enumParametersFeature.h>
 #include <clapeze/features/params/parameterTypes.h>
-#include <kitdsp/apps/chorus.h>
+#include <kitdsp/apps/ensembleChorus.h>
 
 #include <clapeze/processor/baseProcessor.h>
 #include "clapeze/features/assetsFeature.h"
@@ -17,7 +17,7 @@
 #endif
 
 namespace {
-enum class Params : clap_id { Rate, Depth, Delay, Feedback, Mix, Count };
+enum class Params : clap_id { Rate, Depth, Delay, Feedback, Mix, Voices, Count };
 using ParamsFeature = clapeze::params::EnumParametersFeature<Params>;
 }  // namespace
 
@@ -46,6 +46,17 @@ template <>
 struct ParamTraits<Params, Params::Mix> : public clapeze::PercentParam {
     ParamTraits() : clapeze::PercentParam("Mix", "Mix", 0.5f) {}
 };
+
+template <>
+struct ParamTraits<Params, Params::Voices> : public clapeze::IntegerParam {
+    ParamTraits()
+        : clapeze::IntegerParam("Voices",
+                                "Voices",
+                                2,
+                                static_cast<int32_t>(kitdsp::EnsembleChorus::kMaxVoices),
+                                2,
+                                "voices") {}
+};
 }  // namespace clapeze::params
 
 using namespace clapeze;
@@ -63,14 +74,9 @@ class Processor : public EffectProcessor<ParamsFeature::AudioHandle> {
         mChorus->cfg.delayModMs = mChorus->cfg.delayBaseMs * mParams.Get<Params::Depth>();
         mChorus->cfg.feedback = mParams.Get<Params::Feedback>();
         mChorus->cfg.mix = mParams.Get<Params::Mix>();
+        mChorus->cfg.numVoices = static_cast<size_t>(mParams.Get<Params::Voices>());
 
-        for (size_t idx = 0; idx < in.left.size(); ++idx) {
-            kitdsp::float_2 processed = mChorus->Process(kitdsp::float_2(in.left[idx], in.right[idx]));
-
-            // outputs
-            out.left[idx] = processed.left;
-            out.right[idx] = processed.right;
-        }
+        mChorus->Process(in.left, in.right, out.left, out.right);
         return ProcessStatus::Continue;
     }
 
@@ -84,13 +90,13 @@ class Processor : public EffectProcessor<ParamsFeature::AudioHandle> {
 
         mBufLen = static_cast<size_t>(sampleRatef * maxSizeSeconds);
         mBuf.reset(new float[mBufLen]);
-        mChorus = std::make_unique<kitdsp::Chorus>(etl::span(mBuf.get(), mBufLen), sampleRatef);
+        mChorus = std::make_unique<kitdsp::EnsembleChorus>(etl::span(mBuf.get(), mBufLen), sampleRatef);
     }
 
    private:
     std::unique_ptr<float[]> mBuf;
     size_t mBufLen;
-    std::unique_ptr<kitdsp::Chorus> mChorus;
+    std::unique_ptr<kitdsp::EnsembleChorus> mChorus;
 };
 
 #if KITSBLIPS_ENABLE_GUI
@@ -100,12 +106,14 @@ class GuiApp : public kitgui::BaseApp {
     void OnUpdate() override {
         mParams.FlushFromAudio();
         ImGui::TextWrapped(
-            "KitsChorus is currently based on the Juno-60 chorus algorithm. More algorithms Soon(tm), maybe?");
+            "KitsChorus is based on the Juno-60 chorus algorithm. Add more voices for a thicker, string-ensemble style "
+            "sound.");
         kitgui::DebugParam<ParamsFeature, Params::Rate>(mParams);
         kitgui::DebugParam<ParamsFeature, Params::Depth>(mParams);
         kitgui::DebugParam<ParamsFeature, Params::Delay>(mParams);
         kitgui::DebugParam<ParamsFeature, Params::Feedback>(mParams);
         kitgui::DebugParam<ParamsFeature, Params::Mix>(mParams);
+        kitgui::DebugParam<ParamsFeature, Params::Voices>(mParams);
     }
 
    private:
@@ -128,7 +136,8 @@ class Plugin : public EffectPlugin {
                                     .Parameter<Params::Depth>()
                                     .Parameter<Params::Delay>()
                                     .Parameter<Params::Feedback>()
-                                    .Parameter<Params::Mix>();
+                                    .Parameter<Params::Mix>()
+                                    .Parameter<Params::Voices>();
         ConfigFeature<TomlStateFeature<ParamsFeature>>(*this);
 #if KITSBLIPS_ENABLE_GUI
         ConfigFeature<clapeze::AssetsFeature>();
@@ -140,5 +149,5 @@ class Plugin : public EffectPlugin {
     }
 };
 
-CLAPEZE_REGISTER_PLUGIN(Plugin, AudioEffectDescriptor("kitsblips.chorus", "KitsChorus", "2-voice Chorus effect."));
+CLAPEZE_REGISTER_PLUGIN(Plugin, AudioEffectDescriptor("kitsblips.chorus", "KitsChorus", "Multi-voice Chorus/Ensemble effect."));
 }  // namespace chorus
@@ -6,9 +6,12 @@
 #include <kitdsp/filters/onePole.h>
 #include <kitdsp/math/units.h>
 #include <kitdsp/math/util.h>
+#include <kitdsp/volume/truePeakLimiter.h>
+#include <memory>
 
 #include <clapeze/processor/baseProcessor.h>
 #include "clapeze/features/assetsFeature.h"
+#include "clapeze/features/latencyFeature.h"
 #include "clapeze/features/state/tomlStateFeature.h"
 #include "descriptor.h"
 
@@ -111,7 +114,8 @@ class ToneFilter {
 
 class Processor : public EffectProcessor<ParamsFeature::AudioHandle> {
    public:
-    explicit Processor(clapeze::PluginHost& host, ParamsFeature::AudioHandle& params) : EffectProcessor(host, params) {}
+    Processor(clapeze::PluginHost& host, ParamsFeature::AudioHandle& params, LatencyFeature& latency)
+        : EffectProcessor(host, params), mLatency(latency) {}
     ~Processor() = default;
 
     ProcessStatus ProcessAudio(const StereoAudioBuffer& in, StereoAudioBuffer& out) override {
@@ -145,6 +149,9 @@ class Processor : public EffectProcessor<ParamsFeature::AudioHandle> {
             out.right[idx] = kitdsp::lerp(right, processedRight, mixf);
         }
 
+        // gain and makeup can easily push fold/rectify well past full scale, so keep the output under the ceiling
+        mLimiter->Process(out.left, out.right, out.left, out.right);
+
         return ProcessStatus::Continue;
     }
 
@@ -155,6 +162,7 @@ class Processor : public EffectProcessor<ParamsFeature::AudioHandle> {
         tonePreRight.Reset();
         tonePostLeft.Reset();
         tonePostRight.Reset();
+        mLimiter->Reset();
     }
 
     void Activate(double sampleRate, size_t minBlockSize, size_t maxBlockSize) override {
@@ -165,6 +173,9 @@ class Processor : public EffectProcessor<ParamsFeature::AudioHandle> {
         tonePreRight = ToneFilter(sampleRatef);
         tonePostLeft = ToneFilter(sampleRatef);
         tonePostRight = ToneFilter(sampleRatef);
+        mLimiter = std::make_unique<kitdsp::TruePeakLimiter<>>(sampleRatef);
+        // the lookahead is fixed in ms, so it's only known once the sample rate is
+        mLatency.ChangeLatency(static_cast<uint32_t>(mLimiter->GetLatencySamples()));
     }
 
    private:
@@ -175,6 +186,8 @@ class Processor : public EffectProcessor<ParamsFeature::AudioHandle> {
     ToneFilter tonePreRight{cSampleRate};
     ToneFilter tonePostLeft{cSampleRate};
     ToneFilter tonePostRight{cSampleRate};
+    std::unique_ptr<kitdsp::TruePeakLimiter<>> mLimiter{};
+    LatencyFeature& mLatency;
 };
 
 #if KITSBLIPS_ENABLE_GUI
@@ -212,13 +225,14 @@ class Plugin : public EffectPlugin {
                                     .Parameter<Params::Makeup>()
                                     .Parameter<Params::Mix>();
         ConfigFeature<TomlStateFeature<ParamsFeature>>(*this);
+        LatencyFeature& latency = ConfigFeature<LatencyFeature>(0);
 #if KITSBLIPS_ENABLE_GUI
         ConfigFeature<clapeze::AssetsFeature>();
         ConfigFeature<KitguiFeature>(GetHost(),
                                      [&params](kitgui::Context& ctx) { return std::make_unique<GuiApp>(ctx, params); });
 #endif
 
-        ConfigProcessor<Processor>(params.GetAudioHandle<ParamsFeature::AudioHandle>());
+        ConfigProcessor<Processor>(params.GetAudioHandle<ParamsFeature::AudioHandle>(), latency);
     }
 };
 
@@ -6,9 +6,11 @@
 #include <clapeze/features/params/baseParameter.h>
 #include <clapeze/features/params/dynamicParametersFeature.h>
 #include <clapeze/features/params/parameterTypes.h>
+#include <clapeze/features/profilingFeature.h>
 #include <imgui.h>
 #include <kitgui/controls/knob.h>
 #include <kitgui/controls/toggleSwitch.h>
+#include <sstream>
 
 /**
  * TODO: consider rewriting this to be non-specific and instead work off of only what BaseParam provides (this is what
@@ -128,6 +130,51 @@ inline void DebugParam(clapeze::params::DynamicParametersFeature& feature, clap_
         handle.StopGesture(index);
     }
 }
+
+/**
+ * Shows the latest window of CPU load from a ProfilingFeature, as a percentage of each block's duration. Call Poll() on
+ * the feature first.
+ */
+inline void DebugProfiler(const char* title, clapeze::ProfilingFeature& profiling, bool* open = nullptr) {
+    if (!ImGui::Begin(title, open)) {
+        ImGui::End();
+        return;
+    }
+    const clapeze::ProfilingFeature::Stats& stats = profiling.GetStats();
+    ImGui::Text("%u blocks, %u over the %.0f%% budget (%llu since activation)", stats.numBlocks, stats.numOverBudget,
+                profiling.GetBudget() * 100.0f, static_cast<unsigned long long>(profiling.GetTotalOverBudget()));
+
+    if (ImGui::BeginTable("profiler", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("stage");
+        ImGui::TableSetupColumn("min");
+        ImGui::TableSetupColumn("avg");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("max");
+        ImGui::TableHeadersRow();
+        auto Row = [](const char* name, const clapeze::ProfilingFeature::Timing& timing) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(name);
+            for (float value : {timing.min, timing.avg, timing.p99, timing.max}) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f%%", value * 100.0f);
+            }
+        };
+        Row("total", stats.total);
+        const auto& names = profiling.GetStageNames();
+        for (size_t idx = 0; idx < names.size(); ++idx) {
+            Row(names[idx].c_str(), stats.stages[idx]);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Copy CSV")) {
+        std::stringstream ss;
+        profiling.WriteCsv(ss);
+        ImGui::SetClipboardText(ss.str().c_str());
+    }
+    ImGui::End();
+}
 }  // namespace kitgui
 
 #endif
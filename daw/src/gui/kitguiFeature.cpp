@@ -88,7 +88,7 @@ KitguiFeature::~KitguiFeature() {
 
 void KitguiFeature::Configure(BasePlugin& self) {
     GuiFeature::Configure(self);
-    mCtx.SetFileLoader([&self](std::string_view path) -> std::optional<std::string> {
+    mCtx.SetFileLoader([&self](std::string_view path) -> std::optional<kitgui::FileData> {
         auto& assets = clapeze::AssetsFeature::GetFromPlugin<clapeze::AssetsFeature>(self);
         std::string pathstr{path};
         bool isPlugin = true; 
@@ -99,15 +99,18 @@ void KitguiFeature::Configure(BasePlugin& self) {
             pathstr = pathstr.substr(7);
             isPlugin = false;
         }
-        std::string out;
         if(isPlugin) {
-            miniz_istream stream = assets.OpenFromPlugin(pathstr.c_str());
-            out = clapeze::impl::istream_tostring(stream);
-        } else {
-            std::ifstream stream = assets.OpenFromFilesystem(pathstr.c_str());
-            out = clapeze::impl::istream_tostring(stream);
+            // stored assets point into the mapped plugin binary, which stays mapped for as long as the plugin (and so
+            // its gui) is around, so they're passed through without copying. decompressed ones bring their owner along
+            std::optional<AssetData> data = assets.ReadFromPlugin(pathstr);
+            if (!data) {
+                return std::nullopt;
+            }
+            return kitgui::FileData{data->view(), data->owner};
         }
-        return out;
+        std::ifstream stream = assets.OpenFromFilesystem(pathstr.c_str());
+        auto out = std::make_shared<std::string>(clapeze::impl::istream_tostring(stream));
+        return kitgui::FileData{*out, out};
     });
 }
 
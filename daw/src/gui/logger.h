@@ -3,9 +3,9 @@
 #include "clapeze/pluginHost.h"
 #if KITSBLIPS_ENABLE_GUI
 #include <imgui.h>
-#include <mutex>
 
-// From imgui demo (+ a mutex to be used from audio thread) (don't ship with that, obviously)
+// From imgui demo. Main thread only: audio thread code should log through a clapeze::RtLogger, which drains into
+// PluginHost::Log(), and from there into here.
 // Usage:
 //  static ExampleAppLog my_log;
 //  my_log.AddLog("Hello %d world\n", 123);
@@ -16,7 +16,6 @@ struct ExampleAppLog {
     ImVector<int> LineOffsets;  // Index to lines offset. We maintain this with AddLog() calls.
     bool AutoScroll;            // Keep scrolling if already at the bottom.
     bool Show = false;
-    std::recursive_mutex mtx;
 
     ExampleAppLog() {
         AutoScroll = true;
@@ -46,14 +45,12 @@ struct ExampleAppLog {
     }
 
     void Clear() {
-        std::lock_guard<std::recursive_mutex> guard(mtx);
         Buf.clear();
         LineOffsets.clear();
         LineOffsets.push_back(0);
     }
 
     void AddLog(const char* fmt, ...) IM_FMTARGS(2) {
-        std::lock_guard<std::recursive_mutex> guard(mtx);
         int old_size = Buf.size();
         va_list args;
         va_start(args, fmt);
@@ -89,7 +86,6 @@ struct ExampleAppLog {
         ImGui::Separator();
 
         if (ImGui::BeginChild("scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar)) {
-            std::lock_guard<std::recursive_mutex> guard(mtx);
             if (clear)
                 Clear();
             if (copy)
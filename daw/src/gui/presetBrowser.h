@@ -8,11 +8,13 @@
 #include <clapeze/features/params/baseParameter.h>
 #include <clapeze/features/params/parameterTypes.h>
 #include <clapeze/features/presetFeature.h>
+#include <clapeze/features/presetIndex.h>
 #include <imgui.h>
 #include <kitgui/controls/knob.h>
 #include <kitgui/controls/toggleSwitch.h>
 #include <misc/cpp/imgui_stdlib.h>
 #include <filesystem>
+#include <memory>
 
 namespace kitgui {
 class PresetBrowser {
@@ -28,6 +30,28 @@ class PresetBrowser {
                 mBuiltinPresets.erase(mBuiltinPresets.begin()+idx);
             }
         }
+
+        // user presets come from the index, which only re-parses files that changed since the last time
+        mFilePresets.clear();
+        std::filesystem::path userDirectory = assets.GetUserPresetDirectory();
+        if (userDirectory.empty()) {
+            return;
+        }
+        if (!mUserPresets || mUserPresets->GetDirectory() != userDirectory.lexically_normal()) {
+            mUserPresets = std::make_unique<clapeze::PresetIndex>(userDirectory);
+            mUserPresets->Load();
+        }
+        mUserPresets->Scan();
+        mUserPresets->Save();
+        std::string_view pluginId = mPlugin.GetDescriptor().id;
+        for (const auto& [path, entry] : mUserPresets->GetEntries()) {
+            if (entry.isPreset && entry.pluginId == pluginId) {
+                mFilePresets.push_back({mUserPresets->GetFullPath(path).string(),
+                                        entry.info.name.empty() ? std::filesystem::path(path).stem().generic_string()
+                                                                : entry.info.name,
+                                        &entry});
+            }
+        }
     }
     void Update() {
         if (mOpen) {
@@ -53,13 +77,12 @@ class PresetBrowser {
                             }
                             ImGui::PopID();
                         }
-                        for (const auto& path : mFilePresets) {
+                        for (const auto& preset : mFilePresets) {
                             ImGui::PushID(++idx);
-                            std::string name = std::filesystem::path(path).stem().generic_string();
-                            bool selected = lastLocation.has_value() && lastLocation->kind == CLAP_PRESET_DISCOVERY_LOCATION_FILE ? path == lastLocation->location : false;
-                            if ((selected || mFilter.PassFilter(name.c_str())) && ImGui::Selectable(name.c_str(), selected)) {
+                            bool selected = lastLocation.has_value() && lastLocation->kind == CLAP_PRESET_DISCOVERY_LOCATION_FILE ? preset.path == lastLocation->location : false;
+                            if ((selected || PassFilter(preset)) && ImGui::Selectable(preset.name.c_str(), selected)) {
                                 // load
-                                presets.LoadPreset(CLAP_PRESET_DISCOVERY_LOCATION_FILE, path.c_str(), nullptr);
+                                presets.LoadPreset(CLAP_PRESET_DISCOVERY_LOCATION_FILE, preset.path.c_str(), nullptr);
                             }
                             ImGui::PopID();
                         }
@@ -103,8 +126,8 @@ class PresetBrowser {
             ImGui::EndMenu();
         }
         if(ImGui::BeginMenu("User")) {
-            for(const auto& file : mFilePresets) {
-                ImGui::MenuItem(file.c_str());
+            for(const auto& preset : mFilePresets) {
+                ImGui::MenuItem(preset.name.c_str());
             }
             ImGui::EndMenu();
         }
@@ -112,10 +135,31 @@ class PresetBrowser {
 
     bool mOpen = false;
    private:
+    struct FilePreset {
+        std::string path;
+        std::string name;
+        const clapeze::PresetIndex::Entry* entry;
+    };
+
+    // matches on any of the indexed metadata, not just the name
+    bool PassFilter(const FilePreset& preset) const {
+        const clapeze::PresetInfo& info = preset.entry->info;
+        if (mFilter.PassFilter(preset.name.c_str()) || mFilter.PassFilter(info.creator.c_str())) {
+            return true;
+        }
+        for (const auto& feature : info.features) {
+            if (mFilter.PassFilter(feature.c_str())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     clapeze::BasePlugin& mPlugin;
     ImGuiTextFilter mFilter;
     std::vector<std::string> mBuiltinPresets;
-    std::vector<std::string> mFilePresets;
+    std::unique_ptr<clapeze::PresetIndex> mUserPresets;
+    std::vector<FilePreset> mFilePresets;
 };
 }  // namespace kitgui
 #endif
\ No newline at end of file
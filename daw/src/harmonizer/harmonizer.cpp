@@ -19,7 +19,21 @@
 #endif
 
 namespace {
-enum class Params : clap_id { Transpose, Finetune, BaseDelay, GrainSize, Feedback, Mix, Count };
+enum class Params : clap_id {
+    Transpose,
+    Finetune,
+    BaseDelay,
+    GrainSize,
+    Feedback,
+    Mix,
+    Voice2Transpose,
+    Voice2Level,
+    Voice3Transpose,
+    Voice3Level,
+    Voice4Transpose,
+    Voice4Level,
+    Count
+};
 using ParamsFeature = clapeze::params::EnumParametersFeature<Params>;
 }  // namespace
 
@@ -55,6 +69,36 @@ template <>
 struct ParamTraits<Params, Params::Mix> : public clapeze::PercentParam {
     ParamTraits() : clapeze::PercentParam("Mix", "Mix", 1.0f) {}
 };
+
+template <>
+struct ParamTraits<Params, Params::Voice2Transpose> : public clapeze::IntegerParam {
+    ParamTraits() : clapeze::IntegerParam("Voice2Transpose", "Voice 2 Transpose", -12, 12, 4, "semis") {}
+};
+
+template <>
+struct ParamTraits<Params, Params::Voice2Level> : public clapeze::PercentParam {
+    ParamTraits() : clapeze::PercentParam("Voice2Level", "Voice 2 Level", 0.0f) {}
+};
+
+template <>
+struct ParamTraits<Params, Params::Voice3Transpose> : public clapeze::IntegerParam {
+    ParamTraits() : clapeze::IntegerParam("Voice3Transpose", "Voice 3 Transpose", -12, 12, 7, "semis") {}
+};
+
+template <>
+struct ParamTraits<Params, Params::Voice3Level> : public clapeze::PercentParam {
+    ParamTraits() : clapeze::PercentParam("Voice3Level", "Voice 3 Level", 0.0f) {}
+};
+
+template <>
+struct ParamTraits<Params, Params::Voice4Transpose> : public clapeze::IntegerParam {
+    ParamTraits() : clapeze::IntegerParam("Voice4Transpose", "Voice 4 Transpose", -12, 12, -12, "semis") {}
+};
+
+template <>
+struct ParamTraits<Params, Params::Voice4Level> : public clapeze::PercentParam {
+    ParamTraits() : clapeze::PercentParam("Voice4Level", "Voice 4 Level", 0.0f) {}
+};
 }  // namespace clapeze::params
 
 using namespace clapeze;
@@ -74,21 +118,40 @@ class Processor : public EffectProcessor<ParamsFeature::AudioHandle> {
         float feedback = std::exp2f(0.5f * std::log2f(mParams.Get<Params::Feedback>()));
         float mixf = mParams.Get<Params::Mix>();
 
-        float shiftRatio = kitdsp::midiToRatio(transpose + (fine * 0.01f));
-
-        mLeft->SetParams(shiftRatio, grainSizeMs, delayMs, feedback);
-        mRight->SetParams(shiftRatio, grainSizeMs, delayMs, feedback);
+        // the first voice is always on. the others always keep their own slot, even while they're silent, so turning
+        // one down never shifts the rest over into different grains
+        struct ChordVoice {
+            float transpose;
+            float level;
+        };
+        ChordVoice chord[kitdsp::Harmonizer::kMaxVoices] = {
+            {transpose, 1.0f},
+            {static_cast<float>(mParams.Get<Params::Voice2Transpose>()), mParams.Get<Params::Voice2Level>()},
+            {static_cast<float>(mParams.Get<Params::Voice3Transpose>()), mParams.Get<Params::Voice3Level>()},
+            {static_cast<float>(mParams.Get<Params::Voice4Transpose>()), mParams.Get<Params::Voice4Level>()},
+        };
+        kitdsp::Harmonizer::Config cfg{};
+        cfg.baseDelayMs = delayMs;
+        cfg.feedback = feedback;
+        cfg.numVoices = kitdsp::Harmonizer::kMaxVoices;
+        for (size_t idx = 0; idx < kitdsp::Harmonizer::kMaxVoices; ++idx) {
+            kitdsp::Harmonizer::Voice& v = cfg.voices[idx];
+            v.pitchRatio = kitdsp::midiToRatio(chord[idx].transpose + (fine * 0.01f));
+            v.grainSizeMs = grainSizeMs;
+            v.level = chord[idx].level;
+        }
+        mLeft->cfg = cfg;
+        mRight->cfg = cfg;
 
+        etl::span<float> wet(mWet.get(), in.left.size());
+        mLeft->Process(in.left, wet);
         for (size_t idx = 0; idx < in.left.size(); ++idx) {
-            float left = in.left[idx];
-            float processedLeft = mLeft->Process(left);
-            out.left[idx] = kitdsp::lerp(left, processedLeft, mixf);
+            out.left[idx] = kitdsp::lerp(in.left[idx], wet[idx], mixf);
         }
 
+        mRight->Process(in.right, wet);
         for (size_t idx = 0; idx < in.right.size(); ++idx) {
-            float right = in.right[idx];
-            float processedRight = mRight->Process(right);
-            out.right[idx] = kitdsp::lerp(right, processedRight, mixf);
+            out.right[idx] = kitdsp::lerp(in.right[idx], wet[idx], mixf);
         }
         return ProcessStatus::Continue;
     }
@@ -101,24 +164,25 @@ class Processor : public EffectProcessor<ParamsFeature::AudioHandle> {
     void Activate(double sampleRate, size_t minBlockSize, size_t maxBlockSize) override {
         (void)sampleRate;
         (void)minBlockSize;
-        (void)maxBlockSize;
         float sampleRatef = static_cast<float>(sampleRate);
         constexpr float maxSizeSeconds = 1.0f;
 
         mBufLen = static_cast<size_t>(sampleRatef * maxSizeSeconds);
         mBufLeft.reset(new float[mBufLen]);
-        mLeft = std::make_unique<kitdsp::H910PitchShifter>(etl::span(mBufLeft.get(), mBufLen), sampleRatef);
+        mLeft = std::make_unique<kitdsp::Harmonizer>(etl::span(mBufLeft.get(), mBufLen), sampleRatef);
         mBufRight.reset(new float[mBufLen]);
-        mRight = std::make_unique<kitdsp::H910PitchShifter>(etl::span(mBufRight.get(), mBufLen), sampleRatef);
+        mRight = std::make_unique<kitdsp::Harmonizer>(etl::span(mBufRight.get(), mBufLen), sampleRatef);
+        mWet.reset(new float[maxBlockSize]);
     }
 
    private:
     // TODO: create resizable span class that doesn't re-alloc in between
     std::unique_ptr<float[]> mBufLeft;
     std::unique_ptr<float[]> mBufRight;
+    std::unique_ptr<float[]> mWet;
     size_t mBufLen;
-    std::unique_ptr<kitdsp::H910PitchShifter> mLeft;
-    std::unique_ptr<kitdsp::H910PitchShifter> mRight;
+    std::unique_ptr<kitdsp::Harmonizer> mLeft;
+    std::unique_ptr<kitdsp::Harmonizer> mRight;
 };
 
 #if KITSBLIPS_ENABLE_GUI
@@ -130,13 +194,20 @@ class GuiApp : public kitgui::BaseApp {
         ImGui::TextWrapped(
             "This is a pitch shift effect inspired by the EvenTide H910, the very first realtime pitch shift hardware "
             "module. This, of course, means the way it achieves this effect is kind of nasty, and not very "
-            "transparent. it's fun when layered with the original signal, or used as a creative effect, though!");
+            "transparent. it's fun when layered with the original signal, or used as a creative effect, though! Turn up "
+            "the extra voices to build chords.");
         kitgui::DebugParam<ParamsFeature, Params::Transpose>(mParams);
         kitgui::DebugParam<ParamsFeature, Params::Finetune>(mParams);
         kitgui::DebugParam<ParamsFeature, Params::BaseDelay>(mParams);
         kitgui::DebugParam<ParamsFeature, Params::GrainSize>(mParams);
         kitgui::DebugParam<ParamsFeature, Params::Feedback>(mParams);
         kitgui::DebugParam<ParamsFeature, Params::Mix>(mParams);
+        kitgui::DebugParam<ParamsFeature, Params::Voice2Transpose>(mParams);
+        kitgui::DebugParam<ParamsFeature, Params::Voice2Level>(mParams);
+        kitgui::DebugParam<ParamsFeature, Params::Voice3Transpose>(mParams);
+        kitgui::DebugParam<ParamsFeature, Params::Voice3Level>(mParams);
+        kitgui::DebugParam<ParamsFeature, Params::Voice4Transpose>(mParams);
+        kitgui::DebugParam<ParamsFeature, Params::Voice4Level>(mParams);
     }
 
    private:
@@ -160,7 +231,13 @@ class Plugin : public EffectPlugin {
                                     .Parameter<Params::BaseDelay>()
                                     .Parameter<Params::GrainSize>()
                                     .Parameter<Params::Feedback>()
-                                    .Parameter<Params::Mix>();
+                                    .Parameter<Params::Mix>()
+                                    .Parameter<Params::Voice2Transpose>()
+                                    .Parameter<Params::Voice2Level>()
+                                    .Parameter<Params::Voice3Transpose>()
+                                    .Parameter<Params::Voice3Level>()
+                                    .Parameter<Params::Voice4Transpose>()
+                                    .Parameter<Params::Voice4Level>();
         ConfigFeature<TomlStateFeature<ParamsFeature>>(*this);
 #if KITSBLIPS_ENABLE_GUI
         ConfigFeature<clapeze::AssetsFeature>();
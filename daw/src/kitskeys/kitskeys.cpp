@@ -5,6 +5,7 @@
 #include <clapeze/features/params/enumParametersFeature.h>
 #include <clapeze/features/params/parameterTypes.h>
 #include <clapeze/features/presetFeature.h>
+#include <clapeze/features/threadPoolFeature.h>
 #include <clapeze/features/state/baseStateFeature.h>
 #include <clapeze/features/state/tomlStateFeature.h>
 #include <clapeze/impl/stringUtils.h>
@@ -13,6 +14,7 @@
 #include <clapeze/processor/voice.h>
 #include <etl/flat_multimap.h>
 #include <etl/vector.h>
+#include <array>
 #include <kitdsp/control/adsr.h>
 #include <kitdsp/control/approach.h>
 #include <kitdsp/control/gate.h>
@@ -90,6 +92,8 @@ const std::vector<std::pair<int32_t, int32_t>> kSyncFractions{
 // clang-format on
 
 constexpr size_t cMaxVoices = 16;
+// voices are rendered in this many groups, each of which can run on a different thread
+constexpr size_t cNumVoiceGroups = 4;
 using ParamsFeature = clapeze::params::EnumParametersFeature<Params>;
 }  // namespace
 
@@ -491,10 +495,18 @@ class Processor : public clapeze::InstrumentProcessor<ParamsFeature::AudioHandle
     };
 
    public:
-    explicit Processor(clapeze::PluginHost& host, ParamsFeature::AudioHandle& params)
-        : InstrumentProcessor(host, params), mVoices(*this, params) {}
+    explicit Processor(clapeze::PluginHost& host,
+                       ParamsFeature::AudioHandle& params,
+                       clapeze::ThreadPoolFeature& threads)
+        : InstrumentProcessor(host, params), mVoices(*this, params), mThreads(threads) {}
     ~Processor() = default;
 
+    void Activate(double sampleRate, size_t minBlockSize, size_t maxBlockSize) override {
+        for (auto& scratch : mGroupScratch) {
+            scratch.Resize(maxBlockSize);
+        }
+    }
+
     clapeze::ProcessStatus ProcessAudio(clapeze::StereoAudioBuffer& out) override {
         int32_t polyCount = mParams.Get<Params::PolyCount>();
         mVoices.SetNumVoices(polyCount);
@@ -524,10 +536,20 @@ class Processor : public clapeze::InstrumentProcessor<ParamsFeature::AudioHandle
 
         std::fill(out.left.begin(), out.left.end(), 0.0f);
         std::fill(out.right.begin(), out.right.end(), 0.0f);
-        auto status = mVoices.ProcessAudio(out);
+        size_t blockSize = out.left.size();
+        size_t groupSize = (mVoices.GetNumVoices() + cNumVoiceGroups - 1) / cNumVoiceGroups;
+        mThreads.Run(cNumVoiceGroups, [&](uint32_t group) {
+            mGroupOut[group] = mGroupScratch[group].Alloc(blockSize);
+            mVoices.ProcessAudioRange(group * groupSize, (group + 1) * groupSize, mGroupOut[group]);
+        });
+        // mixed in group order, so the result doesn't depend on which thread finished first
+        for (const auto& groupOut : mGroupOut) {
+            out.Add(groupOut);
+        }
+        mVoices.EndFinishedVoices();
+        auto status = clapeze::ProcessStatus::Continue;
 
-        float numSamples = narrow_cast<float>(out.left.size());
-        mParams.Send<Params::LfoOut>(mLeaderLfo.Process(numSamples));
+        mParams.Send<Params::LfoOut>(mLeaderLfo.Process(narrow_cast<float>(blockSize)));
 
         return status;
     }
@@ -553,6 +575,9 @@ class Processor : public clapeze::InstrumentProcessor<ParamsFeature::AudioHandle
     clapeze::VoicePool<Processor, Voice, cMaxVoices> mVoices;
     NoteProcessor mNoteProcessor{};
     AnalogLfo mLeaderLfo{};
+    clapeze::ThreadPoolFeature& mThreads;
+    std::array<clapeze::StereoAudioScratchBuffer, cNumVoiceGroups> mGroupScratch;
+    std::array<clapeze::StereoAudioBuffer, cNumVoiceGroups> mGroupOut{};
 };
 
 #if KITSBLIPS_ENABLE_GUI
@@ -791,6 +816,7 @@ class Plugin : public InstrumentPlugin {
         ConfigFeature<clapeze::AssetsFeature>();
         ConfigFeature<TomlStateFeature<ParamsFeature>>(*this);
         ConfigFeature<clapeze::PresetFeature>(*this);
+        clapeze::ThreadPoolFeature& threads = ConfigFeature<clapeze::ThreadPoolFeature>();
 
 #if KITSBLIPS_ENABLE_GUI
         // aspect ratio 1.5
@@ -800,7 +826,7 @@ class Plugin : public InstrumentPlugin {
             cfg);
 #endif
 
-        ConfigProcessor<Processor>(params.GetAudioHandle<ParamsFeature::AudioHandle>());
+        ConfigProcessor<Processor>(params.GetAudioHandle<ParamsFeature::AudioHandle>(), threads);
     }
 };
 
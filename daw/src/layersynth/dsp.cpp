@@ -58,18 +58,24 @@ bool Voice::ProcessAudio(clapeze::StereoAudioBuffer& out) {
     return mVolumeEnv.IsProcessing();
 }
 
-clapeze::ProcessStatus Layer::ProcessAudio(clapeze::StereoAudioBuffer& out) {
-    clapeze::StereoAudioBuffer tmp = mScratch.Alloc(out.left.size());
-    auto status = mVoices.ProcessAudio(tmp);
-    if (mChorus) {
-        for (size_t idx = 0; idx < tmp.left.size(); ++idx) {
-            kitdsp::float_2 processed = mChorus->Process(kitdsp::float_2(tmp.left[idx], tmp.right[idx]));
-            tmp.left[idx] = processed.left;
-            tmp.right[idx] = processed.right;
-        }
+void Layer::Render(size_t numSamples) {
+    mRendered = mScratch.Alloc(numSamples);
+    mVoices.ProcessAudioRange(0, mVoices.GetNumVoices(), mRendered);
+}
+
+clapeze::ProcessStatus Layer::MixInto(clapeze::StereoAudioBuffer& out, clapeze::StereoAudioBuffer& chorusSend) {
+    const clapeze::StereoAudioBuffer& tmp = mRendered;
+    mVoices.EndFinishedVoices();
+    // each layer sends into one shared chorus. that only approximates a chorus per layer: the chorus clamps its
+    // output and feeds back, so layers that are loud together, or share a send, interact a little
+    float dry = 1.0f - mChorusSend;
+    for (size_t idx = 0; idx < tmp.left.size(); ++idx) {
+        chorusSend.left[idx] += tmp.left[idx] * mChorusSend;
+        chorusSend.right[idx] += tmp.right[idx] * mChorusSend;
+        out.left[idx] += tmp.left[idx] * dry;
+        out.right[idx] += tmp.right[idx] * dry;
     }
-    out.Add(tmp);
-    return status;
+    return clapeze::ProcessStatus::Continue;
 }
 
 clapeze::ProcessStatus Global::ProcessAudio(clapeze::StereoAudioBuffer& out) {
@@ -77,10 +83,49 @@ clapeze::ProcessStatus Global::ProcessAudio(clapeze::StereoAudioBuffer& out) {
     out.Fill(0.0f);
     out.isLeftConstant = false;
     out.isRightConstant = false;
-    for (auto& layer : mLayers) {
-        status = layer.ProcessAudio(out);
+    clapeze::StereoAudioBuffer send = mChorusSend.Alloc(out.left.size());
+    {
+        clapeze::ProfilingFeature::Scope scope(mProfiling, mVoicesStage);
+        size_t numSamples = out.left.size();
+        auto render = [this, numSamples](uint32_t idx) { mLayers[idx].Render(numSamples); };
+        if (mThreads) {
+            mThreads->Run(static_cast<uint32_t>(mLayers.size()), render);
+        } else {
+            for (uint32_t idx = 0; idx < mLayers.size(); ++idx) {
+                render(idx);
+            }
+        }
+        // always mixed in the same order, so the output doesn't depend on which layer finished rendering first
+        for (auto& layer : mLayers) {
+            status = layer.MixInto(out, send);
+        }
+    }
+    if (mChorus) {
+        clapeze::ProfilingFeature::Scope scope(mProfiling, mChorusStage);
+        // there's only one chorus, so the per-layer settings are blended by how much each layer sends to it
+        float totalSend = 0.0f;
+        float rateHz = 0.0f;
+        float depth = 0.0f;
+        float feedback = 0.0f;
+        for (const auto& layer : mLayers) {
+            totalSend += layer.mChorusSend;
+            rateHz += layer.mChorusRateHz * layer.mChorusSend;
+            depth += layer.mChorusDepth * layer.mChorusSend;
+            feedback += layer.mChorusFeedback * layer.mChorusSend;
+        }
+        if (totalSend > 0.0f) {
+            float maxDelayMs = mChorus->GetMaxDelayMs();
+            mChorus->cfg.lfoRateHz = rateHz / totalSend;
+            mChorus->cfg.delayBaseMs = depth / totalSend * maxDelayMs;
+            mChorus->cfg.delayModMs = depth / totalSend * maxDelayMs * 0.4f;
+            mChorus->cfg.feedback = feedback / totalSend;
+        }
+        mChorus->cfg.mix = 1.0f;
+        mChorus->Process(send.left, send.right, send.left, send.right);
+        out.Add(send);
     }
     if (mReverb && mReverbMix > 0.0f) {
+        clapeze::ProfilingFeature::Scope scope(mProfiling, mReverbStage);
         for (size_t idx = 0; idx < out.left.size(); ++idx) {
             kitdsp::float_2 outf = {out.left[idx], out.right[idx]};
             kitdsp::float_2 tmp = mReverb->Process(outf);
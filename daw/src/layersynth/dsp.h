@@ -1,9 +1,11 @@
 #pragma once
 
 #include <clapeze/features/params/dynamicParametersFeature.h>
+#include <clapeze/features/profilingFeature.h>
+#include <clapeze/features/threadPoolFeature.h>
 #include <clapeze/processor/voice.h>
 #include <etl/array.h>
-#include <kitdsp/apps/chorus.h>
+#include <kitdsp/apps/ensembleChorus.h>
 #include <kitdsp/apps/equalizer3Band.h>
 #include <kitdsp/apps/psxReverb.h>
 #include <kitdsp/control/adsr.h>
@@ -18,7 +20,7 @@
 #include <kitdsp/osc/blepOscillator.h>
 #include <kitdsp/osc/naiveOscillator.h>
 #include <kitdsp/sampling/samplePlayer.h>
-#include <kitdsp/util/spanAllocator.h>
+#include <kitdsp/util/arena.h>
 #include <kitdsp/volume/safetyLimiter.h>
 #include <optional>
 
@@ -82,7 +84,10 @@ class Layer {
         }
     }
 
-    clapeze::ProcessStatus ProcessAudio(clapeze::StereoAudioBuffer& out);
+    /** renders every voice into this layer's scratch buffer. layers don't share anything, so this can run in parallel */
+    void Render(size_t numSamples);
+    /** mixes the last Render() into the output and chorus send. [audio-thread] */
+    clapeze::ProcessStatus MixInto(clapeze::StereoAudioBuffer& out, clapeze::StereoAudioBuffer& chorusSend);
 
     void Reset() { mVoices.Reset(); }
 
@@ -92,17 +97,21 @@ class Layer {
 
     void ProcessNoteChoke(const clapeze::NoteTuple& note) { mVoices.ProcessNoteChoke(note); }
 
-    void Activate(float sampleRate, size_t maxBlockSize, kitdsp::DynamicSpanAllocator<float>& memory) {
+    void Activate(size_t maxBlockSize) {
         mVoices.SetNumVoices(cMaxVoices);
         mVoices.SetStrategy(clapeze::VoiceStrategy::Poly);
-        mChorus = std::make_optional<kitdsp::Chorus>(
-            memory.alloc(narrow_cast<size_t>(cMaxChorusTimeMs * sampleRate / 1000.0f)), sampleRate);
         mScratch.Resize(maxBlockSize);
     }
 
     clapeze::StereoAudioScratchBuffer mScratch;
+    clapeze::StereoAudioBuffer mRendered{};
     clapeze::VoicePool<clapeze::BaseProcessor, Voice, cMaxVoices> mVoices;
-    std::optional<kitdsp::Chorus> mChorus;
+
+    // every layer feeds the one chorus in Global, these are its contribution
+    float mChorusSend{};
+    float mChorusRateHz{};
+    float mChorusDepth{};
+    float mChorusFeedback{};
 
     int32_t mWaveIndex{};
     float mNoteOffset{};
@@ -132,6 +141,15 @@ class Global {
 
     clapeze::ProcessStatus ProcessAudio(clapeze::StereoAudioBuffer& out);
 
+    void SetThreadPool(clapeze::ThreadPoolFeature& threads) { mThreads = &threads; }
+
+    void SetProfiling(clapeze::ProfilingFeature& profiling) {
+        mProfiling = &profiling;
+        mVoicesStage = profiling.AddStage("voices");
+        mChorusStage = profiling.AddStage("chorus");
+        mReverbStage = profiling.AddStage("reverb");
+    }
+
     void ProcessNoteOn(const clapeze::NoteTuple& note, float velocity) {
         for (auto& layer : mLayers) {
             layer.ProcessNoteOn(note, velocity);
@@ -155,6 +173,9 @@ class Global {
             layer.Reset();
         }
         mLimit.Reset();
+        if (mChorus) {
+            mChorus->Reset();
+        }
         if (mReverb) {
             mReverb->Reset();
         }
@@ -165,22 +186,39 @@ class Global {
         (void)maxBlockSize;
         float sampleRate = narrow_cast<float>(_sampleRate);
         mSampleRate = sampleRate;
-        mMemory.reset();
         for (auto& layer : mLayers) {
-            layer.Activate(sampleRate, maxBlockSize, mMemory);
+            layer.Activate(maxBlockSize);
         }
-        mReverb = {mMemory.alloc(kitdsp::PSX::Reverb::GetBufferDesiredSizeFloats(sampleRate)), sampleRate};
+        mChorusSend.Resize(maxBlockSize);
+
+        size_t chorusSize = narrow_cast<size_t>(cMaxChorusTimeMs * sampleRate / 1000.0f);
+        size_t reverbSize = kitdsp::PSX::Reverb::GetBufferDesiredSizeFloats(sampleRate);
+        mMemory.Unseal();
+        mMemory.Reset();
+        mMemory.Reserve(kitdsp::Arena::GetAllocSize<float>(chorusSize) +
+                        kitdsp::Arena::GetAllocSize<float>(reverbSize));
+        mChorus = {mMemory.Alloc<float>(chorusSize), sampleRate};
+        mReverb = {mMemory.Alloc<float>(reverbSize), sampleRate};
+        // nothing should allocate from here until the next Activate()
+        mMemory.Seal();
     }
 
     etl::vector<Layer, cNumLayers> mLayers;
+    clapeze::StereoAudioScratchBuffer mChorusSend;
+    std::optional<kitdsp::EnsembleChorus> mChorus{};
     std::optional<kitdsp::PSX::Reverb> mReverb{};
     kitdsp::SafetyLimiter<kitdsp::float_2> mLimit;
-    kitdsp::DynamicSpanAllocator<float> mMemory{};
+    kitdsp::Arena mMemory{};
     float mReverbMix{};
     float mSampleRate{};
     float mTune{};
     float mPortamento{};
 
    private:
+    clapeze::ThreadPoolFeature* mThreads{};
+    clapeze::ProfilingFeature* mProfiling{};
+    clapeze::ProfilingFeature::StageId mVoicesStage{};
+    clapeze::ProfilingFeature::StageId mChorusStage{};
+    clapeze::ProfilingFeature::StageId mReverbStage{};
 };
 }  // namespace layersynth
\ No newline at end of file
@@ -7,12 +7,15 @@
 #include <clapeze/features/params/dynamicParametersFeature.h>
 #include <clapeze/features/params/parameterTypes.h>
 #include <clapeze/features/presetFeature.h>
+#include <clapeze/features/profilingFeature.h>
+#include <clapeze/features/threadPoolFeature.h>
 #include <clapeze/features/state/baseStateFeature.h>
 #include <clapeze/features/state/tomlStateFeature.h>
 #include <clapeze/impl/stringUtils.h>
 #include <clapeze/instrumentPlugin.h>
 #include <clapeze/processor/transport.h>
 #include <clapeze/processor/voice.h>
+#include <clapeze/rtLogger.h>
 #include <etl/flat_multimap.h>
 #include <etl/vector.h>
 #include <kitdsp/apps/psxReverbPresets.h>
@@ -122,14 +125,21 @@ using ParamsFeature = clapeze::params::DynamicParametersFeature;
 using namespace clapeze;
 
 namespace layersynth {
+#if KITSBLIPS_ENABLE_GUI
 static ExampleAppLog sLog;
+#endif
 
 class Processor : public clapeze::InstrumentProcessor<ParamsFeature::AudioHandle> {
    public:
     explicit Processor(clapeze::PluginHost& host,
                        ParamsFeature::AudioHandle& params,
-                       SampleLoader::AudioHandle& sampleLoader)
-        : InstrumentProcessor(host, params), mGlobal(*this, params), mSampleLoader(sampleLoader) {
+                       SampleLoader::AudioHandle& sampleLoader,
+                       clapeze::RtLogger& log,
+                       clapeze::ProfilingFeature& profiling,
+                       clapeze::ThreadPoolFeature& threads)
+        : InstrumentProcessor(host, params), mGlobal(*this, params), mSampleLoader(sampleLoader), mLog(log) {
+        mGlobal.SetProfiling(profiling);
+        mGlobal.SetThreadPool(threads);
         static_assert(P_(GlobalParams::Count) == 104, "Update handlers");
         params.RegisterHandler([&](clap_id id) {
             auto HandleLfo = [&](kitdsp::lfo::TriangleOscillator& lfo, clap_id inner) {
@@ -181,23 +191,13 @@ class Processor : public clapeze::InstrumentProcessor<ParamsFeature::AudioHandle
                 } else if (inner == P_(LayerParams::VcaVelocityMult)) {
                     layer.mVcaVelocityMult = mParams.Get<PercentParam>(id);
                 } else if (inner == P_(LayerParams::ChorusMix)) {
-                    if (layer.mChorus) {
-                        layer.mChorus->cfg.mix = mParams.Get<PercentParam>(id);
-                    }
+                    layer.mChorusSend = mParams.Get<PercentParam>(id);
                 } else if (inner == P_(LayerParams::ChorusRate)) {
-                    if (layer.mChorus) {
-                        layer.mChorus->cfg.lfoRateHz = mParams.Get<FreqParam>(id);
-                    }
+                    layer.mChorusRateHz = mParams.Get<FreqParam>(id);
                 } else if (inner == P_(LayerParams::ChorusDepth)) {
-                    if (layer.mChorus) {
-                        layer.mChorus->cfg.delayBaseMs = mParams.Get<PercentParam>(id) * layer.mChorus->GetMaxDelayMs();
-                        layer.mChorus->cfg.delayModMs =
-                            mParams.Get<PercentParam>(id) * layer.mChorus->GetMaxDelayMs() * 0.4f;
-                    }
+                    layer.mChorusDepth = mParams.Get<PercentParam>(id);
                 } else if (inner == P_(LayerParams::ChorusFeedback)) {
-                    if (layer.mChorus) {
-                        layer.mChorus->cfg.feedback = mParams.Get<PercentParam>(id);
-                    }
+                    layer.mChorusFeedback = mParams.Get<PercentParam>(id);
                 } else if (inner >= P_(LayerParams::FilterEnvStart) && inner < P_(LayerParams::VcaEnvStart)) {
                     for (Voice& voice : layer.mVoices.IterAll()) {
                         HandleEnv(voice.mFilterEnv, inner - P_(LayerParams::FilterEnvStart));
@@ -264,17 +264,17 @@ class Processor : public clapeze::InstrumentProcessor<ParamsFeature::AudioHandle
     }
 
     void ProcessNoteOn(const clapeze::NoteTuple& note, float velocity) override {
-        sLog.AddLog("Note on (%d,%d)\n", note.key, note.id);
+        mLog.Debug("Note on ({},{})", note.key, note.id);
         mGlobal.ProcessNoteOn(note, velocity);
     }
 
     void ProcessNoteOff(const clapeze::NoteTuple& note) override {
-        sLog.AddLog("Note off (%d,%d)\n", note.key, note.id);
+        mLog.Debug("Note off ({},{})", note.key, note.id);
         mGlobal.ProcessNoteOff(note);
     }
 
     void ProcessNoteChoke(const clapeze::NoteTuple& note) override {
-        sLog.AddLog("Note choke (%d,%d)\n", note.key, note.id);
+        mLog.Debug("Note choke ({},{})", note.key, note.id);
         mGlobal.ProcessNoteChoke(note);
     }
 
@@ -287,13 +287,25 @@ class Processor : public clapeze::InstrumentProcessor<ParamsFeature::AudioHandle
    private:
     Global mGlobal;
     SampleLoader::AudioHandle& mSampleLoader;
+    clapeze::RtLogger& mLog;
 };
 
 #if KITSBLIPS_ENABLE_GUI
 class GuiApp : public kitgui::BaseApp {
    public:
-    GuiApp(kitgui::Context& ctx, clapeze::BasePlugin& plugin, ParamsFeature& params, SampleLoader& sampleLoader)
-        : kitgui::BaseApp(ctx), mPlugin(plugin), mParams(params), mSampleLoader(sampleLoader), mPresetBrowser(plugin) {}
+    GuiApp(kitgui::Context& ctx,
+           clapeze::BasePlugin& plugin,
+           ParamsFeature& params,
+           SampleLoader& sampleLoader,
+           clapeze::ProfilingFeature& profiling,
+           clapeze::RtLogger& log)
+        : kitgui::BaseApp(ctx),
+          mPlugin(plugin),
+          mParams(params),
+          mSampleLoader(sampleLoader),
+          mProfiling(profiling),
+          mLog(log),
+          mPresetBrowser(plugin) {}
     ~GuiApp() = default;
 
     void OnActivate() override {
@@ -306,6 +318,10 @@ class GuiApp : public kitgui::BaseApp {
 
     void OnUpdate() override {
         mParams.FlushFromAudio();
+        mSampleLoader.OnMainUpdate();
+        mProfiling.Poll();
+        // for hosts without timers, which never drain the log otherwise
+        mLog.Drain();
         if (ImGui::BeginMainMenuBar()) {
             if (ImGui::BeginMenu("Preset")) {
                 if (ImGui::MenuItem("Reset All")) {
@@ -331,6 +347,7 @@ class GuiApp : public kitgui::BaseApp {
                     mPlugin.GetHost().RequestRestart();
                 }
                 ImGui::MenuItem("AppLog", nullptr, &(sLog.Show));
+                ImGui::MenuItem("Profiler", nullptr, &mShowProfiler);
                 ImGui::EndMenu();
             }
             ImGui::EndMainMenuBar();
@@ -420,6 +437,9 @@ class GuiApp : public kitgui::BaseApp {
         if (sLog.Show) {
             sLog.Draw("AppLog");
         }
+        if (mShowProfiler) {
+            kitgui::DebugProfiler("Profiler", mProfiling, &mShowProfiler);
+        }
     }
 
     void OnGuiUpdate() override {}
@@ -430,7 +450,10 @@ class GuiApp : public kitgui::BaseApp {
     clapeze::BasePlugin& mPlugin;
     ParamsFeature& mParams;
     SampleLoader& mSampleLoader;
+    clapeze::ProfilingFeature& mProfiling;
+    clapeze::RtLogger& mLog;
     kitgui::PresetBrowser mPresetBrowser;
+    bool mShowProfiler{};
 };
 #endif
 
@@ -494,7 +517,11 @@ class Plugin : public InstrumentPlugin {
    protected:
     void Config() override {
         InstrumentPlugin::Config();
+#if KITSBLIPS_ENABLE_GUI
         sLog.Config(GetHost());
+#endif
+        mLog.Start(GetHost());
+        mSampleLoader.Start(GetHost());
 
         ParamsFeature& params = ConfigFeature<ParamsFeature>(GetHost(), P_(GlobalParams::Count));
         static_assert(P_(GlobalParams::Count) == 104, "Update Traits");
@@ -568,23 +595,27 @@ class Plugin : public InstrumentPlugin {
         ConfigFeature<clapeze::AssetsFeature>();
         ConfigFeature<StateFeature>(*this, mSampleLoader);
         ConfigFeature<clapeze::PresetFeature>(*this);
+        clapeze::ProfilingFeature& profiling = ConfigFeature<clapeze::ProfilingFeature>();
+        clapeze::ThreadPoolFeature& threads = ConfigFeature<clapeze::ThreadPoolFeature>();
 
 #if KITSBLIPS_ENABLE_GUI
         // aspect ratio 1.5
         kitgui::SizeConfig cfg{750, 750, false, true};
         ConfigFeature<KitguiFeature>(
             GetHost(),
-            [this, &params](kitgui::Context& ctx) {
-                return std::make_unique<GuiApp>(ctx, *this, params, mSampleLoader);
+            [this, &params, &profiling](kitgui::Context& ctx) {
+                return std::make_unique<GuiApp>(ctx, *this, params, mSampleLoader, profiling, mLog);
             },
             cfg);
 #endif
 
-        ConfigProcessor<Processor>(params.GetAudioHandle<ParamsFeature::AudioHandle>(), mSampleLoader.GetAudioHandle());
+        ConfigProcessor<Processor>(params.GetAudioHandle<ParamsFeature::AudioHandle>(), mSampleLoader.GetAudioHandle(),
+                                   mLog, profiling, threads);
     }
 
    private:
     SampleLoader mSampleLoader;
+    clapeze::RtLogger mLog;
 };
 
 CLAPEZE_REGISTER_PLUGIN(Plugin,
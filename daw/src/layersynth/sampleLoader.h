@@ -1,18 +1,24 @@
 #pragma once
 
+#include <clapeze/pluginHost.h>
 #include <etl/queue_spsc_atomic.h>
 #include <fmt/format.h>
 #include <kitdsp/sampling/samplePlayer.h>
 #include <kitdsp/pitch/zeroCrossingPitchDetector.h>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <filesystem>
 #include <iomanip>
+#include <optional>
 #include <regex>
 #include <vector>
 
 #include "kitdsp/util/macros.h"
 #include "kitdsp/math/interpolate.h"
 #include "kitdsp/math/units.h"
+#include "layersynth/samplePool.h"
 #include "shared/dr_flac.h"
 #include "shared/dr_wav.h"
 
@@ -119,7 +125,6 @@ class RawSampleLoader {
         size_t loopStart = 0;
         size_t loopEnd = 0;
         kitdsp::SampleLoopDirection loopDirection = kitdsp::SampleLoopDirection::Forward;
-        bool useLastSampleData = false;
     };
     /* Source file information used to prepare AudioFiles */
     struct SourceFile {
@@ -143,17 +148,7 @@ class RawSampleLoader {
 
         bool useLastSampleData = false;
 
-        AudioFile Clone() const {
-            AudioFile cloned = CloneLite();
-            if (this->processedSamples.size() > 0) {
-                cloned.samples = new float[this->processedSamples.size()];
-                memcpy(cloned.samples, this->processedSamples.data(), this->processedSamples.size() * sizeof(float));
-            }
-            cloned.numSamples = this->processedSamples.size();
-            cloned.useLastSampleData = false;
-            return cloned;
-        }
-
+        /* everything but the sample data itself, which lives in the loader's buffer pool */
         AudioFile CloneLite() const {
             AudioFile cloned{};
             if(enableLofi) {
@@ -166,7 +161,6 @@ class RawSampleLoader {
             cloned.loopStart = narrow_cast<size_t>(this->loopStart * this->processedSamples.size());
             cloned.loopEnd = narrow_cast<size_t>(this->loopEnd * this->processedSamples.size());
             cloned.loopDirection = this->loopDirection;
-            cloned.useLastSampleData = true;
             return cloned;
         }
 
@@ -206,8 +200,6 @@ class RawSampleLoader {
             sAnySampleChanged = true;
         }
     };
-    using FileQueue = etl::queue_spsc_atomic<std::pair<size_t, AudioFile*>, 200, etl::memory_model::MEMORY_MODEL_SMALL>;
-
     struct SamplePlaybackUpdate {
         size_t fileIndex;
         uint32_t playbackId;
@@ -216,52 +208,42 @@ class RawSampleLoader {
     };
     using PlaybackQueue = etl::queue_spsc_atomic<SamplePlaybackUpdate, 50, etl::memory_model::MEMORY_MODEL_SMALL>;
 
-    class AudioHandle {
+    /* Samples are handed to the audio thread through a SamplePool, see there */
+    using Pool = SamplePool<AudioFile, TNumSamples>;
+
+    class AudioHandle : public Pool::AudioHandle {
        public:
-        AudioHandle(FileQueue& mainToAudio, FileQueue& audioToMain, PlaybackQueue& playbackFileQueue)
-            : mMainToAudioAcquire(mainToAudio),
-              mAudioToMainRelease(audioToMain),
-              mAudioToMainPlayback(playbackFileQueue) {
-            mFiles.fill(nullptr);
-        }
-        bool OnAudioUpdate() {
-            bool changed = false;
-            std::pair<size_t, AudioFile*> pair;
-            while (mMainToAudioAcquire.pop(pair)) {
-                auto [index, file] = pair;
-                if (mFiles[index]) {
-                    if (file->useLastSampleData) {
-                        // move buffer to new file
-                        file->samples = mFiles[index]->samples;
-                        file->numSamples = mFiles[index]->numSamples;
-                        file->useLastSampleData = false;
-                        mFiles[index]->samples = nullptr;
-                        mFiles[index]->numSamples = 0;
-                    }
-                    // release
-                    mAudioToMainRelease.push({index, mFiles[index]});
-                }
-                mFiles[index] = file;
-                changed = true;
-            }
-            return changed;
-        }
-        const AudioFile* GetSampleData(size_t idx) const {
-            if (idx < mFiles.size()) {
-                return mFiles[idx];
-            }
-            return nullptr;
-        }
-        size_t GetNumSampleDatas() const { return mFiles.size(); }
+        AudioHandle(Pool& pool, PlaybackQueue& playbackFileQueue)
+            : Pool::AudioHandle(pool), mAudioToMainPlayback(playbackFileQueue) {}
 
        private:
-        FileQueue& mMainToAudioAcquire;
-        FileQueue& mAudioToMainRelease;
         PlaybackQueue& mAudioToMainPlayback;
-        etl::array<AudioFile*, TNumSamples> mFiles;
     };
 
-    RawSampleLoader() : mAudioHandle(mMainToAudioAcquire, mAudioToMainRelease, mAudioToMainPlayback) {}
+    RawSampleLoader()
+        : mPool([this](size_t idx) { return mMainFiles[idx].CloneLite(); },
+                [this](size_t idx) -> const std::vector<float>& { return mMainFiles[idx].processedSamples; }),
+          mAudioHandle(mPool, mAudioToMainPlayback) {}
+    ~RawSampleLoader() { Stop(); }
+    RawSampleLoader(const RawSampleLoader&) = delete;
+    RawSampleLoader& operator=(const RawSampleLoader&) = delete;
+
+    /*
+     * Starts reclaiming slots the audio thread is done with, and sending any updates that were waiting on them, every
+     * periodMs. Hosts without timer support don't get this, so call OnMainUpdate() yourself instead.
+     */
+    void Start(clapeze::PluginHost& host, uint32_t periodMs = 100) {
+        Stop();
+        mHost = &host;
+        mTimerId = host.AddTimer(periodMs, [this]() { OnMainUpdate(); });
+    }
+    void Stop() {
+        if (mHost && mTimerId) {
+            mHost->CancelTimer(*mTimerId);
+        }
+        mHost = nullptr;
+        mTimerId.reset();
+    }
 
     void LoadSample(size_t idx, const std::string& path) {
         SourceFile& f = mMainFiles[idx];
@@ -367,7 +349,7 @@ class RawSampleLoader {
         } else {
             // guess base frequency
             kitdsp::pitch::ZeroCrossingPitchDetector detect(f.rawSampleRate);
-            detect.Process({f.rawSamples[0].data(), f.rawSamples.size()});
+            detect.Process({f.rawSamples[0].data(), f.rawSamples[0].size()});
             f.baseFrequency = detect.GetFrequency();
             if(f.baseFrequency == 0.0f) {
                 // final fallback
@@ -383,33 +365,13 @@ class RawSampleLoader {
 
     SourceFile& GetSourceFile(size_t idx) { return mMainFiles[idx]; }
 
-    void SendSampleParamsToAudio(size_t idx) {
-        SourceFile& sourceFile = mMainFiles[idx];
-        AudioFile* audioFile = new AudioFile();
-        *audioFile = sourceFile.CloneLite();
-        audioFile->samples = nullptr;
-        audioFile->numSamples = 0;
-        audioFile->useLastSampleData = true;
-        mMainToAudioAcquire.push({idx, audioFile});
-    }
+    /* Sends everything but the sample data, which is shared with the sample that's already on the audio thread */
+    void SendSampleParamsToAudio(size_t idx) { mPool.SendParams(idx); }
 
-    void SendFullSampleToAudio(size_t idx) {
-        SourceFile& sourceFile = mMainFiles[idx];
-        AudioFile* audioFile = new AudioFile();
-        *audioFile = sourceFile.Clone();
-        mMainToAudioAcquire.push({idx, audioFile});
-    }
+    void SendFullSampleToAudio(size_t idx) { mPool.SendFull(idx); }
 
-    void OnMainUpdate() {
-        std::pair<size_t, AudioFile*> pair;
-        while (mAudioToMainRelease.pop(pair)) {
-            auto* file = pair.second;
-            if (file->samples) {
-                delete[] file->samples;
-            }
-            delete file;
-        }
-    }
+    /* Reclaims slots the audio thread is done with, and sends any updates that were waiting on them */
+    void OnMainUpdate() { mPool.OnMainUpdate(); }
     AudioHandle& GetAudioHandle() { return mAudioHandle; }
 
     bool ImguiSampleSelect(const char* id, size_t* sampleIndex) {
@@ -565,10 +527,11 @@ class RawSampleLoader {
     }
 
    private:
-    FileQueue mMainToAudioAcquire{};
-    FileQueue mAudioToMainRelease{};
     PlaybackQueue mAudioToMainPlayback{};
+    Pool mPool;
     AudioHandle mAudioHandle;
+    clapeze::PluginHost* mHost = nullptr;
+    std::optional<clapeze::PluginHost::TimerId> mTimerId;
     etl::array<std::string, TNumSamples> mSamplePaths{};
     size_t mCurrentSampleIndex = 0;
     etl::array<std::string, TNumSamples> mSampleStatus{};
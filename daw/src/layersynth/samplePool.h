@@ -0,0 +1,239 @@
+#pragma once
+
+#include <etl/array.h>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace layersynth {
+
+/*
+ * Hands sample files to the audio thread through a fixed pool of slots. The main thread fills a free slot, and swaps a
+ * pointer to it in. Every swap bumps the published epoch. The slot that got replaced is retired, and is only reused
+ * once the audio thread has acknowledged an epoch at least that new. The audio thread never allocates, frees or waits.
+ *
+ * TFile is copied into its slot as-is, apart from its samples and numSamples, which point at sample data shared by
+ * every slot that has the same samples. When the pool is full, updates wait for OnMainUpdate() to retry them.
+ */
+template <typename TFile, size_t TNumSamples>
+class SamplePool {
+   public:
+    // one published and a few retired slots per sample, before updates have to wait for the audio thread
+    static inline const size_t kNumSlots = TNumSamples * 4;
+
+    /* everything but the sample data, for the given sample */
+    using GetFileFn = std::function<TFile(size_t idx)>;
+    /* the sample data itself, only read when it's sent in full */
+    using GetSamplesFn = std::function<const std::vector<float>&(size_t idx)>;
+
+    struct Handoff {
+        etl::array<std::atomic<const TFile*>, TNumSamples> published{};
+        std::atomic<uint64_t> publishedEpoch{0};
+        std::atomic<uint64_t> acknowledgedEpoch{0};
+    };
+
+    class AudioHandle {
+       public:
+        explicit AudioHandle(SamplePool& pool) : mHandoff(pool.mHandoff) { mFiles.fill(nullptr); }
+        /* Picks up any samples published since the last call. returns true if the sample data needs to be updated */
+        bool OnAudioUpdate() {
+            // what we picked up last time has been handed to the voices since, so the slots it replaced can go
+            mHandoff.acknowledgedEpoch.store(mSeenEpoch, std::memory_order_release);
+
+            uint64_t epoch = mHandoff.publishedEpoch.load(std::memory_order_acquire);
+            if (epoch == mSeenEpoch) {
+                return false;
+            }
+            mSeenEpoch = epoch;
+            for (size_t idx = 0; idx < mFiles.size(); ++idx) {
+                mFiles[idx] = mHandoff.published[idx].load(std::memory_order_acquire);
+            }
+            return true;
+        }
+        const TFile* GetSampleData(size_t idx) const {
+            if (idx < mFiles.size()) {
+                return mFiles[idx];
+            }
+            return nullptr;
+        }
+        size_t GetNumSampleDatas() const { return mFiles.size(); }
+
+       private:
+        Handoff& mHandoff;
+        uint64_t mSeenEpoch = 0;
+        etl::array<const TFile*, TNumSamples> mFiles{};
+    };
+
+    SamplePool(GetFileFn getFile, GetSamplesFn getSamples)
+        : mGetFile(std::move(getFile)), mGetSamples(std::move(getSamples)) {
+        mPublishedSlots.fill(kNoSlot);
+        mPendingUpdates.fill(PendingUpdate::None);
+    }
+    SamplePool(const SamplePool&) = delete;
+    SamplePool& operator=(const SamplePool&) = delete;
+
+    /* Sends everything but the sample data, which is shared with the sample that's already on the audio thread */
+    void SendParams(size_t idx) {
+        if (mPendingUpdates[idx] == PendingUpdate::None && !TrySendParams(idx)) {
+            mPendingUpdates[idx] = PendingUpdate::Params;
+        }
+    }
+
+    void SendFull(size_t idx) {
+        if (!TrySendFull(idx)) {
+            mPendingUpdates[idx] = PendingUpdate::Full;
+        } else {
+            mPendingUpdates[idx] = PendingUpdate::None;
+        }
+    }
+
+    /* Reclaims slots the audio thread is done with, and sends any updates that were waiting on them */
+    void OnMainUpdate() {
+        Reclaim();
+        for (size_t idx = 0; idx < TNumSamples; ++idx) {
+            switch (mPendingUpdates[idx]) {
+                case PendingUpdate::None: {
+                    break;
+                }
+                case PendingUpdate::Params: {
+                    if (TrySendParams(idx)) {
+                        mPendingUpdates[idx] = PendingUpdate::None;
+                    }
+                    break;
+                }
+                case PendingUpdate::Full: {
+                    if (TrySendFull(idx)) {
+                        mPendingUpdates[idx] = PendingUpdate::None;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    /* true if an update for this sample is waiting on a free slot */
+    bool IsPending(size_t idx) const { return mPendingUpdates[idx] != PendingUpdate::None; }
+
+   private:
+    static inline const size_t kNoSlot = SIZE_MAX;
+    /* a preallocated TFile. owned by the main thread, unless it's published or retired */
+    struct Slot {
+        TFile file{};
+        size_t buffer = kNoSlot;
+        // while retired, the epoch the audio thread has to acknowledge before this can be reused
+        uint64_t retiredEpoch = 0;
+        bool inUse = false;
+    };
+    /* sample data, shared between every slot with the same samples */
+    struct Buffer {
+        std::vector<float> samples;
+        // only ever touched on the main thread
+        uint32_t refCount = 0;
+    };
+    enum class PendingUpdate : uint8_t { None, Params, Full };
+
+    bool TrySendParams(size_t idx) {
+        size_t slotIdx = AcquireSlot();
+        if (slotIdx == kNoSlot) {
+            return false;
+        }
+        Slot& slot = mSlots[slotIdx];
+        slot.file = mGetFile(idx);
+        if (mPublishedSlots[idx] != kNoSlot) {
+            size_t bufferIdx = mSlots[mPublishedSlots[idx]].buffer;
+            if (bufferIdx != kNoSlot) {
+                AttachBuffer(slot, bufferIdx);
+            }
+        }
+        Publish(idx, slotIdx);
+        return true;
+    }
+
+    bool TrySendFull(size_t idx) {
+        size_t slotIdx = AcquireSlot();
+        if (slotIdx == kNoSlot) {
+            return false;
+        }
+        size_t bufferIdx = AcquireBuffer();
+        // there's always a buffer per slot, so running out of slots comes first
+        assert(bufferIdx != kNoSlot);
+        mBuffers[bufferIdx].samples = mGetSamples(idx);
+
+        Slot& slot = mSlots[slotIdx];
+        slot.file = mGetFile(idx);
+        AttachBuffer(slot, bufferIdx);
+        Publish(idx, slotIdx);
+        return true;
+    }
+
+    void AttachBuffer(Slot& slot, size_t bufferIdx) {
+        Buffer& buffer = mBuffers[bufferIdx];
+        buffer.refCount++;
+        slot.buffer = bufferIdx;
+        slot.file.samples = buffer.samples.data();
+        slot.file.numSamples = buffer.samples.size();
+    }
+
+    void Publish(size_t idx, size_t slotIdx) {
+        mHandoff.published[idx].store(&mSlots[slotIdx].file, std::memory_order_release);
+        uint64_t epoch = mHandoff.publishedEpoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+        if (mPublishedSlots[idx] != kNoSlot) {
+            mSlots[mPublishedSlots[idx]].retiredEpoch = epoch;
+        }
+        mPublishedSlots[idx] = slotIdx;
+    }
+
+    size_t AcquireSlot() {
+        for (size_t pass = 0; pass < 2; ++pass) {
+            for (size_t slotIdx = 0; slotIdx < kNumSlots; ++slotIdx) {
+                if (!mSlots[slotIdx].inUse) {
+                    mSlots[slotIdx].inUse = true;
+                    return slotIdx;
+                }
+            }
+            Reclaim();
+        }
+        return kNoSlot;
+    }
+
+    size_t AcquireBuffer() {
+        for (size_t bufferIdx = 0; bufferIdx < kNumSlots; ++bufferIdx) {
+            if (mBuffers[bufferIdx].refCount == 0) {
+                return bufferIdx;
+            }
+        }
+        return kNoSlot;
+    }
+
+    void Reclaim() {
+        uint64_t acknowledged = mHandoff.acknowledgedEpoch.load(std::memory_order_acquire);
+        for (Slot& slot : mSlots) {
+            if (!slot.inUse || slot.retiredEpoch == 0 || slot.retiredEpoch > acknowledged) {
+                continue;
+            }
+            if (slot.buffer != kNoSlot) {
+                Buffer& buffer = mBuffers[slot.buffer];
+                if (--buffer.refCount == 0) {
+                    // give the memory back, rather than holding on to the biggest sample ever loaded
+                    std::vector<float>().swap(buffer.samples);
+                }
+            }
+            slot = Slot{};
+        }
+    }
+
+    GetFileFn mGetFile;
+    GetSamplesFn mGetSamples;
+    Handoff mHandoff{};
+    etl::array<Slot, kNumSlots> mSlots{};
+    etl::array<Buffer, kNumSlots> mBuffers{};
+    // the slot each sample is published in, or kNoSlot
+    etl::array<size_t, TNumSamples> mPublishedSlots{};
+    // updates that are waiting on a free slot. only the latest one matters
+    etl::array<PendingUpdate, TNumSamples> mPendingUpdates{};
+};
+}  // namespace layersynth
@@ -8,7 +8,7 @@
 #include <clapeze/features/state/tomlStateFeature.h>
 #include <clapeze/processor/baseProcessor.h>
 #include <kitdsp/math/util.h>
-#include <kitdsp/volume/dbMeter.h>
+#include <kitdsp/volume/blockDbMeter.h>
 #include <clapeze/processor/transport.h>
 
 #include "descriptor.h"
@@ -113,8 +113,9 @@ class Processor : public BaseProcessor {
         (void)minBlockSize;
         (void)maxBlockSize;
         float sampleRatef = narrow_cast<float>(sampleRate);
-        mMeter = kitdsp::DbMeter(sampleRatef);
-        mMeter.SetFrequency(10.0f, sampleRatef);
+        mMeter = kitdsp::BlockDbMeter(sampleRatef);
+        // short enough to respond to individual notes
+        mMeter.cfg.windowMs = 50.0f;
     }
 
     void ProcessEvent(const clap_event_header_t& event) final {
@@ -200,10 +201,8 @@ class Processor : public BaseProcessor {
         mVoices.SetNumVoices(polyCount);
         mVoices.SetStrategy(polyCount > 1 ? clapeze::VoiceStrategy::Poly : clapeze::VoiceStrategy::MonoLast);
 
-        float db{};
-        for(float in : in.left) {
-            db = mMeter.Process(in);
-        }
+        mMeter.Process(in.left);
+        float db = mMeter.GetRmsDb();
 
         float dummyData{};
         StereoAudioBuffer dummyOut{
@@ -236,7 +235,7 @@ class Processor : public BaseProcessor {
     }
 
     clapeze::VoicePool<Processor, Voice, 16> mVoices;
-    kitdsp::DbMeter mMeter{44100};
+    kitdsp::BlockDbMeter mMeter{44100};
     bool mAudioActive = false;
     ParamsFeature::AudioHandle& mParams;
     VoiceQueue& mVoiceQueue;
@@ -5,6 +5,7 @@
 #include <clapeze/features/assetsFeature.h>
 #include <clapeze/pluginHost.h>
 #include <clapeze/processor/baseProcessor.h>
+#include <clapeze/rtLogger.h>
 #include <etl/queue_spsc_atomic.h>
 #include <etl/string.h>
 #include <fmt/base.h>
@@ -21,25 +22,27 @@
 
 namespace tester {
 using namespace clapeze;
+#if KITSBLIPS_ENABLE_GUI
 ExampleAppLog sLog;
+#endif
 
 class Processor : public clapeze::BaseProcessor {
    public:
-    explicit Processor(clapeze::PluginHost& host) : clapeze::BaseProcessor(host) {}
+    explicit Processor(clapeze::PluginHost& host, clapeze::RtLogger& log) : clapeze::BaseProcessor(host), mLog(log) {}
     ~Processor() = default;
 
     void Activate(double sampleRate, size_t minBlockSize, size_t maxBlockSize) override {
-        sLog.AddLog("Processor::Activate(%f, %lu, %lu)\n", sampleRate, minBlockSize, maxBlockSize);
+        mLog.Debug("Processor::Activate({}, {}, {})", sampleRate, minBlockSize, maxBlockSize);
     }
-    void Deactivate() override { sLog.AddLog("Processor::Deactivate()\n"); }
+    void Deactivate() override { mLog.Debug("Processor::Deactivate()"); }
     void ProcessEvent(const clap_event_header_t& event) override {
         switch (event.type) {
             case CLAP_EVENT_NOTE_ON: {
-                sLog.AddLog("CLAP_EVENT_NOTE_ON\n");
+                mLog.Debug("CLAP_EVENT_NOTE_ON");
                 break;
             }
             case CLAP_EVENT_NOTE_OFF: {
-                sLog.AddLog("CLAP_EVENT_NOTE_OFF\n");
+                mLog.Debug("CLAP_EVENT_NOTE_OFF");
                 break;
             }
             default: {
@@ -51,14 +54,20 @@ class Processor : public clapeze::BaseProcessor {
         return clapeze::ProcessStatus::Sleep;
     }
     void ProcessFlush(const clap_process_t& process) override {}
-    void ProcessReset() override { sLog.AddLog("Processor::ProcessReset()\n"); }
+    void ProcessReset() override { mLog.Debug("Processor::ProcessReset()"); }
+
+   private:
+    clapeze::RtLogger& mLog;
 };
 
 #if KITSBLIPS_ENABLE_GUI
 class GuiApp : public kitgui::BaseApp {
    public:
-    explicit GuiApp(kitgui::Context& ctx, clapeze::PluginHost& host) : kitgui::BaseApp(ctx), mHost(host) {}
+    GuiApp(kitgui::Context& ctx, clapeze::PluginHost& host, clapeze::RtLogger& log)
+        : kitgui::BaseApp(ctx), mHost(host), mLog(log) {}
     void OnUpdate() override {
+        // for hosts without timers, which never drain the log otherwise
+        mLog.Drain();
         static bool showDebugLog{};
         if (ImGui::BeginMenuBar()) {
             if (ImGui::BeginMenu("Debug")) {
@@ -78,6 +87,7 @@ class GuiApp : public kitgui::BaseApp {
 
    private:
     clapeze::PluginHost& mHost;
+    clapeze::RtLogger& mLog;
 };
 #endif
 
@@ -89,16 +99,20 @@ class Plugin : public clapeze::BasePlugin {
 
    protected:
     void Config() override {
-        sLog.Config(GetHost());
+        mLog.Start(GetHost());
 #if KITSBLIPS_ENABLE_GUI
+        sLog.Config(GetHost());
         ConfigFeature<clapeze::AssetsFeature>();
         ConfigFeature<KitguiFeature>(
-            GetHost(), [this](kitgui::Context& ctx) { return std::make_unique<GuiApp>(ctx, GetHost()); },
+            GetHost(), [this](kitgui::Context& ctx) { return std::make_unique<GuiApp>(ctx, GetHost(), mLog); },
             kitgui::SizeConfig{1000, 600, false, true});
 #endif
 
-        ConfigProcessor<Processor>();
+        ConfigProcessor<Processor>(mLog);
     }
+
+   private:
+    clapeze::RtLogger mLog;
 };
 
 CLAPEZE_REGISTER_PLUGIN(Plugin,
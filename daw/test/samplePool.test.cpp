@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <vector>
+#include "layersynth/samplePool.h"
+
+using layersynth::SamplePool;
+
+namespace {
+struct File {
+    const float* samples = nullptr;
+    size_t numSamples = 0;
+    float param = 0.0f;
+};
+using Pool = SamplePool<File, 2>;
+
+// stands in for the main thread's copy of each sample
+struct MainFiles {
+    File files[2]{};
+    std::vector<float> samples[2]{};
+
+    Pool MakePool() {
+        return Pool([this](size_t idx) { return files[idx]; },
+                    [this](size_t idx) -> const std::vector<float>& { return samples[idx]; });
+    }
+};
+}  // namespace
+
+TEST(SamplePool, publishesToAudio) {
+    MainFiles main;
+    Pool pool = main.MakePool();
+    Pool::AudioHandle audio(pool);
+    EXPECT_EQ(audio.GetNumSampleDatas(), 2u);
+    EXPECT_FALSE(audio.OnAudioUpdate());
+    EXPECT_EQ(audio.GetSampleData(0), nullptr);
+    EXPECT_EQ(audio.GetSampleData(2), nullptr);
+
+    main.files[0].param = 1.0f;
+    main.samples[0] = {1.0f, 2.0f, 3.0f};
+    pool.SendFull(0);
+    ASSERT_TRUE(audio.OnAudioUpdate());
+    const File* file = audio.GetSampleData(0);
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(file->param, 1.0f);
+    ASSERT_EQ(file->numSamples, 3u);
+    EXPECT_EQ(file->samples[2], 3.0f);
+    // the pool has its own copy
+    EXPECT_NE(file->samples, main.samples[0].data());
+    EXPECT_EQ(audio.GetSampleData(1), nullptr);
+    EXPECT_FALSE(audio.OnAudioUpdate());
+}
+
+TEST(SamplePool, waitsWhenExhausted) {
+    MainFiles main;
+    Pool pool = main.MakePool();
+    Pool::AudioHandle audio(pool);
+
+    // the audio thread never acknowledges anything, so no slot can be reused
+    for (size_t i = 0; i < Pool::kNumSlots; ++i) {
+        main.files[0].param = static_cast<float>(i);
+        pool.SendFull(0);
+        EXPECT_FALSE(pool.IsPending(0));
+    }
+    main.files[0].param = 100.0f;
+    pool.SendFull(0);
+    EXPECT_TRUE(pool.IsPending(0));
+    main.files[1].param = 200.0f;
+    pool.SendParams(1);
+    EXPECT_TRUE(pool.IsPending(1));
+
+    // still nothing acknowledged
+    pool.OnMainUpdate();
+    EXPECT_TRUE(pool.IsPending(0));
+    ASSERT_TRUE(audio.OnAudioUpdate());
+    EXPECT_EQ(audio.GetSampleData(0)->param, static_cast<float>(Pool::kNumSlots - 1));
+    EXPECT_EQ(audio.GetSampleData(1), nullptr);
+}
+
+TEST(SamplePool, retriesPendingUpdates) {
+    MainFiles main;
+    Pool pool = main.MakePool();
+    Pool::AudioHandle audio(pool);
+    for (size_t i = 0; i < Pool::kNumSlots; ++i) {
+        pool.SendFull(0);
+    }
+    main.files[0].param = 1.0f;
+    pool.SendParams(0);
+    main.samples[0] = {4.0f, 5.0f};
+    pool.SendFull(0);
+    // a later params-only update doesn't downgrade the full one that's waiting
+    main.files[0].param = 2.0f;
+    pool.SendParams(0);
+    ASSERT_TRUE(pool.IsPending(0));
+
+    // the first update picks up the latest epoch, the second acknowledges it
+    audio.OnAudioUpdate();
+    audio.OnAudioUpdate();
+    pool.OnMainUpdate();
+    EXPECT_FALSE(pool.IsPending(0));
+
+    ASSERT_TRUE(audio.OnAudioUpdate());
+    const File* file = audio.GetSampleData(0);
+    EXPECT_EQ(file->param, 2.0f);
+    ASSERT_EQ(file->numSamples, 2u);
+    EXPECT_EQ(file->samples[0], 4.0f);
+}
+
+TEST(SamplePool, sharesBuffersForParamUpdates) {
+    MainFiles main;
+    Pool pool = main.MakePool();
+    Pool::AudioHandle audio(pool);
+    main.samples[0] = {1.0f, 2.0f};
+    pool.SendFull(0);
+    audio.OnAudioUpdate();
+    const File* first = audio.GetSampleData(0);
+    const float* firstSamples = first->samples;
+
+    // a params-only update doesn't read the samples at all
+    main.files[0].param = 1.0f;
+    main.samples[0] = {3.0f};
+    pool.SendParams(0);
+    ASSERT_TRUE(audio.OnAudioUpdate());
+    const File* second = audio.GetSampleData(0);
+    EXPECT_NE(second, first);
+    EXPECT_EQ(second->param, 1.0f);
+    EXPECT_EQ(second->samples, firstSamples);
+    EXPECT_EQ(second->numSamples, 2u);
+
+    // the shared buffer outlives the slot that first held it
+    audio.OnAudioUpdate();
+    pool.OnMainUpdate();
+    EXPECT_EQ(second->samples[1], 2.0f);
+
+    pool.SendFull(0);
+    ASSERT_TRUE(audio.OnAudioUpdate());
+    EXPECT_NE(audio.GetSampleData(0)->samples, firstSamples);
+    EXPECT_EQ(audio.GetSampleData(0)->numSamples, 1u);
+}
+
+TEST(SamplePool, keepsSlotsUntilAcknowledged) {
+    MainFiles main;
+    Pool pool = main.MakePool();
+    Pool::AudioHandle audio(pool);
+    main.files[0].param = 1.0f;
+    main.samples[0] = {1.0f, 2.0f};
+    pool.SendFull(0);
+    audio.OnAudioUpdate();
+    const File* old = audio.GetSampleData(0);
+    const float* oldSamples = old->samples;
+
+    // fill every other slot, which would reuse the old one if it were freed early
+    main.files[0].param = 2.0f;
+    main.samples[0] = {3.0f};
+    for (size_t i = 1; i < Pool::kNumSlots; ++i) {
+        pool.SendFull(0);
+        pool.OnMainUpdate();
+    }
+    EXPECT_EQ(old->param, 1.0f);
+    EXPECT_EQ(oldSamples[1], 2.0f);
+
+    // picking up the new sample doesn't acknowledge it yet, voices may still be playing the old one
+    ASSERT_TRUE(audio.OnAudioUpdate());
+    pool.OnMainUpdate();
+    pool.SendFull(0);
+    EXPECT_TRUE(pool.IsPending(0));
+    EXPECT_EQ(old->param, 1.0f);
+    EXPECT_EQ(oldSamples[1], 2.0f);
+
+    // now it's done with
+    audio.OnAudioUpdate();
+    pool.OnMainUpdate();
+    EXPECT_FALSE(pool.IsPending(0));
+}
@@ -0,0 +1,309 @@
+#include "effects.h"
+
+#include <kitdsp/apps/ensembleChorus.h>
+#include <kitdsp/apps/equalizer3Band.h>
+#include <kitdsp/apps/harmonizer.h>
+#include <kitdsp/apps/psxReverb.h>
+#include <kitdsp/apps/psxReverbPresets.h>
+#include <kitdsp/apps/snesBitcrush.h>
+#include <kitdsp/apps/snesEcho.h>
+#include <kitdsp/apps/snesEchoFilterPresets.h>
+#include <kitdsp/math/units.h>
+#include <kitdsp/math/util.h>
+#include <kitdsp/pitch/frequencyShifter.h>
+#include <kitdsp/samplerate/resampler.h>
+#include <cstring>
+
+using namespace kitdsp;
+
+namespace render {
+namespace {
+size_t ToIndex(float value, size_t count) {
+    return static_cast<size_t>(clamp(value, 0.0f, static_cast<float>(count - 1)) + 0.5f);
+}
+
+class PsxReverbEffect : public Effect {
+   public:
+    PsxReverbEffect(float sampleRate, const Params& params)
+        : mBuffer(PSX::Reverb::GetBufferDesiredSizeFloats(sampleRate)),
+          mReverb({mBuffer.data(), mBuffer.size()}, sampleRate),
+          mMix(params.at("mix")) {
+        mReverb.cfg.preset = static_cast<int16_t>(ToIndex(params.at("preset"), PSX::kNumPresets));
+    }
+
+    void Process(etl::span<float> left, etl::span<float> right) override {
+        for (size_t idx = 0; idx < left.size(); ++idx) {
+            float_2 dry{left[idx], right[idx]};
+            float_2 wet = mReverb.Process(dry);
+            left[idx] = lerp(dry.left, wet.left, mMix);
+            right[idx] = lerp(dry.right, wet.right, mMix);
+        }
+    }
+
+   private:
+    std::vector<float> mBuffer;
+    PSX::Reverb mReverb;
+    float mMix;
+};
+
+class SnesEchoEffect : public Effect {
+   public:
+    SnesEchoEffect(float sampleRate, const Params& params) : mChannels{{sampleRate, params}, {sampleRate, params}} {}
+
+    void Process(etl::span<float> left, etl::span<float> right) override {
+        mChannels[0].Process(left);
+        mChannels[1].Process(right);
+    }
+
+   private:
+    struct Channel {
+        Channel(float sampleRate, const Params& params)
+            : buffer(SNES::kExtremeMaxEchoSamples),
+              echo(buffer.data(), buffer.size()),
+              // like the snecho plugin, the echo runs at the original rate
+              sampler(SNES::kOriginalSampleRate, sampleRate),
+              mix(params.at("mix")) {
+            echo.cfg.echoBufferSize = params.at("size");
+            echo.cfg.echoBufferRangeMaxSamples = params.at("extreme") > 0.5f ? SNES::kExtremeMaxEchoSamples
+                                                                              : SNES::kOriginalMaxEchoSamples;
+            echo.cfg.echoFeedback = params.at("feedback");
+            echo.cfg.echoDelayMod = params.at("delayMod");
+            echo.cfg.filterMix = params.at("filterMix");
+            size_t filterPreset = ToIndex(params.at("filterPreset"), SNES::kNumFilterPresets);
+            memcpy(echo.cfg.filterCoefficients, SNES::kFilterPresets[filterPreset].data, SNES::kFIRTaps);
+        }
+
+        void Process(etl::span<float> inOut) {
+            for (float& sample : inOut) {
+                float wet = sampler.Process<interpolate::InterpolationStrategy::None>(
+                    sample, [this](float in, float& out) { out = echo.Process(in * 0.5f) * 2.0f; });
+                sample = lerp(sample, wet, mix);
+            }
+        }
+
+        std::vector<int16_t> buffer;
+        SNES::Echo echo;
+        Resampler<float> sampler;
+        float mix;
+    };
+    Channel mChannels[2];
+};
+
+class ChorusEffect : public Effect {
+   public:
+    ChorusEffect(float sampleRate, const Params& params)
+        : mBuffer(static_cast<size_t>(sampleRate)), mChorus({mBuffer.data(), mBuffer.size()}, sampleRate) {
+        mChorus.cfg.numVoices = static_cast<size_t>(
+            clamp(params.at("voices"), 2.0f, static_cast<float>(EnsembleChorus::kMaxVoices)));
+        mChorus.cfg.lfoRateHz = params.at("rate");
+        mChorus.cfg.delayBaseMs = params.at("delay");
+        mChorus.cfg.delayModMs = params.at("delay") * params.at("depth");
+        mChorus.cfg.feedback = params.at("feedback");
+        mChorus.cfg.mix = params.at("mix");
+    }
+
+    void Process(etl::span<float> left, etl::span<float> right) override {
+        mChorus.Process(left, right, left, right);
+    }
+
+   private:
+    std::vector<float> mBuffer;
+    EnsembleChorus mChorus;
+};
+
+class HarmonizerEffect : public Effect {
+   public:
+    HarmonizerEffect(float sampleRate, const Params& params)
+        : mBufferLeft(static_cast<size_t>(sampleRate)),
+          mBufferRight(static_cast<size_t>(sampleRate)),
+          mLeft({mBufferLeft.data(), mBufferLeft.size()}, sampleRate),
+          mRight({mBufferRight.data(), mBufferRight.size()}, sampleRate),
+          mMix(params.at("mix")) {
+        Harmonizer::Config cfg;
+        cfg.numVoices =
+            static_cast<size_t>(clamp(params.at("voices"), 1.0f, static_cast<float>(Harmonizer::kMaxVoices)));
+        const char* semitoneParams[Harmonizer::kMaxVoices] = {"semitones1", "semitones2", "semitones3", "semitones4"};
+        for (size_t voice = 0; voice < Harmonizer::kMaxVoices; ++voice) {
+            cfg.voices[voice].pitchRatio = midiToRatio(params.at(semitoneParams[voice]));
+            cfg.voices[voice].grainSizeMs = params.at("grainSize");
+            cfg.voices[voice].level = 1.0f / static_cast<float>(cfg.numVoices);
+        }
+        cfg.feedback = params.at("feedback");
+        mLeft.cfg = cfg;
+        mRight.cfg = cfg;
+    }
+
+    void Process(etl::span<float> left, etl::span<float> right) override {
+        mWet.resize(left.size());
+        Mix(mLeft, left);
+        Mix(mRight, right);
+    }
+
+   private:
+    void Mix(Harmonizer& harmonizer, etl::span<float> inOut) {
+        harmonizer.Process(inOut, mWet);
+        for (size_t idx = 0; idx < inOut.size(); ++idx) {
+            inOut[idx] = lerp(inOut[idx], mWet[idx], mMix);
+        }
+    }
+
+    std::vector<float> mBufferLeft;
+    std::vector<float> mBufferRight;
+    std::vector<float> mWet;
+    Harmonizer mLeft;
+    Harmonizer mRight;
+    float mMix;
+};
+
+class FrequencyShifterEffect : public Effect {
+   public:
+    FrequencyShifterEffect(float sampleRate, const Params& params)
+        : mLeft(sampleRate), mRight(sampleRate), mMix(params.at("mix")) {
+        mLeft.SetFrequencyOffset(params.at("shift"), sampleRate);
+        mRight.SetFrequencyOffset(params.at("shift"), sampleRate);
+    }
+
+    void Process(etl::span<float> left, etl::span<float> right) override {
+        for (size_t idx = 0; idx < left.size(); ++idx) {
+            left[idx] = lerp(left[idx], mLeft.Process(left[idx]), mMix);
+            right[idx] = lerp(right[idx], mRight.Process(right[idx]), mMix);
+        }
+    }
+
+   private:
+    FrequencyShifter mLeft;
+    FrequencyShifter mRight;
+    float mMix;
+};
+
+class BitcrushEffect : public Effect {
+   public:
+    BitcrushEffect(float sampleRate, const Params& params)
+        : mLeft(sampleRate), mRight(sampleRate), mMix(params.at("mix")) {}
+
+    void Process(etl::span<float> left, etl::span<float> right) override {
+        for (size_t idx = 0; idx < left.size(); ++idx) {
+            left[idx] = lerp(left[idx], mLeft.Process(left[idx]), mMix);
+            right[idx] = lerp(right[idx], mRight.Process(right[idx]), mMix);
+        }
+    }
+
+   private:
+    SNES::Bitcrush mLeft;
+    SNES::Bitcrush mRight;
+    float mMix;
+};
+
+class EqualizerEffect : public Effect {
+   public:
+    EqualizerEffect(float sampleRate, const Params& params) {
+        Equalizer3Band::Config cfg;
+        cfg.lowGainDb = params.at("lowGain");
+        cfg.lowFreq = params.at("lowFreq");
+        cfg.midGainDb = params.at("midGain");
+        cfg.highGainDb = params.at("highGain");
+        cfg.highFreq = params.at("highFreq");
+        cfg.sampleRate = sampleRate;
+        mLeft.cfg = cfg;
+        mRight.cfg = cfg;
+    }
+
+    void Process(etl::span<float> left, etl::span<float> right) override {
+        for (size_t idx = 0; idx < left.size(); ++idx) {
+            left[idx] = mLeft.Process(left[idx]);
+            right[idx] = mRight.Process(right[idx]);
+        }
+    }
+
+   private:
+    Equalizer3Band mLeft;
+    Equalizer3Band mRight;
+};
+
+template <typename T>
+std::unique_ptr<Effect> Create(float sampleRate, const Params& params) {
+    return std::make_unique<T>(sampleRate, params);
+}
+}  // namespace
+
+const std::vector<EffectInfo>& GetEffects() {
+    static const std::vector<EffectInfo> effects = {
+        {"psxReverb",
+         "the Playstation SPU reverb",
+         {
+             {"preset", 5.0f, "[0, 9] reverb preset, see psxReverbPresets.h (5 = Hall)"},
+             {"mix", 0.5f, "[0, 1] dry/wet"},
+         },
+         Create<PsxReverbEffect>},
+        {"snesEcho",
+         "the SNES SPC700 echo, per channel",
+         {
+             {"size", 0.5f, "[0, 1] delay length"},
+             {"extreme", 0.0f, "[0, 1] 1 extends the max delay past the original 240ms"},
+             {"feedback", 0.5f, "[-1, 1] feedback"},
+             {"delayMod", 0.0f, "[-1, 1] read head offset"},
+             {"filterPreset", 0.0f, "[0, 3] FIR filter preset, see snesEchoFilterPresets.h"},
+             {"filterMix", 1.0f, "[0, 1] filtered/unfiltered"},
+             {"mix", 0.5f, "[0, 1] dry/wet"},
+         },
+         Create<SnesEchoEffect>},
+        {"chorus",
+         "the ensemble chorus",
+         {
+             {"voices", 2.0f, "[2, 8] number of delay taps"},
+             {"rate", 1.0f, "[unbounded] lfo rate, in hz"},
+             {"delay", 8.0f, "[0, 500] base delay, in ms"},
+             {"depth", 0.25f, "[0, 1] lfo depth, relative to the base delay"},
+             {"feedback", 0.0f, "[-1, 1] feedback"},
+             {"mix", 0.5f, "[0, 1] dry/wet"},
+         },
+         Create<ChorusEffect>},
+        {"harmonizer",
+         "a chord harmonizer, per channel",
+         {
+             {"voices", 1.0f, "[1, 4] number of voices"},
+             {"semitones1", 12.0f, "pitch of voice 1, in semitones"},
+             {"semitones2", 7.0f, "pitch of voice 2, in semitones"},
+             {"semitones3", 4.0f, "pitch of voice 3, in semitones"},
+             {"semitones4", -12.0f, "pitch of voice 4, in semitones"},
+             {"grainSize", 30.0f, "[1, 500] grain length, in ms"},
+             {"feedback", 0.0f, "[0, 1) feedback"},
+             {"mix", 0.5f, "[0, 1] dry/wet"},
+         },
+         Create<HarmonizerEffect>},
+        {"freqShift",
+         "a frequency shifter, per channel",
+         {
+             {"shift", 40.0f, "frequency offset, in hz"},
+             {"mix", 1.0f, "[0, 1] dry/wet"},
+         },
+         Create<FrequencyShifterEffect>},
+        {"snesBitcrush",
+         "the SNES sample pipeline, per channel",
+         {
+             {"mix", 1.0f, "[0, 1] dry/wet"},
+         },
+         Create<BitcrushEffect>},
+        {"eq",
+         "a 3 band equalizer",
+         {
+             {"lowGain", 0.0f, "low shelf gain, in db"},
+             {"lowFreq", 200.0f, "low shelf frequency, in hz"},
+             {"midGain", 0.0f, "mid gain, in db"},
+             {"highGain", 0.0f, "high shelf gain, in db"},
+             {"highFreq", 1000.0f, "high shelf frequency, in hz"},
+         },
+         Create<EqualizerEffect>},
+    };
+    return effects;
+}
+
+const EffectInfo* FindEffect(const std::string& name) {
+    for (const EffectInfo& info : GetEffects()) {
+        if (name == info.name) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+}  // namespace render
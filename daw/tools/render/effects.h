@@ -0,0 +1,41 @@
+#pragma once
+
+#include <etl/span.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace render {
+/**
+ * A kitdsp app, wrapped up so it can process stereo blocks with params set by name.
+ */
+class Effect {
+   public:
+    virtual ~Effect() = default;
+    /** processes a block of stereo audio in place. mono inputs are passed in as identical left and right channels */
+    virtual void Process(etl::span<float> left, etl::span<float> right) = 0;
+};
+
+using Params = std::map<std::string, float>;
+
+struct ParamInfo {
+    const char* name;
+    float defaultValue;
+    const char* description;
+};
+
+struct EffectInfo {
+    const char* name;
+    const char* description;
+    std::vector<ParamInfo> params;
+    /** params is guaranteed to have a value for every ParamInfo */
+    std::unique_ptr<Effect> (*create)(float sampleRate, const Params& params);
+};
+
+/** every effect kitdsp-render knows about */
+const std::vector<EffectInfo>& GetEffects();
+
+/** @returns nullptr if there's no effect with that name */
+const EffectInfo* FindEffect(const std::string& name);
+}  // namespace render
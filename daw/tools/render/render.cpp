@@ -0,0 +1,468 @@
+#include <fmt/core.h>
+#include <toml++/toml.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "effects.h"
+#include "shared/dr_flac.h"
+#include "shared/dr_wav.h"
+
+/**
+ * kitdsp-render: streams audio files through a kitdsp effect, without needing a host. See --help.
+ */
+
+namespace fs = std::filesystem;
+using namespace render;
+
+namespace {
+constexpr const char* kUsage = R"(usage: kitdsp-render [options] <input files...>
+
+Renders .wav and .flac files through a kitdsp effect, writing 32-bit float stereo .wav files.
+
+options:
+  -e, --effect <name>       the effect to use, see --list
+  -p, --param <name=value>  sets an effect param. can be repeated
+  -c, --config <file.toml>  loads the effect, params, tail and block size from a file. --param takes priority
+  -o, --output <path>       the output file. with several inputs, or an existing directory, the directory to write
+                            to instead. by default, outputs are written next to inputs as <name>.<effect>.wav.
+                            nothing is rendered if two inputs would write the same output
+  -j, --jobs <n>            how many files to render at once (default: one per core)
+  -b, --block-size <n>      samples per process call (default: 512)
+  -t, --tail <seconds>      renders this much silence after each input, to let effects ring out (default: 0)
+  -l, --list                lists every effect, and its params
+  -h, --help                shows this message
+
+config files look like:
+  effect = "psxReverb"
+  tail = 4.0
+  [params]
+  preset = 3
+  mix = 0.3
+)";
+
+struct Options {
+    std::string effectName;
+    Params params;
+    std::vector<fs::path> inputs;
+    fs::path output;
+    size_t jobs = std::max(std::thread::hardware_concurrency(), 1u);
+    size_t blockSize = 512;
+    float tailSeconds = 0.0f;
+};
+
+struct Result {
+    bool ok = false;
+    std::string error;
+    fs::path output;
+    double audioSeconds = 0.0;
+    // time spent inside Effect::Process()
+    double processSeconds = 0.0;
+    // including decoding and encoding
+    double wallSeconds = 0.0;
+};
+
+/** reads interleaved float frames out of a wav or flac file */
+class Decoder {
+   public:
+    ~Decoder() {
+        if (mFlac) {
+            drflac_close(mFlac);
+        }
+        if (mWavOpen) {
+            drwav_uninit(&mWav);
+        }
+    }
+
+    bool Open(const fs::path& path) {
+        std::string ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (ext == ".flac") {
+            mFlac = drflac_open_file(path.string().c_str(), nullptr);
+            if (!mFlac) {
+                return false;
+            }
+            mNumChannels = mFlac->channels;
+            mSampleRate = mFlac->sampleRate;
+            return true;
+        }
+        mWavOpen = drwav_init_file(&mWav, path.string().c_str(), nullptr);
+        if (!mWavOpen) {
+            return false;
+        }
+        mNumChannels = mWav.channels;
+        mSampleRate = mWav.sampleRate;
+        return true;
+    }
+
+    /** @returns the number of frames read, which is less than numFrames at the end of the file */
+    size_t Read(float* interleaved, size_t numFrames) {
+        if (mFlac) {
+            return static_cast<size_t>(drflac_read_pcm_frames_f32(mFlac, numFrames, interleaved));
+        }
+        return static_cast<size_t>(drwav_read_pcm_frames_f32(&mWav, numFrames, interleaved));
+    }
+
+    size_t GetNumChannels() const { return mNumChannels; }
+    uint32_t GetSampleRate() const { return mSampleRate; }
+
+   private:
+    drflac* mFlac = nullptr;
+    drwav mWav{};
+    bool mWavOpen = false;
+    size_t mNumChannels = 0;
+    uint32_t mSampleRate = 0;
+};
+
+/** writes interleaved stereo float frames to a wav file */
+class Encoder {
+   public:
+    ~Encoder() { Close(); }
+
+    bool Open(const fs::path& path, uint32_t sampleRate) {
+        drwav_data_format format{};
+        format.container = drwav_container_riff;
+        format.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+        format.channels = 2;
+        format.sampleRate = sampleRate;
+        format.bitsPerSample = 32;
+        mOpen = drwav_init_file_write(&mWav, path.string().c_str(), &format, nullptr);
+        return mOpen;
+    }
+
+    bool Write(const float* interleaved, size_t numFrames) {
+        return drwav_write_pcm_frames(&mWav, numFrames, interleaved) == numFrames;
+    }
+
+    /** finishes the file, and lets go of it */
+    void Close() {
+        if (mOpen) {
+            drwav_uninit(&mWav);
+            mOpen = false;
+        }
+    }
+
+   private:
+    drwav mWav{};
+    bool mOpen = false;
+};
+
+Result RenderFile(const EffectInfo& info, const Options& options, const fs::path& input, const fs::path& output) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    Result result;
+    result.output = output;
+
+    Decoder decoder;
+    if (!decoder.Open(input)) {
+        result.error = "could not open input (only .wav and .flac are supported)";
+        return result;
+    }
+    Encoder encoder;
+    if (!encoder.Open(output, decoder.GetSampleRate())) {
+        result.error = fmt::format("could not open {} for writing", output.string());
+        return result;
+    }
+
+    float sampleRate = static_cast<float>(decoder.GetSampleRate());
+    std::unique_ptr<Effect> effect = info.create(sampleRate, options.params);
+
+    size_t numChannels = decoder.GetNumChannels();
+    size_t blockSize = options.blockSize;
+    std::vector<float> in(blockSize * numChannels);
+    std::vector<float> left(blockSize);
+    std::vector<float> right(blockSize);
+    std::vector<float> out(blockSize * 2);
+
+    size_t tailFrames = static_cast<size_t>(options.tailSeconds * sampleRate);
+    size_t totalFrames = 0;
+    Clock::duration processTime{};
+    for (;;) {
+        size_t numFrames = decoder.Read(in.data(), blockSize);
+        if (numFrames < blockSize) {
+            // past the end of the input, render silence until the tail is done
+            size_t numTail = std::min(blockSize - numFrames, tailFrames);
+            std::fill(in.begin() + static_cast<ptrdiff_t>(numFrames * numChannels),
+                      in.begin() + static_cast<ptrdiff_t>((numFrames + numTail) * numChannels), 0.0f);
+            tailFrames -= numTail;
+            numFrames += numTail;
+        }
+        if (numFrames == 0) {
+            break;
+        }
+
+        // mono inputs go to both channels, anything past stereo is dropped
+        for (size_t idx = 0; idx < numFrames; ++idx) {
+            left[idx] = in[idx * numChannels];
+            right[idx] = in[idx * numChannels + (numChannels > 1 ? 1 : 0)];
+        }
+
+        Clock::time_point processStart = Clock::now();
+        effect->Process({left.data(), numFrames}, {right.data(), numFrames});
+        processTime += Clock::now() - processStart;
+
+        for (size_t idx = 0; idx < numFrames; ++idx) {
+            out[idx * 2] = left[idx];
+            out[idx * 2 + 1] = right[idx];
+        }
+        if (!encoder.Write(out.data(), numFrames)) {
+            // don't leave a truncated file behind, it'd look like a finished render
+            encoder.Close();
+            std::error_code error;
+            fs::remove(output, error);
+            result.error = "write failed";
+            return result;
+        }
+        totalFrames += numFrames;
+    }
+
+    result.ok = true;
+    result.audioSeconds = static_cast<double>(totalFrames) / sampleRate;
+    result.processSeconds = std::chrono::duration<double>(processTime).count();
+    result.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+bool ParseParam(const std::string& arg, Params& params) {
+    size_t equals = arg.find('=');
+    if (equals == std::string::npos || equals == 0) {
+        return false;
+    }
+    char* end = nullptr;
+    std::string value = arg.substr(equals + 1);
+    float number = std::strtof(value.c_str(), &end);
+    if (value.empty() || *end != '\0') {
+        return false;
+    }
+    params[arg.substr(0, equals)] = number;
+    return true;
+}
+
+bool LoadConfig(const fs::path& path, Options& options, std::string& error) {
+    toml::parse_result result = toml::parse_file(path.string());
+    if (!result) {
+        error = fmt::format("{}: {}", path.string(), result.error().description());
+        return false;
+    }
+    toml::table& table = result.table();
+    if (auto effect = table["effect"].value<std::string>()) {
+        options.effectName = *effect;
+    }
+    if (auto tail = table["tail"].value<double>()) {
+        options.tailSeconds = static_cast<float>(*tail);
+    }
+    if (auto blockSize = table["blockSize"].value<int64_t>()) {
+        options.blockSize = static_cast<size_t>(std::max<int64_t>(*blockSize, 1));
+    }
+    if (toml::table* params = table["params"].as_table()) {
+        for (auto&& [key, node] : *params) {
+            std::string name{key.str()};
+            if (auto number = node.template value<double>()) {
+                options.params[name] = static_cast<float>(*number);
+            } else if (auto flag = node.template value<bool>()) {
+                options.params[name] = *flag ? 1.0f : 0.0f;
+            } else {
+                error = fmt::format("{}: param '{}' should be a number or a bool", path.string(), name);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ListEffects() {
+    for (const EffectInfo& info : GetEffects()) {
+        fmt::print("{}: {}\n", info.name, info.description);
+        for (const ParamInfo& param : info.params) {
+            fmt::print("    {}={} {}\n", param.name, param.defaultValue, param.description);
+        }
+    }
+}
+
+fs::path GetOutputPath(const Options& options, const fs::path& input) {
+    bool toDirectory = options.inputs.size() > 1 || fs::is_directory(options.output);
+    if (options.output.empty()) {
+        fs::path output = input;
+        return output.replace_extension(fmt::format(".{}.wav", options.effectName));
+    }
+    if (toDirectory) {
+        return options.output / input.filename().replace_extension(".wav");
+    }
+    return options.output;
+}
+
+/**
+ * Two inputs rendering to the same output would overwrite each other (or race, with --jobs), eg. a/x.wav and b/x.wav
+ * into one directory, or x.wav and x.flac. This finds the first pair that would.
+ * @returns false if there's a collision, and describes it in error
+ */
+bool CheckOutputPaths(const std::vector<fs::path>& inputs, const std::vector<fs::path>& outputs, std::string& error) {
+    std::vector<std::pair<fs::path, size_t>> sorted;
+    for (size_t idx = 0; idx < outputs.size(); ++idx) {
+        std::error_code ignored;
+        fs::path normalized = fs::weakly_canonical(outputs[idx], ignored);
+        sorted.emplace_back(normalized.empty() ? outputs[idx].lexically_normal() : normalized, idx);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t idx = 1; idx < sorted.size(); ++idx) {
+        if (sorted[idx].first == sorted[idx - 1].first) {
+            error = fmt::format("{} and {} would both render to {}. render them separately, or rename one",
+                                inputs[sorted[idx - 1].second].string(), inputs[sorted[idx].second].string(),
+                                outputs[sorted[idx].second].string());
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    Params cliParams;
+    std::string configPath;
+
+    std::vector<std::string> args(argv + 1, argv + argc);
+    for (size_t idx = 0; idx < args.size(); ++idx) {
+        const std::string& arg = args[idx];
+        bool hasValue = idx + 1 < args.size();
+        if (arg == "-h" || arg == "--help") {
+            fmt::print("{}", kUsage);
+            return 0;
+        } else if (arg == "-l" || arg == "--list") {
+            ListEffects();
+            return 0;
+        } else if ((arg == "-e" || arg == "--effect") && hasValue) {
+            options.effectName = args[++idx];
+        } else if ((arg == "-p" || arg == "--param") && hasValue) {
+            if (!ParseParam(args[++idx], cliParams)) {
+                fmt::print(stderr, "bad param '{}', expected name=value\n", args[idx]);
+                return 1;
+            }
+        } else if ((arg == "-c" || arg == "--config") && hasValue) {
+            configPath = args[++idx];
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            options.output = args[++idx];
+        } else if ((arg == "-j" || arg == "--jobs") && hasValue) {
+            options.jobs = std::max(std::strtoul(args[++idx].c_str(), nullptr, 10), 1ul);
+        } else if ((arg == "-b" || arg == "--block-size") && hasValue) {
+            options.blockSize = std::max(std::strtoul(args[++idx].c_str(), nullptr, 10), 1ul);
+        } else if ((arg == "-t" || arg == "--tail") && hasValue) {
+            options.tailSeconds = std::max(std::strtof(args[++idx].c_str(), nullptr), 0.0f);
+        } else if (!arg.empty() && arg[0] == '-') {
+            fmt::print(stderr, "unknown option '{}'\n\n{}", arg, kUsage);
+            return 1;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+
+    if (!configPath.empty()) {
+        std::string error;
+        if (!LoadConfig(configPath, options, error)) {
+            fmt::print(stderr, "{}\n", error);
+            return 1;
+        }
+    }
+    for (const auto& [name, value] : cliParams) {
+        options.params[name] = value;
+    }
+
+    const EffectInfo* info = FindEffect(options.effectName);
+    if (!info) {
+        fmt::print(stderr, "unknown effect '{}'. use --list to see them all\n", options.effectName);
+        return 1;
+    }
+    for (const auto& [name, value] : options.params) {
+        bool known = std::any_of(info->params.begin(), info->params.end(),
+                                 [&name](const ParamInfo& param) { return name == param.name; });
+        if (!known) {
+            fmt::print(stderr, "{} has no param '{}'. use --list to see them all\n", info->name, name);
+            return 1;
+        }
+    }
+    for (const ParamInfo& param : info->params) {
+        options.params.emplace(param.name, param.defaultValue);
+    }
+    if (options.inputs.empty()) {
+        fmt::print(stderr, "no input files\n\n{}", kUsage);
+        return 1;
+    }
+    if (options.inputs.size() > 1 && !options.output.empty()) {
+        std::error_code error;
+        fs::create_directories(options.output, error);
+    }
+
+    std::vector<fs::path> outputs;
+    for (const fs::path& input : options.inputs) {
+        outputs.push_back(GetOutputPath(options, input));
+    }
+    std::string collision;
+    if (!CheckOutputPaths(options.inputs, outputs, collision)) {
+        fmt::print(stderr, "{}\n", collision);
+        return 1;
+    }
+
+    // one file per thread. effects are independent, so there's nothing to share
+    std::vector<Result> results(options.inputs.size());
+    std::atomic<size_t> nextInput{0};
+    std::mutex printMutex;
+    auto worker = [&]() {
+        for (size_t idx = nextInput++; idx < options.inputs.size(); idx = nextInput++) {
+            const fs::path& input = options.inputs[idx];
+            const fs::path& output = outputs[idx];
+            // this runs on a worker thread, where an exception would take the whole process down. a missing output
+            // is an error here, and just means there's nothing to overwrite
+            std::error_code error;
+            if (fs::equivalent(input, output, error)) {
+                results[idx].error = "output would overwrite the input";
+            } else {
+                results[idx] = RenderFile(*info, options, input, output);
+            }
+
+            const Result& result = results[idx];
+            std::lock_guard<std::mutex> lock(printMutex);
+            if (result.ok) {
+                fmt::print("{} -> {}: {:.2f}s of audio in {:.3f}s ({:.1f}x realtime, {:.1f}x including file io)\n",
+                           input.string(), output.string(), result.audioSeconds, result.processSeconds,
+                           result.audioSeconds / std::max(result.processSeconds, 1e-9),
+                           result.audioSeconds / std::max(result.wallSeconds, 1e-9));
+            } else {
+                fmt::print(stderr, "{}: {}\n", input.string(), result.error);
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    size_t numThreads = std::min(options.jobs, options.inputs.size());
+    std::vector<std::thread> threads;
+    for (size_t idx = 1; idx < numThreads; ++idx) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t numFailed = 0;
+    double totalAudio = 0.0;
+    double totalProcess = 0.0;
+    for (const Result& result : results) {
+        numFailed += result.ok ? 0 : 1;
+        totalAudio += result.audioSeconds;
+        totalProcess += result.processSeconds;
+    }
+    if (results.size() > 1) {
+        fmt::print("{} files, {:.2f}s of audio in {:.3f}s on {} threads ({:.1f}x realtime per thread, {:.1f}x overall)\n",
+                   results.size() - numFailed, totalAudio, elapsed, numThreads,
+                   totalAudio / std::max(totalProcess, 1e-9), totalAudio / std::max(elapsed, 1e-9));
+    }
+    return numFailed == 0 ? 0 : 1;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <etl/span.h>
+#include <cassert>
 #include <cstring>
 #include "kitdsp/math/shy_fft.h"
 
@@ -436,4 +438,270 @@ class FastYin {
         return size + index;
     }
 };
-}  // namespace kitdsp
\ No newline at end of file
+
+/**
+ * @KitDSP
+ * A streaming version of FastYin, for tracking pitch continuously instead of on one-off buffers. Feed it audio in
+ * whatever block sizes you like, and it runs the YIN algorithm on the last bufferSize samples every hopSize samples.
+ *
+ * Overlapping windows mostly contain the same audio, so instead of redoing everything per window:
+ * - the window is split into hops, and each hop is only FFT'd once, when it arrives. the spectrum of the full window
+ *   (and the half-window used as the correlation kernel) are then rebuilt by phase shifting and summing the stored hop
+ *   spectra. Hops are always a quarter or half of the window, so the phase shifts are just swaps and sign flips.
+ * - the power terms come from the per-hop energies instead of re-summing the window.
+ * That's one forward and one inverse FFT per hop, down from 3 FFTs, and ~2/3 the work area.
+ *
+ * Unlike the rest of this file, this is kitdsp code and follows kitdsp naming.
+ */
+template <size_t bufferSize = 2048, size_t hopSize = bufferSize / 4>
+class StreamingYin {
+   public:
+    static constexpr size_t kNumHops = bufferSize / hopSize;
+    static_assert(bufferSize % hopSize == 0 && (kNumHops == 2 || kNumHops == 4),
+                  "hopSize must be a half or a quarter of bufferSize");
+
+    static constexpr size_t kWorkAreaDesiredSize =
+        /* history */ bufferSize +
+        /* hop spectra */ kNumHops * bufferSize +
+        /* fftInput */ bufferSize +
+        /* acf, reused as the yin buffer */ bufferSize;
+
+    static constexpr float kDefaultThreshold = 0.20f;
+
+    /**
+     * @param sampleRate the sample rate of the audio stream.
+     * @param workArea chunk of memory used for internal computation. must be at least kWorkAreaDesiredSize floats big.
+     * @param threshold the YIN threshold, see FastYin
+     */
+    StreamingYin(float sampleRate, etl::span<float> workArea, float threshold = kDefaultThreshold)
+        : mSampleRate(sampleRate), mThreshold(threshold) {
+        assert(workArea.size() >= kWorkAreaDesiredSize);
+        float* p = workArea.data();
+        mHistory = p;
+        p += bufferSize;
+        mHopSpectra = p;
+        p += kNumHops * bufferSize;
+        mFftInput = p;
+        p += bufferSize;
+        mAcf = p;
+        mFft.Init();
+        Reset();
+    }
+
+    void Reset() {
+        std::memset(mHistory, 0, bufferSize * sizeof(float));
+        std::memset(mHopSpectra, 0, kNumHops * bufferSize * sizeof(float));
+        for (size_t hop = 0; hop < kNumHops; ++hop) {
+            mHopEnergy[hop] = 0.0f;
+        }
+        mOldestHop = 0;
+        mFill = 0;
+        mLatest = {};
+    }
+
+    /**
+     * Feeds in audio.
+     * @return true if at least one new pitch estimate was made. fetch it with GetLatest()
+     */
+    bool Process(etl::span<const float> in) {
+        bool updated = false;
+        size_t idx = 0;
+        while (idx < in.size()) {
+            size_t count = hopSize - mFill;
+            count = count < in.size() - idx ? count : in.size() - idx;
+            std::memcpy(mHistory + bufferSize - hopSize + mFill, in.data() + idx, count * sizeof(float));
+            mFill += count;
+            idx += count;
+
+            if (mFill == hopSize) {
+                Analyze();
+                updated = true;
+                std::memmove(mHistory, mHistory + hopSize, (bufferSize - hopSize) * sizeof(float));
+                mFill = 0;
+            }
+        }
+        return updated;
+    }
+
+    /**
+     * the most recent estimate. pitch is -1 if nothing has been detected, and probability is the confidence in the
+     * estimate (1 - aperiodicity).
+     */
+    const PitchDetectionResult& GetLatest() const { return mLatest; }
+
+   private:
+    static constexpr size_t kYinSize = bufferSize / 2;
+
+    void Analyze() {
+        // 1. FFT the newest hop, replacing the oldest one
+        const float* hop = mHistory + bufferSize - hopSize;
+        float energy = 0.0f;
+        for (size_t j = 0; j < hopSize; ++j) {
+            mFftInput[j] = hop[j];
+            energy += hop[j] * hop[j];
+        }
+        std::memset(mFftInput + hopSize, 0, (bufferSize - hopSize) * sizeof(float));
+        mFft.Direct(mFftInput, mHopSpectra + mOldestHop * bufferSize);
+        mHopEnergy[mOldestHop] = energy;
+        mOldestHop = (mOldestHop + 1) % kNumHops;
+
+        float kernelEnergy = 0.0f;
+        for (size_t hopIdx = 0; hopIdx < kNumHops / 2; ++hopIdx) {
+            kernelEnergy += mHopEnergy[(mOldestHop + hopIdx) % kNumHops];
+        }
+        if (kernelEnergy <= 0.0f) {
+            // silence, the difference function would be all 0/0
+            mLatest = {};
+            mLatest.probability = 0.0f;
+            return;
+        }
+
+        // 2. rebuild the spectra of the kernel (the first half of the window) in mAcf, and the whole window in
+        // mFftInput. these are in shy_fft's layout: real parts, then negated imaginary parts
+        std::memset(mAcf, 0, bufferSize * sizeof(float));
+        for (size_t hopIdx = 0; hopIdx < kNumHops / 2; ++hopIdx) {
+            AccumulateHop(hopIdx, mAcf);
+        }
+        std::memcpy(mFftInput, mAcf, bufferSize * sizeof(float));
+        for (size_t hopIdx = kNumHops / 2; hopIdx < kNumHops; ++hopIdx) {
+            AccumulateHop(hopIdx, mFftInput);
+        }
+
+        // 3. cross-correlate via complex multiplication with the conjugate of the kernel. the kernel is zero-padded
+        // to twice its length, so none of the lags we care about wrap around.
+        const size_t half = bufferSize / 2;
+        mFftInput[0] *= mAcf[0];
+        mFftInput[half] *= mAcf[half];
+        for (size_t k = 1; k < half; ++k) {
+            float xr = mFftInput[k];
+            float xs = mFftInput[half + k];
+            float kr = mAcf[k];
+            float ks = mAcf[half + k];
+            mFftInput[k] = xr * kr + xs * ks;
+            mFftInput[half + k] = xs * kr - xr * ks;
+        }
+        mFft.Inverse(mFftInput, mAcf);
+
+        // 4. difference function, equation (7) in the yin paper. the power terms slide along with tau, built from the
+        // hop energies instead of re-summing the kernel
+        const float scale = 1.0f / static_cast<float>(bufferSize);
+        float powerTerm = kernelEnergy;
+        float* yinBuffer = mAcf;
+        for (size_t tau = 0; tau < kYinSize; ++tau) {
+            float next = mHistory[tau + kYinSize];
+            yinBuffer[tau] = kernelEnergy + powerTerm - 2.0f * mAcf[tau] * scale;
+            powerTerm += next * next - mHistory[tau] * mHistory[tau];
+        }
+
+        // 5. the rest is the same as FastYin
+        CumulativeMeanNormalizedDifference(yinBuffer);
+        int32_t tauEstimate = AbsoluteThreshold(yinBuffer, mLatest);
+        if (tauEstimate != -1) {
+            mLatest.pitch = mSampleRate / ParabolicInterpolation(yinBuffer, tauEstimate);
+        } else {
+            mLatest.pitch = -1;
+        }
+    }
+
+    /** adds the spectrum of a hop, phase shifted to where it sits in the window, to out */
+    void AccumulateHop(size_t hopIdx, float* out) const {
+        const float* spectrum = mHopSpectra + ((mOldestHop + hopIdx) % kNumHops) * bufferSize;
+        const size_t half = bufferSize / 2;
+        // a delay of a quarter window is a rotation by -i per bin
+        const size_t quarterTurns = hopIdx * (4 / kNumHops);
+
+        // the DC and nyquist bins are real, and their rotations always land on a multiple of 2pi
+        out[0] += spectrum[0];
+        out[half] += spectrum[half];
+        if (quarterTurns == 0) {
+            for (size_t k = 1; k < half; ++k) {
+                out[k] += spectrum[k];
+                out[half + k] += spectrum[half + k];
+            }
+            return;
+        }
+        for (size_t k = 1; k < half; ++k) {
+            float r = spectrum[k];
+            float s = spectrum[half + k];
+            switch ((quarterTurns * k) & 3) {
+                case 0:
+                    out[k] += r;
+                    out[half + k] += s;
+                    break;
+                case 1:
+                    out[k] -= s;
+                    out[half + k] += r;
+                    break;
+                case 2:
+                    out[k] -= r;
+                    out[half + k] -= s;
+                    break;
+                case 3:
+                    out[k] += s;
+                    out[half + k] -= r;
+                    break;
+            }
+        }
+    }
+
+    // steps 3-5 below are FastYin's, working on an external buffer
+
+    static void CumulativeMeanNormalizedDifference(float* yinBuffer) {
+        yinBuffer[0] = 1;
+        float runningSum = 0;
+        for (size_t tau = 1; tau < kYinSize; tau++) {
+            runningSum += yinBuffer[tau];
+            yinBuffer[tau] *= tau / runningSum;
+        }
+    }
+
+    int32_t AbsoluteThreshold(const float* yinBuffer, PitchDetectionResult& result) const {
+        size_t tau;
+        for (tau = 2; tau < kYinSize; tau++) {
+            if (yinBuffer[tau] < mThreshold) {
+                while (tau + 1 < kYinSize && yinBuffer[tau + 1] < yinBuffer[tau]) {
+                    tau++;
+                }
+                break;
+            }
+        }
+
+        if (tau == kYinSize || !(yinBuffer[tau] < mThreshold)) {
+            result.probability = 0;
+            result.pitched = false;
+            return -1;
+        }
+        result.probability = 1 - yinBuffer[tau];
+        result.pitched = true;
+        return static_cast<int32_t>(tau);
+    }
+
+    static float ParabolicInterpolation(const float* yinBuffer, int32_t tauEstimate) {
+        int32_t x0 = tauEstimate < 1 ? tauEstimate : tauEstimate - 1;
+        int32_t x2 = tauEstimate + 1 < static_cast<int32_t>(kYinSize) ? tauEstimate + 1 : tauEstimate;
+        if (x0 == tauEstimate) {
+            return yinBuffer[tauEstimate] <= yinBuffer[x2] ? tauEstimate : x2;
+        } else if (x2 == tauEstimate) {
+            return yinBuffer[tauEstimate] <= yinBuffer[x0] ? tauEstimate : x0;
+        }
+        float s0 = yinBuffer[x0];
+        float s1 = yinBuffer[tauEstimate];
+        float s2 = yinBuffer[x2];
+        return tauEstimate + (s2 - s0) / (2 * (2 * s1 - s2 - s0));
+    }
+
+    float mSampleRate{};
+    float mThreshold{};
+
+    float* mHistory{};
+    float* mHopSpectra{};
+    float* mFftInput{};
+    float* mAcf{};
+    float mHopEnergy[kNumHops]{};
+    size_t mOldestHop{};
+    size_t mFill{};
+
+    PitchDetectionResult mLatest{};
+    kitdsp::ShyFFT<float, bufferSize> mFft;
+};
+}  // namespace kitdsp
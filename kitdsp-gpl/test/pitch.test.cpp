@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <vector>
 
 #include "kitdsp-gpl/YinPitchDetector.h"
 #include "kitdsp/math/util.h"
@@ -27,4 +28,74 @@ TEST(YinPitchDetector, CanDetectSines) {
 
     ASSERT_TRUE(result.pitched);
     ASSERT_NEAR(result.pitch, frequencyHz, 1.0f);
-}
\ No newline at end of file
+}
+TEST(StreamingYin, TracksSines) {
+    constexpr float sampleRate = 48000.0f;
+    constexpr size_t bufferSize = 2048;
+    using Detector = StreamingYin<bufferSize>;
+    std::vector<float> workArea(Detector::kWorkAreaDesiredSize);
+    Detector detector(sampleRate, {workArea.data(), workArea.size()});
+
+    // silence shouldn't detect anything
+    float silence[512] = {};
+    ASSERT_TRUE(detector.Process(silence));
+    ASSERT_FALSE(detector.GetLatest().pitched);
+
+    size_t nextSample = 0;
+    for (float frequencyHz : {440.0f, 220.0f, 137.0f, 924.0f}) {
+        // odd block sizes, to make sure hops straddling blocks work
+        float block[331];
+        for (size_t iteration = 0; iteration < 20; ++iteration) {
+            for (float& sample : block) {
+                sample = sinf(kTwoPi * nextSample * frequencyHz / sampleRate);
+                nextSample++;
+            }
+            detector.Process(block);
+        }
+
+        const PitchDetectionResult& result = detector.GetLatest();
+        EXPECT_TRUE(result.pitched);
+        EXPECT_GT(result.probability, 0.9f);
+        EXPECT_NEAR(result.pitch, frequencyHz, 1.0f);
+    }
+}
+
+TEST(StreamingYin, MatchesDirectDifference) {
+    // with a half window hop, compare against a brute force yin on the same window
+    constexpr float sampleRate = 48000.0f;
+    constexpr size_t bufferSize = 1024;
+    using Detector = StreamingYin<bufferSize, bufferSize / 2>;
+    std::vector<float> workArea(Detector::kWorkAreaDesiredSize);
+    Detector detector(sampleRate, {workArea.data(), workArea.size()});
+
+    std::vector<float> audio(bufferSize * 4);
+    for (size_t i = 0; i < audio.size(); ++i) {
+        audio[i] = 0.5f * sinf(kTwoPi * i * 300.0f / sampleRate) + 0.25f * sinf(kTwoPi * i * 900.0f / sampleRate);
+    }
+    detector.Process({audio.data(), audio.size()});
+
+    const float* window = audio.data() + audio.size() - bufferSize;
+    std::vector<float> normalized(bufferSize / 2, 1.0f);
+    float runningSum = 0.0f;
+    for (size_t tau = 1; tau < bufferSize / 2; ++tau) {
+        float difference = 0.0f;
+        for (size_t j = 0; j < bufferSize / 2; ++j) {
+            float delta = window[j] - window[j + tau];
+            difference += delta * delta;
+        }
+        runningSum += difference;
+        normalized[tau] = difference * tau / runningSum;
+    }
+    // first dip under the threshold
+    size_t best = 2;
+    while (best < normalized.size() && normalized[best] >= Detector::kDefaultThreshold) {
+        best++;
+    }
+    while (best + 1 < normalized.size() && normalized[best + 1] < normalized[best]) {
+        best++;
+    }
+
+    ASSERT_TRUE(detector.GetLatest().pitched);
+    EXPECT_NEAR(sampleRate / detector.GetLatest().pitch, static_cast<float>(best), 1.0f);
+    EXPECT_NEAR(detector.GetLatest().probability, 1.0f - normalized[best], 0.01f);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+namespace kitdsp::bench {
+/** the block sizes every kernel is measured at, in samples */
+inline void BlockSizes(benchmark::internal::Benchmark* b) {
+    b->ArgName("block");
+    for (int64_t blockSize : {32, 64, 256, 1024}) {
+        b->Arg(blockSize);
+    }
+}
+
+/**
+ * Reports time_per_sample and samples_per_second for a benchmark that processes one block per iteration. A stereo
+ * sample counts as one sample, so mono and stereo numbers are the cost of the same length of audio.
+ *
+ * time_per_sample is in seconds, which the console shows with a prefix (eg. 1.5ns), and json stores as is.
+ */
+inline void SetSamplesProcessed(benchmark::State& state, int64_t blockSize) {
+    double samples = static_cast<double>(blockSize);
+    state.counters["samples_per_second"] = benchmark::Counter(samples, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["time_per_sample"] =
+        benchmark::Counter(samples, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+/** deterministic white noise in [-1, 1], so every run processes the same input */
+inline std::vector<float> Noise(size_t len, uint32_t seed = 1) {
+    std::vector<float> out(len);
+    uint32_t state = seed;
+    for (float& sample : out) {
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        sample = static_cast<float>(state) / 2147483648.0f - 1.0f;
+    }
+    return out;
+}
+}  // namespace kitdsp::bench
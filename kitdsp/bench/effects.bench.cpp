@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include "bench.h"
+#include "kitdsp/apps/psxReverb.h"
+#include "kitdsp/apps/snesEcho.h"
+#include "kitdsp/math/vector.h"
+#include "kitdsp/sampling/delayLine.h"
+
+using namespace kitdsp;
+
+namespace {
+template <size_t CHANNELS>
+void DelayLineHermite(benchmark::State& state) {
+    // a modulated read, which is the expensive part of a chorus or flanger
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> in = bench::Noise(blockSize * CHANNELS);
+    std::vector<float> out(blockSize * CHANNELS);
+    std::vector<float> memory(4096 * CHANNELS);
+    std::vector<DelayLine<float>> lines;
+    for (size_t channel = 0; channel < CHANNELS; ++channel) {
+        lines.emplace_back(etl::span<float>(memory.data() + channel * 4096, 4096));
+    }
+
+    for (auto _ : state) {
+        for (size_t channel = 0; channel < CHANNELS; ++channel) {
+            const float* channelIn = in.data() + channel * blockSize;
+            float* channelOut = out.data() + channel * blockSize;
+            for (size_t idx = 0; idx < blockSize; ++idx) {
+                lines[channel].Write(channelIn[idx]);
+                float delay = 1000.0f + channelIn[idx] * 100.0f;
+                channelOut[idx] = lines[channel].Read<interpolate::InterpolationStrategy::Hermite>(delay);
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK_TEMPLATE(DelayLineHermite, 1)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(DelayLineHermite, 2)->Apply(bench::BlockSizes);
+
+void PsxReverbStereo(benchmark::State& state) {
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> in = bench::Noise(blockSize * 2);
+    std::vector<float> out(blockSize * 2);
+    const float sampleRate = 48000.0f;
+    std::vector<float> memory(PSX::Reverb::GetBufferDesiredSizeFloats(sampleRate));
+    PSX::Reverb reverb({memory.data(), memory.size()}, sampleRate);
+    // "Hall", one of the bigger presets
+    reverb.cfg.preset = 5;
+
+    for (auto _ : state) {
+        for (size_t idx = 0; idx < blockSize; ++idx) {
+            float_2 wet = reverb.Process({in[idx * 2], in[idx * 2 + 1]});
+            out[idx * 2] = wet.left;
+            out[idx * 2 + 1] = wet.right;
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK(PsxReverbStereo)->Apply(bench::BlockSizes);
+
+void SnesEchoMono(benchmark::State& state) {
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> in = bench::Noise(blockSize);
+    std::vector<float> out(blockSize);
+    std::vector<int16_t> memory(SNES::kOriginalMaxEchoSamples);
+    SNES::Echo echo(memory.data(), memory.size());
+    echo.cfg.echoFeedback = 0.5f;
+    echo.cfg.filterMix = 1.0f;
+
+    for (auto _ : state) {
+        for (size_t idx = 0; idx < blockSize; ++idx) {
+            out[idx] = echo.Process(in[idx]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK(SnesEchoMono)->Apply(bench::BlockSizes);
+}  // namespace
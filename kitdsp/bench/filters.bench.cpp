@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+#include "bench.h"
+#include "kitdsp/filters/biquad.h"
+#include "kitdsp/filters/svf.h"
+
+using namespace kitdsp;
+
+namespace {
+template <size_t CHANNELS>
+void BiquadLowPass(benchmark::State& state) {
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> in = bench::Noise(blockSize * CHANNELS);
+    std::vector<float> out(blockSize * CHANNELS);
+    rbj::BiquadFilter filters[CHANNELS];
+    for (rbj::BiquadFilter& filter : filters) {
+        filter.SetQ<rbj::BiquadFilterMode::LowPass>(0.707f);
+        filter.SetFrequency<rbj::BiquadFilterMode::LowPass>(1000.0f, 48000.0f);
+    }
+
+    for (auto _ : state) {
+        for (size_t channel = 0; channel < CHANNELS; ++channel) {
+            const float* channelIn = in.data() + channel * blockSize;
+            float* channelOut = out.data() + channel * blockSize;
+            for (size_t idx = 0; idx < blockSize; ++idx) {
+                channelOut[idx] = filters[channel].Process(channelIn[idx]);
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK_TEMPLATE(BiquadLowPass, 1)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(BiquadLowPass, 2)->Apply(bench::BlockSizes);
+
+template <size_t CHANNELS>
+void BiquadModulated(benchmark::State& state) {
+    // recalculating coefficients every sample, like when a filter is swept by an envelope
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> in = bench::Noise(blockSize * CHANNELS);
+    std::vector<float> out(blockSize * CHANNELS);
+    rbj::BiquadFilter filters[CHANNELS];
+
+    for (auto _ : state) {
+        for (size_t channel = 0; channel < CHANNELS; ++channel) {
+            const float* channelIn = in.data() + channel * blockSize;
+            float* channelOut = out.data() + channel * blockSize;
+            for (size_t idx = 0; idx < blockSize; ++idx) {
+                filters[channel].template SetFrequency<rbj::BiquadFilterMode::LowPass>(500.0f + static_cast<float>(idx), 48000.0f);
+                channelOut[idx] = filters[channel].Process(channelIn[idx]);
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK_TEMPLATE(BiquadModulated, 1)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(BiquadModulated, 2)->Apply(bench::BlockSizes);
+
+template <size_t CHANNELS>
+void EmileSvfLowPass(benchmark::State& state) {
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> in = bench::Noise(blockSize * CHANNELS);
+    std::vector<float> out(blockSize * CHANNELS);
+    EmileSvf filters[CHANNELS];
+    for (EmileSvf& filter : filters) {
+        filter.SetFrequency(1000.0f, 48000.0f, 0.707f);
+    }
+
+    for (auto _ : state) {
+        for (size_t channel = 0; channel < CHANNELS; ++channel) {
+            const float* channelIn = in.data() + channel * blockSize;
+            float* channelOut = out.data() + channel * blockSize;
+            for (size_t idx = 0; idx < blockSize; ++idx) {
+                channelOut[idx] = filters[channel].template Process<SvfFilterMode::LowPass>(channelIn[idx]);
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK_TEMPLATE(EmileSvfLowPass, 1)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(EmileSvfLowPass, 2)->Apply(bench::BlockSizes);
+
+template <size_t CHANNELS>
+void EmileSvfModulated(benchmark::State& state) {
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> in = bench::Noise(blockSize * CHANNELS);
+    std::vector<float> out(blockSize * CHANNELS);
+    EmileSvf filters[CHANNELS];
+
+    for (auto _ : state) {
+        for (size_t channel = 0; channel < CHANNELS; ++channel) {
+            const float* channelIn = in.data() + channel * blockSize;
+            float* channelOut = out.data() + channel * blockSize;
+            for (size_t idx = 0; idx < blockSize; ++idx) {
+                filters[channel].SetFrequency(500.0f + static_cast<float>(idx), 48000.0f, 0.707f);
+                channelOut[idx] = filters[channel].template Process<SvfFilterMode::LowPass>(channelIn[idx]);
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK_TEMPLATE(EmileSvfModulated, 1)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(EmileSvfModulated, 2)->Apply(bench::BlockSizes);
+}  // namespace
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include "bench.h"
+#include "kitdsp/lookupTables/sineLut.h"
+#include "kitdsp/math/approx.h"
+#include "kitdsp/math/shy_fft.h"
+#include "kitdsp/math/util.h"
+
+using namespace kitdsp;
+
+namespace {
+// the standard library versions, as a baseline for the approximations
+float stdSin2pif(float x) {
+    return sinf(x * kTwoPi);
+}
+float stdTanhf(float x) {
+    return ::tanhf(x);
+}
+float stdRsqrtf(float x) {
+    return 1.0f / sqrtf(x);
+}
+float stdAtanf(float x) {
+    return ::atanf(x);
+}
+
+/**
+ * Measures a function of one float over a block. Inputs are in [0, 1), which is one period for the sin2pif functions,
+ * and a reasonable range for the others.
+ */
+template <float (*FN)(float)>
+void Function(benchmark::State& state) {
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> in = bench::Noise(blockSize);
+    for (float& sample : in) {
+        sample = sample * 0.5f + 0.5f;
+    }
+    std::vector<float> out(blockSize);
+
+    for (auto _ : state) {
+        for (size_t idx = 0; idx < blockSize; ++idx) {
+            out[idx] = FN(in[idx]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK_TEMPLATE(Function, stdSin2pif)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, approx::sin2pif_poly)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, approx::sin2pif_nasty)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, sin2pif_lut)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, sin2pif_lut_lerp)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, stdTanhf)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, approx::tanhf)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, stdRsqrtf)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, approx::rsqrtf)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, stdAtanf)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Function, approx::atanf)->Apply(bench::BlockSizes);
+
+/**
+ * One FFT of SIZE samples per iteration, so SIZE doubles as the block size.
+ */
+template <size_t SIZE>
+void ShyFftRoundTrip(benchmark::State& state) {
+    std::vector<float> in = bench::Noise(SIZE);
+    std::vector<float> scratch(SIZE);
+    std::vector<float> spectrum(SIZE);
+    std::vector<float> out(SIZE);
+    ShyFFT<float, SIZE> fft;
+    fft.Init();
+
+    for (auto _ : state) {
+        // both transforms trash their input
+        std::copy(in.begin(), in.end(), scratch.begin());
+        fft.Direct(scratch.data(), spectrum.data());
+        fft.Inverse(spectrum.data(), out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, SIZE);
+}
+BENCHMARK_TEMPLATE(ShyFftRoundTrip, 32);
+BENCHMARK_TEMPLATE(ShyFftRoundTrip, 64);
+BENCHMARK_TEMPLATE(ShyFftRoundTrip, 256);
+BENCHMARK_TEMPLATE(ShyFftRoundTrip, 1024);
+}  // namespace
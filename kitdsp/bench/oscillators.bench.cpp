@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+#include "bench.h"
+#include "kitdsp/osc/blepOscillator.h"
+#include "kitdsp/osc/dsfOscillator.h"
+#include "kitdsp/osc/emileOscillator.h"
+#include "kitdsp/osc/naiveOscillator.h"
+
+using namespace kitdsp;
+
+// oscillators are generators, so they're only measured mono: a stereo oscillator is just two of them
+
+namespace {
+template <typename OSCILLATOR>
+void Oscillator(benchmark::State& state) {
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> out(blockSize);
+    OSCILLATOR osc;
+    osc.SetFrequency(440.0f, 48000.0f);
+
+    for (auto _ : state) {
+        for (size_t idx = 0; idx < blockSize; ++idx) {
+            out[idx] = osc.Process();
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK_TEMPLATE(Oscillator, naive::RampUpOscillator)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Oscillator, naive::PulseOscillator)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Oscillator, blep::RampUpOscillator)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Oscillator, blep::PulseOscillator)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Oscillator, blep::TriangleOscillator)->Apply(bench::BlockSizes);
+
+void Dsf(benchmark::State& state) {
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> out(blockSize);
+    DsfOscillator osc;
+    osc.Init(48000.0f);
+    osc.SetFreqCarrier(440.0f);
+    osc.SetFreqModulator(880.0f);
+    osc.SetFalloff(0.5f);
+
+    for (auto _ : state) {
+        for (size_t idx = 0; idx < blockSize; ++idx) {
+            osc.Process();
+            out[idx] = osc.Formula1();
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK(Dsf)->Apply(bench::BlockSizes);
+
+template <emile::OscillatorShape SHAPE>
+void Emile(benchmark::State& state) {
+    // emile oscillators render whole blocks at a time
+    size_t blockSize = static_cast<size_t>(state.range(0));
+    std::vector<float> out(blockSize);
+    emile::Oscillator osc;
+    osc.Init();
+
+    for (auto _ : state) {
+        osc.Render<SHAPE>(440.0f / 48000.0f, 0.5f, out.data(), blockSize);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    bench::SetSamplesProcessed(state, state.range(0));
+}
+BENCHMARK_TEMPLATE(Emile, emile::OSCILLATOR_SHAPE_SAW)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Emile, emile::OSCILLATOR_SHAPE_SQUARE)->Apply(bench::BlockSizes);
+BENCHMARK_TEMPLATE(Emile, emile::OSCILLATOR_SHAPE_TRIANGLE)->Apply(bench::BlockSizes);
+}  // namespace
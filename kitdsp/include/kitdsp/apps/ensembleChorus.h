@@ -0,0 +1,89 @@
+#pragma once
+
+#include <etl/span.h>
+#include "kitdsp/control/approach.h"
+#include "kitdsp/control/lfoBank.h"
+#include "kitdsp/math/vector.h"
+#include "kitdsp/sampling/delayLine.h"
+
+namespace kitdsp {
+/**
+ * A multi-voice chorus, in the style of string ensembles (Solina) and the Juno choruses. Each voice is a tap into one
+ * shared delay line, modulated by its own triangle LFO. The LFOs are all the same rate, but evenly spaced in phase, so
+ * the voices never move together. Voices are spread across the stereo field, alternating left and right.
+ *
+ * With 2 voices this sounds the same as kitdsp::Chorus, but it's quite a bit cheaper: the LFOs and delay times are only
+ * updated at control rate (every kControlRate samples), and linearly ramped in between.
+ *
+ * Because all the state is in the one delay line, it can also be used as a shared send effect: sum several sources
+ * into the input with whatever send levels you like, and set mix to 1.0
+ */
+class EnsembleChorus {
+   public:
+    static constexpr size_t kMaxVoices = 8;
+    static constexpr size_t kControlRate = 16;
+
+    struct Config {
+        /// [2, kMaxVoices] number of delay taps
+        size_t numVoices = 2;
+
+        /// [unbounded] lfo rate
+        float lfoRateHz = 1.0f;
+
+        /// [0.0f, GetMaxDelay()] base delay. the LFO will modulate above and below this value
+        float delayBaseMs = 8.0f;
+        /// [0.0f, GetMaxDelay()] delay amount. will be clamped if delayBase + mod goes over a limit.
+        float delayModMs = 2.0f;
+
+        /// [-1, 1] feedback level. 1 = 100%
+        float feedback = 0.0f;
+        /// [0, 1] dry/wet mix
+        float mix = 0.5f;
+    };
+
+    Config cfg;
+
+    EnsembleChorus(etl::span<float> buffer, float sampleRate);
+
+    void Reset();
+
+    float_2 Process(float in);
+    float_2 Process(float_2 in);
+
+    /**
+     * Processes a full block. in and out may alias each other.
+     */
+    void Process(etl::span<const float> inLeft,
+                 etl::span<const float> inRight,
+                 etl::span<float> outLeft,
+                 etl::span<float> outRight);
+
+    float GetMaxDelayMs() const;
+
+   private:
+    /** advances the LFO bank by one control period and sets up delay ramps for the next kControlRate samples */
+    void UpdateControl();
+    float_2 ProcessSample(float_2 in);
+
+    DelayLine<float> mDelayLine;
+    float mSampleRate;
+    float mSamplesPerMs;
+    size_t mNumVoices{};
+    size_t mControlCounter{};
+
+    // one triangle LFO per voice, all at the same rate
+    lfo::LfoBank<kMaxVoices> mLfo;
+
+    // per voice delay ramps, in samples
+    float mDelay[kMaxVoices]{};
+    float mDelayStep[kMaxVoices]{};
+
+    // per voice stereo gains
+    float mGainLeft[kMaxVoices]{};
+    float mGainRight[kMaxVoices]{};
+    float mFeedbackGain{};
+
+    Approach mDelayBaseMs;
+    Approach mDelayModMs;
+};
+}  // namespace kitdsp
@@ -1,33 +1,81 @@
 #pragma once
 
-#include "kitdsp/control/lfo.h"
-#include "kitdsp/sampling/delayLine.h"
+#include <etl/span.h>
 #include "kitdsp/filters/biquad.h"
-#include "kitdsp/math/interpolate.h"
-#include "kitdsp/math/vector.h"
+#include "kitdsp/sampling/delayLine.h"
 
 namespace kitdsp {
-class H910PitchShifter {
+/**
+ * A chord harmonizer: renders up to kMaxVoices pitch shifted copies of the input, all reading from one shared delay
+ * line. Each voice uses the same technique as H910PitchShifter (two crossfaded grains sweeping through the delay line),
+ * so a single voice sounds identical to it, but N voices cost a lot less than N shifters: the input is only stored
+ * once, and the output filter only runs once on the mix.
+ */
+class Harmonizer {
    public:
-    H910PitchShifter(etl::span<float> buffer, float sampleRate);
-    void Reset();
+    static constexpr size_t kMaxVoices = 4;
 
-    void SetParams(float pitchRatio, float grainSizeMs = 30.0f, float baseDelayMs = 0.0f, float feedback = 0.0f);
+    struct Voice {
+        /// [0, unbounded] ratio of output pitch to input pitch. 2.0 is an octave up, 0.5 an octave down
+        float pitchRatio = 1.0f;
+        /// [1.0f, GetMaxGrainSizeMs()] length of each grain. shorter is more "warbly", longer is more "echoey"
+        float grainSizeMs = 30.0f;
+        /// [0, 1] output level of this voice. a silent voice is skipped, but its grains keep moving, so it comes back
+        /// in without a jump
+        float level = 1.0f;
 
-    float Process(float in);
+        bool operator==(const Voice& other) const {
+            return pitchRatio == other.pitchRatio && grainSizeMs == other.grainSizeMs && level == other.level;
+        }
+        bool operator!=(const Voice& other) const { return !(*this == other); }
+    };
+
+    struct Config {
+        /// [1, kMaxVoices] number of active voices, starting from voices[0]. to mute a voice, set its level to 0
+        /// instead of leaving it out, so the voices after it don't move into its place (and pick up its grains)
+        size_t numVoices = 1;
+        Voice voices[kMaxVoices];
+        /// [0.0f, GetMaxGrainSizeMs()] extra delay before the grains
+        float baseDelayMs = 0.0f;
+        /// [0, 1) amount of output sent back into the delay line
+        float feedback = 0.0f;
+    };
+
+    Config cfg;
+
+    Harmonizer(etl::span<float> buffer, float sampleRate);
+    void Reset();
 
-    size_t GetMaxGrainSize() const;
+    float Process(float in);
+    /**
+     * Processes a full block. cfg is assumed to be constant for the whole block. in and out may alias each other.
+     */
+    void Process(etl::span<const float> in, etl::span<float> out);
 
-    size_t GetEffectiveDelay() const;
+    float GetMaxGrainSizeMs() const;
 
    private:
+    /** recalculates everything derived from cfg, but only if it has changed */
+    void UpdateParams();
+
     DelayLine<float> mDelayLine;
-    lfo::Phasor mGrainPhasor;
-    float mSampleRate;
-    float mGrainSizeSamples;
-    float mBaseDelaySamples;
-    bool mSlowing;
-    float mFeedback;
     rbj::BiquadFilter mFilterOut;
+    float mSampleRate;
+    Config mLastCfg;
+    bool mParamsValid{};
+
+    // derived from cfg
+    size_t mNumVoices{};
+    float mBaseDelaySamples{};
+    float mFeedback{};
+    float mGrainSizeSamples[kMaxVoices]{};
+    float mAdvance[kMaxVoices]{};
+    // the grain delay is offset + direction * phase, which sweeps upwards when slowing, and downwards when speeding up
+    float mDelayOffset[kMaxVoices]{};
+    float mDelayDirection[kMaxVoices]{};
+    float mLevel[kMaxVoices]{};
+
+    // signal state
+    float mPhase[kMaxVoices]{};
 };
 }  // namespace kitdsp
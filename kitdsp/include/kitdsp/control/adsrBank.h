@@ -0,0 +1,246 @@
+#pragma once
+
+#include <etl/span.h>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "kitdsp/control/adsr.h"
+#include "kitdsp/control/approach.h"
+#include "kitdsp/control/gateEventQueue.h"
+#include "kitdsp/math/util.h"
+
+namespace kitdsp {
+/**
+ * N ApproachAdsr envelopes, advanced together. Each envelope is a lane, and lanes are stored side by side so the per
+ * sample update is the same straight-line math on every lane, which the compiler can vectorize. Stage changes are
+ * rare, so they're handled separately, and only when a lane actually finishes a stage.
+ *
+ * Gate events can be sent immediately, or at a sample offset into the next block, which is how notes are timed in a
+ * plugin. Output curves match ApproachAdsr.
+ */
+template <size_t N>
+class AdsrBank {
+   public:
+    using State = ApproachAdsr::State;
+    static constexpr size_t kNumLanes = N;
+    static constexpr size_t kMaxEvents = N * 4;
+
+    AdsrBank() {
+        for (size_t lane = 0; lane < N; ++lane) {
+            mAttackH[lane] = 1.0f;
+            mDecayH[lane] = 1.0f;
+            mSustain[lane] = 0.0f;
+            mReleaseH[lane] = 1.0f;
+            mChokeH[lane] = 1.0f;
+        }
+        Reset();
+    }
+
+    void Reset() {
+        for (size_t lane = 0; lane < N; ++lane) {
+            Reset(lane);
+        }
+        mEvents.Clear();
+    }
+
+    void Reset(size_t lane) {
+        mCurrent[lane] = 0.0f;
+        EnterState(lane, State::Idle);
+    }
+
+    /** sets the params for every lane */
+    void SetParams(float attackMs, float decayMs, float sustainValue, float releaseMs, float sampleRate) {
+        SetParams(0, attackMs, decayMs, sustainValue, releaseMs, sampleRate);
+        for (size_t lane = 1; lane < N; ++lane) {
+            mAttackH[lane] = mAttackH[0];
+            mDecayH[lane] = mDecayH[0];
+            mSustain[lane] = mSustain[0];
+            mReleaseH[lane] = mReleaseH[0];
+            mChokeH[lane] = mChokeH[0];
+            EnterState(lane, mState[lane]);
+        }
+    }
+
+    /** sets the params for a single lane, see ApproachAdsr::SetParams() */
+    void SetParams(size_t lane, float attackMs, float decayMs, float sustainValue, float releaseMs, float sampleRate) {
+        assert(lane < N);
+        mAttackH[lane] = Approach::CalculateHalfLifeFromSettleTime(attackMs, sampleRate, cSettlePrecision, 1.0f);
+        mDecayH[lane] = Approach::CalculateHalfLifeFromSettleTime(decayMs, sampleRate, cSettlePrecision,
+                                                                  kitdsp::max(0.001f, 1.0f - sustainValue));
+        mSustain[lane] = sustainValue;
+        mReleaseH[lane] = Approach::CalculateHalfLifeFromSettleTime(releaseMs, sampleRate, cSettlePrecision,
+                                                                    kitdsp::max(sustainValue, 0.001f));
+        mChokeH[lane] = Approach::CalculateHalfLifeFromSettleTime(1.0f, sampleRate, cSettlePrecision, 1.0f);
+        EnterState(lane, mState[lane]);
+    }
+
+    void TriggerOpen(size_t lane) { Apply(lane, GateEvent::Open); }
+    void TriggerClose(size_t lane) { Apply(lane, GateEvent::Close); }
+    void TriggerChoke(size_t lane) { Apply(lane, GateEvent::Choke); }
+
+    /**
+     * Queues up a gate event to happen offset samples into the next Process() call. If too many events are queued up,
+     * this happens immediately instead.
+     */
+    void Trigger(size_t lane, GateEvent event, size_t offset) {
+        assert(lane < N);
+        if (!mEvents.Push(lane, event, offset)) {
+            Apply(lane, event);
+        }
+    }
+
+    /** advances every lane by one sample. read the results with GetValue() */
+    void Process() {
+        mEvents.PopDue(0, [this](size_t lane, GateEvent event) { Apply(lane, event); });
+        ProcessSample();
+        mEvents.Advance(1);
+    }
+
+    /**
+     * Renders a block of numSamples for every lane. The output is laid out lane by lane, so lane n is in
+     * out[n * numSamples, (n + 1) * numSamples).
+     */
+    void Process(size_t numSamples, etl::span<float> out) {
+        assert(out.size() >= numSamples * N);
+        for (size_t idx = 0; idx < numSamples; ++idx) {
+            mEvents.PopDue(idx, [this](size_t lane, GateEvent event) { Apply(lane, event); });
+            ProcessSample();
+            for (size_t lane = 0; lane < N; ++lane) {
+                out[lane * numSamples + idx] = mCurrent[lane];
+            }
+        }
+        mEvents.Advance(numSamples);
+    }
+
+    float GetValue(size_t lane) const { return mCurrent[lane]; }
+    State GetState(size_t lane) const { return mState[lane]; }
+    bool IsProcessing(size_t lane) const { return mState[lane] != State::Idle; }
+
+   private:
+    void Apply(size_t lane, GateEvent event) {
+        assert(lane < N);
+        switch (event) {
+            case GateEvent::Open: {
+                // retrigger, like ApproachAdsr
+                EnterState(lane, State::Attack);
+                break;
+            }
+            case GateEvent::Close: {
+                State state = mState[lane];
+                if (state == State::Attack || state == State::Decay || state == State::Sustain) {
+                    EnterState(lane, State::Release);
+                }
+                break;
+            }
+            case GateEvent::Choke: {
+                EnterState(lane, State::Choke);
+                break;
+            }
+        }
+    }
+
+    void ProcessSample() {
+        // the hot loop: no branches, just selects and masks, so every lane can be done at once
+        uint32_t anyFinished = 0;
+        for (size_t lane = 0; lane < N; ++lane) {
+            float target = mTarget[lane];
+            float current = mCurrent[lane] + (target - mCurrent[lane]) * mH[lane];
+            uint32_t settled = fabsf(target - current) < cSettlePrecision;
+            mCurrent[lane] = settled ? target : current;
+            mFinished[lane] = settled & mMoving[lane];
+            anyFinished |= mFinished[lane];
+        }
+
+        if (anyFinished) {
+            for (size_t lane = 0; lane < N; ++lane) {
+                if (mFinished[lane]) {
+                    EnterState(lane, NextState(mState[lane]));
+                }
+            }
+        }
+    }
+
+    static State NextState(State state) {
+        switch (state) {
+            case State::Attack: {
+                return State::Decay;
+            }
+            case State::Decay: {
+                return State::Sustain;
+            }
+            case State::Choke:
+            case State::Release: {
+                return State::Idle;
+            }
+            case State::Idle:
+            case State::Sustain: {
+                break;
+            }
+        }
+        return state;
+    }
+
+    void EnterState(size_t lane, State state) {
+        mState[lane] = state;
+        switch (state) {
+            case State::Idle: {
+                mTarget[lane] = 0.0f;
+                mH[lane] = 1.0f;
+                mMoving[lane] = 0u;
+                break;
+            }
+            case State::Sustain: {
+                // jumps straight to the sustain level, so changing it takes effect immediately
+                mTarget[lane] = mSustain[lane];
+                mH[lane] = 1.0f;
+                mMoving[lane] = 0u;
+                break;
+            }
+            case State::Attack: {
+                mTarget[lane] = 1.0f;
+                mH[lane] = mAttackH[lane];
+                mMoving[lane] = 1u;
+                break;
+            }
+            case State::Decay: {
+                mTarget[lane] = mSustain[lane];
+                mH[lane] = mDecayH[lane];
+                mMoving[lane] = 1u;
+                break;
+            }
+            case State::Release: {
+                mTarget[lane] = 0.0f;
+                mH[lane] = mReleaseH[lane];
+                mMoving[lane] = 1u;
+                break;
+            }
+            case State::Choke: {
+                mTarget[lane] = 0.0f;
+                mH[lane] = mChokeH[lane];
+                mMoving[lane] = 1u;
+                break;
+            }
+        }
+    }
+
+    static constexpr float cSettlePrecision = 0.0001f;
+
+    // per-sample state, one entry per lane
+    alignas(16) float mCurrent[N]{};
+    alignas(16) float mTarget[N]{};
+    alignas(16) float mH[N]{};
+    // 1 if the current stage moves on to another when it settles
+    alignas(16) uint32_t mMoving[N]{};
+    alignas(16) uint32_t mFinished[N]{};
+
+    // per-lane params
+    State mState[N]{};
+    float mAttackH[N]{};
+    float mDecayH[N]{};
+    float mSustain[N]{};
+    float mReleaseH[N]{};
+    float mChokeH[N]{};
+
+    GateEventQueue<kMaxEvents> mEvents{};
+};
+}  // namespace kitdsp
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <etl/span.h>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "kitdsp/control/dx7Envelope.h"
+#include "kitdsp/control/gateEventQueue.h"
+#include "kitdsp/math/units.h"
+
+namespace kitdsp {
+/**
+ * N Dx7Envelope envelopes, advanced together. Like AdsrBank, lanes are stored side by side so the per sample update
+ * can be vectorized, and stage changes only happen when a lane actually reaches the end of a segment.
+ *
+ * Differences from Dx7Envelope: segments always move towards their level, even if the envelope was retriggered from
+ * somewhere that puts the level on the other side of where the segment would normally start, and segment 2 holds
+ * still once it's reached its level, instead of continuing on.
+ */
+template <size_t N>
+class Dx7EnvelopeBank {
+   public:
+    using State = Dx7Envelope::State;
+    static constexpr size_t kNumLanes = N;
+    static constexpr size_t kNumSegments = 4;
+    static constexpr size_t kMaxEvents = N * 4;
+
+    Dx7EnvelopeBank() {
+        const float defaultLevel[kNumSegments] = {0.0f, 1.0f, 1.0f, 0.0f};
+        for (size_t lane = 0; lane < N; ++lane) {
+            mSampleRate[lane] = 0.0f;
+            for (size_t segment = 0; segment < kNumSegments; ++segment) {
+                mLevel[segment][lane] = defaultLevel[segment];
+                mDurationMs[segment][lane] = 1.0f;
+                mSegmentAdvance[segment][lane] = 1.0f;
+            }
+        }
+        Reset();
+    }
+
+    void Reset() {
+        for (size_t lane = 0; lane < N; ++lane) {
+            Reset(lane);
+        }
+        mEvents.Clear();
+    }
+
+    void Reset(size_t lane) {
+        mCurrent[lane] = 0.0f;
+        EnterState(lane, State::Idle);
+    }
+
+    /** sets a segment for every lane */
+    void SetSegment(size_t idx, float level, float durationMs, float sampleRate) {
+        for (size_t lane = 0; lane < N; ++lane) {
+            SetSegment(lane, idx, level, durationMs, sampleRate);
+        }
+    }
+
+    /** sets a segment for a single lane, see Dx7Envelope::SetSegment() */
+    void SetSegment(size_t lane, size_t idx, float level, float durationMs, float sampleRate) {
+        assert(lane < N && idx < kNumSegments);
+        mLevel[idx][lane] = level;
+        mDurationMs[idx][lane] = durationMs;
+        mSampleRate[lane] = sampleRate;
+
+        float lastLevel = 0.0f;
+        for (size_t segment = 0; segment < kNumSegments; ++segment) {
+            float dy = mLevel[segment][lane] - lastLevel;
+            float durationSamples = msToSamples(mDurationMs[segment][lane], sampleRate);
+            mSegmentAdvance[segment][lane] = durationSamples == 0.0f ? dy : dy / durationSamples;
+            lastLevel = mLevel[segment][lane];
+        }
+
+        if (mState[lane] != State::Idle && mState[lane] != State::Choke) {
+            EnterState(lane, mState[lane]);
+        }
+    }
+
+    void TriggerOpen(size_t lane) { Apply(lane, GateEvent::Open); }
+    void TriggerClose(size_t lane) { Apply(lane, GateEvent::Close); }
+    void TriggerChoke(size_t lane) { Apply(lane, GateEvent::Choke); }
+
+    /**
+     * Queues up a gate event to happen offset samples into the next Process() call. If too many events are queued up,
+     * this happens immediately instead.
+     */
+    void Trigger(size_t lane, GateEvent event, size_t offset) {
+        assert(lane < N);
+        if (!mEvents.Push(lane, event, offset)) {
+            Apply(lane, event);
+        }
+    }
+
+    /** advances every lane by one sample. read the results with GetValue() */
+    void Process() {
+        mEvents.PopDue(0, [this](size_t lane, GateEvent event) { Apply(lane, event); });
+        ProcessSample();
+        mEvents.Advance(1);
+    }
+
+    /**
+     * Renders a block of numSamples for every lane. The output is laid out lane by lane, so lane n is in
+     * out[n * numSamples, (n + 1) * numSamples).
+     */
+    void Process(size_t numSamples, etl::span<float> out) {
+        assert(out.size() >= numSamples * N);
+        for (size_t idx = 0; idx < numSamples; ++idx) {
+            mEvents.PopDue(idx, [this](size_t lane, GateEvent event) { Apply(lane, event); });
+            ProcessSample();
+            for (size_t lane = 0; lane < N; ++lane) {
+                out[lane * numSamples + idx] = mCurrent[lane];
+            }
+        }
+        mEvents.Advance(numSamples);
+    }
+
+    float GetValue(size_t lane) const { return mCurrent[lane]; }
+    State GetState(size_t lane) const { return mState[lane]; }
+    bool IsProcessing(size_t lane) const { return mState[lane] != State::Idle; }
+
+   private:
+    void Apply(size_t lane, GateEvent event) {
+        assert(lane < N);
+        switch (event) {
+            case GateEvent::Open: {
+                EnterState(lane, State::Segment0);
+                break;
+            }
+            case GateEvent::Close: {
+                State state = mState[lane];
+                if (state == State::Segment0 || state == State::Segment1 || state == State::Segment2) {
+                    EnterState(lane, State::Segment3);
+                }
+                break;
+            }
+            case GateEvent::Choke: {
+                EnterState(lane, State::Choke);
+                break;
+            }
+        }
+    }
+
+    void ProcessSample() {
+        // the hot loop: no branches, just selects and masks, so every lane can be done at once
+        uint32_t anyFinished = 0;
+        for (size_t lane = 0; lane < N; ++lane) {
+            float target = mTarget[lane];
+            uint32_t isGoingDown = mCurrent[lane] > target;
+            float current = mCurrent[lane] + mAdvance[lane];
+            uint32_t isBelow = current <= target;
+            uint32_t isAbove = current >= target;
+            uint32_t reached = (isGoingDown & isBelow) | ((isGoingDown ^ 1u) & isAbove);
+            mCurrent[lane] = reached ? target : current;
+            mFinished[lane] = reached & mMoving[lane];
+            anyFinished |= mFinished[lane];
+        }
+
+        if (anyFinished) {
+            for (size_t lane = 0; lane < N; ++lane) {
+                if (mFinished[lane]) {
+                    FinishState(lane);
+                }
+            }
+        }
+    }
+
+    void FinishState(size_t lane) {
+        switch (mState[lane]) {
+            case State::Segment0: {
+                EnterState(lane, State::Segment1);
+                break;
+            }
+            case State::Segment1: {
+                EnterState(lane, State::Segment2);
+                break;
+            }
+            case State::Segment2: {
+                // sustain: hold still until the gate closes
+                mAdvance[lane] = 0.0f;
+                mMoving[lane] = 0u;
+                break;
+            }
+            case State::Segment3: {
+                EnterState(lane, State::Choke);
+                break;
+            }
+            case State::Choke: {
+                EnterState(lane, State::Idle);
+                break;
+            }
+            case State::Idle: {
+                break;
+            }
+        }
+    }
+
+    void EnterState(size_t lane, State state) {
+        mState[lane] = state;
+        switch (state) {
+            case State::Idle: {
+                mTarget[lane] = 0.0f;
+                mAdvance[lane] = 0.0f;
+                mMoving[lane] = 0u;
+                break;
+            }
+            case State::Choke: {
+                // 1 ms, or right away if there's no sample rate to go on yet
+                mTarget[lane] = 0.0f;
+                float chokeSamples = mSampleRate[lane] > 0.0f ? mSampleRate[lane] / 1000.0f : 1.0f;
+                mAdvance[lane] = -mCurrent[lane] / chokeSamples;
+                mMoving[lane] = 1u;
+                break;
+            }
+            case State::Segment0:
+            case State::Segment1:
+            case State::Segment2:
+            case State::Segment3: {
+                size_t segment = static_cast<size_t>(state) - static_cast<size_t>(State::Segment0);
+                float target = mLevel[segment][lane];
+                float advance = fabsf(mSegmentAdvance[segment][lane]);
+                float distance = target - mCurrent[lane];
+                // a flat segment that starts somewhere else jumps straight to its level
+                advance = advance == 0.0f ? distance : (distance < 0.0f ? -advance : advance);
+                mTarget[lane] = target;
+                mAdvance[lane] = advance;
+                mMoving[lane] = 1u;
+                break;
+            }
+        }
+    }
+
+    // per-sample state, one entry per lane
+    alignas(16) float mCurrent[N]{};
+    alignas(16) float mTarget[N]{};
+    alignas(16) float mAdvance[N]{};
+    // 1 if the current stage moves on to another when it's reached
+    alignas(16) uint32_t mMoving[N]{};
+    alignas(16) uint32_t mFinished[N]{};
+
+    // per-lane params
+    State mState[N]{};
+    float mSampleRate[N]{};
+    float mLevel[kNumSegments][N]{};
+    float mDurationMs[kNumSegments][N]{};
+    float mSegmentAdvance[kNumSegments][N]{};
+
+    GateEventQueue<kMaxEvents> mEvents{};
+};
+}  // namespace kitdsp
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kitdsp {
+enum class GateEvent : uint8_t {
+    Open,
+    Close,
+    Choke,
+};
+
+/**
+ * A small fixed-size queue of gate events for a bank of envelopes, so they can be triggered at a sample offset into the
+ * next block instead of at the start of it. Events are kept sorted by offset, and events with the same offset come out
+ * in the order they were pushed.
+ */
+template <size_t CAPACITY>
+class GateEventQueue {
+   public:
+    void Clear() {
+        mHead = 0;
+        mSize = 0;
+    }
+
+    /**
+     * @returns false if the queue is full, in which case the event is dropped
+     */
+    bool Push(size_t lane, GateEvent event, size_t offset) {
+        if (mSize == CAPACITY) {
+            return false;
+        }
+        // compact first, so there's always room at the end
+        if (mHead + mSize == CAPACITY) {
+            for (size_t idx = 0; idx < mSize; ++idx) {
+                mEvents[idx] = mEvents[mHead + idx];
+            }
+            mHead = 0;
+        }
+        size_t idx = mHead + mSize;
+        while (idx > mHead && mEvents[idx - 1].offset > offset) {
+            mEvents[idx] = mEvents[idx - 1];
+            idx--;
+        }
+        mEvents[idx] = {static_cast<uint32_t>(lane), static_cast<uint32_t>(offset), event};
+        mSize++;
+        return true;
+    }
+
+    /**
+     * Calls fn(lane, event) for each event that's due by the given offset, and removes it.
+     */
+    template <typename F>
+    void PopDue(size_t offset, F&& fn) {
+        while (mSize > 0 && mEvents[mHead].offset <= offset) {
+            const Entry& entry = mEvents[mHead];
+            mHead++;
+            mSize--;
+            fn(static_cast<size_t>(entry.lane), entry.event);
+        }
+    }
+
+    /**
+     * Moves time forward, so offsets of the remaining events are relative to the next block.
+     */
+    void Advance(size_t numSamples) {
+        for (size_t idx = mHead; idx < mHead + mSize; ++idx) {
+            mEvents[idx].offset = mEvents[idx].offset > numSamples ? mEvents[idx].offset - numSamples : 0;
+        }
+        if (mSize == 0) {
+            mHead = 0;
+        }
+    }
+
+    size_t Size() const { return mSize; }
+
+   private:
+    struct Entry {
+        uint32_t lane;
+        uint32_t offset;
+        GateEvent event;
+    };
+    Entry mEvents[CAPACITY]{};
+    size_t mHead = 0;
+    size_t mSize = 0;
+};
+}  // namespace kitdsp
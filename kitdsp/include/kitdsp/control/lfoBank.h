@@ -0,0 +1,192 @@
+#pragma once
+
+#include <etl/span.h>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "kitdsp/control/lfo.h"
+#include "kitdsp/math/approx.h"
+#include "kitdsp/math/hash.h"
+#include "kitdsp/math/util.h"
+
+namespace kitdsp {
+namespace lfo {
+enum class Shape {
+    // in phase with a cos wave, like SineOscillator
+    Sine,
+    // in phase with a cos wave, like TriangleOscillator
+    Triangle,
+    // ramps from -1 up to 1
+    Saw,
+    Square,
+    // the saw, quantized to a number of steps
+    Stepped,
+    // a new random value every cycle
+    SampleAndHold,
+    // random values like SampleAndHold, but smoothly interpolated from one to the next
+    SmoothRandom,
+};
+
+/**
+ * N LFOs that share a shape, but each have their own rate and phase. Phases are stored side by side, and each shape is
+ * a straight-line loop over every lane, so the whole bank steps at once with SIMD. Random shapes hash a per-lane cycle
+ * counter instead of keeping RNG state, so they don't need any branching either.
+ *
+ * LFOs usually don't need to run at audio rate: call Process(numSamples) once per block (or per control period) and
+ * read the lanes with GetValue(). Outputs are bipolar, [-1, 1].
+ */
+template <size_t N>
+class LfoBank {
+   public:
+    static constexpr size_t kNumLanes = N;
+
+    explicit LfoBank(uint32_t seed = 0) : mSeed(seed) {
+        for (size_t lane = 0; lane < N; ++lane) {
+            mAdvance[lane] = 0.0f;
+        }
+        Reset();
+    }
+
+    /** resets every phase to 0, and the random shapes to the start of their sequences */
+    void Reset() {
+        for (size_t lane = 0; lane < N; ++lane) {
+            mPhase[lane] = 0.0f;
+            // golden ratio spacing, so lanes don't share random sequences
+            mCycle[lane] = mSeed + static_cast<uint32_t>(lane) * 0x9e3779b9u;
+        }
+        UpdateValues();
+    }
+
+    void SetShape(Shape shape) {
+        mShape = shape;
+        UpdateValues();
+    }
+
+    /** how many levels Shape::Stepped has */
+    void SetSteps(size_t steps) {
+        mSteps = static_cast<float>(max<size_t>(steps, 2));
+        UpdateValues();
+    }
+
+    /** sets the rate of every lane */
+    void SetFrequency(float frequencyHz, float sampleRate) {
+        float advance = sampleRate == 0.0f ? 0.0f : frequencyHz / sampleRate;
+        for (size_t lane = 0; lane < N; ++lane) {
+            mAdvance[lane] = advance;
+        }
+    }
+
+    void SetFrequency(size_t lane, float frequencyHz, float sampleRate) {
+        assert(lane < N);
+        mAdvance[lane] = sampleRate == 0.0f ? 0.0f : frequencyHz / sampleRate;
+    }
+
+    /** jumps a lane to a phase in [0, 1). useful for spreading lanes out, or for hard sync */
+    void SetPhase(size_t lane, float phase) {
+        assert(lane < N);
+        mPhase[lane] = Phasor::WrapPhase(phase);
+        UpdateValues();
+    }
+
+    /**
+     * Advances every lane by numSamples, then updates their values. Call once per block for control-rate modulation.
+     */
+    void Process(float numSamples = 1.0f) {
+        for (size_t lane = 0; lane < N; ++lane) {
+            float phase = mPhase[lane] + mAdvance[lane] * numSamples;
+            // floor(), done by hand so it vectorizes
+            int32_t wraps = static_cast<int32_t>(phase);
+            wraps -= static_cast<int32_t>(phase < static_cast<float>(wraps));
+            mPhase[lane] = phase - static_cast<float>(wraps);
+            mCycle[lane] += static_cast<uint32_t>(wraps);
+        }
+        UpdateValues();
+    }
+
+    /**
+     * Renders numSamples at audio rate for every lane. The output is laid out lane by lane, so lane n is in
+     * out[n * numSamples, (n + 1) * numSamples).
+     */
+    void Process(size_t numSamples, etl::span<float> out) {
+        assert(out.size() >= numSamples * N);
+        for (size_t idx = 0; idx < numSamples; ++idx) {
+            Process(1.0f);
+            for (size_t lane = 0; lane < N; ++lane) {
+                out[lane * numSamples + idx] = mValue[lane];
+            }
+        }
+    }
+
+    float GetValue(size_t lane) const { return mValue[lane]; }
+    float GetPhase(size_t lane) const { return mPhase[lane]; }
+
+   private:
+    static float Random(uint32_t cycle) { return hash(cycle) * 2.0f - 1.0f; }
+
+    void UpdateValues() {
+        // one loop per shape, so each loop is free of branches
+        switch (mShape) {
+            case Shape::Sine: {
+                for (size_t lane = 0; lane < N; ++lane) {
+                    mValue[lane] = approx::cos2pif_poly(mPhase[lane]);
+                }
+                break;
+            }
+            case Shape::Triangle: {
+                for (size_t lane = 0; lane < N; ++lane) {
+                    mValue[lane] = fabsf(mPhase[lane] - 0.5f) * 4.0f - 1.0f;
+                }
+                break;
+            }
+            case Shape::Saw: {
+                for (size_t lane = 0; lane < N; ++lane) {
+                    mValue[lane] = mPhase[lane] * 2.0f - 1.0f;
+                }
+                break;
+            }
+            case Shape::Square: {
+                for (size_t lane = 0; lane < N; ++lane) {
+                    mValue[lane] = mPhase[lane] < 0.5f ? 1.0f : -1.0f;
+                }
+                break;
+            }
+            case Shape::Stepped: {
+                float scale = 2.0f / (mSteps - 1.0f);
+                for (size_t lane = 0; lane < N; ++lane) {
+                    // phase is never negative, so truncating is the same as floor()
+                    mValue[lane] = static_cast<float>(static_cast<int32_t>(mPhase[lane] * mSteps)) * scale - 1.0f;
+                }
+                break;
+            }
+            case Shape::SampleAndHold: {
+                for (size_t lane = 0; lane < N; ++lane) {
+                    mValue[lane] = Random(mCycle[lane]);
+                }
+                break;
+            }
+            case Shape::SmoothRandom: {
+                for (size_t lane = 0; lane < N; ++lane) {
+                    float from = Random(mCycle[lane]);
+                    float to = Random(mCycle[lane] + 1u);
+                    // smoothstep, so the slope is continuous across cycles
+                    float t = mPhase[lane];
+                    t = t * t * (3.0f - 2.0f * t);
+                    mValue[lane] = from + (to - from) * t;
+                }
+                break;
+            }
+        }
+    }
+
+    Shape mShape = Shape::Sine;
+    float mSteps = 8.0f;
+    uint32_t mSeed{};
+
+    alignas(16) float mPhase[N]{};
+    alignas(16) float mAdvance[N]{};
+    alignas(16) float mValue[N]{};
+    // how many cycles each lane has been through, for the random shapes
+    alignas(16) uint32_t mCycle[N]{};
+};
+}  // namespace lfo
+}  // namespace kitdsp
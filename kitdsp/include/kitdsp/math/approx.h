@@ -53,6 +53,34 @@ inline float cos2pif_nasty(float x) {
     return 2.0f * x * (1.0f - fabsf(2.0f * x));
 }
 
+/**
+ * period is [0,1] instead of [0,2pi]. Folds the input into a quarter period and evaluates a 9th order taylor series
+ * there, without any branches so it vectorizes. Max error is ~4e-6, so harmonics are >100dB down.
+ */
+inline float sin2pif_poly(float x) {
+    // limit range to [0, 1), a quarter period behind. this avoids floorf(), which doesn't vectorize without
+    // -fno-trapping-math
+    float r = x + 0.25f;
+    int32_t whole = static_cast<int32_t>(r);
+    whole -= static_cast<int32_t>(r < static_cast<float>(whole));
+    r = r - static_cast<float>(whole);
+    // then fold into [-0.25, 0.25] with a triangle, using sin(pi - a) = sin(a)
+    float t = 0.25f - fabsf(r - 0.5f);
+
+    float a = kTwoPi * t;
+    float a2 = a * a;
+    // clang-format off
+    return a * (1.0f + a2 * (-1.0f / 6.0f + a2 * (1.0f / 120.0f + a2 * (-1.0f / 5040.0f + a2 * (1.0f / 362880.0f)))));
+    // clang-format on
+}
+
+/**
+ * period is [0,1] instead of [0,2pi]. see sin2pif_poly()
+ */
+inline float cos2pif_poly(float x) {
+    return sin2pif_poly(x + 0.25f);
+}
+
 /*
  * adapted from https://github.com/squinkylabs/Demo/blob/main/src/VCO3.cpp
  * input: _x must be >= 0, and <= 2 * pi.
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kitdsp {
+namespace pitch {
+/**
+ * Places pitch marks (epochs) on a signal: one mark per period of the fundamental, each on the largest peak within half
+ * a period of where the last mark says the next one should be. This is what pitch-synchronous effects like PSOLA need
+ * to line their grains up with.
+ *
+ * It doesn't detect pitch itself, feed it the period from a pitch detector (ZeroCrossingPitchDetector, or FastYin from
+ * kitdsp-gpl) and it will refine that into exact sample positions. The search is done incrementally as samples come
+ * in, so it costs a compare per sample instead of a cross-correlation per mark.
+ *
+ * The most recent kMaxMarks marks are kept in a ring buffer, addressed by age (0 being the newest).
+ */
+class PitchMarkTracker {
+   public:
+    static constexpr size_t kMaxMarks = 16;
+
+    PitchMarkTracker();
+    void Reset();
+
+    /**
+     * Processes one sample.
+     * @param periodSamples the current period estimate, in samples. must be >= 1.
+     * @return true if a new mark was placed
+     */
+    bool Process(float in, float periodSamples);
+
+    size_t GetNumMarks() const;
+    /** how long ago a mark was, in samples. pass this to DelayLine::Read() to get the sample at the mark */
+    size_t GetMarkDelay(size_t age) const;
+    /** the period estimate at the time the mark was placed */
+    float GetMarkPeriod(size_t age) const;
+    /** finds the mark that is closest to the given delay, returning its age */
+    size_t FindNearestMark(float delaySamples) const;
+
+   private:
+    // time is tracked as a wrapping sample counter, all that matters is the difference between two times
+    uint32_t mNow{};
+    uint32_t mMarkTime[kMaxMarks]{};
+    float mMarkPeriod[kMaxMarks]{};
+    size_t mNewestMark{};
+    size_t mNumMarks{};
+
+    // the search for the next mark
+    uint32_t mLastMarkTime{};
+    uint32_t mCandidateTime{};
+    float mCandidateValue{};
+    bool mHasCandidate{};
+};
+}  // namespace pitch
+}  // namespace kitdsp
@@ -1,25 +1,9 @@
+#pragma once
 
-#include "kitdsp/control/lfo.h"
+#include <etl/span.h>
+#include "kitdsp/pitch/pitchMarkTracker.h"
+#include "kitdsp/pitch/zeroCrossingPitchDetector.h"
 #include "kitdsp/sampling/delayLine.h"
-#include "kitdsp/math/approx.h"
-#include "kitdsp/math/interpolate.h"
-#include "kitdsp/math/util.h"
-
-namespace {
-float hanningWindow(float t) {
-    if (t <= 0.0f || t >= 1.0f) {
-        return 0.0f;
-    }
-    return 0.5f * (1.0f - kitdsp::approx::cos2pif_nasty(t));
-}
-
-float rectWindow(float t) {
-    if (t <= 0.0f || t >= 1.0f) {
-        return 0.0f;
-    }
-    return 1.0f;
-}
-}  // namespace
 
 namespace kitdsp {
 namespace pitch {
@@ -31,74 +15,48 @@ namespace pitch {
  *  - If you repeat a grain, then you get higher duration with the same pitch.
  *  - If you play the grain back faster, you get lower duration with a higher pitch.
  * You can combine the two to get a different pitch, and have the duration changes cancel out.
+ *
+ * This implementation is the time-domain flavor: grains are two periods long, centered on the pitch marks found by
+ * PitchMarkTracker, and are never resampled. The pitch changes because the grains are overlapped closer together (or
+ * further apart) than they were in the input, which keeps the formants where they were.
  */
 class PsolaPitchShifter {
-    struct Grain {
-        float sizeSamples = 0.0f;
-        float samplesPlayed = 0.0f;
-        float speed = 0.0f;
-        explicit Grain(DelayLine<float>& buf) : mBuf(buf) {}
-        void Set(float start, float size, float speed) {
-            this->pos = start;
-            this->sizeSamples = size;
-            this->speed = speed;
-            this->samplesPlayed = 0.0f;
-        }
-        void Advance() {
-            pos = std::max(0.0f, pos + 1.0f - speed);
-            samplesPlayed += speed;
-        }
-        float Read() {
-            if (sizeSamples == 0.0f) {
-                return 0.0f;
-            }
-            float progress = kitdsp::clamp(samplesPlayed / sizeSamples, 0.0f, 1.0f);
-            using namespace kitdsp::interpolate;
-            return mBuf.Read<InterpolationStrategy::Linear>(pos) * hanningWindow(progress);
-        }
-
-       private:
-        float pos;
-        DelayLine<float>& mBuf;
-    };
-
    public:
-    explicit PsolaPitchShifter(etl::span<float> buf) : mBuf(buf), mGrain1(mBuf), mGrain2(mBuf) { Reset(); }
-    void Reset() { mBuf.Reset(); }
-    void SetParams(float pitchMultiplier, float sampleRate) {
-        mSpeed = pitchMultiplier;
-        mPeriod = 0.05f * sampleRate;
-        float overlapRatio = 1.0f - 0.2f;  // TODO not this
-        assert(pitchMultiplier != 0);
-        mGrainPicker.SetPeriodSamples(overlapRatio * (mPeriod / pitchMultiplier));
-    }
-    float Process(float input) {
-        mBuf.Write(input);
-        mGrain1.Advance();
-        mGrain2.Advance();
+    static constexpr size_t kMaxGrains = 8;
+    static constexpr size_t kWindowTableSize = 256;
+    /** shortest period we'll track, anything shorter is treated as unpitched */
+    static constexpr float kMinPeriodSamples = 16.0f;
+
+    PsolaPitchShifter(etl::span<float> buf, float sampleRate);
+    void Reset();
+    void SetParams(float pitchMultiplier);
+
+    /** uses the built-in ZeroCrossingPitchDetector to find the input pitch */
+    float Process(float input);
+    /**
+     * uses an externally detected pitch instead, eg. from FastYin in kitdsp-gpl. Pass 0 for unpitched input.
+     */
+    float Process(float input, float periodSamples);
 
-        if (mGrainPicker.Process()) {
-            // TODO: use autocorrelation to pick high quality next grain: this is more like minimum latency last grain
-            if (nextGrain == 1) {
-                mGrain1.Set(mPeriod, mPeriod, mSpeed);
-                nextGrain = 2;
-            } else {
-                mGrain2.Set(mPeriod, mPeriod, mSpeed);
-                nextGrain = 1;
-            }
-        }
+   private:
+    struct Grain {
+        size_t delay = 0;
+        float window = 1.0f;
+        float windowStep = 0.0f;
+    };
 
-        return mGrain1.Read() + mGrain2.Read();
-    }
+    void StartGrain(float periodSamples);
+    float ReadWindow(float t) const;
 
-   private:
     DelayLine<float> mBuf;
-    lfo::ImpulseTrain mGrainPicker;
-    Grain mGrain1;
-    Grain mGrain2;
-    size_t nextGrain = 1;
+    ZeroCrossingPitchDetector mDetector;
+    PitchMarkTracker mMarks;
+    Grain mGrains[kMaxGrains];
+    float mWindowTable[kWindowTableSize + 1]{};
+    float mSamplesUntilGrain = 0.0f;
     float mSpeed = 1.0f;
-    float mPeriod = 0.1f;
+    float mFallbackPeriod{};
+    float mMaxPeriod{};
 };
 }  // namespace pitch
-}  // namespace kitdsp
\ No newline at end of file
+}  // namespace kitdsp
@@ -1,32 +1,71 @@
 #pragma once
 
 #include <etl/span.h>
-#include <kitdsp/control/approach.h>
+#include <cstddef>
+#include "kitdsp/filters/dcBlocker.h"
+#include "kitdsp/filters/onePole.h"
 
 /**
- * Detects the pitch of a signal by counting the number of zero crossings
+ * Detects the pitch of a signal by measuring the time between zero crossings
  * This works well for very simple monophonic signals, such as those produced by synth oscillators
+ *
+ * To make it a bit more robust on real recordings:
+ * - the input is low passed, to take out harmonics that would otherwise add extra crossings
+ * - a crossing only counts once the signal has dipped below a threshold relative to the last period's peak level
+ *   (hysteresis), so noise around zero doesn't retrigger it
+ * - crossing times are interpolated between samples, so the period isn't quantized to whole samples
+ * - the reported period is the median of the last few periods, so one-off glitches are thrown out entirely
  */
 
- namespace kitdsp {
-  namespace pitch {
+namespace kitdsp {
+namespace pitch {
 
-    class ZeroCrossingPitchDetector {
-      public:
-      ZeroCrossingPitchDetector(float sampleRate);
-      void Reset();
+class ZeroCrossingPitchDetector {
+   public:
+    /** the median is taken over this many periods */
+    static constexpr size_t kNumPeriods = 5;
+    /** fraction of the last period's peak the signal has to dip below before the next crossing counts */
+    static constexpr float kHysteresis = 0.2f;
+    /** anything quieter than this is considered silence, and won't produce crossings */
+    static constexpr float kNoiseFloor = 1e-4f;
 
-      void Process(etl::span<float> input);
-      void Process(float input);
+    explicit ZeroCrossingPitchDetector(float sampleRate);
+    void Reset();
 
-      float GetFrequency() const;
-      float GetPeriod() const;
+    /**
+     * Processes a full block. This is much faster than calling Process(float) for each sample: most chunks don't have
+     * a crossing in them, which can be checked for in bulk.
+     */
+    void Process(etl::span<const float> input);
+    void Process(float input);
 
-      private:
-      float mSampleRate;
-      float mLastSample = 0.0f;
-      size_t mNextPeriod = 0;
-      Approach mSmoothedPeriod;
-    };
- }
-  }
\ No newline at end of file
+    float GetFrequency() const;
+    float GetPeriod() const;
+
+   private:
+    float Prefilter(float input);
+    void ProcessFiltered(float input);
+    void AddPeriod(float period);
+
+    float mSampleRate;
+    float mMaxPeriod;
+    DcBlocker mDcBlocker;
+    OnePoleSeries<2> mLowPass;
+
+    // crossing detection
+    float mLastSample{};
+    float mThreshold{};
+    float mPeriodPeak{};
+    bool mArmed{};
+    bool mHasCrossing{};
+    size_t mElapsed{};
+    float mLastFraction{};
+
+    // output
+    float mPeriods[kNumPeriods]{};
+    size_t mNextPeriod{};
+    size_t mNumPeriods{};
+    float mPeriod{};
+};
+}  // namespace pitch
+}  // namespace kitdsp
@@ -67,6 +67,38 @@ class DelayLine {
         return {};
     }
 
+    /** upper limit for the number of taps in a single ReadLinear() call */
+    static constexpr size_t kMaxTaps = 16;
+
+    /**
+     * Reads many linearly interpolated taps at once, equivalent to calling Read<InterpolationStrategy::Linear>() for
+     * each delay. Splitting the index math, the gather, and the interpolation into separate loops lets the compiler
+     * vectorize the two ends, which is most of the cost for multi-tap effects like choruses.
+     */
+    inline void ReadLinear(etl::span<const float> delays, etl::span<TSample> out) const {
+        assert(delays.size() <= kMaxTaps && out.size() >= delays.size());
+        const size_t numTaps = delays.size();
+        const size_t size = mBuffer.size();
+        size_t index[kMaxTaps];
+        float frac[kMaxTaps];
+        TSample x0[kMaxTaps];
+        TSample x1[kMaxTaps];
+
+        for (size_t tap = 0; tap < numTaps; ++tap) {
+            size_t idx = static_cast<size_t>(delays[tap]);
+            assert(idx < size - 1);
+            frac[tap] = delays[tap] - static_cast<float>(idx);
+            index[tap] = mWriteIndex + idx;
+        }
+        for (size_t tap = 0; tap < numTaps; ++tap) {
+            x0[tap] = mBuffer[index[tap] % size];
+            x1[tap] = mBuffer[(index[tap] + 1) % size];
+        }
+        for (size_t tap = 0; tap < numTaps; ++tap) {
+            out[tap] = x0[tap] + (x1[tap] - x0[tap]) * frac[tap];
+        }
+    }
+
     void ReadChunk(size_t startSample, etl::span<TSample>& out) {
         assert(startSample - static_cast<int32_t>(out.size()) + 1 >= 0);
         for (size_t i = 0; i < out.size(); ++i) {
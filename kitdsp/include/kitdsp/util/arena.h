@@ -0,0 +1,141 @@
+#pragma once
+
+#include <etl/span.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace kitdsp {
+/**
+ * A bump allocator for DSP memory (delay lines, reverb buffers, etc.) that is sized once, when the plugin is activated,
+ * and then handed out in pieces without ever touching the heap again.
+ *
+ * Usage:
+ *  - on activate, Reserve() enough bytes for everything (GetAllocSize() helps with the math), then Alloc() each buffer.
+ *    Reserve() only reallocates when it needs to grow, so re-activating doesn't fragment or leak.
+ *  - Seal() it before processing starts. In debug builds, allocating from a sealed arena asserts, which proves the
+ *    audio thread never allocates.
+ *  - Unseal() and Reset() on deactivate.
+ *
+ * Every allocation is aligned to kAlignment bytes, so buffers can be used with any SIMD instruction set. Allocations can
+ * be temporarily rolled back with checkpoints (see Scope), and GetHighWaterMark() reports the most memory ever used,
+ * which is handy for sizing Reserve() calls.
+ */
+class Arena {
+   public:
+    static constexpr size_t kAlignment = 64;
+
+    struct Checkpoint {
+        size_t used;
+    };
+
+    /**
+     * Rolls the arena back to where it was when the scope was created, when the scope is destroyed.
+     */
+    class Scope {
+       public:
+        explicit Scope(Arena& arena) : mArena(arena), mCheckpoint(arena.Save()) {}
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope() { mArena.Rollback(mCheckpoint); }
+
+       private:
+        Arena& mArena;
+        Checkpoint mCheckpoint;
+    };
+
+    /** an empty arena. Reserve() memory before allocating from it */
+    Arena() {}
+
+    /**
+     * An arena over externally provided memory, for platforms where the memory is laid out up front (eg. SDRAM on
+     * daisy). The start is aligned up, so some of the memory may go unused. The memory must outlive the arena.
+     */
+    explicit Arena(etl::span<uint8_t> mem) { SetMemory(mem.data(), mem.size()); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Makes sure there's room for at least numBytes. This allocates if the arena needs to grow, which invalidates all
+     * previous allocations, so it should only be called on an empty arena. Not real-time safe.
+     */
+    void Reserve(size_t numBytes) {
+        assert(!mSealed && "Reserve() called on a sealed arena");
+        assert(mUsed == 0 && "Reserve() called with live allocations");
+        numBytes = GetAllocSize<uint8_t>(numBytes);
+        if (numBytes <= mCapacity) {
+            return;
+        }
+        // extra room, so the start can be aligned
+        mOwned.reset(new uint8_t[numBytes + kAlignment - 1]);
+        SetMemory(mOwned.get(), numBytes + kAlignment - 1);
+    }
+
+    /**
+     * Allocates space for count Ts. The memory is zeroed, but not constructed, so this should only be used for plain
+     * data. If there's not enough room, this asserts, and returns an empty span in release builds.
+     */
+    template <typename T>
+    etl::span<T> Alloc(size_t count) {
+        assert(!mSealed && "allocated from a sealed arena, probably on the audio thread");
+        size_t size = GetAllocSize<T>(count);
+        if (size > mCapacity - mUsed) {
+            assert(false && "arena is out of memory, Reserve() more");
+            return {};
+        }
+        uint8_t* start = mBase + mUsed;
+        mUsed += size;
+        mHighWaterMark = mUsed > mHighWaterMark ? mUsed : mHighWaterMark;
+        for (size_t idx = 0; idx < size; ++idx) {
+            start[idx] = 0;
+        }
+        return {reinterpret_cast<T*>(start), count};
+    }
+
+    /** frees every allocation. any spans handed out before this are invalid after */
+    void Reset() { mUsed = 0; }
+
+    Checkpoint Save() const { return {mUsed}; }
+
+    /** frees every allocation made since the checkpoint was saved */
+    void Rollback(Checkpoint checkpoint) {
+        assert(checkpoint.used <= mUsed);
+        mUsed = checkpoint.used;
+    }
+
+    /** after this, allocating is an error, until Unseal() */
+    void Seal() { mSealed = true; }
+    void Unseal() { mSealed = false; }
+    bool IsSealed() const { return mSealed; }
+
+    /** bytes in use, including alignment padding */
+    size_t GetUsed() const { return mUsed; }
+    size_t GetCapacity() const { return mCapacity; }
+    /** the most bytes that have ever been in use at once */
+    size_t GetHighWaterMark() const { return mHighWaterMark; }
+
+    /** how many bytes Alloc<T>(count) takes up, including alignment padding */
+    template <typename T>
+    static constexpr size_t GetAllocSize(size_t count) {
+        return (count * sizeof(T) + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+   private:
+    void SetMemory(uint8_t* mem, size_t size) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(mem);
+        size_t padding = (kAlignment - address % kAlignment) % kAlignment;
+        mBase = mem + padding;
+        mCapacity = size > padding ? (size - padding) / kAlignment * kAlignment : 0;
+        mUsed = 0;
+    }
+
+    std::unique_ptr<uint8_t[]> mOwned;
+    uint8_t* mBase = nullptr;
+    size_t mCapacity = 0;
+    size_t mUsed = 0;
+    size_t mHighWaterMark = 0;
+    bool mSealed = false;
+};
+}  // namespace kitdsp
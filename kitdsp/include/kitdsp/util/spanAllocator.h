@@ -1,12 +1,13 @@
 #pragma once
 
 #include <etl/span.h>
-#include <vector>
+#include <cassert>
 
 namespace kitdsp {
 
 /**
  * Implements a "bump" allocator backed by a fixed span of externally provided memory.
+ * For memory that the plugin owns, see Arena, which also aligns allocations and can be checked for real-time safety.
  */
 template <typename T>
 class SubSpanAllocator {
@@ -35,39 +36,4 @@ class SubSpanAllocator {
     size_t mNextIdx = 0;
 };
 
-/**
- * Implements a direct allocator: each call to "alloc" will perform a call to new[] under the hood.
- */
-template <typename T>
-class DynamicSpanAllocator {
-   public:
-    explicit DynamicSpanAllocator() {}
-    DynamicSpanAllocator(const DynamicSpanAllocator&) = delete;
-    DynamicSpanAllocator(DynamicSpanAllocator&&) = delete;
-    DynamicSpanAllocator& operator=(const DynamicSpanAllocator&) = delete;
-    DynamicSpanAllocator& operator=(DynamicSpanAllocator&&) = delete;
-    ~DynamicSpanAllocator() { reset(); }
-
-    /**
-     * allocates a new block of memory as a span<T>. The allocator itself owns this memory: it remains valid until
-     * reset() is called or the allocator is destructed.
-     */
-    etl::span<T> alloc(size_t size) {
-        mMemory.push_back(new T[size]);
-        return {mMemory.back(), size};
-    }
-
-    /**
-     * calls delete[] on all previously allocated blocks of memory. doing this invalidates them!
-     */
-    void reset() {
-        for (T* block : mMemory) {
-            delete[] block;
-        }
-    }
-
-   private:
-    std::vector<T*> mMemory;
-};
-
 }  // namespace kitdsp
\ No newline at end of file
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <etl/span.h>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include "kitdsp/filters/biquad.h"
+#include "kitdsp/math/units.h"
+#include "kitdsp/math/util.h"
+#include "kitdsp/volume/truePeakDetector.h"
+
+namespace kitdsp {
+/**
+ * A block-based level meter. Where DbMeter smooths and converts to dB on every sample, this only accumulates sums of
+ * squares and peaks while processing, and does the expensive conversions when a reading is asked for, so it's cheap
+ * enough to leave running on every plugin.
+ *
+ * The input is binned into kBinMs chunks, and readings are taken over a sliding window of whole bins, so they update
+ * every kBinMs. Available readings are:
+ *  - RMS and sample peak, over cfg.windowMs.
+ *  - Momentary (400ms) and short-term (3s) loudness, as in EBU R128 / ITU-R BS.1770. This is K-weighted, which costs
+ *    a couple biquads per channel, so it's opt-in with cfg.loudness.
+ *  - True peak, over cfg.windowMs, also opt-in with cfg.truePeak. See TruePeakDetector.
+ *
+ * Mono input is metered as a single channel, so it reads ~3 LU quieter than the same signal on both stereo channels.
+ */
+class BlockDbMeter {
+   public:
+    static constexpr float kBinMs = 10.0f;
+    /** enough bins for short-term loudness, which is the longest window */
+    static constexpr size_t kMaxBins = 300;
+    static constexpr size_t kMomentaryBins = 40;
+    static constexpr size_t kShortTermBins = 300;
+    /** what readings bottom out at, instead of -inf */
+    static constexpr float kSilenceDb = -120.0f;
+
+    struct Config {
+        /// [kBinMs, 3000] window for GetRmsDb(), GetPeakDb() and GetTruePeakDb()
+        float windowMs = 300.0f;
+        /// enables GetMomentaryLufs() and GetShortTermLufs()
+        bool loudness = false;
+        /// enables GetTruePeakDb()
+        bool truePeak = false;
+    };
+
+    Config cfg;
+
+    explicit BlockDbMeter(float sampleRate) {
+        mBinSamples = max<size_t>(static_cast<size_t>(msToSamples(kBinMs, sampleRate) + 0.5f), 1);
+
+        // K-weighting, as specified by BS.1770. the spec gives coefficients for 48k, which were designed with the
+        // bilinear transform from a shelf at 1681.97Hz and a highpass at 38.14Hz. The rbj shelf is the same filter, but
+        // its frequency is the geometric mean of its poles and zeros instead of the poles, so it sits a quarter of the
+        // gain lower. Doing that in the prewarped domain makes it match at any sample rate.
+        const float shelfGainDb = 3.9998438f;
+        float prewarped = tanf(kPi * 1681.9745f / sampleRate) / sqrtf(sqrtf(dbToRatio(shelfGainDb)));
+        float shelfFrequency = atanf(prewarped) * sampleRate / kPi;
+        for (size_t channel = 0; channel < 2; ++channel) {
+            mShelf[channel].SetShelf<rbj::BiquadFilterMode::HighShelf>(0.7071752f, shelfGainDb);
+            mShelf[channel].SetFrequency<rbj::BiquadFilterMode::HighShelf>(shelfFrequency, sampleRate);
+            mHighpass[channel].SetQ<rbj::BiquadFilterMode::Highpass>(0.5003270f);
+            mHighpass[channel].SetFrequency<rbj::BiquadFilterMode::Highpass>(38.135471f, sampleRate);
+        }
+        Reset();
+    }
+
+    void Reset() {
+        for (size_t channel = 0; channel < 2; ++channel) {
+            mShelf[channel].Reset();
+            mHighpass[channel].Reset();
+        }
+        mPeakDetector.Reset();
+        for (size_t idx = 0; idx < kMaxBins; ++idx) {
+            mBins[idx] = {};
+        }
+        mNewestBin = 0;
+        mCurrent = {};
+        mCurrentSamples = 0;
+        mLastCfg = cfg;
+    }
+
+    /**
+     * Meters a block of mono audio. cfg is assumed to be constant for the whole block.
+     */
+    void Process(etl::span<const float> in) { ProcessChannels(in, in, 1); }
+
+    /**
+     * Meters a block of stereo audio. cfg is assumed to be constant for the whole block.
+     */
+    void Process(etl::span<const float> inLeft, etl::span<const float> inRight) {
+        ProcessChannels(inLeft, inRight, 2);
+    }
+
+    /**
+     * @returns RMS level over the window, in dBFS (max amplitude sine wave = 0dbfs, to match DbMeter)
+     */
+    float GetRmsDb() const {
+        size_t numBins = GetWindowBins();
+        float sum = 0.0f;
+        for (size_t age = 0; age < numBins; ++age) {
+            sum += GetBin(age).power;
+        }
+        float meanSquare = sum / static_cast<float>(numBins * mBinSamples * mNumChannels);
+        return PowerToDb(meanSquare) + 3.0103f;
+    }
+
+    /**
+     * @returns the largest sample over the window, in dBFS
+     */
+    float GetPeakDb() const {
+        size_t numBins = GetWindowBins();
+        float peak = 0.0f;
+        for (size_t age = 0; age < numBins; ++age) {
+            peak = max(peak, GetBin(age).peak);
+        }
+        return AmplitudeToDb(peak);
+    }
+
+    /**
+     * @returns the true peak over the window, in dBTP. Requires cfg.truePeak.
+     */
+    float GetTruePeakDb() const {
+        assert(cfg.truePeak);
+        size_t numBins = GetWindowBins();
+        float peak = 0.0f;
+        for (size_t age = 0; age < numBins; ++age) {
+            peak = max(peak, GetBin(age).truePeak);
+        }
+        return AmplitudeToDb(peak);
+    }
+
+    /**
+     * @returns EBU R128 momentary loudness (400ms), in LUFS. Requires cfg.loudness.
+     */
+    float GetMomentaryLufs() const {
+        assert(cfg.loudness);
+        return GetLoudness(kMomentaryBins);
+    }
+
+    /**
+     * @returns EBU R128 short-term loudness (3s), in LUFS. Requires cfg.loudness.
+     */
+    float GetShortTermLufs() const {
+        assert(cfg.loudness);
+        return GetLoudness(kShortTermBins);
+    }
+
+   private:
+    static constexpr size_t kLanes = 4;
+
+    struct Bin {
+        /** sum of squares, across all channels */
+        float power{};
+        /** sum of K-weighted squares, across all channels */
+        float loudness{};
+        float peak{};
+        float truePeak{};
+    };
+
+    void ProcessChannels(etl::span<const float> inLeft, etl::span<const float> inRight, size_t numChannels) {
+        assert(inLeft.size() == inRight.size());
+        if (numChannels != mNumChannels || cfg.loudness != mLastCfg.loudness || cfg.truePeak != mLastCfg.truePeak) {
+            // switching modes would leave a mix of old and new measurements in the window
+            mNumChannels = numChannels;
+            Reset();
+        }
+        mLastCfg = cfg;
+
+        size_t len = inLeft.size();
+        size_t offset = 0;
+        while (offset < len) {
+            size_t chunk = min(len - offset, mBinSamples - mCurrentSamples);
+            const float* left = inLeft.data() + offset;
+            const float* right = inRight.data() + offset;
+            AccumulateLevel(left, chunk);
+            if (numChannels == 2) {
+                AccumulateLevel(right, chunk);
+            }
+            if (cfg.loudness) {
+                AccumulateLoudness(left, right, chunk, numChannels);
+            }
+            if (cfg.truePeak) {
+                for (size_t idx = 0; idx < chunk; ++idx) {
+                    mCurrent.truePeak = max(mCurrent.truePeak, mPeakDetector.Process({left[idx], right[idx]}));
+                }
+            }
+
+            offset += chunk;
+            mCurrentSamples += chunk;
+            if (mCurrentSamples == mBinSamples) {
+                mNewestBin = (mNewestBin + 1) % kMaxBins;
+                mBins[mNewestBin] = mCurrent;
+                mCurrent = {};
+                mCurrentSamples = 0;
+            }
+        }
+    }
+
+    void AccumulateLevel(const float* in, size_t len) {
+        // split into independent lanes, so the compiler is free to vectorize this
+        float power[kLanes]{};
+        float peak[kLanes]{};
+        size_t idx = 0;
+        for (; idx + kLanes <= len; idx += kLanes) {
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                float x = in[idx + lane];
+                power[lane] += x * x;
+                peak[lane] = max(peak[lane], fabsf(x));
+            }
+        }
+        for (; idx < len; ++idx) {
+            power[0] += in[idx] * in[idx];
+            peak[0] = max(peak[0], fabsf(in[idx]));
+        }
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            mCurrent.power += power[lane];
+            mCurrent.peak = max(mCurrent.peak, peak[lane]);
+        }
+    }
+
+    void AccumulateLoudness(const float* left, const float* right, size_t len, size_t numChannels) {
+        // the filters are recursive, so there's no getting around doing these one sample at a time
+        const float* channels[2] = {left, right};
+        for (size_t channel = 0; channel < numChannels; ++channel) {
+            const float* in = channels[channel];
+            float sum = 0.0f;
+            for (size_t idx = 0; idx < len; ++idx) {
+                float weighted = mHighpass[channel].Process(mShelf[channel].Process(in[idx]));
+                sum += weighted * weighted;
+            }
+            mCurrent.loudness += sum;
+        }
+    }
+
+    size_t GetWindowBins() const {
+        return clamp<size_t>(static_cast<size_t>(cfg.windowMs / kBinMs + 0.5f), 1, kMaxBins);
+    }
+
+    const Bin& GetBin(size_t age) const { return mBins[(mNewestBin + kMaxBins - age) % kMaxBins]; }
+
+    float GetLoudness(size_t numBins) const {
+        float sum = 0.0f;
+        for (size_t age = 0; age < numBins; ++age) {
+            sum += GetBin(age).loudness;
+        }
+        // channels are summed, not averaged (BS.1770 weights L and R by 1.0 each)
+        float meanSquare = sum / static_cast<float>(numBins * mBinSamples);
+        return PowerToDb(meanSquare) - 0.691f;
+    }
+
+    static float PowerToDb(float power) { return power > 0.0f ? max(10.0f * log10f(power), kSilenceDb) : kSilenceDb; }
+    static float AmplitudeToDb(float amplitude) {
+        return amplitude > 0.0f ? max(ratioToDb(amplitude), kSilenceDb) : kSilenceDb;
+    }
+
+    size_t mBinSamples{};
+    size_t mNumChannels{1};
+    Config mLastCfg{};
+
+    rbj::BiquadFilter mShelf[2];
+    rbj::BiquadFilter mHighpass[2];
+    TruePeakDetector mPeakDetector;
+
+    Bin mBins[kMaxBins]{};
+    size_t mNewestBin{};
+    Bin mCurrent{};
+    size_t mCurrentSamples{};
+};
+}  // namespace kitdsp
@@ -5,7 +5,7 @@
 
 namespace kitdsp {
 /**
- * tracks the decibel loudness of the input
+ * tracks the decibel loudness of the input, one sample at a time. For meters, see BlockDbMeter, which is much cheaper
  */
 class DbMeter : public OnePole {
    public:
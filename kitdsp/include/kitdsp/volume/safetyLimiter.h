@@ -11,6 +11,8 @@ namespace kitdsp {
  * producing very loud outputs, something like this can limit the volume before
  * it does damage to your speakers!
  *
+ * This only looks at sample peaks, and reacts after the fact. For a clean output stage, use TruePeakLimiter.
+ *
  * derived from: https://github.com/pichenettes/stmlib/blob/master/dsp/limiter.h
  */
 template <typename TSample>
@@ -53,11 +55,6 @@ inline float_2 SafetyLimiter<float_2>::Process(float_2 in) {
     // reduce gain if peak is above 1.0
     float gain = mPeak <= 1.0f ? 1.0f : 1.0f / mPeak;
 
-    if(gain < 1.0f) {
-        // TODO: debug break
-        printf("SAFETY LIMITER ACTIVATED\n");
-    }
-
     return (in * gain * kPostGain).map([](float i){return clamp(i, -1.0f, 1.0f);});
 }
 }  // namespace kitdsp
\ No newline at end of file
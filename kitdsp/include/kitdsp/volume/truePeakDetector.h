@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include "kitdsp/math/util.h"
+#include "kitdsp/math/vector.h"
+
+namespace kitdsp {
+/**
+ * Estimates the true peak of a stereo signal, as in ITU-R BS.1770: the peak after it's been reconstructed by a DAC,
+ * which can be higher than any of the samples. This is done by 4x oversampling with a short windowed sinc, and taking
+ * the largest absolute value across both channels.
+ *
+ * The estimate lags the input, since the interpolation needs samples from either side: it covers the span between
+ * kLatencySamples and kLatencySamples + 1 samples ago.
+ */
+class TruePeakDetector {
+   public:
+    static constexpr size_t kOversampling = 4;
+    /** taps per phase of the interpolation filter */
+    static constexpr size_t kInterpolationTaps = 12;
+    static constexpr size_t kLatencySamples = kInterpolationTaps / 2 - 1;
+
+    TruePeakDetector() {
+        // hann windowed sinc, one filter per fractional position between samples. position 0 is the sample itself, so
+        // it doesn't need a filter. Like the BS.1770 filter, this is accurate up to ~16kHz at 44.1k, and content close
+        // to nyquist will be underestimated
+        const float center = static_cast<float>(kInterpolationTaps / 2);
+        const float windowWidth = center + 1.0f;
+        for (size_t phase = 1; phase < kOversampling; ++phase) {
+            float sum = 0.0f;
+            for (size_t tap = 0; tap < kInterpolationTaps; ++tap) {
+                float x = center - static_cast<float>(tap) - static_cast<float>(phase) / kOversampling;
+                float sinc = sinf(kPi * x) / (kPi * x);
+                float window = 0.5f + 0.5f * cosf(kPi * x / windowWidth);
+                mInterpolation[phase - 1][tap] = sinc * window;
+                sum += sinc * window;
+            }
+            // unity gain at DC
+            for (size_t tap = 0; tap < kInterpolationTaps; ++tap) {
+                mInterpolation[phase - 1][tap] /= sum;
+            }
+        }
+        Reset();
+    }
+
+    void Reset() {
+        for (size_t idx = 0; idx < kInterpolationTaps * 2; ++idx) {
+            mHistory[idx] = {};
+        }
+        mHistoryIndex = 0;
+    }
+
+    /**
+     * @returns the true peak (as a linear amplitude) from about kLatencySamples ago
+     */
+    float Process(float_2 in) {
+        // mHistory is doubled up, so the newest kInterpolationTaps samples are always contiguous starting at
+        // mHistoryIndex
+        mHistoryIndex = (mHistoryIndex + kInterpolationTaps - 1) % kInterpolationTaps;
+        mHistory[mHistoryIndex] = in;
+        mHistory[mHistoryIndex + kInterpolationTaps] = in;
+        const float_2* window = mHistory + mHistoryIndex;
+        float peak = max(fabsf(window[kInterpolationTaps / 2].left), fabsf(window[kInterpolationTaps / 2].right));
+        for (size_t phase = 0; phase < kOversampling - 1; ++phase) {
+            float_2 interpolated{};
+            for (size_t tap = 0; tap < kInterpolationTaps; ++tap) {
+                interpolated = interpolated + window[tap] * mInterpolation[phase][tap];
+            }
+            peak = max(peak, max(fabsf(interpolated.left), fabsf(interpolated.right)));
+        }
+        return peak;
+    }
+
+   private:
+    float mInterpolation[kOversampling - 1][kInterpolationTaps]{};
+    float_2 mHistory[kInterpolationTaps * 2]{};
+    size_t mHistoryIndex{};
+};
+}  // namespace kitdsp
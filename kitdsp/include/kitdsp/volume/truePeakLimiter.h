@@ -0,0 +1,228 @@
+#pragma once
+
+#include <etl/span.h>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "kitdsp/math/units.h"
+#include "kitdsp/math/util.h"
+#include "kitdsp/math/vector.h"
+#include "kitdsp/volume/truePeakDetector.h"
+
+namespace kitdsp {
+/**
+ * A stereo-linked lookahead limiter that keeps the true peak level under a ceiling. True peak, as in ITU-R BS.1770,
+ * is the peak of the signal after it's been reconstructed by a DAC. It can be higher than any of the samples, so a
+ * sample peak limiter (like SafetyLimiter) can still clip downstream. This one estimates it with TruePeakDetector.
+ *
+ * The gain is computed the usual way for lookahead limiters: the gain needed for each sample is held for the whole
+ * lookahead, then smoothed with a moving average of the same length. That means the gain reaches its target exactly
+ * as the loud sample comes out of the delay line, with a smooth attack ramp leading up to it. Recovery afterwards is a
+ * one-pole release.
+ *
+ * This adds GetLatencySamples() of latency, which should be reported to the host.
+ *
+ * Gain reduction can be read from any thread, which is useful for meters/debugging. It's published once per block
+ * (or every kTelemetryInterval samples when processing per sample) using relaxed atomics, so there's no locking or IO
+ * on the audio thread.
+ */
+template <size_t MAX_LOOKAHEAD = 1024>
+class TruePeakLimiter {
+   public:
+    static constexpr size_t kTelemetryInterval = 64;
+
+    struct Config {
+        /// [unbounded, 0] maximum true peak level
+        float ceilingDb = -1.0f;
+        /// [0, unbounded] how long it takes to recover from gain reduction
+        float releaseMs = 100.0f;
+    };
+
+    Config cfg;
+
+    explicit TruePeakLimiter(float sampleRate, float lookaheadMs = 2.0f) : mSampleRate(sampleRate) {
+        SetLookahead(lookaheadMs);
+    }
+
+    /**
+     * Changes the lookahead time, and therefore the latency. This resets the limiter.
+     */
+    void SetLookahead(float lookaheadMs) {
+        mLookahead = clamp<size_t>(static_cast<size_t>(msToSamples(lookaheadMs, mSampleRate) + 0.5f), 1,
+                                   MAX_LOOKAHEAD);
+        Reset();
+    }
+
+    /** how many samples later a sample comes out than it went in */
+    size_t GetLatencySamples() const { return mLookahead + TruePeakDetector::kLatencySamples; }
+
+    void Reset() {
+        mPeakDetector.Reset();
+        for (size_t idx = 0; idx < kDelaySize; ++idx) {
+            mDelay[idx] = {};
+        }
+        mDelayIndex = 0;
+        mHoldFront = 0;
+        mHoldCount = 0;
+        mTime = 0;
+        mRelease = 1.0f;
+        for (size_t idx = 0; idx < mLookahead; ++idx) {
+            mBox[idx] = 1.0f;
+        }
+        mBoxIndex = 0;
+        mBoxSum = static_cast<float>(mLookahead);
+        mPendingMinGain = 1.0f;
+        mPendingCount = 0;
+        mParamsValid = false;
+    }
+
+    float_2 Process(float_2 in) {
+        UpdateParams();
+        float_2 out = ProcessSample(in);
+        if (++mPendingCount == kTelemetryInterval) {
+            Publish();
+        }
+        return out;
+    }
+
+    /**
+     * Processes a full block. cfg is assumed to be constant for the whole block. in and out may alias each other.
+     */
+    void Process(etl::span<const float> inLeft,
+                 etl::span<const float> inRight,
+                 etl::span<float> outLeft,
+                 etl::span<float> outRight) {
+        size_t len = inLeft.size();
+        assert(inRight.size() == len && outLeft.size() == len && outRight.size() == len);
+        UpdateParams();
+        for (size_t idx = 0; idx < len; ++idx) {
+            float_2 out = ProcessSample({inLeft[idx], inRight[idx]});
+            outLeft[idx] = out.left;
+            outRight[idx] = out.right;
+        }
+        Publish();
+    }
+
+    /**
+     * The most gain reduction applied since the last call, in dB (0 means no limiting). Safe to call from any thread.
+     */
+    float ConsumeMaxGainReductionDb() {
+        float minGain = mMinGain.exchange(1.0f, std::memory_order_relaxed);
+        return -ratioToDb(minGain);
+    }
+
+    /**
+     * Counts up each time a block is processed with some gain reduction. Safe to call from any thread.
+     */
+    uint32_t GetActivationCount() const { return mActivationCount.load(std::memory_order_relaxed); }
+
+   private:
+    static constexpr size_t kDelaySize = MAX_LOOKAHEAD + TruePeakDetector::kLatencySamples + 1;
+    static constexpr size_t kHoldSize = MAX_LOOKAHEAD + 1;
+
+    void UpdateParams() {
+        if (mParamsValid && cfg.ceilingDb == mLastCfg.ceilingDb && cfg.releaseMs == mLastCfg.releaseMs) {
+            return;
+        }
+        mLastCfg = cfg;
+        mParamsValid = true;
+        mCeiling = dbToRatio(cfg.ceilingDb);
+        float releaseSamples = msToSamples(cfg.releaseMs, mSampleRate);
+        mReleaseCoefficient = releaseSamples <= 1.0f ? 1.0f : 1.0f - expf(-1.0f / releaseSamples);
+    }
+
+    float_2 ProcessSample(float_2 in) {
+        // 1. estimate the true peak
+        float peak = mPeakDetector.Process(in);
+
+        // 2. gain needed to get that peak under the ceiling
+        float required = peak > mCeiling ? mCeiling / peak : 1.0f;
+
+        // 3. hold the smallest gain for the whole lookahead (a running minimum over a monotonic queue). it's held one
+        // sample longer than the lookahead so the gain stays down on both sides of an inter-sample peak. the expired
+        // front goes first, so the queue never holds more than kHoldSize entries
+        if (mHoldCount > 0 && mTime - mHoldTime[mHoldFront] > mLookahead) {
+            mHoldFront = (mHoldFront + 1) % kHoldSize;
+            mHoldCount--;
+        }
+        while (mHoldCount > 0 && mHoldValue[(mHoldFront + mHoldCount - 1) % kHoldSize] >= required) {
+            mHoldCount--;
+        }
+        size_t back = (mHoldFront + mHoldCount) % kHoldSize;
+        mHoldValue[back] = required;
+        mHoldTime[back] = mTime;
+        mHoldCount++;
+        assert(mHoldCount <= kHoldSize);
+        mTime++;
+        float held = mHoldValue[mHoldFront];
+
+        // 4. attack is handled by the lookahead, so this only needs to slow down the release
+        mRelease = held < mRelease ? held : mRelease + (held - mRelease) * mReleaseCoefficient;
+
+        // 5. moving average, so the gain ramps down over the lookahead instead of jumping
+        mBoxSum += mRelease - mBox[mBoxIndex];
+        mBox[mBoxIndex] = mRelease;
+        mBoxIndex++;
+        if (mBoxIndex == mLookahead) {
+            // re-sum every so often so rounding errors can't build up
+            mBoxIndex = 0;
+            mBoxSum = 0.0f;
+            for (size_t idx = 0; idx < mLookahead; ++idx) {
+                mBoxSum += mBox[idx];
+            }
+        }
+        float gain = min(mBoxSum / static_cast<float>(mLookahead), 1.0f);
+        mPendingMinGain = min(mPendingMinGain, gain);
+
+        // 6. delay the audio so it lines up with its gain
+        mDelay[mDelayIndex] = in;
+        size_t latency = GetLatencySamples();
+        float_2 delayed = mDelay[(mDelayIndex + kDelaySize - latency) % kDelaySize];
+        mDelayIndex = (mDelayIndex + 1) % kDelaySize;
+
+        return delayed * gain;
+    }
+
+    void Publish() {
+        if (mPendingMinGain < 1.0f) {
+            float current = mMinGain.load(std::memory_order_relaxed);
+            while (mPendingMinGain < current &&
+                   !mMinGain.compare_exchange_weak(current, mPendingMinGain, std::memory_order_relaxed)) {
+            }
+            mActivationCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        mPendingMinGain = 1.0f;
+        mPendingCount = 0;
+    }
+
+    float mSampleRate;
+    size_t mLookahead{1};
+
+    // cached from cfg
+    Config mLastCfg;
+    bool mParamsValid{};
+    float mCeiling{1.0f};
+    float mReleaseCoefficient{1.0f};
+
+    // signal state
+    TruePeakDetector mPeakDetector;
+    float_2 mDelay[kDelaySize]{};
+    size_t mDelayIndex{};
+    float mHoldValue[kHoldSize]{};
+    uint32_t mHoldTime[kHoldSize]{};
+    size_t mHoldFront{};
+    size_t mHoldCount{};
+    uint32_t mTime{};
+    float mRelease{1.0f};
+    float mBox[MAX_LOOKAHEAD]{};
+    size_t mBoxIndex{};
+    float mBoxSum{};
+
+    // telemetry
+    float mPendingMinGain{1.0f};
+    size_t mPendingCount{};
+    std::atomic<float> mMinGain{1.0f};
+    std::atomic<uint32_t> mActivationCount{0};
+};
+}  // namespace kitdsp
@@ -0,0 +1,130 @@
+#include "kitdsp/apps/ensembleChorus.h"
+#include "kitdsp/math/util.h"
+
+namespace kitdsp {
+
+EnsembleChorus::EnsembleChorus(etl::span<float> buffer, float sampleRate)
+    : mDelayLine(buffer), mSampleRate(sampleRate), mSamplesPerMs(sampleRate / 1000.0f) {
+    // smoothing only happens once per control period, so the half life is based on the control rate
+    float controlRate = mSampleRate / static_cast<float>(kControlRate);
+    mDelayBaseMs.SetHalfLife(0.01f, controlRate);
+    mDelayModMs.SetHalfLife(0.01f, controlRate);
+    mLfo.SetShape(lfo::Shape::Triangle);
+    Reset();
+}
+
+void EnsembleChorus::Reset() {
+    cfg = {};
+    mDelayLine.Reset();
+    mDelayBaseMs.Reset();
+    mDelayModMs.Reset();
+    mLfo.Reset();
+    // force UpdateControl() to re-layout the voices
+    mNumVoices = 0;
+    mControlCounter = 0;
+}
+
+float_2 EnsembleChorus::Process(float in) {
+    return Process({in, in});
+}
+
+float_2 EnsembleChorus::Process(float_2 in) {
+    if (mControlCounter == 0) {
+        UpdateControl();
+        mControlCounter = kControlRate;
+    }
+    mControlCounter--;
+    return ProcessSample(in);
+}
+
+void EnsembleChorus::Process(etl::span<const float> inLeft,
+                             etl::span<const float> inRight,
+                             etl::span<float> outLeft,
+                             etl::span<float> outRight) {
+    size_t len = inLeft.size();
+    assert(inRight.size() == len && outLeft.size() == len && outRight.size() == len);
+    for (size_t idx = 0; idx < len; ++idx) {
+        if (mControlCounter == 0) {
+            UpdateControl();
+            mControlCounter = kControlRate;
+        }
+        mControlCounter--;
+        float_2 out = ProcessSample({inLeft[idx], inRight[idx]});
+        outLeft[idx] = out.left;
+        outRight[idx] = out.right;
+    }
+}
+
+void EnsembleChorus::UpdateControl() {
+    size_t numVoices = clamp<size_t>(cfg.numVoices, 2, kMaxVoices);
+    bool relayout = numVoices != mNumVoices;
+    if (relayout) {
+        mNumVoices = numVoices;
+        float voicesf = static_cast<float>(mNumVoices);
+        for (size_t voice = 0; voice < mNumVoices; ++voice) {
+            // evenly spaced LFO phases, so no two voices are ever moving together
+            mLfo.SetPhase(voice, mLfo.GetPhase(0) + static_cast<float>(voice) / voicesf);
+
+            // alternate voices between the left and right edges, working inwards. 2 voices are hard panned.
+            size_t slot = voice % 2 == 0 ? voice / 2 : mNumVoices - 1 - voice / 2;
+            float pan = -1.0f + 2.0f * static_cast<float>(slot) / (voicesf - 1.0f);
+            // linear pan law, normalized so each side sums to 1.0 no matter how many voices there are
+            mGainLeft[voice] = (1.0f - pan) / voicesf;
+            mGainRight[voice] = (1.0f + pan) / voicesf;
+        }
+    }
+
+    mDelayBaseMs.target = cfg.delayBaseMs;
+    mDelayModMs.target = cfg.delayModMs;
+    float delayBaseMs = mDelayBaseMs.Process();
+    float delayModMs = mDelayModMs.Process();
+    float maxDelay = static_cast<float>(mDelayLine.Size() - 4);
+    float rampScale = 1.0f / static_cast<float>(kControlRate);
+
+    mLfo.SetFrequency(cfg.lfoRateHz, mSampleRate);
+    mLfo.Process(static_cast<float>(kControlRate));
+    for (size_t voice = 0; voice < mNumVoices; ++voice) {
+        float lfo = mLfo.GetValue(voice);
+        float target = clamp((delayBaseMs + lfo * delayModMs) * mSamplesPerMs, 1.0f, maxDelay);
+        if (relayout) {
+            mDelay[voice] = target;
+        }
+        mDelayStep[voice] = (target - mDelay[voice]) * rampScale;
+    }
+
+    mFeedbackGain = cfg.feedback / static_cast<float>(mNumVoices);
+}
+
+float_2 EnsembleChorus::ProcessSample(float_2 in) {
+    float taps[kMaxVoices];
+    for (size_t voice = 0; voice < mNumVoices; ++voice) {
+        mDelay[voice] += mDelayStep[voice];
+    }
+    mDelayLine.ReadLinear({mDelay, mNumVoices}, {taps, mNumVoices});
+
+    float_2 out{};
+    float outSum = 0.0f;
+    for (size_t voice = 0; voice < mNumVoices; ++voice) {
+        out.left += taps[voice] * mGainLeft[voice];
+        out.right += taps[voice] * mGainRight[voice];
+        outSum += taps[voice];
+    }
+
+    // send input in
+    float inMono = (in.left + in.right) * 0.5f;
+    mDelayLine.Write(inMono + (outSum * mFeedbackGain));
+
+    // lerp
+    out = fade(in, out, cfg.mix);
+
+    out.left = clamp<float>(out.left, -1.0f, 1.0f);
+    out.right = clamp<float>(out.right, -1.0f, 1.0f);
+
+    return out;
+}
+
+float EnsembleChorus::GetMaxDelayMs() const {
+    return static_cast<float>(mDelayLine.Size() - 4) / mSamplesPerMs;
+}
+
+}  // namespace kitdsp
@@ -1,8 +1,8 @@
 #include "kitdsp/pitch/frequencyShifter.h"
 #include "kitdsp/lookupTables/sineLut.h"
 
-#define sin_(x) sin2pif_lut(x)
-#define cos_(x) sin2pif_lut((x) + 0.25f)
+#define sin_(x) sin2pif_lut_lerp(x)
+#define cos_(x) cos2pif_lut_lerp(x)
 
 namespace kitdsp {
 FrequencyShifter::FrequencyShifter(float sampleRate) {
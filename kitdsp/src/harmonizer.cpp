@@ -1,51 +1,104 @@
-#include "kitdsp/harmonizer.h"
-#include "kitdsp/filters/biquad.h"
+#include "kitdsp/apps/harmonizer.h"
+#include "kitdsp/control/lfo.h"
+#include "kitdsp/math/interpolate.h"
+#include "kitdsp/math/util.h"
 
 namespace kitdsp {
 Harmonizer::Harmonizer(etl::span<float> buffer, float sampleRate) : mDelayLine(buffer), mSampleRate(sampleRate) {
-    // from the H910 manual, which doesn't expose grain size but mentions that in pitch mode that the delay is variable
-    // around 30ms
-    SetParams(2.0f, 30.0f, 0.0f, 0.0f);
+    // these never change, so unlike the old H910PitchShifter there's no need to recalculate them every sample
+    mFilterOut.SetFrequency<rbj::BiquadFilterMode::LowPass>(12000.0f, mSampleRate);
+    mFilterOut.SetQ<rbj::BiquadFilterMode::LowPass>(1.0f);
+    Reset();
 }
-void Harmonizer::Reset() {}
 
-void Harmonizer::SetParams(float pitchRatio, float grainSizeMs, float baseDelayMs, float feedback) {
-    mBaseDelaySamples = baseDelayMs * mSampleRate / 1000.0f;
-    mGrainSizeSamples = grainSizeMs * mSampleRate / 1000.0f;
-    mSlowing = pitchRatio < 1.0f;
-    mFeedback = feedback;
-
-    mGrainPhasor.SetPeriod(pitchRatio == 1.0f ? 0.0f : fabsf(grainSizeMs / (pitchRatio - 1.0f)), mSampleRate);
+void Harmonizer::Reset() {
+    mDelayLine.Reset();
+    mFilterOut.Reset();
+    for (float& phase : mPhase) {
+        phase = 0.0f;
+    }
+    mParamsValid = false;
 }
 
-float Harmonizer::Process(float in) {
-    using namespace kitdsp::interpolate;
-
-    float phase1 = mGrainPhasor.Process();
-    float phase2 = lfo::Phasor::WrapPhase(phase1 + 0.5f);
+void Harmonizer::UpdateParams() {
+    if (mParamsValid && cfg.numVoices == mLastCfg.numVoices && cfg.baseDelayMs == mLastCfg.baseDelayMs &&
+        cfg.feedback == mLastCfg.feedback) {
+        bool voicesChanged = false;
+        for (size_t voice = 0; voice < cfg.numVoices; ++voice) {
+            voicesChanged = voicesChanged || cfg.voices[voice] != mLastCfg.voices[voice];
+        }
+        if (!voicesChanged) {
+            return;
+        }
+    }
+    mLastCfg = cfg;
+    mParamsValid = true;
 
-    float grain1Delay = mBaseDelaySamples + ((mSlowing ? phase1 : 1.0f - phase1) * mGrainSizeSamples);
-    float grain2Delay = mBaseDelaySamples + ((mSlowing ? phase2 : 1.0f - phase2) * mGrainSizeSamples);
-    float grain1 = mDelayLine.Read<InterpolationStrategy::Cubic>(grain1Delay);
-    float grain2 = mDelayLine.Read<InterpolationStrategy::Cubic>(grain2Delay);
+    float samplesPerMs = mSampleRate / 1000.0f;
+    // cubic reads need one sample of headroom on either side
+    float maxDelaySamples = static_cast<float>(mDelayLine.Size() - 3);
 
-    // using a triangle wave here to mimic original H910 harmonizer
-    float tri = fabsf(phase1 - 0.5f) * 2.0f;
-    mFilterOut.SetFrequency<rbj::BiquadFilterMode::LowPass>(12000.0f, mSampleRate);
-    mFilterOut.SetQ<rbj::BiquadFilterMode::LowPass>(1.0f);
+    mNumVoices = clamp<size_t>(cfg.numVoices, 1, kMaxVoices);
+    mBaseDelaySamples = clamp(cfg.baseDelayMs * samplesPerMs + 1.0f, 1.0f, maxDelaySamples - 1.0f);
+    mFeedback = cfg.feedback;
+    for (size_t voice = 0; voice < mNumVoices; ++voice) {
+        const Voice& v = cfg.voices[voice];
+        mGrainSizeSamples[voice] = clamp(v.grainSizeMs * samplesPerMs, 1.0f, maxDelaySamples - mBaseDelaySamples);
 
-    float out = clamp<float>(mFilterOut.Process(fade(grain1, grain2, tri)), -1.0f, 1.0f);
+        // the grain needs to sweep across the whole grain size in the time it takes to gain/lose a grain's worth of
+        // playback, which is grainSize / |ratio - 1|
+        float periodSamples =
+            v.pitchRatio == 1.0f ? 0.0f : fabsf(v.grainSizeMs / (v.pitchRatio - 1.0f)) * mSampleRate * 0.001f;
+        mAdvance[voice] = periodSamples == 0.0f ? 0.0f : 1.0f / periodSamples;
 
-    mDelayLine.Write(in + (out * mFeedback));
+        bool slowing = v.pitchRatio < 1.0f;
+        mDelayOffset[voice] = slowing ? 0.0f : 1.0f;
+        mDelayDirection[voice] = slowing ? 1.0f : -1.0f;
+        mLevel[voice] = v.level;
+    }
+}
 
+float Harmonizer::Process(float in) {
+    float out;
+    Process({&in, 1}, {&out, 1});
     return out;
 }
 
-size_t Harmonizer::GetMaxGrainSize() const {
-    return mDelayLine.Size();
+void Harmonizer::Process(etl::span<const float> in, etl::span<float> out) {
+    using namespace kitdsp::interpolate;
+    assert(in.size() == out.size());
+    UpdateParams();
+
+    for (size_t idx = 0; idx < in.size(); ++idx) {
+        float mixed = 0.0f;
+        for (size_t voice = 0; voice < mNumVoices; ++voice) {
+            float phase1 = lfo::Phasor::WrapPhase(mPhase[voice] + mAdvance[voice]);
+            mPhase[voice] = phase1;
+            if (mLevel[voice] == 0.0f) {
+                continue;
+            }
+            float phase2 = lfo::Phasor::WrapPhase(phase1 + 0.5f);
+
+            float grainSize = mGrainSizeSamples[voice];
+            float grain1Delay =
+                mBaseDelaySamples + (mDelayOffset[voice] + mDelayDirection[voice] * phase1) * grainSize;
+            float grain2Delay =
+                mBaseDelaySamples + (mDelayOffset[voice] + mDelayDirection[voice] * phase2) * grainSize;
+            float grain1 = mDelayLine.Read<InterpolationStrategy::Cubic>(grain1Delay);
+            float grain2 = mDelayLine.Read<InterpolationStrategy::Cubic>(grain2Delay);
+
+            // using a triangle wave here to mimic original H910 harmonizer
+            float tri = fabsf(phase1 - 0.5f) * 2.0f;
+            mixed += fade(grain1, grain2, tri) * mLevel[voice];
+        }
+
+        float processed = clamp<float>(mFilterOut.Process(mixed), -1.0f, 1.0f);
+        mDelayLine.Write(in[idx] + (processed * mFeedback));
+        out[idx] = processed;
+    }
 }
 
-size_t Harmonizer::GetEffectiveDelay() const {
-    return 0;  // idk man
+float Harmonizer::GetMaxGrainSizeMs() const {
+    return static_cast<float>(mDelayLine.Size() - 4) * 1000.0f / mSampleRate;
 }
 }  // namespace kitdsp
@@ -0,0 +1,81 @@
+#include "kitdsp/pitch/pitchMarkTracker.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace kitdsp {
+namespace pitch {
+PitchMarkTracker::PitchMarkTracker() {
+    Reset();
+}
+
+void PitchMarkTracker::Reset() {
+    mNow = 0;
+    for (size_t idx = 0; idx < kMaxMarks; ++idx) {
+        mMarkTime[idx] = 0;
+        mMarkPeriod[idx] = 0.0f;
+    }
+    mNewestMark = 0;
+    mNumMarks = 0;
+    mLastMarkTime = 0;
+    mCandidateTime = 0;
+    mCandidateValue = 0.0f;
+    mHasCandidate = false;
+}
+
+bool PitchMarkTracker::Process(float in, float periodSamples) {
+    assert(periodSamples >= 1.0f);
+    mNow++;
+
+    // the next mark should be one period after the last one. search half a period either side of that for a peak
+    float elapsed = static_cast<float>(mNow - mLastMarkTime);
+    if (elapsed < periodSamples * 0.5f) {
+        return false;
+    }
+    if (!mHasCandidate || in > mCandidateValue) {
+        mCandidateTime = mNow;
+        mCandidateValue = in;
+        mHasCandidate = true;
+    }
+    if (elapsed < periodSamples * 1.5f) {
+        return false;
+    }
+
+    // search window is over, commit the best candidate
+    mNewestMark = (mNewestMark + 1) % kMaxMarks;
+    mMarkTime[mNewestMark] = mCandidateTime;
+    mMarkPeriod[mNewestMark] = periodSamples;
+    mNumMarks = mNumMarks < kMaxMarks ? mNumMarks + 1 : kMaxMarks;
+    mLastMarkTime = mCandidateTime;
+    mHasCandidate = false;
+    return true;
+}
+
+size_t PitchMarkTracker::GetNumMarks() const {
+    return mNumMarks;
+}
+
+size_t PitchMarkTracker::GetMarkDelay(size_t age) const {
+    assert(age < mNumMarks);
+    return mNow - mMarkTime[(mNewestMark + kMaxMarks - age) % kMaxMarks];
+}
+
+float PitchMarkTracker::GetMarkPeriod(size_t age) const {
+    assert(age < mNumMarks);
+    return mMarkPeriod[(mNewestMark + kMaxMarks - age) % kMaxMarks];
+}
+
+size_t PitchMarkTracker::FindNearestMark(float delaySamples) const {
+    size_t nearest = 0;
+    float nearestDistance = INFINITY;
+    for (size_t age = 0; age < mNumMarks; ++age) {
+        float distance = fabsf(static_cast<float>(GetMarkDelay(age)) - delaySamples);
+        if (distance < nearestDistance) {
+            nearest = age;
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
+}
+}  // namespace pitch
+}  // namespace kitdsp
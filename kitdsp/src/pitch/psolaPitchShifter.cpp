@@ -0,0 +1,99 @@
+#include "kitdsp/pitch/psolaPitchShifter.h"
+
+#include <algorithm>
+#include <cmath>
+#include "kitdsp/math/interpolate.h"
+#include "kitdsp/math/util.h"
+
+namespace kitdsp {
+namespace pitch {
+PsolaPitchShifter::PsolaPitchShifter(etl::span<float> buf, float sampleRate)
+    : mBuf(buf),
+      mDetector(sampleRate),
+      mFallbackPeriod(0.01f * sampleRate),
+      // grains are read from up to ~3.5 periods ago, leave some headroom
+      mMaxPeriod(static_cast<float>(buf.size() - 1) * 0.25f) {
+    // hann window. computed once up front so each grain sample is a table lookup instead of a cos()
+    for (size_t idx = 0; idx <= kWindowTableSize; ++idx) {
+        float t = static_cast<float>(idx) / static_cast<float>(kWindowTableSize);
+        mWindowTable[idx] = 0.5f * (1.0f - cosf(kTwoPi * t));
+    }
+    Reset();
+}
+
+void PsolaPitchShifter::Reset() {
+    mBuf.Reset();
+    mDetector.Reset();
+    mMarks.Reset();
+    for (Grain& grain : mGrains) {
+        grain = {};
+    }
+    mSamplesUntilGrain = 0.0f;
+}
+
+void PsolaPitchShifter::SetParams(float pitchMultiplier) {
+    assert(pitchMultiplier > 0.0f);
+    mSpeed = pitchMultiplier;
+}
+
+float PsolaPitchShifter::Process(float input) {
+    mDetector.Process(input);
+    return Process(input, mDetector.GetPeriod());
+}
+
+float PsolaPitchShifter::Process(float input, float periodSamples) {
+    mBuf.Write(input);
+
+    // unpitched input still needs grains, they just won't line up with anything
+    float period = periodSamples < kMinPeriodSamples ? mFallbackPeriod : periodSamples;
+    period = clamp(period, kMinPeriodSamples, mMaxPeriod);
+    mMarks.Process(input, period);
+
+    // output grains are spaced by the output period, no matter where the marks they're reading from are
+    mSamplesUntilGrain -= 1.0f;
+    if (mSamplesUntilGrain <= 0.0f) {
+        StartGrain(period);
+        mSamplesUntilGrain += period / mSpeed;
+    }
+
+    float out = 0.0f;
+    for (Grain& grain : mGrains) {
+        if (grain.window < 1.0f) {
+            out += mBuf.Read(static_cast<int32_t>(grain.delay)) * ReadWindow(grain.window);
+            grain.window += grain.windowStep;
+        }
+    }
+    return clamp(out, -1.0f, 1.0f);
+}
+
+void PsolaPitchShifter::StartGrain(float periodSamples) {
+    if (mMarks.GetNumMarks() == 0) {
+        return;
+    }
+
+    // the newest marks might not have a full period after them yet, so aim for one period back
+    size_t age = mMarks.FindNearestMark(periodSamples);
+    size_t halfSize = static_cast<size_t>(mMarks.GetMarkPeriod(age) + 0.5f);
+
+    // use a free grain, or steal whichever is closest to finishing
+    Grain* grain = &mGrains[0];
+    for (Grain& candidate : mGrains) {
+        if (candidate.window > grain->window) {
+            grain = &candidate;
+        }
+    }
+
+    // the grain starts half a grain before the mark, and is played back at the original speed, so the read position is
+    // fixed for the whole grain and doesn't need any interpolation
+    grain->delay = std::min(mMarks.GetMarkDelay(age) + halfSize, mBuf.Size() - 1);
+    grain->window = 0.0f;
+    grain->windowStep = 1.0f / static_cast<float>(halfSize * 2);
+}
+
+float PsolaPitchShifter::ReadWindow(float t) const {
+    float pos = t * static_cast<float>(kWindowTableSize);
+    size_t idx = static_cast<size_t>(pos);
+    return interpolate::linear(mWindowTable[idx], mWindowTable[idx + 1], pos - static_cast<float>(idx));
+}
+}  // namespace pitch
+}  // namespace kitdsp
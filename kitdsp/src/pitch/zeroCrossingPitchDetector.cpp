@@ -1,38 +1,144 @@
 #include "kitdsp/pitch/zeroCrossingPitchDetector.h"
 
+#include <cmath>
+#include "kitdsp/math/util.h"
+
 namespace kitdsp {
 namespace pitch {
-ZeroCrossingPitchDetector::ZeroCrossingPitchDetector(float sampleRate) : mSampleRate(sampleRate) {
-    mSmoothedPeriod.SetHalfLife(0.001f, mSampleRate);
+namespace {
+// lowest pitch we'll report. anything longer is assumed to be a gap in the signal, not a period
+constexpr float kMinFrequency = 20.0f;
+constexpr float kMaxFrequency = 4000.0f;
+constexpr float kLowPassFrequency = 1000.0f;
+constexpr size_t kChunkSize = 64;
+constexpr size_t kLanes = 4;
+}  // namespace
+
+ZeroCrossingPitchDetector::ZeroCrossingPitchDetector(float sampleRate)
+    : mSampleRate(sampleRate), mMaxPeriod(sampleRate / kMinFrequency) {
+    mLowPass.SetFrequency(kLowPassFrequency, mSampleRate);
     Reset();
 }
 
 void ZeroCrossingPitchDetector::Reset() {
-    mSmoothedPeriod.Reset();
+    mDcBlocker.Reset();
+    mLowPass.Reset();
+    mLastSample = 0.0f;
+    mThreshold = kNoiseFloor;
+    mPeriodPeak = 0.0f;
+    mArmed = false;
+    mHasCrossing = false;
+    mElapsed = 0;
+    mLastFraction = 0.0f;
+    mNextPeriod = 0;
+    mNumPeriods = 0;
+    mPeriod = 0.0f;
 }
 
-void ZeroCrossingPitchDetector::Process(etl::span<float> input) {
-    for (float f : input) {
-        Process(f);
+void ZeroCrossingPitchDetector::Process(etl::span<const float> input) {
+    float filtered[kChunkSize];
+    for (size_t start = 0; start < input.size(); start += kChunkSize) {
+        size_t len = min(kChunkSize, input.size() - start);
+        for (size_t idx = 0; idx < len; ++idx) {
+            filtered[idx] = Prefilter(input[start + idx]);
+        }
+
+        // find the range of the chunk, in independent lanes so this can be vectorized
+        float lo[kLanes] = {INFINITY, INFINITY, INFINITY, INFINITY};
+        float hi[kLanes] = {-INFINITY, -INFINITY, -INFINITY, -INFINITY};
+        size_t idx = 0;
+        for (; idx + kLanes <= len; idx += kLanes) {
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                lo[lane] = min(lo[lane], filtered[idx + lane]);
+                hi[lane] = max(hi[lane], filtered[idx + lane]);
+            }
+        }
+        for (; idx < len; ++idx) {
+            lo[0] = min(lo[0], filtered[idx]);
+            hi[0] = max(hi[0], filtered[idx]);
+        }
+        for (size_t lane = 1; lane < kLanes; ++lane) {
+            lo[0] = min(lo[0], lo[lane]);
+            hi[0] = max(hi[0], hi[lane]);
+        }
+
+        // if nothing in the chunk could change state, skip straight to the end of it
+        bool eventful = mArmed ? hi[0] >= 0.0f : lo[0] < -mThreshold;
+        if (!eventful) {
+            mElapsed += len;
+            mPeriodPeak = max(mPeriodPeak, max(hi[0], -lo[0]));
+            mLastSample = filtered[len - 1];
+            continue;
+        }
+
+        for (idx = 0; idx < len; ++idx) {
+            ProcessFiltered(filtered[idx]);
+        }
     }
 }
 
 void ZeroCrossingPitchDetector::Process(float input) {
-    if (mLastSample < 0.0f && input >= 0.0f) {
-        mSmoothedPeriod.target = narrow_cast<float>(mNextPeriod);
-        mNextPeriod = 0;
+    ProcessFiltered(Prefilter(input));
+}
+
+float ZeroCrossingPitchDetector::Prefilter(float input) {
+    return mLowPass.Process(mDcBlocker.Process(input));
+}
+
+void ZeroCrossingPitchDetector::ProcessFiltered(float input) {
+    mElapsed++;
+    mPeriodPeak = max(mPeriodPeak, fabsf(input));
+
+    if (!mArmed) {
+        mArmed = input < -mThreshold;
+    } else if (input >= 0.0f) {
+        // negative to positive crossing, somewhere between the last sample and this one
+        float fraction = mLastSample / (mLastSample - input);
+        if (mHasCrossing) {
+            AddPeriod(static_cast<float>(mElapsed) + fraction - mLastFraction);
+        }
+        mHasCrossing = true;
+        mElapsed = 0;
+        mLastFraction = fraction;
+
+        mThreshold = max(kNoiseFloor, mPeriodPeak * kHysteresis);
+        mPeriodPeak = 0.0f;
+        mArmed = false;
     }
 
     mLastSample = input;
-    mNextPeriod++;
-    mSmoothedPeriod.Process();
+}
+
+void ZeroCrossingPitchDetector::AddPeriod(float period) {
+    if (period > mMaxPeriod || period < mSampleRate / kMaxFrequency) {
+        // either a gap in the signal, or noise. start over
+        mNumPeriods = 0;
+        return;
+    }
+
+    mPeriods[mNextPeriod] = period;
+    mNextPeriod = (mNextPeriod + 1) % kNumPeriods;
+    mNumPeriods = min(mNumPeriods + 1, kNumPeriods);
+
+    // insertion sort is plenty for a handful of periods
+    float sorted[kNumPeriods];
+    for (size_t idx = 0; idx < mNumPeriods; ++idx) {
+        float value = mPeriods[(mNextPeriod + kNumPeriods - 1 - idx) % kNumPeriods];
+        size_t insert = idx;
+        while (insert > 0 && sorted[insert - 1] > value) {
+            sorted[insert] = sorted[insert - 1];
+            insert--;
+        }
+        sorted[insert] = value;
+    }
+    mPeriod = sorted[mNumPeriods / 2];
 }
 
 float ZeroCrossingPitchDetector::GetFrequency() const {
-    return mSmoothedPeriod.current == 0.0f ? 0.0f : mSampleRate / mSmoothedPeriod.current;
+    return mPeriod == 0.0f ? 0.0f : mSampleRate / mPeriod;
 }
 float ZeroCrossingPitchDetector::GetPeriod() const {
-    return mSmoothedPeriod.current;
+    return mPeriod;
 }
 }  // namespace pitch
-}  // namespace kitdsp
\ No newline at end of file
+}  // namespace kitdsp
@@ -19,6 +19,7 @@ TEST(chorus, works) {
 
     // test 1 default settings
     chorus.Reset();
+    test::RenderTimer timer;
     for (size_t i = 0; i < len; ++i) {
         float in = f.samples[0][i];
         float_2 out = chorus.Process(in);
@@ -30,5 +31,6 @@ TEST(chorus, works) {
         f.samples[1][i] = out.right;
     }
 
+    timer.Finish();
     test::Snapshot(f);
 }
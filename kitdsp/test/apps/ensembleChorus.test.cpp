@@ -0,0 +1,87 @@
+#include "kitdsp/apps/ensembleChorus.h"
+#include <AudioFile.h>
+#include <gtest/gtest.h>
+#include "kitdsp/apps/chorus.h"
+#include "util.h"
+
+using namespace kitdsp;
+
+TEST(ensembleChorus, works) {
+    AudioFile<float> f;
+    bool ok = f.load(PROJECT_DIR "/test/guitar.wav");
+    ASSERT_TRUE(ok);
+
+    float sampleRate = f.getSampleRate();
+
+    constexpr size_t bufferSize = 41000;
+    float buffer[bufferSize];
+    EnsembleChorus chorus(etl::span<float>(buffer, bufferSize), sampleRate);
+
+    chorus.Reset();
+    chorus.cfg.numVoices = 6;
+    chorus.cfg.lfoRateHz = 0.6f;
+    test::RenderTimer timer;
+    chorus.Process(f.samples[0], f.samples[1], f.samples[0], f.samples[1]);
+    timer.Finish();
+
+    test::Snapshot(f);
+}
+
+TEST(ensembleChorus, twoVoicesMatchChorus) {
+    float sampleRate = 48000.0f;
+    size_t len = static_cast<size_t>(sampleRate);
+
+    constexpr size_t bufferSize = 4800;
+    float chorusBuffer[bufferSize];
+    float ensembleBuffer[bufferSize];
+    Chorus chorus(etl::span<float>(chorusBuffer, bufferSize), sampleRate);
+    EnsembleChorus ensemble(etl::span<float>(ensembleBuffer, bufferSize), sampleRate);
+    chorus.Reset();
+    ensemble.Reset();
+
+    for (size_t i = 0; i < len; ++i) {
+        float in = 0.5f * sinf(kTwoPi * 220.0f * static_cast<float>(i) / sampleRate);
+        float_2 expected = chorus.Process(in);
+        float_2 actual = ensemble.Process(in);
+        // the only difference should be the control-rate ramps around the peaks of the LFO
+        ASSERT_NEAR(expected.left, actual.left, 0.01f) << "at sample " << i;
+        ASSERT_NEAR(expected.right, actual.right, 0.01f) << "at sample " << i;
+    }
+}
+
+TEST(ensembleChorus, blockMatchesPerSample) {
+    float sampleRate = 48000.0f;
+    constexpr size_t len = 1000;
+    constexpr size_t bufferSize = 4800;
+    float perSampleBuffer[bufferSize];
+    float blockBuffer[bufferSize];
+    EnsembleChorus perSample(etl::span<float>(perSampleBuffer, bufferSize), sampleRate);
+    EnsembleChorus block(etl::span<float>(blockBuffer, bufferSize), sampleRate);
+    perSample.Reset();
+    block.Reset();
+    perSample.cfg.numVoices = 5;
+    block.cfg.numVoices = 5;
+
+    float left[len];
+    float right[len];
+    for (size_t i = 0; i < len; ++i) {
+        left[i] = 0.5f * sinf(kTwoPi * 220.0f * static_cast<float>(i) / sampleRate);
+        right[i] = 0.5f * sinf(kTwoPi * 330.0f * static_cast<float>(i) / sampleRate);
+    }
+    float_2 expected[len];
+    for (size_t i = 0; i < len; ++i) {
+        expected[i] = perSample.Process(float_2{left[i], right[i]});
+    }
+    // uneven block sizes, to make sure the control rate carries over between blocks
+    size_t start = 0;
+    for (size_t blockSize : {7, 64, 100, 829}) {
+        block.Process({left + start, blockSize}, {right + start, blockSize}, {left + start, blockSize},
+                      {right + start, blockSize});
+        start += blockSize;
+    }
+    ASSERT_EQ(start, len);
+    for (size_t i = 0; i < len; ++i) {
+        ASSERT_FLOAT_EQ(expected[i].left, left[i]);
+        ASSERT_FLOAT_EQ(expected[i].right, right[i]);
+    }
+}
@@ -18,6 +18,7 @@ TEST(shift, works) {
     // test 1 default settings
     shift.Reset();
     shift.SetFrequencyOffset(40, sampleRate);
+    test::RenderTimer timer;
     for (size_t i = 0; i < len; ++i) {
         float in = f.samples[0][i] * 0.6f;
         float out = shift.Process(in);
@@ -27,5 +28,6 @@ TEST(shift, works) {
         f.samples[1][i] = out;
     }
 
+    timer.Finish();
     test::Snapshot(f);
 }
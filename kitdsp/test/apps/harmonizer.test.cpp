@@ -1,5 +1,8 @@
 #include <AudioFile.h>
 #include <gtest/gtest.h>
+#include <vector>
+#include "kitdsp/apps/harmonizer.h"
+#include "kitdsp/math/units.h"
 #include "kitdsp/math/util.h"
 #include "kitdsp/math/vector.h"
 #include "kitdsp/pitch/h910PitchShifter.h"
@@ -22,6 +25,7 @@ TEST(harmonizer, works) {
 
     // test 1 default settings
     harmonizer.Reset();
+    test::RenderTimer timer;
     for (size_t i = 0; i < len; ++i) {
         float in = f.samples[0][i];
         // harmonizer.SetParams();
@@ -34,9 +38,93 @@ TEST(harmonizer, works) {
         f.samples[1][i] = fade(in, out.right, 0.5f);
     }
 
+    timer.Finish();
     test::Snapshot(f);
 }
 
+TEST(harmonizer, chord) {
+    AudioFile<float> f;
+    bool ok = f.load(PROJECT_DIR "/test/guitar.wav");
+    ASSERT_TRUE(ok);
+
+    float sampleRate = f.getSampleRate();
+
+    constexpr size_t bufferSize = 41000;
+    float buffer[bufferSize];
+    Harmonizer harmonizer(etl::span<float>(buffer, bufferSize), sampleRate);
+
+    // major triad, a little quieter so the sum doesn't clip
+    harmonizer.Reset();
+    harmonizer.cfg.numVoices = 3;
+    harmonizer.cfg.voices[0].pitchRatio = 1.0f;
+    harmonizer.cfg.voices[1].pitchRatio = midiToRatio(4.0f);
+    harmonizer.cfg.voices[2].pitchRatio = midiToRatio(7.0f);
+    harmonizer.cfg.voices[2].grainSizeMs = 40.0f;
+    for (auto& voice : harmonizer.cfg.voices) {
+        voice.level = 0.33f;
+    }
+    harmonizer.Process(f.samples[0], f.samples[0]);
+    f.samples[1] = f.samples[0];
+
+    test::Snapshot(f);
+}
+
+TEST(harmonizer, oneVoiceMatchesH910) {
+    float sampleRate = 48000.0f;
+    size_t len = static_cast<size_t>(sampleRate);
+
+    constexpr size_t bufferSize = 4800;
+    float h910Buffer[bufferSize];
+    float harmonizerBuffer[bufferSize];
+    H910PitchShifter h910(etl::span<float>(h910Buffer, bufferSize), sampleRate);
+    Harmonizer harmonizer(etl::span<float>(harmonizerBuffer, bufferSize), sampleRate);
+
+    h910.SetParams(1.5f, 25.0f, 2.0f, 0.3f);
+    harmonizer.cfg.voices[0].pitchRatio = 1.5f;
+    harmonizer.cfg.voices[0].grainSizeMs = 25.0f;
+    harmonizer.cfg.baseDelayMs = 2.0f;
+    harmonizer.cfg.feedback = 0.3f;
+
+    for (size_t i = 0; i < len; ++i) {
+        float in = 0.5f * sinf(kTwoPi * 220.0f * static_cast<float>(i) / sampleRate);
+        ASSERT_NEAR(h910.Process(in), harmonizer.Process(in), 1e-5f) << "at sample " << i;
+    }
+}
+
+TEST(harmonizer, silentVoicesKeepTheirPlace) {
+    float sampleRate = 48000.0f;
+    size_t len = static_cast<size_t>(sampleRate);
+
+    constexpr size_t bufferSize = 4800;
+    float mutedBuffer[bufferSize];
+    float automatedBuffer[bufferSize];
+    Harmonizer muted(etl::span<float>(mutedBuffer, bufferSize), sampleRate);
+    Harmonizer automated(etl::span<float>(automatedBuffer, bufferSize), sampleRate);
+    for (Harmonizer* harmonizer : {&muted, &automated}) {
+        harmonizer->cfg.numVoices = 3;
+        harmonizer->cfg.voices[0].level = 0.5f;
+        harmonizer->cfg.voices[1].pitchRatio = midiToRatio(4.0f);
+        harmonizer->cfg.voices[2].pitchRatio = midiToRatio(7.0f);
+        harmonizer->cfg.voices[2].level = 0.5f;
+    }
+    muted.cfg.voices[1].level = 0.0f;
+    automated.cfg.voices[1].level = 0.5f;
+
+    // once the middle voice is turned down, the last voice carries on exactly where it was
+    for (size_t i = 0; i < len; ++i) {
+        if (i == len / 2) {
+            automated.cfg.voices[1].level = 0.0f;
+        }
+        float in = 0.5f * sinf(kTwoPi * 220.0f * static_cast<float>(i) / sampleRate);
+        float mutedOut = muted.Process(in);
+        float automatedOut = automated.Process(in);
+        // give the output filter a moment to forget the middle voice
+        if (i > len / 2 + 1000) {
+            ASSERT_NEAR(mutedOut, automatedOut, 1e-4f) << "at sample " << i;
+        }
+    }
+}
+
 TEST(psola, works) {
     AudioFile<float> f;
     bool ok = f.load(PROJECT_DIR "/test/guitar.wav");
@@ -47,10 +135,10 @@ TEST(psola, works) {
 
     constexpr size_t snesBufferSize = 41000;
     float snesBuffer[snesBufferSize];
-    pitch::PsolaPitchShifter shifter(etl::span<float>(snesBuffer, snesBufferSize));
+    pitch::PsolaPitchShifter shifter(etl::span<float>(snesBuffer, snesBufferSize), sampleRate);
 
     shifter.Reset();
-    shifter.SetParams(0.25f, sampleRate);
+    shifter.SetParams(0.25f);
     for (size_t i = 0; i < len; ++i) {
         float in = f.samples[0][i];
         float_2 out = float_2(shifter.Process(in));
@@ -64,3 +152,46 @@ TEST(psola, works) {
 
     test::Snapshot(f);
 }
+
+TEST(psola, shiftsPitch) {
+    float sampleRate = 48000.0f;
+    constexpr size_t bufferSize = 4096;
+    float buffer[bufferSize];
+    pitch::PsolaPitchShifter shifter(etl::span<float>(buffer, bufferSize), sampleRate);
+
+    // PSOLA needs some harmonics to work with, a pure sine can cancel itself out
+    auto input = [sampleRate](size_t i) {
+        float out = 0.0f;
+        for (size_t harmonic = 1; harmonic <= 8; ++harmonic) {
+            out += 0.3f / harmonic * sinf(kTwoPi * 220.0f * harmonic * static_cast<float>(i) / sampleRate);
+        }
+        return out;
+    };
+
+    size_t len = static_cast<size_t>(sampleRate);
+    std::vector<float> out(len);
+    auto autocorrelation = [&out, len](float lagSamples) {
+        // skip past the startup
+        size_t lag = static_cast<size_t>(lagSamples + 0.5f);
+        float correlation = 0.0f;
+        float energy = 0.0f;
+        for (size_t i = len / 2; i < len; ++i) {
+            correlation += out[i] * out[i - lag];
+            energy += out[i] * out[i];
+        }
+        return correlation / energy;
+    };
+
+    float inputPeriod = sampleRate / 220.0f;
+    for (float ratio : {1.5f, 1.25f, 0.75f}) {
+        shifter.Reset();
+        shifter.SetParams(ratio);
+        for (size_t i = 0; i < len; ++i) {
+            out[i] = shifter.Process(input(i));
+        }
+
+        // the output should repeat at the new period, and not the old one
+        EXPECT_GT(autocorrelation(inputPeriod / ratio), 0.95f) << "ratio " << ratio;
+        EXPECT_LT(autocorrelation(inputPeriod), 0.5f) << "ratio " << ratio;
+    }
+}
@@ -19,6 +19,7 @@ TEST(psxEcho, works) {
     f.setSampleRate(PSX::kOriginalSampleRate);
 
     // test 4 filter
+    test::RenderTimer timer;
     for (size_t filter = 0; filter < PSX::kNumPresets; ++filter) {
         psx.Reset();
         psx.cfg.preset = filter;
@@ -36,5 +37,6 @@ TEST(psxEcho, works) {
         }
     }
 
+    timer.Finish();
     test::Snapshot(f);
 }
\ No newline at end of file
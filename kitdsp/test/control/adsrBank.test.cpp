@@ -0,0 +1,89 @@
+#include "kitdsp/control/adsrBank.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace kitdsp;
+
+constexpr float kSampleRate = 48000.0f;
+
+TEST(adsrBank, matchesApproachAdsr) {
+    constexpr size_t kLanes = 5;
+    AdsrBank<kLanes> bank;
+    ApproachAdsr reference[kLanes];
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        float scale = static_cast<float>(lane + 1);
+        bank.SetParams(lane, 2.0f * scale, 5.0f * scale, 0.1f * scale, 3.0f * scale, kSampleRate);
+        reference[lane].SetParams(2.0f * scale, 5.0f * scale, 0.1f * scale, 3.0f * scale, kSampleRate);
+    }
+
+    for (size_t idx = 0; idx < 4000; ++idx) {
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            // stagger the gates so lanes are in different stages
+            size_t open = 100 * lane;
+            size_t close = 1000 + 300 * lane;
+            if (idx == open) {
+                bank.TriggerOpen(lane);
+                reference[lane].TriggerOpen();
+            }
+            if (idx == close) {
+                bank.TriggerClose(lane);
+                reference[lane].TriggerClose();
+            }
+            if (lane == 4 && idx == 1200) {
+                bank.TriggerChoke(lane);
+                reference[lane].TriggerChoke();
+            }
+        }
+        bank.Process();
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            reference[lane].Process();
+            ASSERT_NEAR(bank.GetValue(lane), reference[lane].GetValue(), 1e-6f) << "lane " << lane << " idx " << idx;
+            ASSERT_EQ(bank.IsProcessing(lane), reference[lane].IsProcessing()) << "lane " << lane << " idx " << idx;
+        }
+    }
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        EXPECT_FALSE(bank.IsProcessing(lane));
+    }
+}
+
+TEST(adsrBank, blockMatchesPerSample) {
+    constexpr size_t kLanes = 16;
+    constexpr size_t kBlockSize = 64;
+    AdsrBank<kLanes> block;
+    AdsrBank<kLanes> perSample;
+    block.SetParams(1.0f, 2.0f, 0.5f, 4.0f, kSampleRate);
+    perSample.SetParams(1.0f, 2.0f, 0.5f, 4.0f, kSampleRate);
+
+    std::vector<float> out(kLanes * kBlockSize);
+    for (size_t blockIdx = 0; blockIdx < 8; ++blockIdx) {
+        size_t blockStart = blockIdx * kBlockSize;
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            // gates land in the middle of blocks, and sometimes past the end of the block they were sent in
+            size_t open = lane * 13;
+            size_t close = 150 + lane * 17;
+            if (open >= blockStart && open < blockStart + kBlockSize) {
+                block.Trigger(lane, GateEvent::Open, open - blockStart);
+            }
+            if (close >= blockStart && close < blockStart + kBlockSize) {
+                block.Trigger(lane, GateEvent::Close, close - blockStart + kBlockSize / 2);
+            }
+        }
+        block.Process(kBlockSize, out);
+
+        for (size_t idx = 0; idx < kBlockSize; ++idx) {
+            size_t now = blockStart + idx;
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                if (now == lane * 13) {
+                    perSample.TriggerOpen(lane);
+                }
+                if (now == 150 + lane * 17 + kBlockSize / 2) {
+                    perSample.TriggerClose(lane);
+                }
+            }
+            perSample.Process();
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                ASSERT_EQ(out[lane * kBlockSize + idx], perSample.GetValue(lane)) << "lane " << lane << " at " << now;
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include "kitdsp/control/dx7EnvelopeBank.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace kitdsp;
+
+constexpr float kSampleRate = 48000.0f;
+
+TEST(dx7EnvelopeBank, matchesDx7Envelope) {
+    constexpr size_t kLanes = 4;
+    Dx7EnvelopeBank<kLanes> bank;
+    Dx7Envelope reference[kLanes];
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        float scale = static_cast<float>(lane + 1);
+        const float levels[4] = {1.0f, 0.1f * scale, 0.5f, 0.0f};
+        for (size_t segment = 0; segment < 4; ++segment) {
+            float durationMs = 2.0f * scale + static_cast<float>(segment);
+            bank.SetSegment(lane, segment, levels[segment], durationMs, kSampleRate);
+            reference[lane].SetSegment(segment, levels[segment], durationMs, kSampleRate);
+        }
+    }
+
+    for (size_t idx = 0; idx < 2000; ++idx) {
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            size_t open = 50 * lane;
+            size_t close = 900 + 100 * lane;
+            if (idx == open) {
+                bank.TriggerOpen(lane);
+                reference[lane].TriggerOpen();
+            }
+            if (idx == close) {
+                bank.TriggerClose(lane);
+                reference[lane].TriggerClose();
+            }
+        }
+        bank.Process();
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            reference[lane].Process();
+            ASSERT_NEAR(bank.GetValue(lane), reference[lane].GetValue(), 1e-5f) << "lane " << lane << " idx " << idx;
+            ASSERT_EQ(bank.IsProcessing(lane), reference[lane].IsProcessing()) << "lane " << lane << " idx " << idx;
+        }
+    }
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        EXPECT_FALSE(bank.IsProcessing(lane));
+    }
+}
+
+TEST(dx7EnvelopeBank, retriggersTowardsLevel) {
+    Dx7EnvelopeBank<1> bank;
+    bank.SetSegment(0, 0.2f, 10.0f, kSampleRate);
+    bank.SetSegment(1, 0.2f, 10.0f, kSampleRate);
+    bank.SetSegment(2, 0.2f, 10.0f, kSampleRate);
+    bank.SetSegment(3, 0.0f, 10.0f, kSampleRate);
+    bank.TriggerOpen(0);
+    for (size_t idx = 0; idx < 2000; ++idx) {
+        bank.Process();
+    }
+    EXPECT_EQ(bank.GetValue(0), 0.2f);
+
+    // segment 0 now starts above its level
+    bank.SetSegment(2, 0.8f, 10.0f, kSampleRate);
+    for (size_t idx = 0; idx < 2000; ++idx) {
+        bank.Process();
+    }
+    EXPECT_EQ(bank.GetValue(0), 0.8f);
+    bank.TriggerOpen(0);
+    for (size_t idx = 0; idx < 2000; ++idx) {
+        bank.Process();
+    }
+    EXPECT_NEAR(bank.GetValue(0), 0.8f, 1e-5f);
+    EXPECT_TRUE(bank.IsProcessing(0));
+}
+
+TEST(dx7EnvelopeBank, blockMatchesPerSample) {
+    constexpr size_t kLanes = 8;
+    constexpr size_t kBlockSize = 32;
+    Dx7EnvelopeBank<kLanes> block;
+    Dx7EnvelopeBank<kLanes> perSample;
+    const float levels[4] = {1.0f, 0.3f, 0.6f, 0.0f};
+    for (size_t segment = 0; segment < 4; ++segment) {
+        block.SetSegment(segment, levels[segment], 1.0f, kSampleRate);
+        perSample.SetSegment(segment, levels[segment], 1.0f, kSampleRate);
+    }
+
+    std::vector<float> out(kLanes * kBlockSize);
+    for (size_t blockIdx = 0; blockIdx < 16; ++blockIdx) {
+        size_t blockStart = blockIdx * kBlockSize;
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            size_t open = 7 + lane * 11;
+            if (open >= blockStart && open < blockStart + kBlockSize) {
+                block.Trigger(lane, GateEvent::Open, open - blockStart);
+                block.Trigger(lane, GateEvent::Close, open - blockStart + 200);
+            }
+        }
+        block.Process(kBlockSize, out);
+
+        for (size_t idx = 0; idx < kBlockSize; ++idx) {
+            size_t now = blockStart + idx;
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                if (now == 7 + lane * 11) {
+                    perSample.TriggerOpen(lane);
+                }
+                if (now == 207 + lane * 11) {
+                    perSample.TriggerClose(lane);
+                }
+            }
+            perSample.Process();
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                ASSERT_EQ(out[lane * kBlockSize + idx], perSample.GetValue(lane)) << "lane " << lane << " at " << now;
+            }
+        }
+    }
+}
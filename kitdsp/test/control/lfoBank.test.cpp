@@ -0,0 +1,129 @@
+#include "kitdsp/control/lfoBank.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include "kitdsp/control/lfo.h"
+
+using namespace kitdsp;
+using namespace kitdsp::lfo;
+
+constexpr float kSampleRate = 48000.0f;
+
+TEST(lfoBank, matchesScalarOscillators) {
+    constexpr size_t kLanes = 6;
+    LfoBank<kLanes> sines;
+    LfoBank<kLanes> triangles;
+    triangles.SetShape(Shape::Triangle);
+    TriangleOscillator reference[kLanes];
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        float frequency = 0.5f + static_cast<float>(lane) * 3.3f;
+        sines.SetFrequency(lane, frequency, kSampleRate);
+        triangles.SetFrequency(lane, frequency, kSampleRate);
+        reference[lane].SetFrequency(frequency, kSampleRate);
+    }
+
+    for (size_t idx = 0; idx < 10000; ++idx) {
+        // one control-rate step of 16 samples
+        sines.Process(16.0f);
+        triangles.Process(16.0f);
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            reference[lane].Process(16.0f);
+            ASSERT_NEAR(triangles.GetValue(lane), reference[lane].GetValue(), 1e-4f);
+            ASSERT_NEAR(sines.GetValue(lane), cosf(kTwoPi * reference[lane].GetPhase()), 1e-4f);
+        }
+    }
+}
+
+TEST(lfoBank, hasShapes) {
+    LfoBank<1> lfo;
+    // a period of 8 samples
+    lfo.SetFrequency(kSampleRate / 8.0f, kSampleRate);
+
+    lfo.SetShape(Shape::Saw);
+    EXPECT_EQ(lfo.GetValue(0), -1.0f);
+    lfo.Process(2.0f);
+    EXPECT_EQ(lfo.GetValue(0), -0.5f);
+
+    lfo.SetShape(Shape::Square);
+    EXPECT_EQ(lfo.GetValue(0), 1.0f);
+    lfo.Process(2.0f);
+    EXPECT_EQ(lfo.GetValue(0), -1.0f);
+
+    lfo.SetShape(Shape::Stepped);
+    lfo.SetSteps(4);
+    EXPECT_FLOAT_EQ(lfo.GetValue(0), 1.0f / 3.0f);
+    lfo.Process(1.0f);
+    EXPECT_FLOAT_EQ(lfo.GetValue(0), 1.0f / 3.0f);
+    lfo.Process(1.0f);
+    EXPECT_EQ(lfo.GetValue(0), 1.0f);
+}
+
+TEST(lfoBank, randomShapesChangeEachCycle) {
+    constexpr size_t kLanes = 4;
+    LfoBank<kLanes> hold;
+    LfoBank<kLanes> smooth;
+    hold.SetShape(Shape::SampleAndHold);
+    smooth.SetShape(Shape::SmoothRandom);
+    // a period of 100 samples
+    hold.SetFrequency(kSampleRate / 100.0f, kSampleRate);
+    smooth.SetFrequency(kSampleRate / 100.0f, kSampleRate);
+
+    float sum = 0.0f;
+    float sumSquares = 0.0f;
+    size_t numCycles = 2000;
+    std::vector<float> last(kLanes, 0.0f);
+    for (size_t cycle = 0; cycle < numCycles; ++cycle) {
+        float held[kLanes]{};
+        for (size_t idx = 0; idx < 100; ++idx) {
+            hold.Process(1.0f);
+            smooth.Process(1.0f);
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                // no jumps
+                if (cycle > 0 || idx > 0) {
+                    ASSERT_LT(fabsf(smooth.GetValue(lane) - last[lane]), 0.05f);
+                }
+                last[lane] = smooth.GetValue(lane);
+
+                // the cycle boundary drifts a little from rounding, so only look at the middle of it
+                if (idx == 10) {
+                    held[lane] = hold.GetValue(lane);
+                    EXPECT_GE(held[lane], -1.0f);
+                    EXPECT_LE(held[lane], 1.0f);
+                    sum += held[lane];
+                    sumSquares += held[lane] * held[lane];
+                } else if (idx > 10 && idx < 90) {
+                    ASSERT_EQ(hold.GetValue(lane), held[lane]);
+                }
+            }
+            if (idx == 10) {
+                // lanes don't follow each other
+                EXPECT_NE(held[0], held[1]);
+            }
+        }
+    }
+    // uniformly distributed in [-1, 1]
+    float count = static_cast<float>(numCycles * kLanes);
+    EXPECT_NEAR(sum / count, 0.0f, 0.05f);
+    EXPECT_NEAR(sumSquares / count, 1.0f / 3.0f, 0.05f);
+}
+
+TEST(lfoBank, blockMatchesControlRate) {
+    constexpr size_t kLanes = 4;
+    constexpr size_t kBlockSize = 32;
+    LfoBank<kLanes> block;
+    LfoBank<kLanes> perSample;
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        block.SetFrequency(lane, 100.0f * static_cast<float>(lane + 1), kSampleRate);
+        perSample.SetFrequency(lane, 100.0f * static_cast<float>(lane + 1), kSampleRate);
+        block.SetPhase(lane, 0.1f * static_cast<float>(lane));
+        perSample.SetPhase(lane, 0.1f * static_cast<float>(lane));
+    }
+
+    std::vector<float> out(kLanes * kBlockSize);
+    block.Process(kBlockSize, out);
+    for (size_t idx = 0; idx < kBlockSize; ++idx) {
+        perSample.Process();
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            ASSERT_EQ(out[lane * kBlockSize + idx], perSample.GetValue(lane));
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#include "kitdsp/math/approx.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include "kitdsp/lookupTables/sineLut.h"
+#include "kitdsp/math/util.h"
+
+using namespace kitdsp;
+
+namespace {
+template <typename F>
+double maxSineError(F fn) {
+    double maxError = 0.0;
+    // covers negative and multi-period inputs too
+    for (int32_t idx = -100000; idx <= 100000; ++idx) {
+        float x = static_cast<float>(idx) / 32768.0f;
+        double expected = std::sin(static_cast<double>(kTwoPi) * static_cast<double>(x));
+        maxError = std::max(maxError, std::fabs(static_cast<double>(fn(x)) - expected));
+    }
+    return maxError;
+}
+}  // namespace
+
+TEST(approx, sinePolyIsAccurate) {
+    EXPECT_LT(maxSineError([](float x) { return approx::sin2pif_poly(x); }), 5e-6);
+    EXPECT_LT(maxSineError([](float x) { return approx::cos2pif_poly(x - 0.25f); }), 5e-6);
+}
+
+TEST(approx, sineLutLerpIsAccurate) {
+    EXPECT_LT(maxSineError([](float x) { return sin2pif_lut_lerp(x); }), 6e-6);
+    EXPECT_LT(maxSineError([](float x) { return cos2pif_lut_lerp(x - 0.25f); }), 6e-6);
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
 #include <kitdsp/math/approx.h>
+#include <kitdsp/math/util.h>
 #include <kitdsp/osc/oscillatorUtil.h>
+#include <kitdsp/pitch/pitchMarkTracker.h>
 #include <kitdsp/pitch/zeroCrossingPitchDetector.h>
 
 TEST(zeroCrossingPitchDetector, detectsSineWaves) {
@@ -37,3 +41,85 @@ TEST(zeroCrossingPitchDetector, detectsSineWaves) {
     }
     EXPECT_NEAR(detect.GetFrequency(), 924.0f, 1.0f);
 }
+
+TEST(zeroCrossingPitchDetector, ignoresHarmonicsAndNoise) {
+    float SR = 48000.0f;
+    kitdsp::pitch::ZeroCrossingPitchDetector detect(SR);
+    size_t len = static_cast<size_t>(SR);
+
+    // a bright, slightly noisy tone with a DC offset. the 2nd and 3rd harmonics add extra crossings per period
+    uint32_t seed = 1;
+    for (size_t i = 0; i < len; ++i) {
+        float t = static_cast<float>(i) / SR;
+        seed = seed * 1664525u + 1013904223u;
+        float noise = (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 0.05f;
+        float in = 0.1f + 0.5f * sinf(kitdsp::kTwoPi * 196.0f * t) + 0.4f * sinf(kitdsp::kTwoPi * 392.0f * t) +
+                   0.3f * sinf(kitdsp::kTwoPi * 588.0f * t) + noise;
+        detect.Process(in);
+    }
+    EXPECT_NEAR(detect.GetFrequency(), 196.0f, 0.5f);
+}
+
+TEST(zeroCrossingPitchDetector, blockMatchesPerSample) {
+    float SR = 44100.0f;
+    kitdsp::pitch::ZeroCrossingPitchDetector perSample(SR);
+    kitdsp::pitch::ZeroCrossingPitchDetector block(SR);
+
+    std::vector<float> in(static_cast<size_t>(SR));
+    for (size_t i = 0; i < in.size(); ++i) {
+        // fade in from silence, then a pitch sweep
+        float t = static_cast<float>(i) / SR;
+        float level = kitdsp::clamp(t * 4.0f - 1.0f, 0.0f, 1.0f);
+        in[i] = level * sinf(kitdsp::kTwoPi * (110.0f * t + 110.0f * t * t));
+    }
+
+    for (float f : in) {
+        perSample.Process(f);
+    }
+    // odd sizes so the chunks don't line up with anything
+    for (size_t start = 0; start < in.size(); start += 1001) {
+        size_t len = std::min<size_t>(1001, in.size() - start);
+        block.Process({in.data() + start, len});
+    }
+    EXPECT_EQ(perSample.GetPeriod(), block.GetPeriod());
+    // the median lags behind the sweep a little
+    EXPECT_NEAR(block.GetFrequency(), 330.0f, 4.0f);
+}
+
+TEST(zeroCrossingPitchDetector, isSubSampleAccurate) {
+    // 48000 / 137 = 350.36... samples, so integer periods would be off by ~0.4Hz
+    float SR = 48000.0f;
+    kitdsp::pitch::ZeroCrossingPitchDetector detect(SR);
+    std::vector<float> in(static_cast<size_t>(SR));
+    for (size_t i = 0; i < in.size(); ++i) {
+        in[i] = sinf(kitdsp::kTwoPi * 137.0f * static_cast<float>(i) / SR);
+    }
+    detect.Process({in.data(), in.size()});
+    EXPECT_NEAR(detect.GetFrequency(), 137.0f, 0.02f);
+}
+
+TEST(pitchMarkTracker, marksEveryPeriod) {
+    float SR = 48000.0f;
+    float periodSamples = 100.0f;
+    kitdsp::pitch::PitchMarkTracker marks;
+
+    size_t len = static_cast<size_t>(SR);
+    size_t lastMarkSample = 0;
+    size_t numMarks = 0;
+    for (size_t i = 0; i < len; ++i) {
+        float sinWave = sinf(kitdsp::kTwoPi * static_cast<float>(i) / periodSamples);
+        if (marks.Process(sinWave, periodSamples)) {
+            // marks should land on the peaks, a quarter period into each cycle
+            size_t markSample = i - marks.GetMarkDelay(0);
+            EXPECT_NEAR(static_cast<float>(markSample % 100), 25.0f, 1.0f);
+            if (numMarks > 0) {
+                EXPECT_EQ(markSample - lastMarkSample, 100u);
+            }
+            lastMarkSample = markSample;
+            numMarks++;
+        }
+    }
+    EXPECT_NEAR(static_cast<float>(numMarks), static_cast<float>(len) / periodSamples, 2.0f);
+    EXPECT_EQ(marks.GetNumMarks(), kitdsp::pitch::PitchMarkTracker::kMaxMarks);
+    EXPECT_EQ(marks.FindNearestMark(250.0f), 2u);
+}
@@ -2,7 +2,21 @@
 
 #include <AudioFile.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace kitdsp::test {
 template <typename... TColumns>
@@ -10,16 +24,45 @@ class CsvFile {
     using Row = std::tuple<TColumns...>;
 
    public:
+    /**
+     * Reads a file written by save(). Fields can't contain commas or newlines, since nothing is quoted.
+     * @returns false if the file can't be read, or if any row doesn't match TColumns
+     */
     bool load(const std::string& filepath) {
-        // TODO
-        return false;
+        std::ifstream in(filepath);
+        if (!in) {
+            return false;
+        }
+        std::string line;
+        if (!std::getline(in, line)) {
+            return false;
+        }
+        columns = split(line);
+        rows.clear();
+        while (std::getline(in, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            std::vector<std::string> fields = split(line);
+            if (fields.size() != sizeof...(TColumns)) {
+                return false;
+            }
+            Row row;
+            if (!readRow(fields, row, std::index_sequence_for<TColumns...>{})) {
+                return false;
+            }
+            rows.push_back(row);
+        }
+        return true;
     }
     bool save(const std::string& filepath) {
         std::ofstream out(filepath);
-        // TODO: failure checking
+        if (!out) {
+            return false;
+        }
         write(out);
         out.close();
-        return true;
+        return !out.fail();
     }
     void print() {
         write(std::cout);
@@ -29,7 +72,40 @@ class CsvFile {
     std::vector<Row> rows;
 
    private:
+    static std::vector<std::string> split(const std::string& line) {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            // tolerate files saved with windows line endings
+            if (!field.empty() && field.back() == '\r') {
+                field.pop_back();
+            }
+            fields.push_back(field);
+        }
+        return fields;
+    }
+
+    template <typename T>
+    static bool readField(const std::string& field, T& out) {
+        if constexpr (std::is_same_v<T, std::string>) {
+            out = field;
+            return true;
+        } else {
+            std::istringstream ss(field);
+            ss >> out;
+            return !ss.fail();
+        }
+    }
+
+    template <std::size_t... I>
+    bool readRow(const std::vector<std::string>& fields, Row& row, std::index_sequence<I...>) {
+        return (readField(fields[I], std::get<I>(row)) && ...);
+    }
+
     void write(std::ostream& out) const {
+        // enough digits that floats survive a round trip through load()
+        out << std::setprecision(std::numeric_limits<float>::max_digits10);
         bool comma = false;
         for (const auto& column : columns) {
             if (comma) {
@@ -55,57 +131,73 @@ class CsvFile {
     }
 };
 
+/**
+ * How closely a render has to match its snapshot.
+ */
+struct Tolerance {
+    /// the largest difference allowed for any single value, relative to max(1, |expected|)
+    double maxError = 0.01;
+    /// the lowest signal to noise ratio allowed, treating the difference from the snapshot as noise
+    double minSnrDb = 60.0;
+};
+
 namespace {
+inline std::string SnapshotPath(std::string_view postfix, std::string_view extension) {
+    const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::stringstream ss;
+    ss << PROJECT_DIR << "/test/snapshots/" << test_info->test_suite_name() << "_" << test_info->name() << postfix
+       << extension;
+    return ss.str();
+}
+
 template <typename T>
-void compareElem(const T& expected, const T& actual) {
+void compareElem(const T& expected, const T& actual, size_t row, const Tolerance& tolerance) {
     if constexpr (std::is_floating_point_v<T>) {
-        EXPECT_NEAR(expected, actual, 1e-5);
+        double scale = std::max(1.0, std::abs(static_cast<double>(expected)));
+        EXPECT_NEAR(expected, actual, tolerance.maxError * scale) << "in row " << row;
     } else {
-        EXPECT_EQ(expected, actual);
+        EXPECT_EQ(expected, actual) << "in row " << row;
     }
 }
 template <typename Tuple1, typename Tuple2, std::size_t... I>
-void compareTupleImpl(const Tuple1& t1, const Tuple2& t2, std::index_sequence<I...>) {
-    (compareElem(std::get<I>(t1), std::get<I>(t2)), ...);
+void compareTupleImpl(const Tuple1& t1,
+                      const Tuple2& t2,
+                      size_t row,
+                      const Tolerance& tolerance,
+                      std::index_sequence<I...>) {
+    (compareElem(std::get<I>(t1), std::get<I>(t2), row, tolerance), ...);
 }
 template <typename... Ts>
-void compareTuple(const std::tuple<Ts...>& expected, const std::tuple<Ts...>& actual) {
-    compareTupleImpl(expected, actual, std::index_sequence_for<Ts...>{});
+void compareTuple(const std::tuple<Ts...>& expected,
+                  const std::tuple<Ts...>& actual,
+                  size_t row,
+                  const Tolerance& tolerance) {
+    compareTupleImpl(expected, actual, row, tolerance, std::index_sequence_for<Ts...>{});
 }
 }  // namespace
 
 template <typename... TColumns>
-inline void Snapshot(CsvFile<TColumns...>& f, std::string_view postfix = "") {
+inline void Snapshot(CsvFile<TColumns...>& f, std::string_view postfix = "", Tolerance tolerance = {0.0001, 0.0}) {
     // time to snapshot
     bool shouldUpdate = getenv("UPDATE_SNAPSHOTS") != nullptr;
 
-    const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
-    std::stringstream ss;
-    ss << PROJECT_DIR << "/test/snapshots/" << test_info->test_suite_name() << "_" << test_info->name() << postfix
-       << ".csv";
-
-    std::string filepath{ss.str()};
-    ASSERT_TRUE(f.save(filepath)) << "File saving failed";
-
-    // TODO: csv loading
-    // CsvFile<TColumns...> expected;
-    // bool loaded = expected.load(filepath);
-    // if (!loaded || shouldUpdate) {
-    //    // file may not exist, try to write
-    //    ASSERT_TRUE(f.save(filepath)) << "File saving failed";
-    //    return;
-    //}
-
-    // for (size_t i = 0; i < f.columns.size(); ++i) {
-    //     EXPECT_STREQ(f.columns[i], expected.columns[i]);
-    // }
-
-    // for (size_t i = 0; i < f.rows.size(); ++i) {
-    //     compareElem(f.rows[i], expected.rows[i]);
-    // }
+    std::string filepath = SnapshotPath(postfix, ".csv");
+    CsvFile<TColumns...> expected;
+    bool loaded = expected.load(filepath);
+    if (!loaded || shouldUpdate) {
+        // file may not exist, try to write
+        ASSERT_TRUE(f.save(filepath)) << "File saving failed";
+        return;
+    }
+
+    ASSERT_EQ(f.columns, expected.columns);
+    ASSERT_EQ(f.rows.size(), expected.rows.size()) << "Set the environment variable UPDATE_SNAPSHOTS to update anyways";
+    for (size_t i = 0; i < f.rows.size(); ++i) {
+        compareTuple(expected.rows[i], f.rows[i], i, tolerance);
+    }
 }
 
-inline void Snapshot(AudioFile<float>& f, std::string_view postfix = "") {
+inline void Snapshot(AudioFile<float>& f, std::string_view postfix = "", Tolerance tolerance = {}) {
     // pass 1: sanity check
     float SR = f.getSampleRate();
     for (size_t i = 0; i < f.getNumSamplesPerChannel(); ++i) {
@@ -120,12 +212,7 @@ inline void Snapshot(AudioFile<float>& f, std::string_view postfix = "") {
     // time to snapshot
     bool shouldUpdate = getenv("UPDATE_SNAPSHOTS") != nullptr;
 
-    const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
-    std::stringstream ss;
-    ss << PROJECT_DIR << "/test/snapshots/" << test_info->test_suite_name() << "_" << test_info->name() << postfix
-       << ".wav";
-
-    std::string filepath{ss.str()};
+    std::string filepath = SnapshotPath(postfix, ".wav");
     AudioFile<float> expected;
     bool loaded = expected.load(filepath);
     if (!loaded || shouldUpdate) {
@@ -135,7 +222,7 @@ inline void Snapshot(AudioFile<float>& f, std::string_view postfix = "") {
     }
     EXPECT_EQ(f.getSampleRate(), expected.getSampleRate());
     EXPECT_EQ(f.getNumChannels(), expected.getNumChannels());
-    EXPECT_DOUBLE_EQ(f.getLengthInSeconds(), f.getLengthInSeconds());
+    EXPECT_EQ(f.getNumSamplesPerChannel(), expected.getNumSamplesPerChannel());
 
     if (f.getNumChannels() != expected.getNumChannels() ||
         f.getNumSamplesPerChannel() != expected.getNumSamplesPerChannel() ||
@@ -143,13 +230,128 @@ inline void Snapshot(AudioFile<float>& f, std::string_view postfix = "") {
         return;
     }
 
-    for (size_t i = 0; i < f.getNumSamplesPerChannel(); ++i) {
-        for (size_t c = 0; c < f.getNumChannels(); ++c) {
-            ASSERT_NEAR(f.samples[c][i], expected.samples[c][i], 0.01)
-                << "Non-matching sample at " << i << " (" << (i / SR) << " seconds)\n"
+    // pass 2: compare. samples are allowed to drift a little, as long as the render as a whole stays close, so
+    // approximations and reordered math don't need exact matches
+    for (size_t c = 0; c < f.getNumChannels(); ++c) {
+        double signalPower = 0.0;
+        double errorPower = 0.0;
+        double maxError = 0.0;
+        size_t maxErrorIndex = 0;
+        for (size_t i = 0; i < f.getNumSamplesPerChannel(); ++i) {
+            double reference = expected.samples[c][i];
+            double error = static_cast<double>(f.samples[c][i]) - reference;
+            signalPower += reference * reference;
+            errorPower += error * error;
+            if (std::abs(error) > maxError) {
+                maxError = std::abs(error);
+                maxErrorIndex = i;
+            }
+        }
+        EXPECT_LE(maxError, tolerance.maxError)
+            << "Non-matching sample at " << maxErrorIndex << " (" << (maxErrorIndex / SR) << " seconds) in channel "
+            << c << "\n"
+            << "Set the environment variable UPDATE_SNAPSHOTS to update anyways";
+        // a silent snapshot has no meaningful SNR, maxError covers it
+        if (errorPower > 0.0 && signalPower > 0.0) {
+            double snrDb = 10.0 * std::log10(signalPower / errorPower);
+            EXPECT_GE(snrDb, tolerance.minSnrDb)
+                << "Render drifted from the snapshot in channel " << c << "\n"
                 << "Set the environment variable UPDATE_SNAPSHOTS to update anyways";
         }
     }
 }
 
+namespace {
+/**
+ * How long a fixed, kitdsp-independent workload takes on this machine, in seconds. Render times are divided by this
+ * before they're stored, so baselines mean roughly the same thing on a faster or slower machine.
+ */
+inline double ReferenceSeconds() {
+    static const double seconds = []() {
+        std::vector<float> buffer(4096);
+        double best = std::numeric_limits<double>::max();
+        for (size_t run = 0; run < 5; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            float state = 0.0f;
+            for (size_t pass = 0; pass < 64; ++pass) {
+                for (size_t i = 0; i < buffer.size(); ++i) {
+                    // a one-pole lowpass over a ramp
+                    state += (static_cast<float>(i & 255) * 0.01f - state) * 0.1f;
+                    buffer[i] = state;
+                }
+            }
+            // keep the optimizer from throwing the work away
+            volatile float sink = buffer[run];
+            (void)sink;
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        return best;
+    }();
+    return seconds;
+}
+}  // namespace
+
+/**
+ * Times a render, and compares it against a baseline. Baselines are stored per test as snapshots/<test>.timing.csv, in
+ * units of ReferenceSeconds(), and are checked in like the other snapshots. A test without one records it on its first
+ * run, and UPDATE_TIMINGS re-records them. Record them from an optimized build.
+ *
+ * A single render is noisy, and baselines move around a lot between machines, compilers and build types (shared CI
+ * runners especially), so timings never fail a test unless asked to: set KITDSP_TIMING_TOLERANCE to a percentage, and
+ * renders that got more than that much slower than their baseline fail. Otherwise, renders more than
+ * kWarningTolerancePercent slower only print a warning.
+ *
+ * Usage:
+ *   test::RenderTimer timer;
+ *   // ...render into f...
+ *   timer.Finish();
+ *   test::Snapshot(f);
+ */
+class RenderTimer {
+   public:
+    static constexpr double kWarningTolerancePercent = 200.0;
+
+    RenderTimer() : mStart(std::chrono::steady_clock::now()) {}
+
+    void Finish(std::string_view postfix = "") {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStart;
+        double cost = elapsed.count() / ReferenceSeconds();
+        ::testing::Test::RecordProperty("render_seconds", std::to_string(elapsed.count()));
+
+        bool shouldUpdate = getenv("UPDATE_TIMINGS") != nullptr;
+        std::string filepath = SnapshotPath(postfix, ".timing.csv");
+        CsvFile<double, double> baseline;
+        bool loaded = baseline.load(filepath) && baseline.rows.size() == 1;
+        if (!loaded || shouldUpdate) {
+            CsvFile<double, double> out;
+            out.columns = {"cost", "seconds"};
+            out.rows.push_back({cost, elapsed.count()});
+            ASSERT_TRUE(out.save(filepath)) << "File saving failed";
+            return;
+        }
+
+        double expectedCost = std::get<0>(baseline.rows[0]);
+        const char* toleranceEnv = getenv("KITDSP_TIMING_TOLERANCE");
+        if (toleranceEnv == nullptr) {
+#ifdef NDEBUG
+            // unoptimized builds are nowhere near the baselines, so there's nothing worth warning about
+            if (cost > expectedCost * (1.0 + kWarningTolerancePercent / 100.0)) {
+                std::cerr << "[  WARNING ] Render took " << elapsed.count() << "s, "
+                          << (cost / expectedCost - 1.0) * 100.0 << "% slower than the baseline\n";
+            }
+#endif
+            return;
+        }
+        double tolerancePercent = std::atof(toleranceEnv);
+        EXPECT_LE(cost, expectedCost * (1.0 + tolerancePercent / 100.0))
+            << "Render took " << elapsed.count() << "s, " << (cost / expectedCost - 1.0) * 100.0
+            << "% slower than the baseline\n"
+            << "Set the environment variable UPDATE_TIMINGS to update anyways";
+    }
+
+   private:
+    std::chrono::steady_clock::time_point mStart;
+};
+
 }  // namespace kitdsp::test
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "kitdsp/util/arena.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+using namespace kitdsp;
+
+namespace {
+bool isAligned(const void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % Arena::kAlignment == 0;
+}
+}  // namespace
+
+TEST(arena, allocatesAlignedZeroedMemory) {
+    Arena arena;
+    arena.Reserve(Arena::GetAllocSize<float>(3) + Arena::GetAllocSize<double>(100));
+    etl::span<float> a = arena.Alloc<float>(3);
+    etl::span<double> b = arena.Alloc<double>(100);
+    ASSERT_EQ(a.size(), 3u);
+    ASSERT_EQ(b.size(), 100u);
+    EXPECT_TRUE(isAligned(a.data()));
+    EXPECT_TRUE(isAligned(b.data()));
+    // no overlap
+    EXPECT_GE(reinterpret_cast<uintptr_t>(b.data()), reinterpret_cast<uintptr_t>(a.data() + a.size()));
+    for (double sample : b) {
+        EXPECT_EQ(sample, 0.0);
+    }
+    EXPECT_EQ(arena.GetUsed(), arena.GetCapacity());
+}
+
+TEST(arena, reusesMemoryAcrossResets) {
+    Arena arena;
+    arena.Reserve(4096);
+    float* first = arena.Alloc<float>(1000).data();
+    arena.Alloc<float>(10)[0] = 1.0f;
+
+    // re-activating with the same or less memory doesn't reallocate
+    arena.Reset();
+    arena.Reserve(1024);
+    EXPECT_EQ(arena.Alloc<float>(1000).data(), first);
+    // and old allocations are zeroed out
+    EXPECT_EQ(arena.Alloc<float>(10)[0], 0.0f);
+    EXPECT_EQ(arena.GetHighWaterMark(), Arena::GetAllocSize<float>(1000) + Arena::GetAllocSize<float>(10));
+}
+
+TEST(arena, rollsBackToCheckpoints) {
+    Arena arena;
+    arena.Reserve(1024);
+    arena.Alloc<uint8_t>(1);
+    size_t used = arena.GetUsed();
+    {
+        Arena::Scope scope(arena);
+        arena.Alloc<uint8_t>(500);
+        EXPECT_GT(arena.GetUsed(), used);
+    }
+    EXPECT_EQ(arena.GetUsed(), used);
+    EXPECT_EQ(arena.GetHighWaterMark(), 64u + 512u);
+
+    Arena::Checkpoint checkpoint = arena.Save();
+    arena.Alloc<uint8_t>(100);
+    arena.Rollback(checkpoint);
+    EXPECT_EQ(arena.GetUsed(), used);
+}
+
+TEST(arena, worksOverExternalMemory) {
+    std::vector<uint8_t> mem(1000);
+    // deliberately misaligned
+    Arena arena({mem.data() + 1, mem.size() - 1});
+    EXPECT_GE(arena.GetCapacity(), 1000u - 2u * Arena::kAlignment);
+    etl::span<float> a = arena.Alloc<float>(10);
+    EXPECT_TRUE(isAligned(a.data()));
+    EXPECT_GE(a.data(), reinterpret_cast<float*>(mem.data()));
+}
+
+#ifndef NDEBUG
+TEST(arenaDeathTest, trapsAllocationsWhenSealed) {
+    Arena arena;
+    arena.Reserve(1024);
+    arena.Seal();
+    EXPECT_DEATH(arena.Alloc<float>(1), "sealed");
+    arena.Unseal();
+    EXPECT_EQ(arena.Alloc<float>(1).size(), 1u);
+}
+#endif
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "kitdsp/math/util.h"
+#include "kitdsp/volume/blockDbMeter.h"
+#include "kitdsp/volume/dbMeter.h"
+
+using namespace kitdsp;
+
+namespace {
+std::vector<float> makeSine(float frequency, float amplitude, float sampleRate, size_t len) {
+    std::vector<float> out(len);
+    for (size_t idx = 0; idx < len; ++idx) {
+        out[idx] = amplitude * sinf(kTwoPi * frequency * static_cast<float>(idx) / sampleRate);
+    }
+    return out;
+}
+
+// feeds the meter in uneven blocks, so bins don't line up with them
+void processInBlocks(BlockDbMeter& meter, const std::vector<float>& left, const std::vector<float>& right) {
+    size_t offset = 0;
+    size_t blockSize = 37;
+    while (offset < left.size()) {
+        size_t len = min(blockSize, left.size() - offset);
+        meter.Process({left.data() + offset, len}, {right.data() + offset, len});
+        offset += len;
+        blockSize = blockSize * 7 % 509 + 1;
+    }
+}
+}  // namespace
+
+TEST(blockDbMeter, matchesDbMeter) {
+    float sampleRate = 48000.0f;
+    std::vector<float> in = makeSine(440.0f, dbToRatio(-12.0f), sampleRate, 48000);
+
+    DbMeter reference(sampleRate);
+    float referenceDb = 0.0f;
+    for (float sample : in) {
+        referenceDb = reference.Process(sample);
+    }
+
+    auto meter = std::make_unique<BlockDbMeter>(sampleRate);
+    meter->Process(in);
+    EXPECT_NEAR(meter->GetRmsDb(), referenceDb, 0.1f);
+    EXPECT_NEAR(meter->GetRmsDb(), -12.0f, 0.05f);
+    EXPECT_NEAR(meter->GetPeakDb(), -12.0f, 0.05f);
+}
+
+TEST(blockDbMeter, windowsAreSliding) {
+    float sampleRate = 44100.0f;
+    auto meter = std::make_unique<BlockDbMeter>(sampleRate);
+    meter->cfg.windowMs = 100.0f;
+
+    std::vector<float> loud = makeSine(1000.0f, 1.0f, sampleRate, 44100);
+    std::vector<float> silence(4410 * 2, 0.0f);
+    processInBlocks(*meter, loud, loud);
+    EXPECT_NEAR(meter->GetRmsDb(), 0.0f, 0.05f);
+
+    // half the window is silent, so the power is halved
+    processInBlocks(*meter, {silence.begin(), silence.begin() + 2205}, {silence.begin(), silence.begin() + 2205});
+    EXPECT_NEAR(meter->GetRmsDb(), -3.01f, 0.05f);
+    EXPECT_NEAR(meter->GetPeakDb(), 0.0f, 0.05f);
+
+    processInBlocks(*meter, silence, silence);
+    EXPECT_EQ(meter->GetRmsDb(), BlockDbMeter::kSilenceDb + 3.0103f);
+    EXPECT_EQ(meter->GetPeakDb(), BlockDbMeter::kSilenceDb);
+}
+
+TEST(blockDbMeter, measuresLoudness) {
+    // EBU Tech 3341 test cases 1 and 2: a stereo 1kHz sine reads the same in LUFS as in dBFS
+    for (float sampleRate : {44100.0f, 48000.0f}) {
+        for (float level : {-23.0f, -33.0f}) {
+            auto meter = std::make_unique<BlockDbMeter>(sampleRate);
+            meter->cfg.loudness = true;
+            std::vector<float> in = makeSine(1000.0f, dbToRatio(level), sampleRate, static_cast<size_t>(sampleRate * 4));
+            processInBlocks(*meter, in, in);
+            EXPECT_NEAR(meter->GetMomentaryLufs(), level, 0.1f) << sampleRate;
+            EXPECT_NEAR(meter->GetShortTermLufs(), level, 0.1f) << sampleRate;
+        }
+    }
+}
+
+TEST(blockDbMeter, loudnessIsKWeighted) {
+    float sampleRate = 48000.0f;
+    auto meter = std::make_unique<BlockDbMeter>(sampleRate);
+    meter->cfg.loudness = true;
+
+    // BS.1770 K-weighting response: +0.7dB at 1kHz (which cancels out the -0.691 offset), +4dB at the top of the shelf,
+    // and cut below ~40Hz
+    std::vector<float> high = makeSine(10000.0f, dbToRatio(-23.0f), sampleRate, 48000);
+    processInBlocks(*meter, high, high);
+    EXPECT_NEAR(meter->GetMomentaryLufs(), -23.0f - 0.691f + 4.0f, 0.2f);
+
+    meter->Reset();
+    std::vector<float> low = makeSine(20.0f, dbToRatio(-23.0f), sampleRate, 48000);
+    processInBlocks(*meter, low, low);
+    EXPECT_LT(meter->GetMomentaryLufs(), -23.0f - 10.0f);
+}
+
+TEST(blockDbMeter, measuresTruePeak) {
+    float sampleRate = 48000.0f;
+    auto meter = std::make_unique<BlockDbMeter>(sampleRate);
+    meter->cfg.truePeak = true;
+
+    // fs/4 sine, phased so every sample lands 3dB below the real peak
+    std::vector<float> in(4800);
+    for (size_t idx = 0; idx < in.size(); ++idx) {
+        in[idx] = 0.5f * sinf(kPi * 0.5f * static_cast<float>(idx) + kPi * 0.25f);
+    }
+    processInBlocks(*meter, in, in);
+    EXPECT_NEAR(meter->GetPeakDb(), ratioToDb(0.5f) - 3.01f, 0.05f);
+    EXPECT_NEAR(meter->GetTruePeakDb(), ratioToDb(0.5f), 0.2f);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "kitdsp/filters/onePole.h"
+#include "kitdsp/math/units.h"
+#include "kitdsp/math/util.h"
+#include "kitdsp/volume/truePeakLimiter.h"
+
+using namespace kitdsp;
+
+namespace {
+using Limiter = TruePeakLimiter<>;
+
+// a much more expensive reference: 16x oversampling with a long sinc
+float measureTruePeak(const std::vector<float>& in) {
+    constexpr int32_t kRadius = 64;
+    constexpr int32_t kFactor = 16;
+    float peak = 0.0f;
+    for (int32_t idx = kRadius; idx < static_cast<int32_t>(in.size()) - kRadius; ++idx) {
+        for (int32_t phase = 0; phase < kFactor; ++phase) {
+            float t = static_cast<float>(phase) / kFactor;
+            float sum = 0.0f;
+            for (int32_t tap = -kRadius; tap <= kRadius; ++tap) {
+                float x = static_cast<float>(tap) - t;
+                float sinc = x == 0.0f ? 1.0f : sinf(kPi * x) / (kPi * x);
+                float window = 0.5f + 0.5f * cosf(kPi * x / (kRadius + 1));
+                sum += in[idx + tap] * sinc * window;
+            }
+            peak = max(peak, fabsf(sum));
+        }
+    }
+    return peak;
+}
+}  // namespace
+
+TEST(truePeakLimiter, catchesInterSamplePeaks) {
+    float sampleRate = 48000.0f;
+    auto limiter = std::make_unique<Limiter>(sampleRate);
+    limiter->cfg.ceilingDb = -1.0f;
+
+    // a sine at a quarter of the sample rate, 45 degrees out of phase. every sample is at 0.707 of the real peak, so a
+    // sample peak limiter would let it through 3dB too hot
+    size_t len = 4800;
+    std::vector<float> left(len);
+    std::vector<float> right(len);
+    for (size_t i = 0; i < len; ++i) {
+        float level = i < len / 2 ? 0.25f : 1.2f;
+        left[i] = level * sinf(kHalfPi * static_cast<float>(i) + kPi * 0.25f);
+        right[i] = 0.5f * left[i];
+    }
+    EXPECT_GT(measureTruePeak(left), 1.0f);
+
+    limiter->Process({left.data(), len}, {right.data(), len}, {left.data(), len}, {right.data(), len});
+
+    float ceiling = dbToRatio(-1.0f);
+    EXPECT_LT(measureTruePeak(left), ceiling * dbToRatio(0.1f));
+    EXPECT_NEAR(limiter->ConsumeMaxGainReductionDb(), ratioToDb(1.2f / ceiling), 0.2f);
+    EXPECT_EQ(limiter->ConsumeMaxGainReductionDb(), 0.0f);
+    EXPECT_EQ(limiter->GetActivationCount(), 1u);
+}
+
+TEST(truePeakLimiter, limitsBurstsWithoutOvershoot) {
+    float sampleRate = 44100.0f;
+    auto limiter = std::make_unique<Limiter>(sampleRate, 5.0f);
+    limiter->cfg.ceilingDb = -0.3f;
+    limiter->cfg.releaseMs = 50.0f;
+
+    // 4x oversampling can't see peaks right up at nyquist (neither can BS.1770), so the noise is band limited
+    OnePoleSeries<4> lowPass;
+    lowPass.SetFrequency(12000.0f, sampleRate);
+
+    size_t len = static_cast<size_t>(sampleRate * 0.5f);
+    std::vector<float> out(len);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < len; ++i) {
+        // loud noise bursts
+        seed = seed * 1664525u + 1013904223u;
+        float noise = lowPass.Process(static_cast<float>(seed >> 8) / 16777216.0f - 0.5f);
+        float level = (i / 4410) % 2 == 0 ? 4.0f : 0.1f;
+        out[i] = limiter->Process(float_2{noise * level, 0.0f}).left;
+    }
+
+    EXPECT_LT(measureTruePeak(out), dbToRatio(-0.3f) * dbToRatio(0.2f));
+}
+
+TEST(truePeakLimiter, reportsLatency) {
+    float sampleRate = 48000.0f;
+    auto limiter = std::make_unique<Limiter>(sampleRate, 1.0f);
+    size_t latency = limiter->GetLatencySamples();
+    EXPECT_EQ(latency, 48u + TruePeakDetector::kLatencySamples);
+
+    // a quiet impulse should come out untouched, just late
+    for (size_t i = 0; i < latency * 2; ++i) {
+        float_2 out = limiter->Process(float_2{i == 0 ? 0.5f : 0.0f, 0.0f});
+        EXPECT_EQ(out.left, i == latency ? 0.5f : 0.0f) << "at sample " << i;
+    }
+    EXPECT_EQ(limiter->ConsumeMaxGainReductionDb(), 0.0f);
+    EXPECT_EQ(limiter->GetActivationCount(), 0u);
+
+    limiter->SetLookahead(3.0f);
+    EXPECT_EQ(limiter->GetLatencySamples(), 144u + TruePeakDetector::kLatencySamples);
+}
+
+TEST(truePeakLimiter, blockMatchesPerSample) {
+    float sampleRate = 48000.0f;
+    auto perSample = std::make_unique<Limiter>(sampleRate);
+    auto block = std::make_unique<Limiter>(sampleRate);
+
+    size_t len = 2000;
+    std::vector<float> left(len);
+    std::vector<float> right(len);
+    for (size_t i = 0; i < len; ++i) {
+        left[i] = 2.0f * sinf(kTwoPi * 1000.0f * static_cast<float>(i) / sampleRate);
+        right[i] = 1.5f * sinf(kTwoPi * 1500.0f * static_cast<float>(i) / sampleRate);
+    }
+
+    std::vector<float_2> expected(len);
+    for (size_t i = 0; i < len; ++i) {
+        expected[i] = perSample->Process(float_2{left[i], right[i]});
+    }
+    for (size_t start = 0; start < len; start += 333) {
+        size_t size = std::min<size_t>(333, len - start);
+        block->Process({left.data() + start, size}, {right.data() + start, size}, {left.data() + start, size},
+                       {right.data() + start, size});
+    }
+    for (size_t i = 0; i < len; ++i) {
+        EXPECT_EQ(expected[i].left, left[i]) << "at sample " << i;
+        EXPECT_EQ(expected[i].right, right[i]) << "at sample " << i;
+    }
+}
+
+TEST(truePeakLimiter, worksAtMaxLookahead) {
+    constexpr size_t kMaxLookahead = 32;
+    float sampleRate = 48000.0f;
+    auto limiter = std::make_unique<TruePeakLimiter<kMaxLookahead>>(sampleRate, 100.0f);
+    limiter->cfg.ceilingDb = -1.0f;
+    limiter->cfg.releaseMs = 0.0f;
+    size_t latency = limiter->GetLatencySamples();
+    ASSERT_EQ(latency, kMaxLookahead + TruePeakDetector::kLatencySamples);
+
+    // a decay above the ceiling needs less gain every sample, which fills the whole hold queue
+    size_t loudLen = kMaxLookahead * 4;
+    size_t len = loudLen + 4800;
+    std::vector<float> in(len);
+    for (size_t i = 0; i < len; ++i) {
+        in[i] = i < loudLen ? 8.0f - 6.5f * static_cast<float>(i) / static_cast<float>(loudLen)
+                            : 0.5f * sinf(kTwoPi * 440.0f * static_cast<float>(i) / sampleRate);
+    }
+
+    float ceiling = dbToRatio(-1.0f);
+    for (size_t i = 0; i < len; ++i) {
+        float out = limiter->Process(float_2{in[i], in[i]}).left;
+        EXPECT_LE(fabsf(out), ceiling * dbToRatio(0.1f)) << "at sample " << i;
+        if (i >= len / 2) {
+            // long after the release, anything under the ceiling comes out untouched
+            EXPECT_NEAR(out, in[i - latency], 1e-6f) << "at sample " << i;
+        }
+    }
+}
@@ -34,6 +34,15 @@ namespace kitgui {
 class BaseApp;
 class FileContext;
 
+/**
+ * The contents of a file. bytes stay valid for as long as owner is held, or for as long as whoever handed them out says
+ * if owner is null.
+ */
+struct FileData {
+    std::string_view bytes{};
+    std::shared_ptr<const void> owner{};
+};
+
 struct SizeConfig {
     uint32_t startingWidth{400};
     uint32_t startingHeight{400};
@@ -47,7 +56,7 @@ struct SizeConfig {
 class Context {
    public:
     using AppFactory = std::function<std::unique_ptr<BaseApp>(Context& ctx)>;
-    using FileLoader = std::function<std::optional<std::string>(std::string_view path)>;
+    using FileLoader = std::function<std::optional<FileData>(std::string_view path)>;
     using Logger = std::function<void(std::string_view message)>;
 
     /**
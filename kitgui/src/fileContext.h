@@ -1,8 +1,9 @@
 #pragma once
 
 #include <Magnum/FileCallback.h>
-#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include "kitgui/context.h"
 
@@ -14,10 +15,11 @@ class FileContext {
 
     /**
      * Synchronously loads a file into the cache and returns its contents.
-     * If the file is already in cache, we'll just return the pointer immediately.
-     * The policy parameter helps determine the lifetime of the returned string and associated cache entry.
+     * If the file is already in cache, we'll just return it immediately.
+     * The policy parameter helps determine the lifetime of the returned view and associated cache entry.
      */
-    std::string* GetOrLoadFileByName(const std::string& filename, Magnum::InputFileCallbackPolicy policy);
+    std::optional<std::string_view> GetOrLoadFileByName(const std::string& filename,
+                                                        Magnum::InputFileCallbackPolicy policy);
 
     /**
      * Sets the mechanism used to synchronously load files. the default mechanism uses stdio.
@@ -25,8 +27,8 @@ class FileContext {
     void SetFileLoader(Context::FileLoader mLoader);
 
    private:
-    // std::unique_ptr is used to ensure a stable address for the file data
-    std::unordered_map<std::string, std::unique_ptr<std::string>> mFiles;
+    // each entry holds on to its owner, so the file data stays put until it's uncached
+    std::unordered_map<std::string, FileData> mFiles;
     Context::FileLoader mLoader;
 };
 
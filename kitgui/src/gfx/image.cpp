@@ -38,8 +38,9 @@ struct Image::Impl {
 
         const auto fileCallback = [](const std::string& filename, Magnum::InputFileCallbackPolicy policy,
                                      void* ctx) -> Containers::Optional<Containers::ArrayView<const char>> {
-            std::string* fileData = ((kitgui::FileContext*)ctx)->GetOrLoadFileByName(filename, policy);
-            if (fileData == nullptr) {
+            std::optional<std::string_view> fileData =
+                ((kitgui::FileContext*)ctx)->GetOrLoadFileByName(filename, policy);
+            if (!fileData) {
                 return {};
             }
             return Containers::ArrayView<const char>(fileData->data(), fileData->size());